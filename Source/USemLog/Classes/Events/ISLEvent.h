@@ -37,6 +37,12 @@ public:
 	// Create owl representation of the event
 	virtual FSLOwlNode ToOwlNode() const = 0;
 
+	// Get the owl class of the event without creating its owl node (NAME_None if not implemented)
+	virtual FName GetTypeName() const { return NAME_None; };
+
+	// Get the ids of the involved entities (the individuals referenced by its owl node, except the timepoints)
+	virtual void GetEntityIds(TArray<FString>& OutIds) const {};
+
 	// Add the owl representation of the event to the owl document
 	virtual void AddToOwlDoc(FSLOwlDoc* OutDoc) = 0;
 
@@ -17,25 +17,31 @@ public:
 
 	// Constructor with initialization
 	FSLContactEvent(const FString& InId, const float InStart, const float InEnd, const uint64 InPairId,
-		const FSLEntity& InItem1, const FSLEntity& InItem2);
+		const FSLEntityHandle& InItem1, const FSLEntityHandle& InItem2);
 
 	// Constructor initialization without end time
 	FSLContactEvent(const FString& InId, const float InStart, const uint64 InPairId,
-		const FSLEntity& InItem1, const FSLEntity& InItem2);
+		const FSLEntityHandle& InItem1, const FSLEntityHandle& InItem2);
 	
 	// Pair id of the event (combination of two unique runtime ids)
 	uint64 PairId;
 
 	// Item1 in contact
-	FSLEntity Item1;
+	FSLEntityHandle Item1;
 
 	// Item2 in contact
-	FSLEntity Item2;
+	FSLEntityHandle Item2;
 
 	/* Begin IEvent interface */
 	// Create an owl representation of the event
 	virtual FSLOwlNode ToOwlNode() const override;
 
+	// Get the owl class of the event
+	virtual FName GetTypeName() const override;
+
+	// Get the ids of the involved entities
+	virtual void GetEntityIds(TArray<FString>& OutIds) const override;
+
 	// Add the owl representation of the event to the owl document
 	virtual void AddToOwlDoc(FSLOwlDoc* OutDoc) override;
 
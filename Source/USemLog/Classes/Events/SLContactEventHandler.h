@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLContactEvent.h"
 #include "Events/SLSupportedByEvent.h"
 #include "TimerManager.h"
@@ -34,7 +35,7 @@ private:
 	bool FinishContactEvent(const FSLEntity&, float EndTime);
 
 	// Start new supported by event
-	void AddNewSupportedByEvent(const FSLEntity& Supported, const FSLEntity& Supporting, float StartTime, const uint64 EventPairId);
+	void AddNewSupportedByEvent(const FSLEntityHandle& Supported, const FSLEntityHandle& Supporting, float StartTime, const uint64 EventPairId);
 
 	// Finish then publish the event
 	bool FinishSupportedByEvent(const uint64 InPairId, float EndTime);
@@ -49,7 +50,7 @@ private:
 	void OnSLOverlapEnd(const FSLEntity& Self, const FSLEntity& Other, float Time);
 
 	// Event called when a supported by event begins
-	void OnSLSupportedByBegin(const FSLEntity& Supported, const FSLEntity& Supporting, float StartTime, const uint64 EventPairId);
+	void OnSLSupportedByBegin(const FSLEntityHandle& Supported, const FSLEntityHandle& Supporting, float StartTime, const uint64 EventPairId);
 	
 	// Event called when a supported by event ends
 	void OnSLSupportedByEnd(const uint64 PairId1, const uint64 PairId2, float Time);
@@ -63,6 +64,12 @@ private:
 
 	// Array of started supported by events
 	TArray<TSharedPtr<FSLSupportedByEvent>> StartedSupportedByEvents;
+
+	// Pool of the contact events
+	TSLEventPool<FSLContactEvent> ContactEventPool;
+
+	// Pool of the supported by events
+	TSLEventPool<FSLSupportedByEvent> SupportedByEventPool;
 	
 	/* Constant values */
 	constexpr static float ContactEventMin = 0.3f;
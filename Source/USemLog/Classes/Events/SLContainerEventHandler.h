@@ -4,6 +4,8 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLContainerEvent.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLGraspEvent.h"
 
 /**
@@ -28,4 +30,7 @@ private:
 private:
 	// Parent
 	class USLContainerListener* Parent;
+
+	// Pool of the container events
+	TSLEventPool<FSLContainerEvent> EventPool;
 };
@@ -0,0 +1,139 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "Misc/ScopeLock.h"
+
+/**
+* Per type pool of events, the events are constructed in chunks of preallocated slots and handed out as shared pointers,
+* released slots are reused, the chunks are freed once the pool and all its events are gone (end of the episode);
+* only the event memory is pooled, the shared pointers still allocate their (small) reference controller per event
+*/
+template<typename T>
+class TSLEventPool
+{
+public:
+	// Ctor
+	TSLEventPool() : Storage(new FStorage()) {};
+
+	// The storage outlives the pool while events are alive
+	TSLEventPool(const TSLEventPool&) = delete;
+	TSLEventPool& operator=(const TSLEventPool&) = delete;
+
+	// Dtor, the storage is freed with the last event
+	~TSLEventPool()
+	{
+		if (Storage->ReleasePool())
+		{
+			delete Storage;
+		}
+	};
+
+	// Construct an event in a free slot
+	template<typename... ArgsType>
+	TSharedPtr<T> Create(ArgsType&&... Args)
+	{
+		T* Event = new (Storage->Allocate()) T(Forward<ArgsType>(Args)...);
+		return MakeShareable(Event, FReleaser(Storage));
+	};
+
+	// Number of events alive
+	int32 Num() const { return Storage->NumLive; };
+
+private:
+	/**
+	* Chunks of slots and the free list, kept alive by the pool and by the live events
+	*/
+	struct FStorage
+	{
+		// Slot memory
+		TArray<TTypeCompatibleBytes<T>*> Chunks;
+
+		// Released slots
+		TArray<T*> FreeSlots;
+
+		// Used slots of the last chunk
+		int32 NumUsedInChunk = ChunkSize;
+
+		// Number of events alive
+		int32 NumLive = 0;
+
+		// Set until the pool is destroyed
+		bool bPoolAlive = true;
+
+		// Guards the slots (events can be released from other threads)
+		FCriticalSection Lock;
+
+		// Free the chunks, all the events are destroyed by now
+		~FStorage()
+		{
+			for (TTypeCompatibleBytes<T>* Chunk : Chunks)
+			{
+				delete[] Chunk;
+			}
+		};
+
+		// Get a free slot
+		void* Allocate()
+		{
+			FScopeLock ScopeLock(&Lock);
+			NumLive++;
+			if (FreeSlots.Num() > 0)
+			{
+				return FreeSlots.Pop(false);
+			}
+			if (NumUsedInChunk == ChunkSize)
+			{
+				Chunks.Add(new TTypeCompatibleBytes<T>[ChunkSize]);
+				NumUsedInChunk = 0;
+			}
+			return Chunks.Last()[NumUsedInChunk++].GetTypedPtr();
+		};
+
+		// Give the slot back, true if it was the last user of the storage
+		bool Release(T* Slot)
+		{
+			FScopeLock ScopeLock(&Lock);
+			NumLive--;
+			FreeSlots.Add(Slot);
+			return !bPoolAlive && NumLive == 0;
+		};
+
+		// Called by the pool dtor, true if there are no events alive
+		bool ReleasePool()
+		{
+			FScopeLock ScopeLock(&Lock);
+			bPoolAlive = false;
+			return NumLive == 0;
+		};
+	};
+
+	/**
+	* Deleter of the shared pointers, destroys the event and gives its slot back (a plain pointer, the live events are counted by the storage)
+	*/
+	struct FReleaser
+	{
+		FReleaser(FStorage* InStorage) : Storage(InStorage) {};
+
+		void operator()(T* Event) const
+		{
+			Event->~T();
+			if (Storage->Release(Event))
+			{
+				delete Storage;
+			}
+		};
+
+		FStorage* Storage;
+	};
+
+	// Slots of the pool
+	FStorage* Storage;
+
+	/* Constants */
+	// Number of slots allocated at once
+	constexpr static int32 ChunkSize = 256;
+};
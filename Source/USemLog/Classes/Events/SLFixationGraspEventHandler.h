@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLGraspEvent.h"
 
 /**
@@ -47,4 +48,7 @@ private:
 
 	// Array of started events
 	TArray<TSharedPtr<FSLGraspEvent>> StartedEvents;
+
+	// Pool of the grasp events
+	TSLEventPool<FSLGraspEvent> EventPool;
 };
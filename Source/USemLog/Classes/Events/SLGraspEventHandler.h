@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLGraspEvent.h"
 
 /**
@@ -43,6 +44,9 @@ private:
 
 	// Array of started events
 	TArray<TSharedPtr<FSLGraspEvent>> StartedEvents;
+
+	// Pool of the grasp events
+	TSLEventPool<FSLGraspEvent> EventPool;
 	
 	/* Constant values */
 	constexpr static float GraspEventMin = 0.25f;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLContactEvent.h"
 #include "TimerManager.h"
 
@@ -47,4 +48,7 @@ private:
 
 	// Array of started contact events
 	TArray<TSharedPtr<FSLContactEvent>> StartedEvents;
+
+	// Pool of the contact events
+	TSLEventPool<FSLContactEvent> EventPool;
 };
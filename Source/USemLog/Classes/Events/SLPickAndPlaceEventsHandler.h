@@ -4,6 +4,11 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLSlideEvent.h"
+#include "Events/SLPickUpEvent.h"
+#include "Events/SLTransportEvent.h"
+#include "Events/SLPutDownEvent.h"
+#include "Events/SLEventPool.h"
 #include "SLStructs.h"
 
 /**
@@ -37,5 +42,17 @@ private:
 private:
 	// Parent
 	class USLPickAndPlaceListener* Parent;
+
+	// Pool of the slide events
+	TSLEventPool<FSLSlideEvent> SlideEventPool;
+
+	// Pool of the pick up events
+	TSLEventPool<FSLPickUpEvent> PickUpEventPool;
+
+	// Pool of the transport events
+	TSLEventPool<FSLTransportEvent> TransportEventPool;
+
+	// Pool of the put down events
+	TSLEventPool<FSLPutDownEvent> PutDownEventPool;
 };
 
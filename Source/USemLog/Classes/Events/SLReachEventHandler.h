@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLReachEvent.h"
 #include "Events/SLPreGraspPositioningEvent.h"
 
@@ -30,6 +31,12 @@ private:
 	// Parent
 	class USLReachListener* Parent;
 
+	// Pool of the reach events
+	TSLEventPool<FSLReachEvent> ReachEventPool;
+
+	// Pool of the pre grasp positioning events
+	TSLEventPool<FSLPreGraspPositioningEvent> PreGraspEventPool;
+
 	/* Constants */
 	// Minimal duration for the reaching events
 	constexpr static float ReachEventMin = 0.25f;
@@ -47,6 +47,12 @@ public:
 	// Create an owl representation of the event
 	virtual FSLOwlNode ToOwlNode() const override;
 
+	// Get the owl class of the event
+	virtual FName GetTypeName() const override;
+
+	// Get the ids of the involved entities
+	virtual void GetEntityIds(TArray<FString>& OutIds) const override;
+
 	// Add the owl representation of the event to the owl document
 	virtual void AddToOwlDoc(FSLOwlDoc* OutDoc) override;
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventPool.h"
 #include "Events/SLSlicingEvent.h"
 
 /**
@@ -56,4 +57,7 @@ private:
 
 	// Array of started events
 	TArray<TSharedPtr<FSLSlicingEvent>> StartedEvents;
+
+	// Pool of the slicing events
+	TSLEventPool<FSLSlicingEvent> EventPool;
 };
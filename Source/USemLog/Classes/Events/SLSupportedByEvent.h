@@ -17,25 +17,31 @@ public:
 
 	// Constructor with initialization 
 	FSLSupportedByEvent(const FString& InId, const float InStart, const float InEnd, const uint64 InPairId,
-		const FSLEntity& InSupportedItem, const FSLEntity& InSupportingItem);
+		const FSLEntityHandle& InSupportedItem, const FSLEntityHandle& InSupportingItem);
 
 	// Constructor with initialization without end time 
 	FSLSupportedByEvent(const FString& InId, const float InStart, const uint64 InPairId,
-		const FSLEntity& InSupportedItem, const FSLEntity& InSupportingItem);
+		const FSLEntityHandle& InSupportedItem, const FSLEntityHandle& InSupportingItem);
 
 	// Pair id of the event (combination of two unique runtime ids)
 	uint64 PairId;
 
 	// Supported item
-	FSLEntity SupportedItem;
+	FSLEntityHandle SupportedItem;
 
 	// Supporting item
-	FSLEntity SupportingItem;
+	FSLEntityHandle SupportingItem;
 
 	/* Begin IEvent interface */
 	// Create an owl representation of the event
 	virtual FSLOwlNode ToOwlNode() const override;
 
+	// Get the owl class of the event
+	virtual FName GetTypeName() const override;
+
+	// Get the ids of the involved entities
+	virtual void GetEntityIds(TArray<FString>& OutIds) const override;
+
 	// Add the owl representation of the event to the owl document
 	virtual void AddToOwlDoc(FSLOwlDoc* OutDoc) override;
 
@@ -83,7 +83,19 @@ public:
 	// Finish logger
 	void Finish(const float Time, bool bForced = false);
 
+	// Init and start the listeners of an actor registered at runtime (e.g. spawned)
+	void AddActorListeners(AActor* Actor);
+
+	// Finish the listeners of a destroyed actor, their pending events end at the given time
+	void RemoveActorListeners(AActor* Actor, float Time);
+
+	// Temporal index of the finished events (thread safe queries, stays valid after the logger is destroyed)
+	TSharedPtr<class FSLEventIndex, ESPMode::ThreadSafe> GetEventIndex() const { return EventIndex; };
+
 private:
+	// Init the contact shape and its event handler (false if the component is not an annotated contact shape)
+	bool AddContactShape(class UShapeComponent* ShapeComp);
+
 	// Check if the component is valid in the world and has a semantically annotated owner
 	bool IsValidAndAnnotated(UActorComponent* Comp) const;
 	
@@ -119,27 +131,39 @@ private:
 	// Save events to timelines
 	bool bWriteTimelines;
 
+	// Listen for contact events (cached for the entities registered at runtime)
+	bool bLogContactEvents;
+
+	// Listen for supported by events (cached for the entities registered at runtime)
+	bool bLogSupportedByEvents;
+
 	// Array of finished events
 	TArray<TSharedPtr<ISLEvent>> FinishedEvents;
 
+	// Index of the finished events (per type interval trees, per entity postings)
+	TSharedPtr<class FSLEventIndex, ESPMode::ThreadSafe> EventIndex;
+
 	// Owl document of the finished events
 	TSharedPtr<FSLOwlExperiment> ExperimentDoc;
 
-	// Semantic event handlers (takes input raw events, outputs finished semantic events)
-	TArray<TSharedPtr<ISLEventHandler>> EventHandlers;
+	// Semantic event handlers (takes input raw events, outputs finished semantic events), sets for O(1) runtime adds and removals
+	TSet<TSharedPtr<ISLEventHandler>> EventHandlers;
 
 	// List of the contact trigger shapes, stored to call Start and Finish on them
-	TArray<class ISLContactShapeInterface*> ContactShapes;
+	TSet<class ISLContactShapeInterface*> ContactShapes;
+
+	// Contact event handler of each contact shape (used to finish the handler when the shape is destroyed)
+	TMap<UActorComponent*, TSharedPtr<ISLEventHandler>> ContactShapeHandlers;
 
 	// Cache of the grasp listeners
-	TArray<class USLManipulatorListener*> GraspListeners;
+	TSet<class USLManipulatorListener*> GraspListeners;
 
 	// Cache of the pick and place listeners
-	TArray<class USLPickAndPlaceListener*> PickAndPlaceListeners;
+	TSet<class USLPickAndPlaceListener*> PickAndPlaceListeners;
 
 	// Cache of the grasp listeners
-	TArray<class USLReachListener*> ReachListeners;
+	TSet<class USLReachListener*> ReachListeners;
 
 	// Cache of the container manipulation listeners
-	TArray<class USLContainerListener*> ContainerListeners;
+	TSet<class USLContainerListener*> ContainerListeners;
 };
@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "SLStructs.h" // FSLEntity
+#include "Tickable.h"
+#include "Async/AsyncWork.h"
+#include "RenderCommandFence.h"
 #include "SLItemScanner.generated.h"
 
 // Forward declarations
@@ -13,6 +16,8 @@ class UMaterialInterface;
 class UGameViewportClient;
 class AStaticMeshActor;
 class APlayerCameraManager;
+class USceneCaptureComponent2D;
+class UTextureRenderTarget2D;
 
 /**
 * View modes
@@ -28,14 +33,72 @@ enum class ESLItemScannerViewMode : uint8
 	Normal					UMETA(DisplayName = "Normal"),
 };
 
+/**
+* Image of a batched scan, read back from the render target and encoded on a worker thread
+*/
+struct FSLScanImage
+{
+	// Pixels read back from the render target
+	TArray<FColor> Bitmap;
+
+	// Png compressed image
+	TArray<uint8> CompressedBitmap;
+
+	// Number of item and background pixels (INDEX_NONE if the view mode does not allow counting)
+	int32 ItemPixelNum = INDEX_NONE;
+	int32 BackgroundPixelNum = INDEX_NONE;
+};
+
+/**
+* Background task counting the item pixels and compressing a batched scan image
+*/
+class FSLScanEncodeWorker : public FNonAbandonableTask
+{
+	friend class FAsyncTask<FSLScanEncodeWorker>;
+
+public:
+	// Ctor
+	FSLScanEncodeWorker(FSLScanImage* InImage, ESLItemScannerViewMode InViewMode, FIntPoint InResolution,
+		const FString& InPath, const FString& InCachePath) :
+		Image(InImage), ViewMode(InViewMode), Resolution(InResolution), Path(InPath), CachePath(InCachePath) {};
+
+private:
+	// FAsyncTask - async work done here
+	void DoWork();
+
+	// Needed by unreal internally
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FSLScanEncodeWorker, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+	// Image to process (owned by the scanner)
+	FSLScanImage* Image;
+
+	// View mode the image was rendered with
+	ESLItemScannerViewMode ViewMode;
+
+	// Image resolution
+	FIntPoint Resolution;
+
+	// Local save path of the png (empty if not saved locally)
+	FString Path;
+
+	// Scan cache path of the png (empty if the cache is not used)
+	FString CachePath;
+};
+
 /**
  * Scans handheld items by taking images from unidistributed points form a sphere as a camera location
  */
 UCLASS()
-class USLItemScanner : public UObject
+class USLItemScanner : public UObject, public FTickableGameObject
 {
 	GENERATED_BODY()
 
+	// Uses the pixel counting functions
+	friend class FSLScanEncodeWorker;
+
 public:
 	// Ctor
 	USLItemScanner();
@@ -45,7 +108,8 @@ public:
 
 	// Setup scanning room
 	void Init(const FString& InTaskId, const FString InServerIp, uint16 InServerPort,
-		FIntPoint InResolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally);
+		FIntPoint InResolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally,
+		int32 InBatchSize = 0, bool bInUseScanCache = false);
 
 	// Start scanning
 	void Start(USLMetadataLogger* InParent);
@@ -62,6 +126,17 @@ public:
 	// Get finished state
 	bool IsFinished() const { return bIsFinished; };
 
+	/** Begin FTickableGameObject interface */
+	// Called after ticking all actors, DeltaTime is the time passed since the last call.
+	virtual void Tick(float DeltaTime) override;
+
+	// Return if object is ready to be ticked
+	virtual bool IsTickable() const override;
+
+	// Return the stat id to use for this tickable
+	virtual TStatId GetStatId() const override;
+	/** End FTickableGameObject interface */
+
 private:
 	//// Load scan box actor
 	//bool LoadScanBoxActor();
@@ -87,16 +162,16 @@ private:
 	// Setup next view mode (bCircular, if the last value is reached, jump to the first one)
 	bool SetupNextViewMode();
 	
-	// Move first item in the scan box
+	// Move the first item with uncached scans in the scan box
 	bool SetupFirstScanItem();
 
-	// Set next item in the scan box, return false if there are no more items
+	// Set next item with uncached scans in the scan box, return false if there are no more items
 	bool SetupNextItem();
 
-	// Move camera in position for the first scan
+	// Move camera in position for the first uncached scan
 	bool SetupFirstScanPose();
 
-	// Move camera in position for the next scan, return false if there are no more poses
+	// Move camera in position for the next uncached scan, return false if there are no more poses
 	bool SetupNextScanPose();
 
 	// Request a screenshot
@@ -109,10 +184,10 @@ private:
 	void CountItemPixelNum(const TArray<FColor>& Bitmap);
 	
 	// Get the number of pixels of the given color in the image
-	int32 GetColorPixelNum(const TArray<FColor>& Bitmap, const FColor& Color) const;
+	static int32 GetColorPixelNum(const TArray<FColor>& Bitmap, const FColor& Color);
 	
 	// Get the number of pixels of the given two colors in the image
-	void GetColorsPixelNum(const TArray<FColor>& Bitmap, const FColor& ColorA, int32& OutNumA, const FColor& ColorB, int32& OutNumB);
+	static void GetColorsPixelNum(const TArray<FColor>& Bitmap, const FColor& ColorA, int32& OutNumA, const FColor& ColorB, int32& OutNumB);
 	
 	// Apply view mode
 	void ApplyViewMode(ESLItemScannerViewMode Mode);
@@ -120,6 +195,56 @@ private:
 	// Get view mode name
 	FString GetViewModeName(ESLItemScannerViewMode Mode) const;
 
+	/* Batched scanning */
+	// Start scanning in batches with scene captures
+	bool StartBatched();
+
+	// Move every item in its own isolated cell
+	void PlaceItemsInCells();
+
+	// Create the scene captures and their render targets
+	bool SetupBatchCaptures();
+
+	// Set the jobs of the next batch, return false if there are no more scans
+	bool SetupNextBatch();
+
+	// Apply the view mode on the scene captures
+	void ApplyBatchViewMode(ESLItemScannerViewMode Mode);
+
+	// Apply or remove the mask material on the items of the batch
+	void ApplyBatchMaskMaterial(bool bApply);
+
+	// Render all the scans of the batch in the current view mode and enqueue their readback
+	void CaptureBatch();
+
+	// Encode the read back images of the current view mode on worker threads
+	void StartBatchEncoding();
+
+	// Wait for the workers and write the scan entries of the batch
+	void FinishBatch();
+
+	// Get the scan name (for saving locally)
+	FString GetScanName(int32 ItemIdx, int32 PoseIdx, ESLItemScannerViewMode Mode) const;
+
+	/* Scan cache */
+	// Hash the scan inputs of every item, write the already cached scans and report the hit rate
+	void LoadScanCache();
+
+	// Content hash of the item scan inputs (mesh, materials, resolution, view modes, poses)
+	FString GetItemScanHash(UStaticMeshComponent* SMC) const;
+
+	// Get the cache file path of the scan image (empty if the cache is not used)
+	FString GetScanCachePath(int32 ItemIdx, int32 PoseIdx, ESLItemScannerViewMode Mode) const;
+
+	// Check if all the view modes of the scan are cached
+	bool IsScanCached(int32 ItemIdx, int32 PoseIdx) const { return CachedJobs.Contains(ItemIdx * ScanPoses.Num() + PoseIdx); };
+
+	// Check if all the scans of the item are cached
+	bool IsItemCached(int32 ItemIdx) const;
+
+	// Write the image to the cache (through a temporary file, a crash never leaves a partial image behind)
+	static bool SaveToScanCache(const FString& CachePath, const TArray<uint8>& CompressedBitmap);
+
 	// Apply mask material to current item
 	void ApplyMaskMaterial();
 
@@ -209,10 +334,75 @@ private:
 	// Currently counted number of pixels of the item
 	int32 ItemPixelNum;
 
+	/* Batched scanning */
+	// Number of scans rendered in one frame (0 - sequential screenshots)
+	int32 BatchSize;
+
+	// True if the object can be ticked (used by FTickableGameObject)
+	bool bIsTickable;
+
+	// Owner of the scene captures
+	UPROPERTY() // Avoid GC
+	AActor* CaptureActor;
+
+	// Scene captures, one for every scan of the batch
+	UPROPERTY() // Avoid GC
+	TArray<USceneCaptureComponent2D*> Captures;
+
+	// Render targets of the scene captures
+	UPROPERTY() // Avoid GC
+	TArray<UTextureRenderTarget2D*> RenderTargets;
+
+	// Location of the cell of every item
+	TArray<FVector> CellLocations;
+
+	// Scan jobs which are not cached (Item * NumPoses + Pose)
+	TArray<int32> PendingJobs;
+
+	// First pending scan job of the batch
+	int32 BatchFirstJobIdx;
+
+	// Number of scan jobs in the batch
+	int32 BatchNumJobs;
+
+	// Images of the batch (Job * NumViewModes + ViewMode)
+	TArray<FSLScanImage> BatchImages;
+
+	// Running image encoders
+	TArray<FAsyncTask<FSLScanEncodeWorker>*> EncodeWorkers;
+
+	// Original materials of the items with the mask material applied
+	TMap<UStaticMeshComponent*, TArray<UMaterialInterface*>> BatchOriginalMaterials;
+
+	// Signaled once the render thread has read back the images
+	FRenderCommandFence ReadbackFence;
+
+	// Set while waiting for the readback
+	bool bReadbackPending;
+
+	/* Scan cache */
+	// Skip the scans which are already in the cache
+	bool bUseScanCache;
+
+	// Cache directory of every item
+	TArray<FString> ScanCacheDirs;
+
+	// Scan jobs with all the view modes in the cache
+	TSet<int32> CachedJobs;
+
 	/* Constants */
 	// Volume limit in cubic centimeters (1000cm^3 = 1 Liter) of items to scan
 	constexpr static const float VolumeLimit = 40000.f;
 
 	// Length limit of its bounding box points (cm) 
 	constexpr static const float LengthLimit = 75.f;
+
+	// Distance of the scan camera poses to the item (cm)
+	constexpr static const float ScanRadius = 50.f;
+
+	// Number of scan camera poses
+	constexpr static const uint32 NumScanPoses = 128;
+
+	// Version of the scan outputs, increment to invalidate the cache
+	constexpr static const int32 ScanCacheVersion = 1;
 };
@@ -8,7 +8,101 @@
 #include "SLOwlSemanticMap.h"
 
 /**
- * Class for exporting the semantic map in an OWL format
+* Snapshot of a semantically annotated object (or constraint), read on the game thread,
+* the owl individuals are built from it on the worker threads
+*/
+struct FSLSemanticMapObjectData
+{
+	// Semantic id and class
+	FString Id;
+	FString Class;
+
+	// Semantically annotated parent and (direct) children ids
+	FString ParentId;
+	TArray<FString> ChildIds;
+
+	// Mobility property (empty if none)
+	FString Mobility;
+
+	// Physics properties
+	bool bHasPhysics = false;
+	float Mass = 0.f;
+	bool bGenerateOverlapEvents = false;
+	bool bGravity = false;
+
+	// Visual mask color
+	FString ColorHex;
+
+	// Path to the cad model (static meshes)
+	FString PathToCadModel;
+
+	// Tags of the actor or component
+	TArray<FName> Tags;
+
+	// Pose in ROS coordinates (actors and scene components)
+	bool bHasPose = false;
+	FVector ROSLoc = FVector::ZeroVector;
+	FQuat ROSQuat = FQuat::Identity;
+
+	/* Constraint data */
+	bool bIsConstraint = false;
+	FString ConstrParentId;
+	FString ConstrChildId;
+	uint8 LinMotion[3] = { 0, 0, 0 };
+	float LinLimit = 0.f;
+	bool bLinSoftConstraint = false;
+	float LinStiffness = 0.f;
+	float LinDamping = 0.f;
+	uint8 AngMotion[3] = { 0, 0, 0 };
+	float AngLimit[3] = { 0.f, 0.f, 0.f };
+	bool bAngSoftSwingConstraint = false;
+	float AngSwingStiffness = 0.f;
+	float AngSwingDamping = 0.f;
+	bool bAngSoftTwistConstraint = false;
+	float AngTwistStiffness = 0.f;
+	float AngTwistDamping = 0.f;
+};
+
+/**
+* Snapshot of the data of a class definition
+*/
+struct FSLSemanticMapClassData
+{
+	FString Class;
+	FString SubClassOf;
+
+	// Bounding box size in meters (zero if unknown)
+	FVector BBSize = FVector::ZeroVector;
+
+	// Bone names of skeletal meshes
+	TArray<FString> BoneNames;
+};
+
+/**
+* Serialized individuals of an object from the previous write, reused while the object fingerprint does not change
+*/
+struct FSLSemanticMapCacheEntry
+{
+	// Hash of the object snapshot
+	FString Fingerprint;
+
+	// Serialized owl individuals of the object
+	FString IndividualStr;
+
+	// Serialize the entry
+	friend FArchive& operator<<(FArchive& Ar, FSLSemanticMapCacheEntry& Entry)
+	{
+		Ar << Entry.Fingerprint;
+		Ar << Entry.IndividualStr;
+		return Ar;
+	}
+};
+
+/**
+ * Class for exporting the semantic map in an OWL format,
+ * the objects are read on the game thread, their individuals are built and serialized in parallel,
+ * and streamed to file in a deterministic (id) order; in incremental mode only the individuals
+ * of the objects whose fingerprint changed since the previous write are rebuilt
  */
 struct USEMLOG_API FSLSemanticMapWriter
 {
@@ -20,7 +114,8 @@ public:
 	bool WriteToFile(UWorld* World,
 		ESLOwlSemanticMapTemplate TemplateType = ESLOwlSemanticMapTemplate::NONE,
 		const FString& InDirectory = TEXT("SemLog"),
-		const FString& InFilename = TEXT("SemanticMap"));
+		const FString& InFilename = TEXT("SemanticMap"),
+		bool bIncremental = false);
 
 private:
 	// Create semantic map template
@@ -28,29 +123,45 @@ private:
 		ESLOwlSemanticMapTemplate TemplateType,
 		const FString& DocId = "");
 
-	// Add individuals to the semantic map
-	void AddAllIndividuals(TSharedPtr<FSLOwlSemanticMap> InSemMap, UWorld* World);
-
-	// Add object individual to the semantic map
-	void AddObjectIndividual(TSharedPtr<FSLOwlSemanticMap> InSemMap,
-		UObject* Object,
-		const FString& InId,
-		const FString& InClass);
-
-	// Add class definition individual
-	void AddClassDefinition(TSharedPtr<FSLOwlSemanticMap> InSemMap,
-		UObject* Object,
-		const FString& InClass,
-		const FString& InSubClassOf = TEXT(""));
-
-	// Add constraint individual
-	void AddConstraintIndividual(TSharedPtr<FSLOwlSemanticMap> InSemMap,
-		UPhysicsConstraintComponent* ConstraintComp,
-		const FString& InId,
-		const TArray<FName>& InTags);
-
-	// Add individual physics properties
-	TArray<FSLOwlNode> GetIndividualPhysicsProperties(UObject* Object);
+	// Snapshot the data of the semantically annotated objects and classes (game thread)
+	void ReadAllObjects(UWorld* World,
+		TArray<FSLSemanticMapObjectData>& OutObjects,
+		TArray<FSLSemanticMapClassData>& OutClasses);
+
+	// Snapshot the object data
+	void ReadObjectData(UObject* Object, FSLSemanticMapObjectData& OutData);
+
+	// Snapshot the constraint data, false if the constrained actors are not annotated
+	bool ReadConstraintData(UPhysicsConstraintComponent* ConstraintComp, const TArray<FName>& InTags, FSLSemanticMapObjectData& OutData);
+
+	// Snapshot the class data
+	void ReadClassData(UObject* Object, FSLSemanticMapClassData& OutData);
+
+	// Build and serialize the individuals of the object (thread safe)
+	static FString BuildObjectIndividuals(const FString& MapPrefix, const FString& DocId, const FSLSemanticMapObjectData& Data);
+
+	// Build and serialize the individuals of the constraint (thread safe)
+	static FString BuildConstraintIndividuals(const FString& MapPrefix, const FString& DocId, const FSLSemanticMapObjectData& Data);
+
+	// Build the class definition
+	static FSLOwlNode BuildClassDefinition(const FSLSemanticMapClassData& Data);
+
+	// Hash of the object snapshot (tags, pose, parent/child links, properties)
+	static FString GetFingerprint(const FSLSemanticMapObjectData& Data);
+
+	// Hash of the class definitions snapshots
+	static FString GetClassesFingerprint(const TArray<FSLSemanticMapClassData>& Classes);
+
+	// Load the fingerprints and individuals of the previous write, false if missing or incompatible
+	static bool LoadCache(const FString& Path, ESLOwlSemanticMapTemplate TemplateType,
+		FString& OutDocId, FString& OutClassesFingerprint, TMap<FString, FSLSemanticMapCacheEntry>& OutEntries);
+
+	// Save the fingerprints and individuals of the current write
+	static bool SaveCache(const FString& Path, ESLOwlSemanticMapTemplate TemplateType,
+		const FString& DocId, const FString& ClassesFingerprint, const TArray<FString>& Ids, const TArray<FSLSemanticMapCacheEntry>& Entries);
+
+	// Write the document with the serialized individuals appended, without building the whole document string
+	static bool StreamToFile(const FString& Path, TSharedPtr<FSLOwlSemanticMap> InSemMap, const TArray<FString>& IndividualStrs);
 	
 	// Get object semantically annotated parent id (empty string if none)
 	FString GetParentId(UObject* Object);
@@ -60,4 +171,12 @@ private:
 
 	// Get mobility property
 	FString GetMobility(UObject* Object);
+
+private:
+	// Parsed tags of the written world
+	class FSLTagCache* TagCache;
+
+	/* Constants */
+	// Version of the cache file, bump when the individuals format changes
+	constexpr static int32 CacheVersion = 1;
 };
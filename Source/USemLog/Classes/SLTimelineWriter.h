@@ -0,0 +1,60 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ISLEvent.h"
+
+/**
+ * Exports the event timelines in a columnar binary format for very large event sets,
+ * the events are grouped by their (interned) context and sorted by start time, for every context the intervals are
+ * additionally merged at several time resolutions (levels of detail), a local viewer page loads only the visible level
+ *
+ * Output directory <LogDir>/Episodes/<EpId>_TL/:
+ *	index.json  - contexts, time range and the levels (with the max duration of their rows)
+ *	L0.bin      - raw events (start, end, id)
+ *	L<k>.bin    - merged intervals (start, end, number of merged events), coarsest level is L1
+ *	viewer.html - canvas viewer (open it through a local http server, e.g. python -m http.server)
+ */
+struct USEMLOG_API FSLTimelineWriter
+{
+public:
+	// Write the columnar timelines of the events
+	static bool WriteTimelines(const TArray<TSharedPtr<ISLEvent>>& InEvents,
+		const FString& InLogDir,
+		const FString& InEpId);
+
+private:
+	// Write a level file, the rows are grouped by context (ContextOffsets) and sorted by start time
+	static bool WriteLevel(const FString& Path, uint32 Level,
+		const TArray<uint32>& ContextOffsets,
+		const TArray<float>& Starts,
+		const TArray<float>& Ends,
+		const TArray<uint32>& Counts,
+		const TArray<FString>* Ids = nullptr);
+
+	// Escape the string for json
+	static FString EscapeJson(const FString& Str);
+
+	// Html and javascript of the viewer page
+	static const TCHAR* GetViewerPage();
+
+public:
+	/* Constants */
+	// Level file header values
+	constexpr static uint32 FileMagic = 0x4C54534C; // "SLTL"
+	constexpr static uint32 FileVersion = 2;
+
+	// Number of intervals of a context in the coarsest level (roughly the screen width in pixels)
+	constexpr static int32 CoarsestBins = 2048;
+
+	// Resolution ratio between two consecutive levels
+	constexpr static int32 LevelRatio = 8;
+
+	// Max number of merged levels
+	constexpr static int32 MaxLevels = 8;
+
+	// The google charts html is written as well up to this number of events
+	constexpr static int32 MaxHtmlEvents = 5000;
+};
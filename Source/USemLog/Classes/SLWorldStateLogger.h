@@ -29,12 +29,15 @@ public:
 	// Init Logger
 	void Init(ESLWorldStateWriterType WriterType, const FSLWorldStateWriterParams& InWriterParams);
 
-	// Start logger
-	void Start(const float UpdateRate);
+	// Start logger (with fixed rate sampling the state is interpolated at exact multiples of the update rate)
+	void Start(const float UpdateRate, bool bFixedRateSampling = false);
 
 	// Finish logger
 	void Finish(bool bForced = false);
 
+	// Add entities registered at runtime (e.g. spawned) to the logged ones
+	void AddEntities(const TArray<FSLEntity>& Entities);
+
 protected:
 	/** Begin FTickableGameObject interface */
 	// Called after ticking all actors, DeltaTime is the time passed since the last call.
@@ -67,6 +70,9 @@ private:
 	// True if the object can be ticked (used by FTickableGameObject)
 	bool bIsTickable;
 
+	// True if the worker samples at a fixed rate (it is fed every frame)
+	bool bIsFixedRate;
+
 	// Timer handle for custom update rate
 	FTimerHandle TimerHandle;
 
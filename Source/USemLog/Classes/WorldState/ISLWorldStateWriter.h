@@ -33,6 +33,15 @@ struct FSLWorldStateWriterParams
 	// Overwrite exiting data
 	bool bOverwrite;
 
+	// Max number of samples stored in an entity bucket (entity bucketed writers only)
+	uint32 BucketMaxSamples;
+
+	// Max time span (s) covered by an entity bucket (entity bucketed writers only)
+	float BucketMaxDuration;
+
+	// Write the samples to a native mongo time series collection instead of manual buckets
+	bool bUseTimeSeriesCollection;
+
 	// Constructor
 	FSLWorldStateWriterParams(
 		float InLinearDistance,
@@ -41,14 +50,20 @@ struct FSLWorldStateWriterParams
 		const FString& InEpisodeId,
 		const FString& InServerIp = "",
 		uint16 InServerPort = 0,
-		bool bInOverwrite = false) :
+		bool bInOverwrite = false,
+		uint32 InBucketMaxSamples = 200,
+		float InBucketMaxDuration = 10.f,
+		bool bInUseTimeSeriesCollection = false) :
 		LinearDistanceSquared(InLinearDistance*InLinearDistance),
 		AngularDistance(InAngularDistance),
 		TaskId(InTaskId),
 		EpisodeId(InEpisodeId),
 		ServerIp(InServerIp),
 		ServerPort(InServerPort),
-		bOverwrite(bInOverwrite)
+		bOverwrite(bInOverwrite),
+		BucketMaxSamples(InBucketMaxSamples),
+		BucketMaxDuration(InBucketMaxDuration),
+		bUseTimeSeriesCollection(bInUseTimeSeriesCollection)
 	{};
 };
 
@@ -6,6 +6,8 @@
 #include "CoreMinimal.h"
 #include "SLStructs.h"
 #include "Camera/PlayerCameraManager.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
 
 /**
 * Structure holding the eye tracking data
@@ -50,9 +52,35 @@ struct FSLGazeData
 };
 
 /**
-* Handler for getting the eye tracking data
+* Gaze data with the time of its trace
 */
-class FSLGazeDataHandler
+struct FSLGazeSample
+{
+	// World time when the gaze ray was traced
+	float Timestamp;
+
+	// The traced data
+	FSLGazeData Data;
+};
+
+/**
+* Gaze direction reported by the eye tracker, traced on the next tick
+*/
+struct FSLGazeRay
+{
+	// Platform time when the eye tracker reported the ray
+	double PlatformTime;
+
+	// Gaze direction in the camera frame
+	FVector Direction;
+};
+
+/**
+* Handler for getting the eye tracking data, the gaze rays reported by the eye tracker (at its native rate)
+* are buffered and traced asynchronously on the next tick of the game thread (issued in one frame, read in the next one),
+* the hits are buffered in a ring read by the world state worker
+*/
+class FSLGazeDataHandler : public FTickableGameObject
 {
 public:
 	// Default constructor
@@ -76,9 +104,39 @@ public:
 	// Check if the eye tracking software is stopped
 	bool IsFinished() const { return bIsFinished; };
 
-	// Get the current gaze data, true if a raytrace hit occurs
+	// Get the latest gaze data, true if the latest trace hit an entity (thread safe)
 	bool GetData(FSLGazeData& OutData);
 
+	// Get the buffered samples newer than the given time, oldest first, returns their number (thread safe)
+	int32 GetSamples(float SinceTime, TArray<FSLGazeSample>& OutSamples);
+
+	// Buffer the gaze ray to be traced on the next tick (thread safe, called from the eye tracker data callback)
+	void AddRay(const FVector& Direction);
+
+	/** Begin FTickableGameObject interface */
+	// Called after ticking all actors, DeltaTime is the time passed since the last call.
+	virtual void Tick(float DeltaTime) override;
+
+	// Return if object is ready to be ticked
+	virtual bool IsTickable() const override;
+
+	// Return the stat id to use for this tickable
+	virtual TStatId GetStatId() const override;
+
+	// Return the world of the traces (ticked with the world, skipped while it is paused)
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	/** End FTickableGameObject interface */
+
+private:
+	// Read the results of the traces issued in the previous frame
+	void ConsumeTraces();
+
+	// Issue the async traces of the gaze rays buffered since the previous tick
+	void IssueTraces();
+
+	// Add the hit to the ring, or mark the latest trace as a miss (game thread)
+	void SetLatestSample(float Timestamp, const FSLGazeData* Data);
+
 private:
 	// True if the eye tracking framework is successfully working
 	bool bIsInit;
@@ -92,10 +150,57 @@ private:
 	// Used for trace calculation
 	UWorld* World;
 
+	// Semantic data of the world, resolved on the game thread (the gaze data is read from the world state worker)
+	class FSLEntitiesManager* EntitiesManager;
+
 	// Used for getting the gaze origin point
 	APlayerCameraManager* PlayerCameraRef;
 
+	// True if the eye tracker pushes its data through the callback, otherwise the gaze ray is polled every tick
+	bool bUseDataCallback;
+
+	// Ring of the gaze rays reported since the previous tick
+	TArray<FSLGazeRay> Rays;
+
+	// Index of the next ray to write in the ring
+	int32 RayHead;
+
+	// Number of buffered rays in the ring
+	int32 NumRays;
+
+	// Guards the rays (written by the eye tracker thread, read by the game thread)
+	FCriticalSection RaysLock;
+
+	// Rays taken from the ring, reused between ticks
+	TArray<FSLGazeRay> RaysToTrace;
+
+	// Handles and world times of the pending async traces, in time order
+	TArray<TPair<FTraceHandle, float>> PendingTraces;
+
+	// Camera pose and world time of the previous tick, the rays are traced from the camera pose interpolated at their time
+	FVector PrevCameraLoc;
+	FQuat PrevCameraQuat;
+	float PrevTickTime;
+
+	// Ring of the latest hits
+	TArray<FSLGazeSample> Samples;
+
+	// Index of the next sample to write in the ring
+	int32 SampleHead;
+
+	// Number of valid samples in the ring
+	int32 NumSamples;
+
+	// True if the latest trace hit an entity
+	bool bLatestIsHit;
+
+	// Guards the samples (written by the game thread, read by the world state worker)
+	FCriticalSection SamplesLock;
+
 	/* Constants */
 	constexpr static float RayLength = 1000.f;
 	constexpr static float RayRadius = 1.5f;
+
+	// Max number of buffered samples (more than a second at the eye tracker rate)
+	constexpr static int32 SampleCapacity = 256;
 };
@@ -4,10 +4,14 @@
 #pragma once
 
 #include "Async/AsyncWork.h"
+#include "Containers/Queue.h"
 #include "ISLWorldStateWriter.h"
 #include "SLStructs.h"
 #include "SLGazeDataHandler.h"
 
+// Forward declaration
+struct FSLLivePoseFrame;
+
 /**
 * Type of world state loggers
 */
@@ -17,6 +21,7 @@ enum class ESLWorldStateWriterType : uint8
 	Json					UMETA(DisplayName = "Json"),
 	Bson					UMETA(DisplayName = "Bson"),
 	MongoC					UMETA(DisplayName = "MongoC"),
+	MongoCBuckets			UMETA(DisplayName = "MongoC (entity buckets)"),
 	MongoCxx				UMETA(DisplayName = "MongoCxx")
 };
 
@@ -59,16 +64,14 @@ public:
 	// Remove all non-movable semantic items from the update pool
 	void RemoveStaticItems();
 
-	// TODO implement these for cutting
-	//// Remove entity from being logged
-	//bool RemoveEntity(UObject* Obj);
-
-	//// Add new actor entity
-	//bool AddNewActorEntity(AActor* Actor);
+	// Queue an entity registered at runtime, it is added to the update pool by the worker before its next write (game thread only)
+	bool AddEntity(const FSLEntity& Entity);
 
-	//// Add new scene component entity
-	//bool AddNewComponentEntity(AActor* Actor);
+	// Write the world state at exact multiples of the sample rate by interpolating between the frame poses (worker must be idle)
+	void StartFixedRateSampling(float InSampleRate, float StartTime);
 
+	// Set the time of the frame to sample (call before starting the task)
+	void SetFrameTime(float InFrameTime) { FrameTime = InFrameTime; };
 
 private:
 	// FAsyncTask - async work done here
@@ -77,6 +80,28 @@ private:
 	// Needed by unreal internally
 	FORCEINLINE TStatId GetStatId() const;
 
+	// Write the interpolated samples due between the previous and the current frame
+	void WriteFixedRateSamples();
+
+	// Read the current pose of every entity as its frame pose
+	void AdvanceFramePoses();
+
+	// Publish the poses of the entities which moved since their previous publish to the live subscribers,
+	// or the poses of all the entities if the subscribers need a keyframe
+	void PublishPoses(float Timestamp);
+
+	// Add the poses of the entities which moved since their previous publish, or all of them (their published pose is updated)
+	template<typename T>
+	void AddMovedPoses(TArray<TSLEntityPreviousPose<T>>& Entities, FSLLivePoseFrame& OutPoses, bool bAll = false);
+
+	// Set the current poses as the published ones (the entities are published once they move, or with the keyframes)
+	template<typename T>
+	void SeedPublishedPoses(TArray<TSLEntityPreviousPose<T>>& Entities);
+
+	// Remove the entities of the given objects from the update pool
+	template<typename T>
+	void RemoveEntities(TArray<TSLEntityPreviousPose<T>>& Entities, const TArray<TWeakObjectPtr<UObject>>& Objects);
+
 private:
 	// Worker is init
 	bool bIsInit;
@@ -96,6 +121,21 @@ private:
 	// Distance squared threshold
 	float LinearDistanceSquared;
 
+	// Angular distance threshold
+	float AngularDistance;
+
+	// Publish the poses to the live subscribers as well
+	bool bPublishLive;
+
+	// Episode of the published poses
+	FString EpisodeId;
+
+	// Keyframe generation of the publisher at the last published keyframe
+	int32 PublishedKeyframeGeneration;
+
+	// Set if entities were added since the last published keyframe
+	bool bKeyframePending;
+
 	// Raw data writer
 	TSharedPtr<ISLWorldStateWriter> Writer;
 
@@ -110,6 +150,32 @@ private:
 
 	// Gaze data handler
 	FSLGazeDataHandler GazeDataHandler;
+
+	// Gaze samples of the current frame (fixed rate sampling)
+	TArray<FSLGazeSample> GazeSamples;
+
+	// Fixed sampling rate (0 if the state is written at the frame times)
+	float SampleRate;
+
+	// Index of the next sample, its timestamp is NextSampleIdx * SampleRate
+	int64 NextSampleIdx;
+
+	// Time of the frame to sample, and of the previously sampled one
+	float FrameTime;
+	float PrevFrameTime;
+
+	// Entities registered while the worker might be running, consumed by the worker
+	// (removed entities need no queue, their weak pointers fail and the writers drop them)
+	TQueue<TSLEntityPreviousPose<AActor>, EQueueMode::Spsc> PendingActorEntities;
+	TQueue<TSLEntityPreviousPose<USceneComponent>, EQueueMode::Spsc> PendingComponentEntities;
+	TQueue<TSLEntityPreviousPose<USLSkeletalDataComponent>, EQueueMode::Spsc> PendingSkeletalEntities;
+
+	// Runtime registered entities marked as static, removed from the update pool once their initial pose is written
+	TQueue<TWeakObjectPtr<UObject>, EQueueMode::Spsc> PendingStaticEntities;
+	TArray<TWeakObjectPtr<UObject>> StaticEntitiesToRemove;
+
+	// Set if the world state was written since the static entities were queued for removal
+	bool bStaticEntitiesWritten;
 	
 	
 	
@@ -5,6 +5,7 @@
 
 #include "CoreMinimal.h"
 #include "ISLWorldStateWriter.h"
+#include "SLPoseBatch.h"
 
 /**
  * Raw data logger to json format
@@ -51,13 +52,24 @@ private:
 	void AddSkeletalEntities(TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
 		TArray<TSharedPtr<FJsonValue>>& OutJsonEntitiesArr);
 
-	// Get key value pairs as json entry
+	// Add the entities of the (converted) pose batch to the json array
+	template<typename T>
+	void AddEntitiesPoses(const TArray<TSLEntityPreviousPose<T>>& Entities,
+		TArray<TSharedPtr<FJsonValue>>& OutJsonEntitiesArr);
+
+	// Get key value pairs and the pose (already in the ROS frame) as json entry
 	TSharedPtr<FJsonObject> GetAsJsonEntry(const TMap<FString, FString>& InKeyValMap,
-		const FVector& InLoc, const FQuat& InQuat);
+		const FVector& ROSLoc, const FQuat& ROSQuat);
 
 	// Write entry to file
 	void WriteToFile(const TSharedPtr<FJsonObject>& InRootObj);
 
 	// File handle to write the raw data to file
 	IFileHandle* FileHandle;
+
+	// Poses of the entities to write, converted to the ROS frame in one pass (reused between writes)
+	FSLPoseBatch PoseBatch;
+
+	// Poses of the bones of the skeletal entity to write
+	FSLPoseBatch BonePoseBatch;
 };
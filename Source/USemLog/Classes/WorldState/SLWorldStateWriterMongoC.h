@@ -5,6 +5,7 @@
 
 #include "USemLog.h"
 #include "ISLWorldStateWriter.h"
+#include "SLPoseBatch.h"
 #if SL_WITH_LIBMONGO_C
 THIRD_PARTY_INCLUDES_START
 	#if PLATFORM_WINDOWS
@@ -47,6 +48,9 @@ public:
 		FSLGazeData& GazeData,
 		bool bCheckAndRemoveInvalidEntities = true) override;
 
+	// Indexes of the world state collection (used by the writer and the index commandlet)
+	static TArray<FString> GetIndexKeys();
+
 private:
 	// Connect to the database
 	bool Connect(const FString& DBName, const FString& CollectionName, const FString& ServerIp, uint16 ServerPort, bool bOverwrite = false);
@@ -54,42 +58,56 @@ private:
 	// Disconnect and clean db connection
 	void Disconnect();
 	
-	// Create indexes on the logged data, usually called after logging
+	// Create the indexes, called before the first insert
 	bool CreateIndexes() const;
 
 #if SL_WITH_LIBMONGO_C
 	// Add non skeletal actors to array
 	void AddActorEntities(TArray<TSLEntityPreviousPose<AActor>>& ActorEntities,
-		bson_t* out_doc, uint32_t& idx) const;
+		bson_t* out_doc, uint32_t& idx);
 
 	// Add non skeletal components to array
 	void AddComponentEntities(TArray<TSLEntityPreviousPose<USceneComponent>>& ComponentEntities,
-		bson_t* out_doc, uint32_t& idx) const;
+		bson_t* out_doc, uint32_t& idx);
 
 	// Add skeletal actors to array
 	void AddSkeletalEntities(TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
+		bson_t* out_doc, uint32_t& idx);
+
+	// Add the entities of the (converted) pose batch to array
+	template<typename T>
+	void AddEntitiesPoses(const TArray<TSLEntityPreviousPose<T>>& Entities,
 		bson_t* out_doc, uint32_t& idx) const;
 
 	// Add gaze data
 	void AddGazeData(const FSLGazeData& GazeData, bson_t* out_doc) const;
 
 	// Add skeletal bones to array
-	void AddSkeletalBones(USkeletalMeshComponent* SkelComp, bson_t* out_doc) const;
+	void AddSkeletalBones(USkeletalMeshComponent* SkelComp, bson_t* out_doc);
 
-	// Add pose to document
-	void AddPoseChild(const FVector& InLoc, const FQuat& InQuat, bson_t* out_doc) const;
+	// Add pose (already in the ROS frame) to document
+	void AddPoseChild(const FVector& ROSLoc, const FQuat& ROSQuat, bson_t* out_doc) const;
 
 private:
-	// Server uri
-	mongoc_uri_t* uri;
-
-	// MongoC connection client
-	mongoc_client_t* client;
+	// Pooled client used for the synchronous operations
+	mongoc_client_t* client = nullptr;
 
 	// Database to access
-	mongoc_database_t* database;
+	mongoc_database_t* database = nullptr;
 
 	// Database collection
-	mongoc_collection_t* collection;
+	mongoc_collection_t* collection = nullptr;
 #endif //SL_WITH_LIBMONGO_C
+
+	// Database name (task id)
+	FString DatabaseName;
+
+	// Collection name (episode id)
+	FString CollName;
+
+	// Poses of the entities to write, converted to the ROS frame in one pass (reused between writes)
+	FSLPoseBatch PoseBatch;
+
+	// Poses of the bones of the skeletal entity to write
+	FSLPoseBatch BonePoseBatch;
 };
@@ -0,0 +1,218 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "ISLWorldStateWriter.h"
+#include "SLPoseBatch.h"
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+	#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+	#else
+	#include <mongoc/mongoc.h>
+	#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+/**
+* Packed pose samples of a bone of a skeletal entity bucket (ROS coordinates)
+*/
+struct FSLWSBoneBucket
+{
+	// Name of the bone
+	FName Name;
+
+	// Packed locations [x0,y0,z0,x1,y1,z1,..]
+	TArray<double> Locs;
+
+	// Packed rotations [x0,y0,z0,w0,x1,y1,z1,w1,..]
+	TArray<double> Rots;
+};
+
+/**
+* Packed pose samples of an entity for a time window (ROS coordinates)
+*/
+struct FSLWSEntityBucket
+{
+	// Semantic id of the entity
+	FString Id;
+
+	// Timestamp of the first sample
+	float StartTime = 0.f;
+
+	// Timestamp of the last sample
+	float EndTime = 0.f;
+
+	// Timestamps of the samples
+	TArray<float> Timestamps;
+
+	// Packed locations [x0,y0,z0,x1,y1,z1,..]
+	TArray<double> Locs;
+
+	// Packed rotations [x0,y0,z0,w0,x1,y1,z1,w1,..]
+	TArray<double> Rots;
+
+	// Bones of skeletal entities (same number of samples as the entity)
+	TArray<FSLWSBoneBucket> Bones;
+
+	// Number of samples in the bucket
+	FORCEINLINE int32 Num() const { return Timestamps.Num(); }
+
+	// Clear the samples, keep the allocated memory
+	void Reset()
+	{
+		Timestamps.Reset();
+		Locs.Reset();
+		Rots.Reset();
+		for (auto& Bone : Bones)
+		{
+			Bone.Locs.Reset();
+			Bone.Rots.Reset();
+		}
+	}
+};
+
+/**
+ * World state writer to mongo, groups the samples of every entity
+ * in per-entity bucket documents (id, t_start, t_end, packed arrays),
+ * or in a native mongo time series collection, instead of one document per timestamp
+ */
+class FSLWorldStateWriterMongoCBuckets : public ISLWorldStateWriter
+{
+public:
+	// Default constr
+	FSLWorldStateWriterMongoCBuckets();
+
+	// Init constr
+	FSLWorldStateWriterMongoCBuckets(const FSLWorldStateWriterParams& InParams);
+
+	// Destr
+	virtual ~FSLWorldStateWriterMongoCBuckets();
+
+	// Init
+	virtual void Init(const FSLWorldStateWriterParams& InParams) override;
+
+	// Finish (flushes the open buckets)
+	virtual void Finish() override;
+
+	// Write the data
+	virtual void Write(float Timestamp,
+		TArray<TSLEntityPreviousPose<AActor>>& ActorEntities,
+		TArray<TSLEntityPreviousPose<USceneComponent>>& ComponentEntities,
+		TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
+		FSLGazeData& GazeData,
+		bool bCheckAndRemoveInvalidEntities = true) override;
+
+	// Indexes of the bucket or time series collection (used by the writer and the index commandlet)
+	static TArray<FString> GetIndexKeys(bool bTimeSeries);
+
+private:
+	// Connect to the database
+	bool Connect(const FString& DBName, const FString& CollectionName, const FString& ServerIp, uint16 ServerPort, bool bOverwrite = false);
+
+	// Disconnect and clean db connection
+	void Disconnect();
+
+	// Create the indexes, called before the first insert
+	bool CreateIndexes() const;
+
+	// Remove the invalid entities and flush their buckets
+	template<typename T>
+	void RemoveInvalidEntities(TArray<TSLEntityPreviousPose<T>>& Entities);
+
+	// Add the current pose (already in the ROS frame) to the entity bucket, true if the bucket is full
+	bool AddSample(UObject* Obj, const FString& Id, float Timestamp, const FVector& ROSLoc, const FQuat& ROSQuat,
+		USkeletalMeshComponent* SkelComp = nullptr);
+
+	// Create the bone buckets of the entity bucket in the current bone names order
+	void InitBoneBuckets(FSLWSEntityBucket& Bucket);
+
+	// True if the bucket reached the sample or the time span limit
+	FORCEINLINE bool IsBucketFull(const FSLWSEntityBucket& Bucket) const
+	{
+		return Bucket.Num() >= BucketMaxSamples || (Bucket.EndTime - Bucket.StartTime) >= BucketMaxDuration;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	// Write the bucket as a document and reset it
+	void FlushBucket(FSLWSEntityBucket& Bucket);
+
+	// Write out the gaze bucket as a document and reset it
+	void FlushGazeBucket();
+
+	// Add the entity sample (already in the ROS frame) as a time series measurement document
+	void AddMeasurementDoc(const FString& Id, float Timestamp, const FVector& ROSLoc, const FQuat& ROSQuat,
+		USkeletalMeshComponent* SkelComp = nullptr);
+
+	// Add the gaze sample (already in the ROS frame) as a time series measurement document
+	void AddGazeMeasurementDoc(float Timestamp, const FVector& ROSTarget, const FVector& ROSOrigin, const FString& EntityId);
+
+	// Hand the pending documents over to the mongo service
+	void InsertPendingDocs();
+
+	// Add packed array of doubles
+	void AddDoubleArray(const char* Key, const TArray<double>& InArr, bson_t* out_doc) const;
+
+	// Add pose (already in the ROS frame) to document
+	void AddPoseChild(const FVector& ROSLoc, const FQuat& ROSQuat, bson_t* out_doc) const;
+#endif //SL_WITH_LIBMONGO_C
+
+	// Add packed location (already in the ROS frame)
+	static FORCEINLINE void AppendLoc(TArray<double>& OutArr, const FVector& ROSLoc);
+
+	// Add packed rotation (already in the ROS frame)
+	static FORCEINLINE void AppendRot(TArray<double>& OutArr, const FQuat& ROSQuat);
+
+private:
+	// Max samples per bucket
+	int32 BucketMaxSamples;
+
+	// Max time span per bucket
+	float BucketMaxDuration;
+
+	// Write individual measurements to a server side bucketed time series collection
+	bool bUseTimeSeries;
+
+	// Open buckets of every logged entity
+	TMap<UObject*, FSLWSEntityBucket> Buckets;
+
+	// Open gaze bucket
+	FSLWSEntityBucket GazeBucket;
+
+	// Packed gaze origins of the gaze bucket (the targets are stored as the bucket locations)
+	TArray<double> GazeOrigins;
+
+	// Ids of the gazed entities in the gaze bucket
+	TArray<FString> GazeEntityIds;
+
+	// Poses of the entities to write, converted to the ROS frame in one pass (reused between writes)
+	FSLPoseBatch PoseBatch;
+
+	// Bone names and converted poses of the skeletal entity to write
+	TArray<FName> BoneNames;
+	FSLPoseBatch BonePoseBatch;
+
+#if SL_WITH_LIBMONGO_C
+	// Documents waiting to be submitted in the current write
+	TArray<bson_t*> PendingDocs;
+
+	// Pooled client used for the synchronous operations
+	mongoc_client_t* client = nullptr;
+
+	// Database to access
+	mongoc_database_t* database = nullptr;
+
+	// Database collection
+	mongoc_collection_t* collection = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+
+	// Database name (task id)
+	FString DatabaseName;
+
+	// Collection name (episode id)
+	FString CollName;
+};
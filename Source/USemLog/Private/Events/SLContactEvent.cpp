@@ -6,14 +6,14 @@
 
 // Constructor with initialization
 FSLContactEvent::FSLContactEvent(const FString& InId, const float InStart, const float InEnd, const uint64 InPairId,
-	const FSLEntity& InItem1, const FSLEntity& InItem2) :
+	const FSLEntityHandle& InItem1, const FSLEntityHandle& InItem2) :
 	ISLEvent(InId, InStart, InEnd), PairId(InPairId), Item1(InItem1), Item2(InItem2)
 {
 }
 
 // Constructor initialization without end time
 FSLContactEvent::FSLContactEvent(const FString& InId, const float InStart, const uint64 InPairId,
-	const FSLEntity& InItem1, const FSLEntity& InItem2) :
+	const FSLEntityHandle& InItem1, const FSLEntityHandle& InItem2) :
 	ISLEvent(InId, InStart), PairId(InPairId), Item1(InItem1), Item2(InItem2)
 {
 }
@@ -27,11 +27,25 @@ FSLOwlNode FSLContactEvent::ToOwlNode() const
 		"log", Id, "TouchingSituation");
 	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", Start));
 	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", End));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Item1.Id));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Item2.Id));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Item1->Id));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Item2->Id));
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLContactEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("TouchingSituation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLContactEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Item1->Id);
+	OutIds.AddUnique(Item2->Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLContactEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
@@ -44,10 +58,10 @@ void FSLContactEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 		Start, FSLOwlExperimentStatics::CreateTimepointIndividual("log", Start));
 	EventsDoc->AddTimepointIndividual(
 		End, FSLOwlExperimentStatics::CreateTimepointIndividual("log", End));
-	EventsDoc->AddObjectIndividual(Item1.Obj,
-		FSLOwlExperimentStatics::CreateObjectIndividual("log", Item1.Id, Item1.Class));
-	EventsDoc->AddObjectIndividual(Item2.Obj,
-		FSLOwlExperimentStatics::CreateObjectIndividual("log", Item2.Id, Item2.Class));
+	EventsDoc->AddObjectIndividual(Item1->Obj,
+		FSLOwlExperimentStatics::CreateObjectIndividual("log", Item1->Id, Item1->Class));
+	EventsDoc->AddObjectIndividual(Item2->Obj,
+		FSLOwlExperimentStatics::CreateObjectIndividual("log", Item2->Id, Item2->Class));
 	OutDoc->AddIndividual(ToOwlNode());
 }
 
@@ -61,13 +75,13 @@ FString FSLContactEvent::Context() const
 FString FSLContactEvent::Tooltip() const
 {
 	return FString::Printf(TEXT("\'O1\',\'%s\',\'Id\',\'%s\',\'O2\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
-		*Item1.Class, *Item1.Id, *Item2.Class, *Item2.Id, *Id);
+		*Item1->Class, *Item1->Id, *Item2->Class, *Item2->Id, *Id);
 }
 
 // Get the data as string
 FString FSLContactEvent::ToString() const
 {
 	return FString::Printf(TEXT("Item1:[%s] Item2:[%s] PairId:%lld"),
-		*Item1.ToString(), *Item2.ToString(), PairId);
+		*Item1->ToString(), *Item2->ToString(), PairId);
 }
 /* End ISLEvent interface */
\ No newline at end of file
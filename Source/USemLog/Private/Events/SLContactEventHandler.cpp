@@ -6,6 +6,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 // Set parent
 void FSLContactEventHandler::Init(UObject* InParent)
@@ -69,10 +70,10 @@ void FSLContactEventHandler::Finish(float EndTime, bool bForced)
 void FSLContactEventHandler::AddNewContactEvent(const FSLContactResult& InResult)
 {
 	// Start a semantic contact event
-	TSharedPtr<FSLContactEvent> ContactEvent = MakeShareable(new FSLContactEvent(
-		FIds::NewGuidInBase64Url(), InResult.Time,
-		FIds::PairEncodeCantor(InResult.Self.Obj->GetUniqueID(), InResult.Other.Obj->GetUniqueID()),
-		InResult.Self, InResult.Other));
+	TSharedPtr<FSLContactEvent> ContactEvent = ContactEventPool.Create(
+		FSLIdGenerator::GetInstance()->NewId(), InResult.Time,
+		FIds::PairEncodeCantor(InResult.Self->Obj->GetUniqueID(), InResult.Other->Obj->GetUniqueID()),
+		InResult.Self, InResult.Other);
 	// Add event to the pending contacts array
 	StartedContactEvents.Emplace(ContactEvent);
 }
@@ -84,7 +85,7 @@ bool FSLContactEventHandler::FinishContactEvent(const FSLEntity& InOther, float
 	for (auto EventItr(StartedContactEvents.CreateIterator()); EventItr; ++EventItr)
 	{
 		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Item2.EqualsFast(InOther))
+		if ((*EventItr)->Item2->EqualsFast(InOther))
 		{
 			// Set the event end time
 			(*EventItr)->End = EndTime;
@@ -105,11 +106,11 @@ bool FSLContactEventHandler::FinishContactEvent(const FSLEntity& InOther, float
 }
 
 // Start new supported by event
-void FSLContactEventHandler::AddNewSupportedByEvent(const FSLEntity& Supported, const FSLEntity& Supporting, float StartTime, const uint64 EventPairId)
+void FSLContactEventHandler::AddNewSupportedByEvent(const FSLEntityHandle& Supported, const FSLEntityHandle& Supporting, float StartTime, const uint64 EventPairId)
 {
 	// Start a supported by event
-	TSharedPtr<FSLSupportedByEvent> Event = MakeShareable(new FSLSupportedByEvent(
-		FIds::NewGuidInBase64Url(), StartTime, EventPairId, Supported, Supporting));
+	TSharedPtr<FSLSupportedByEvent> Event = SupportedByEventPool.Create(
+		FSLIdGenerator::GetInstance()->NewId(), StartTime, EventPairId, Supported, Supporting);
 	// Add event to the pending array
 	StartedSupportedByEvents.Emplace(Event);
 }
@@ -181,7 +182,7 @@ void FSLContactEventHandler::OnSLOverlapEnd(const FSLEntity& Self, const FSLEnti
 }
 
 // Event called when a supported by event begins
-void FSLContactEventHandler::OnSLSupportedByBegin(const FSLEntity& Supported, const FSLEntity& Supporting, float StartTime, const uint64 PairId)
+void FSLContactEventHandler::OnSLSupportedByBegin(const FSLEntityHandle& Supported, const FSLEntityHandle& Supporting, float StartTime, const uint64 PairId)
 {
 	AddNewSupportedByEvent(Supported, Supporting, StartTime, PairId);
 }
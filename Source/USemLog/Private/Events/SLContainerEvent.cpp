@@ -35,6 +35,20 @@ FSLOwlNode FSLContainerEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLContainerEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("ContainerManipulation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLContainerEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLContainerEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
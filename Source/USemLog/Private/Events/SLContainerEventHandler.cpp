@@ -8,6 +8,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 
 // Set parent
@@ -16,9 +17,9 @@ void FSLContainerEventHandler::Init(UObject* InParent)
 	if (!bIsInit)
 	{
 		// Make sure the mappings singleton is initialized (the handler uses it)
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(InParent->GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(InParent->GetWorld());
+			FSLEntitiesManager::GetInstance(InParent->GetWorld())->Init(InParent->GetWorld());
 		}
 
 		// Check if parent is of right type
@@ -65,11 +66,11 @@ void FSLContainerEventHandler::Finish(float EndTime, bool bForced)
 void FSLContainerEventHandler::OnContainerManipulation(const FSLEntity& Self, AActor* Other, float StartTime, float EndTime, const FString& Type)
 {
 	// Check that the objects are semantically annotated
-	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(Other))
+	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntityPtr(Other))
 	{
-		OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLContainerEvent(
-			FIds::NewGuidInBase64Url(), StartTime, EndTime,
+		OnSemanticEvent.ExecuteIfBound(EventPool.Create(
+			FSLIdGenerator::GetInstance()->NewId(), StartTime, EndTime,
 			FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other->GetUniqueID()),
-			Self, *OtherItem, Type)));
+			Self, *OtherItem, Type));
 	}
 }
@@ -9,6 +9,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 
 // Set parent
@@ -17,9 +18,9 @@ void FSLFixationGraspEventHandler::Init(UObject* InParent)
 	if (!bIsInit)
 	{
 		// Make sure the mappings singleton is initialized (the handler uses it)
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(InParent->GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(InParent->GetWorld());
+			FSLEntitiesManager::GetInstance(InParent->GetWorld())->Init(InParent->GetWorld());
 		}
 
 #if SL_WITH_MC_GRASP
@@ -73,10 +74,10 @@ void FSLFixationGraspEventHandler::Finish(float EndTime, bool bForced)
 void FSLFixationGraspEventHandler::AddNewEvent(const FSLEntity& Self, const FSLEntity& Other, float StartTime)
 {
 	// Start a semantic grasp event
-	TSharedPtr<FSLGraspEvent> Event = MakeShareable(new FSLGraspEvent(
-		FIds::NewGuidInBase64Url(), StartTime, 
+	TSharedPtr<FSLGraspEvent> Event = EventPool.Create(
+		FSLIdGenerator::GetInstance()->NewId(), StartTime, 
 		FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other.Obj->GetUniqueID()),
-		Self, Other));
+		Self, Other);
 	// Add event to the pending array
 	StartedEvents.Emplace(Event);
 }
@@ -119,8 +120,8 @@ void FSLFixationGraspEventHandler::FinishAllEvents(float EndTime)
 void FSLFixationGraspEventHandler::OnSLGraspBegin(UObject* Self, UObject* Other, float Time)
 {
 	// Check that the objects are semantically annotated
-	FSLEntity SelfItem = FSLEntitiesManager::GetInstance()->GetEntity(Self);
-	FSLEntity OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(Other);
+	FSLEntity SelfItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(Self);
+	FSLEntity OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(Other);
 	if (SelfItem.IsSet() && OtherItem.IsSet())
 	{
 		FSLFixationGraspEventHandler::AddNewEvent(SelfItem, OtherItem, Time);
@@ -35,6 +35,20 @@ FSLOwlNode FSLGraspEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLGraspEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("GraspingSomething"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLGraspEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLGraspEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
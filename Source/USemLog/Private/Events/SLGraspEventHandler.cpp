@@ -7,6 +7,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 
 // Set parent
@@ -15,9 +16,9 @@ void FSLGraspEventHandler::Init(UObject* InParent)
 	if (!bIsInit)
 	{
 		// Make sure the mappings singleton is initialized (the handler uses it)
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(InParent->GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(InParent->GetWorld());
+			FSLEntitiesManager::GetInstance(InParent->GetWorld())->Init(InParent->GetWorld());
 		}
 
 		// Check if parent is of right type
@@ -72,10 +73,10 @@ void FSLGraspEventHandler::Finish(float EndTime, bool bForced)
 void FSLGraspEventHandler::AddNewEvent(const FSLEntity& Self, const FSLEntity& Other, float StartTime, const FString& InType)
 {
 	// Start a semantic grasp event
-	TSharedPtr<FSLGraspEvent> Event = MakeShareable(new FSLGraspEvent(
-		FIds::NewGuidInBase64Url(), StartTime,
+	TSharedPtr<FSLGraspEvent> Event = EventPool.Create(
+		FSLIdGenerator::GetInstance()->NewId(), StartTime,
 		FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other.Obj->GetUniqueID()),
-		Self, Other, InType));
+		Self, Other, InType);
 	// Add event to the pending array
 	StartedEvents.Emplace(Event);
 }
@@ -126,7 +127,7 @@ void FSLGraspEventHandler::FinishAllEvents(float EndTime)
 void FSLGraspEventHandler::OnSLGraspBegin(const FSLEntity& Self, AActor* Other, float Time, const FString& Type)
 {
 	// Check that the objects are semantically annotated
-	FSLEntity OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(Other);
+	FSLEntity OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(Other);
 	if (OtherItem.IsSet())
 	{
 		AddNewEvent(Self, OtherItem, Time, Type);
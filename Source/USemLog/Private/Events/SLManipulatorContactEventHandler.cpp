@@ -7,6 +7,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 // Set parent
 void FSLManipulatorContactEventHandler::Init(UObject* InParent)
@@ -64,10 +65,10 @@ void FSLManipulatorContactEventHandler::Finish(float EndTime, bool bForced)
 void FSLManipulatorContactEventHandler::AddNewEvent(const FSLContactResult& InResult)
 {
 	// Start a semantic contact event
-	TSharedPtr<FSLContactEvent> ContactEvent = MakeShareable(new FSLContactEvent(
-		FIds::NewGuidInBase64Url(), InResult.Time,
-		FIds::PairEncodeCantor(InResult.Self.Obj->GetUniqueID(), InResult.Other.Obj->GetUniqueID()),
-		InResult.Self, InResult.Other));
+	TSharedPtr<FSLContactEvent> ContactEvent = EventPool.Create(
+		FSLIdGenerator::GetInstance()->NewId(), InResult.Time,
+		FIds::PairEncodeCantor(InResult.Self->Obj->GetUniqueID(), InResult.Other->Obj->GetUniqueID()),
+		InResult.Self, InResult.Other);
 	// Add event to the pending contacts array
 	StartedEvents.Emplace(ContactEvent);
 }
@@ -79,7 +80,7 @@ bool FSLManipulatorContactEventHandler::FinishEvent(const FSLEntity& InOther, fl
 	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
 	{
 		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Item2.EqualsFast(InOther))
+		if ((*EventItr)->Item2->EqualsFast(InOther))
 		{
 			// Set the event end time
 			(*EventItr)->End = EndTime;
@@ -12,6 +12,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 
 // Set parent
@@ -20,9 +21,9 @@ void FSLPickAndPlaceEventsHandler::Init(UObject* InParent)
 	if (!bIsInit)
 	{
 		// Make sure the mappings singleton is initialized (the handler uses it)
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(InParent->GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(InParent->GetWorld());
+			FSLEntitiesManager::GetInstance(InParent->GetWorld())->Init(InParent->GetWorld());
 		}
 
 		// Check if parent is of right type
@@ -77,47 +78,47 @@ void FSLPickAndPlaceEventsHandler::Finish(float EndTime, bool bForced)
 // Event called when a slide event happened
 void FSLPickAndPlaceEventsHandler::OnSLSlide(const FSLEntity& Self, AActor* Other, float StartTime, float EndTime)
 {
-	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(Other))
+	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntityPtr(Other))
 	{
-		OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLSlideEvent(
-			FIds::NewGuidInBase64Url(), StartTime, EndTime,
+		OnSemanticEvent.ExecuteIfBound(SlideEventPool.Create(
+			FSLIdGenerator::GetInstance()->NewId(), StartTime, EndTime,
 			FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other->GetUniqueID()),
-			Self, *OtherItem)));
+			Self, *OtherItem));
 	}
 }
 
 // Event called when a pick up event happened
 void FSLPickAndPlaceEventsHandler::OnSLPickUp(const FSLEntity& Self, AActor* Other, float StartTime, float EndTime)
 {
-	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(Other))
+	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntityPtr(Other))
 	{
-		OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLPickUpEvent(
-			FIds::NewGuidInBase64Url(), StartTime, EndTime,
+		OnSemanticEvent.ExecuteIfBound(PickUpEventPool.Create(
+			FSLIdGenerator::GetInstance()->NewId(), StartTime, EndTime,
 			FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other->GetUniqueID()),
-			Self, *OtherItem)));
+			Self, *OtherItem));
 	}
 }
 
 // Event called when a transport event happened
 void FSLPickAndPlaceEventsHandler::OnSLTransport(const FSLEntity& Self, AActor* Other, float StartTime, float EndTime)
 {
-	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(Other))
+	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntityPtr(Other))
 	{
-		OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLTransportEvent(
-			FIds::NewGuidInBase64Url(), StartTime, EndTime,
+		OnSemanticEvent.ExecuteIfBound(TransportEventPool.Create(
+			FSLIdGenerator::GetInstance()->NewId(), StartTime, EndTime,
 			FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other->GetUniqueID()),
-			Self, *OtherItem)));
+			Self, *OtherItem));
 	}
 }
 
 // Event called when a put down event happened
 void FSLPickAndPlaceEventsHandler::OnSLPutDown(const FSLEntity& Self, AActor* Other, float StartTime, float EndTime)
 {
-	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(Other))
+	if(FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntityPtr(Other))
 	{
-		OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLPutDownEvent(
-			FIds::NewGuidInBase64Url(), StartTime, EndTime,
+		OnSemanticEvent.ExecuteIfBound(PutDownEventPool.Create(
+			FSLIdGenerator::GetInstance()->NewId(), StartTime, EndTime,
 			FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), Other->GetUniqueID()),
-			Self, *OtherItem)));
+			Self, *OtherItem));
 	}
 }
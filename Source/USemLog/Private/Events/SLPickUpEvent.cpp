@@ -32,6 +32,20 @@ FSLOwlNode FSLPickUpEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLPickUpEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("PickUpSituation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLPickUpEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLPickUpEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
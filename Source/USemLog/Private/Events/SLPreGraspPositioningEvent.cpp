@@ -32,6 +32,20 @@ FSLOwlNode FSLPreGraspPositioningEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLPreGraspPositioningEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("PreGraspPositioning"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLPreGraspPositioningEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLPreGraspPositioningEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
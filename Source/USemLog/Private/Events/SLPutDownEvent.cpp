@@ -32,6 +32,20 @@ FSLOwlNode FSLPutDownEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLPutDownEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("PutDownSituation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLPutDownEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLPutDownEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
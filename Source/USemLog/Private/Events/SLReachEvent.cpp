@@ -32,6 +32,20 @@ FSLOwlNode FSLReachEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLReachEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("ReachingForSomething"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLReachEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLReachEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
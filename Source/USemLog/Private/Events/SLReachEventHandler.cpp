@@ -7,6 +7,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 
 // Set parent
@@ -15,9 +16,9 @@ void FSLReachEventHandler::Init(UObject* InParent)
 	if (!bIsInit)
 	{
 		// Make sure the mappings singleton is initialized (the handler uses it)
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(InParent->GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(InParent->GetWorld());
+			FSLEntitiesManager::GetInstance(InParent->GetWorld())->Init(InParent->GetWorld());
 		}
 
 		// Check if parent is of right type
@@ -69,21 +70,21 @@ void FSLReachEventHandler::Finish(float EndTime, bool bForced)
 void FSLReachEventHandler::OnSLPreAndReachEvent(const FSLEntity& Self, UObject* Other, float ReachStartTime, float ReachEndTime, float PreGraspEndTime)
 {
 	// Check that the objects are semantically annotated
-	if (FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(Other))
+	if (FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntityPtr(Other))
 	{
 		const uint64 PairID =FIds::PairEncodeCantor(Self.Obj->GetUniqueID(), OtherItem->Obj->GetUniqueID());
 		if(ReachEndTime - ReachStartTime > ReachEventMin)
 		{
-			OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLReachEvent(
-				FIds::NewGuidInBase64Url(), ReachStartTime, ReachEndTime,
-				PairID,Self, *OtherItem)));
+			OnSemanticEvent.ExecuteIfBound(ReachEventPool.Create(
+				FSLIdGenerator::GetInstance()->NewId(), ReachStartTime, ReachEndTime,
+				PairID,Self, *OtherItem));
 		}
 
 		if(PreGraspEndTime - ReachEndTime > PreGraspPositioningEventMin)
 		{
-			OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLPreGraspPositioningEvent(
-				FIds::NewGuidInBase64Url(), ReachEndTime, PreGraspEndTime,
-				PairID,Self, *OtherItem)));
+			OnSemanticEvent.ExecuteIfBound(PreGraspEventPool.Create(
+				FSLIdGenerator::GetInstance()->NewId(), ReachEndTime, PreGraspEndTime,
+				PairID,Self, *OtherItem));
 		}
 	}
 }
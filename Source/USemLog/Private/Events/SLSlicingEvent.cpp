@@ -42,6 +42,25 @@ FSLOwlNode FSLSlicingEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLSlicingEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("SlicingingSomething"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLSlicingEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(PerformedBy.Id);
+	OutIds.AddUnique(DeviceUsed.Id);
+	OutIds.AddUnique(ObjectActedOn.Id);
+	if (bTaskSuccessful)
+	{
+		OutIds.AddUnique(OutputsCreated.Id);
+	}
+}
+
 // Add the owl representation of the event to the owl document
 void FSLSlicingEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
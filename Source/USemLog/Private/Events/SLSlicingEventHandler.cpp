@@ -10,6 +10,7 @@
 
 // UUtils
 #include "Ids.h"
+#include "SLIdGenerator.h"
 
 
 // Set parent
@@ -18,9 +19,9 @@ void FSLSlicingEventHandler::Init(UObject* InParent)
 	if (!bIsInit)
 	{
 		// Make sure the mappings singleton is initialized (the handler uses it)
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(InParent->GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(InParent->GetWorld());
+			FSLEntitiesManager::GetInstance(InParent->GetWorld())->Init(InParent->GetWorld());
 		}
 
 #if SL_WITH_SLICING
@@ -77,10 +78,10 @@ void FSLSlicingEventHandler::Finish(float EndTime, bool bForced)
 void FSLSlicingEventHandler::AddNewEvent(const FSLEntity& PerformedBy, const FSLEntity& DeviceUsed, const FSLEntity& ObjectActedOn, float StartTime)
 {
 	// Start a semantic Slicing event
-	TSharedPtr<FSLSlicingEvent> Event = MakeShareable(new FSLSlicingEvent(
-		FIds::NewGuidInBase64Url(), StartTime, 
+	TSharedPtr<FSLSlicingEvent> Event = EventPool.Create(
+		FSLIdGenerator::GetInstance()->NewId(), StartTime, 
 		FIds::PairEncodeCantor(PerformedBy.Obj->GetUniqueID(), ObjectActedOn.Obj->GetUniqueID()),
-		PerformedBy, DeviceUsed, ObjectActedOn));
+		PerformedBy, DeviceUsed, ObjectActedOn);
 	// Add event to the pending array
 	StartedEvents.Emplace(Event);
 }
@@ -125,9 +126,9 @@ void FSLSlicingEventHandler::FinishAllEvents(float EndTime)
 void FSLSlicingEventHandler::OnSLSlicingBegin(UObject* PerformedBy, UObject* DeviceUsed, UObject* ObjectActedOn, float Time)
 {
 	// Check that the objects are semantically annotated
-  	FSLEntity PerformedByEntity = FSLEntitiesManager::GetInstance()->GetEntity(PerformedBy);
-	FSLEntity DeviceUsedEntity = FSLEntitiesManager::GetInstance()->GetEntity(DeviceUsed);
-	FSLEntity CutEntity = FSLEntitiesManager::GetInstance()->GetEntity(ObjectActedOn);
+  	FSLEntity PerformedByEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(PerformedBy);
+	FSLEntity DeviceUsedEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(DeviceUsed);
+	FSLEntity CutEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(ObjectActedOn);
 	if (PerformedByEntity.IsSet()
 		&& CutEntity.IsSet()
 		&& DeviceUsedEntity.IsSet())
@@ -139,8 +140,8 @@ void FSLSlicingEventHandler::OnSLSlicingBegin(UObject* PerformedBy, UObject* Dev
 // Event called when a semantic Slicing event ends
 void FSLSlicingEventHandler::OnSLSlicingEndFail(UObject* PerformedBy, UObject* ObjectActedOn, float Time)
 {
-	FSLEntity PerformedByEntity = FSLEntitiesManager::GetInstance()->GetEntity(PerformedBy);
-	FSLEntity CutEntity = FSLEntitiesManager::GetInstance()->GetEntity(ObjectActedOn);
+	FSLEntity PerformedByEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(PerformedBy);
+	FSLEntity CutEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(ObjectActedOn);
 	if (PerformedByEntity.IsSet()
 		&& CutEntity.IsSet())
 	{
@@ -151,9 +152,9 @@ void FSLSlicingEventHandler::OnSLSlicingEndFail(UObject* PerformedBy, UObject* O
 // Event called when a semantic Slicing event ends
 void FSLSlicingEventHandler::OnSLSlicingEndSuccess(UObject* PerformedBy, UObject* ObjectActedOn, UObject* OutputsCreated, float Time)
 {
-	FSLEntity PerformedByEntity = FSLEntitiesManager::GetInstance()->GetEntity(PerformedBy);
-	FSLEntity CutEntity = FSLEntitiesManager::GetInstance()->GetEntity(ObjectActedOn);
-	FSLEntity OutputsCreatedEntity = FSLEntitiesManager::GetInstance()->GetEntity(OutputsCreated);
+	FSLEntity PerformedByEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(PerformedBy);
+	FSLEntity CutEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(ObjectActedOn);
+	FSLEntity OutputsCreatedEntity = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(OutputsCreated);
 	if (PerformedByEntity.IsSet()
 		&& CutEntity.IsSet()
 		&& OutputsCreatedEntity.IsSet())
@@ -170,8 +171,8 @@ void FSLSlicingEventHandler::OnSLObjectCreation(UObject* TransformedObject, UObj
 	IdValue.Append(FTags::GetValue(TransformedObject, "SemLog", "Id"));
 	FTags::AddKeyValuePair(NewSlice, "SemLog", "Id", IdValue, true);
 
-	if (FSLEntitiesManager::GetInstance()->AddObject(TransformedObject) &&
-		FSLEntitiesManager::GetInstance()->AddObject(NewSlice))
+	if (FSLEntitiesManager::GetInstance(Parent->GetWorld())->AddObject(TransformedObject) &&
+		FSLEntitiesManager::GetInstance(Parent->GetWorld())->AddObject(NewSlice))
 	{
 		UE_LOG(LogTemp, Error, TEXT(">>Items Have been Created"));
 	}
@@ -180,9 +181,9 @@ void FSLSlicingEventHandler::OnSLObjectCreation(UObject* TransformedObject, UObj
 // Event called when an object is destroyed
 void FSLSlicingEventHandler::OnSLObjectDestruction(UObject* ObjectActedOn, float Time)
 {
-	FSLEntity OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(ObjectActedOn);
+	FSLEntity OtherItem = FSLEntitiesManager::GetInstance(Parent->GetWorld())->GetEntity(ObjectActedOn);
 	if (OtherItem.IsSet())
 	{
-		FSLEntitiesManager::GetInstance()->RemoveEntity(ObjectActedOn);
+		FSLEntitiesManager::GetInstance(Parent->GetWorld())->RemoveEntity(ObjectActedOn);
 	}
 }
@@ -32,6 +32,20 @@ FSLOwlNode FSLSlideEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLSlideEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("SlidingSituation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLSlideEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLSlideEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
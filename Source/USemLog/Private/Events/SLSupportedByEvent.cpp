@@ -6,14 +6,14 @@
 
 // Constructor with initialization
 FSLSupportedByEvent::FSLSupportedByEvent(const FString& InId, const float InStart, const float InEnd, const uint64 InPairId,
-	const FSLEntity& InSupportedItem, const FSLEntity& InSupportingItem) :
+	const FSLEntityHandle& InSupportedItem, const FSLEntityHandle& InSupportingItem) :
 	ISLEvent(InId, InStart, InEnd), PairId(InPairId), SupportedItem(InSupportedItem), SupportingItem(InSupportingItem)
 {
 }
 
 // Constructor initialization without end time
 FSLSupportedByEvent::FSLSupportedByEvent(const FString& InId, const float InStart, const uint64 InPairId,
-	const FSLEntity& InSupportedItem, const FSLEntity& InSupportingItem) :
+	const FSLEntityHandle& InSupportedItem, const FSLEntityHandle& InSupportingItem) :
 	ISLEvent(InId, InStart), PairId(InPairId), SupportedItem(InSupportedItem), SupportingItem(InSupportingItem)
 {
 }
@@ -27,11 +27,25 @@ FSLOwlNode FSLSupportedByEvent::ToOwlNode() const
 		"log", Id, "SupportedBySituation");
 	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", Start));
 	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", End));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportedProperty("log", SupportedItem.Id));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportingProperty("log", SupportingItem.Id));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportedProperty("log", SupportedItem->Id));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportingProperty("log", SupportingItem->Id));
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLSupportedByEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("SupportedBySituation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLSupportedByEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(SupportedItem->Id);
+	OutIds.AddUnique(SupportingItem->Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLSupportedByEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
@@ -44,10 +58,10 @@ void FSLSupportedByEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 		FSLOwlExperimentStatics::CreateTimepointIndividual("log", Start));
 	EventsDoc->AddTimepointIndividual(End,
 		FSLOwlExperimentStatics::CreateTimepointIndividual("log", End));
-	EventsDoc->AddObjectIndividual(SupportedItem.Obj,
-		 FSLOwlExperimentStatics::CreateObjectIndividual("log", SupportedItem.Id, SupportedItem.Class));
-	EventsDoc->AddObjectIndividual(SupportingItem.Obj,
-		FSLOwlExperimentStatics::CreateObjectIndividual("log", SupportingItem.Id, SupportingItem.Class));
+	EventsDoc->AddObjectIndividual(SupportedItem->Obj,
+		 FSLOwlExperimentStatics::CreateObjectIndividual("log", SupportedItem->Id, SupportedItem->Class));
+	EventsDoc->AddObjectIndividual(SupportingItem->Obj,
+		FSLOwlExperimentStatics::CreateObjectIndividual("log", SupportingItem->Id, SupportingItem->Class));
 	OutDoc->AddIndividual(ToOwlNode());
 }
 
@@ -61,13 +75,13 @@ FString FSLSupportedByEvent::Context() const
 FString FSLSupportedByEvent::Tooltip() const
 {
 	return FString::Printf(TEXT("\'SupportedItem\',\'%s\',\'Id\',\'%s\',\'SupportingItem\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
-		*SupportedItem.Class, *SupportedItem.Id, *SupportingItem.Class, *SupportingItem.Id, *Id);
+		*SupportedItem->Class, *SupportedItem->Id, *SupportingItem->Class, *SupportingItem->Id, *Id);
 }
 
 // Get the data as string
 FString FSLSupportedByEvent::ToString() const
 {
 	return FString::Printf(TEXT("SupportedItem:[%s] SupportingItem:[%s] PairId:%lld"),
-		*SupportedItem.ToString(), *SupportingItem.ToString(), PairId);
+		*SupportedItem->ToString(), *SupportingItem->ToString(), PairId);
 }
 /* End ISLEvent interface */
\ No newline at end of file
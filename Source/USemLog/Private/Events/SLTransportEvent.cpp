@@ -32,6 +32,20 @@ FSLOwlNode FSLTransportEvent::ToOwlNode() const
 	return EventIndividual;
 }
 
+// Get the owl class of the event
+FName FSLTransportEvent::GetTypeName() const
+{
+	static const FName TypeName(TEXT("TransportingSituation"));
+	return TypeName;
+}
+
+// Get the ids of the involved entities
+void FSLTransportEvent::GetEntityIds(TArray<FString>& OutIds) const
+{
+	OutIds.AddUnique(Manipulator.Id);
+	OutIds.AddUnique(Item.Id);
+}
+
 // Add the owl representation of the event to the owl document
 void FSLTransportEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 {
@@ -83,15 +83,15 @@ void USLContactCapsule::Init(bool bInLogSupportedByEvents)
 		}
 
 		// Make sure the semantic entities are set
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(GetWorld());
+			FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 		}
 
 		// TODO add case where owner is a component (e.g. instead of using get owner, use outer)
 		// Make sure owner is a valid semantic item
-		SemanticOwner = FSLEntitiesManager::GetInstance()->GetEntity(GetOwner());
-		if (!SemanticOwner.IsSet())
+		SemanticOwner = FSLEntitiesManager::GetInstance(GetWorld())->GetEntityHandle(GetOwner());
+		if (!SemanticOwner.IsValid() || !SemanticOwner->IsSet())
 		{
 			return;
 		}
@@ -129,11 +129,6 @@ void USLContactCapsule::Start()
 {
 	if (!bIsStarted && bIsInit)
 	{
-		if(bLogSupportedByEvents)
-		{
-			StartSupportedByUpdateCheck();
-		}
-		
 		// Enable overlap events
 		SetGenerateOverlapEvents(true);
 
@@ -3,6 +3,7 @@
 
 #include "SLContactShapeInterface.h"
 #include "SLEntitiesManager.h"
+#include "SLTrace.h"
 #include "Components/MeshComponent.h"
 
 // UUtils
@@ -14,12 +15,20 @@ void ISLContactShapeInterface::Finish(bool bForced)
 {
 	if (!bIsFinished && (bIsInit || bIsStarted))
 	{
-		// Publish any pending delayed events	
-		for(const auto& Ev : RecentlyEndedOverlapEvents)
+		// Publish any pending delayed events
+		FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(World);
+		for(auto& Pair : RecentlyEndedOverlapEvents)
 		{
-			PublishDelayedOverlapEndEvent(Ev);
+			TimerWheel->Cancel(Pair.Value.TimerHandle);
+			PublishDelayedOverlapEndEvent(Pair.Value);
 		}
 		RecentlyEndedOverlapEvents.Empty();
+
+		// Remove the pending supported by candidates
+		if (bLogSupportedByEvents && bIsStarted)
+		{
+			FSLSupportedByEvaluator::GetInstance(World)->RemoveShape(this);
+		}
 		
 		// Disable overlap events
 		ShapeComponent->SetGenerateOverlapEvents(false);
@@ -38,7 +47,6 @@ bool ISLContactShapeInterface::InitInterface(UShapeComponent* InShapeComponent,
 	{
 		World = InWorld;
 		ShapeComponent = InShapeComponent;
-		DelayTimerDelegate.BindRaw(this, &ISLContactShapeInterface::DelayedOverlapEndEventCallback);
 		return true;
 	}
 	return false;
@@ -59,89 +67,32 @@ void ISLContactShapeInterface::TriggerInitialOverlaps()
 	}
 }
 
-// Start checking for supported by events
-void ISLContactShapeInterface::StartSupportedByUpdateCheck()
+// Add a supported by candidate to the evaluator
+void ISLContactShapeInterface::AddSupportedByCandidate(const FSLContactResult& InContact)
 {
-	if(World)
-	{
-		// Start updating the timer, will be paused if there are no candidates
-		SBTimerDelegate.BindRaw(this, &ISLContactShapeInterface::SupportedByUpdateCheckBegin);
-		World->GetTimerManager().SetTimer(SBTimerHandle, SBTimerDelegate, SBUpdateRate, true);
-	}
+	FSLSupportedByEvaluator::GetInstance(World)->AddCandidate(this, ShapeComponent, InContact);
 }
 
-// Supported by update
-// TODO is a supported by end update look required?
-void ISLContactShapeInterface::SupportedByUpdateCheckBegin()
+// Called by the evaluator with the started supported by events of this shape
+void ISLContactShapeInterface::OnSupportedByBegin(const TArray<FSLSBBeginResult>& InResults)
 {
-	// Check if candidates are in a supported by event
-	for (auto CandidateItr(SBCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
+	const float Time = World->GetTimeSeconds();
+	for (const FSLSBBeginResult& Result : InResults)
 	{
-		// Get relative vertical speed
-		const float RelVertSpeed = FMath::Abs(CandidateItr->SelfMeshComponent->GetComponentVelocity().Z -
-			CandidateItr->OtherMeshComponent->GetComponentVelocity().Z);
-		
-		// Check that the relative speed on Z between the two objects is smaller than the threshold
-		if (RelVertSpeed < SBMaxVertSpeed)
+		OnBeginSLSupportedBy.Broadcast(Result.Supported, Result.Supporting, Time, Result.PairId);
+
+		// If self item is supporting another, do not add it to the supported by events id
+		if (Result.bSelfIsSupported)
 		{
-			if (CandidateItr->bIsOtherASemanticOverlapArea)
-			{
-				// Check which is supporting and which is supported
-				// TODO simple height comparison for now
-				if (CandidateItr->SelfMeshComponent->GetComponentLocation().Z >
-					CandidateItr->OtherMeshComponent->GetComponentLocation().Z)
-				{
-					FSLEntity Supported = CandidateItr->Self;
-					FSLEntity Supporting = CandidateItr->Other;
-					const uint64 PairId = FIds::PairEncodeCantor(Supported.Obj->GetUniqueID(), Supporting.Obj->GetUniqueID());
-					OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-					IsSupportedByPariIds.Add(PairId);
-				}
-				else
-				{
-					FSLEntity Supported = CandidateItr->Other;
-					FSLEntity Supporting = CandidateItr->Self;
-					const uint64 PairId = FIds::PairEncodeCantor(Supported.Obj->GetUniqueID(), Supporting.Obj->GetUniqueID());
-					OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-					// Self item is supporting another, to not add it to the supportedby events id
-				}
-			}
-			else 
-			{
-				// Other can only support, self can only be supported
-				FSLEntity Supported = CandidateItr->Self;
-				FSLEntity Supporting = CandidateItr->Other;
-				const uint64 PairId = FIds::PairEncodeCantor(Supported.Obj->GetUniqueID(), Supporting.Obj->GetUniqueID());
-				OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-				IsSupportedByPariIds.Add(PairId);
-			}
-			// Remove candidate, it is now part of a started event
-			CandidateItr.RemoveCurrent();
+			IsSupportedByPariIds.Add(Result.PairId);
 		}
 	}
-	
-	// PauseGraspDetection timer
-	if (SBCandidates.Num() == 0)
-	{
-		World->GetTimerManager().PauseTimer(SBTimerHandle);
-	}
 }
 
-// Remove candidate from array
+// Remove candidate from the evaluator
 bool ISLContactShapeInterface::CheckAndRemoveIfJustCandidate(UObject* InOther)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto CandidateItr(SBCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
-	{
-		if ((*CandidateItr).Other.Obj == InOther)
-		{
-			// Remove candidate from the list
-			CandidateItr.RemoveCurrent();
-
-			return true; // Found
-		}
-	}
-	return false; // Not in list
+	return FSLSupportedByEvaluator::GetInstance(World)->RemoveCandidate(this, InOther);
 }
 
 // Called on overlap begin events
@@ -158,16 +109,11 @@ void ISLContactShapeInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedCom
 		return;
 	}
 
-	// Check if the component or its outer is semantically annotated
-	FSLEntity OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(OtherComp);
-	if (!OtherItem.IsSet())
+	// Check if the component or its outer is semantically annotated (cached, no entity data is copied)
+	const FSLEntityHandle OtherItem = FSLEntitiesManager::GetInstance(World)->ResolveEntity(OtherComp);
+	if (!OtherItem.IsValid())
 	{
-		// Other not valid, check if its outer is semantically annotated
-		OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(OtherComp->GetOuter());
-		if (!OtherItem.IsSet())
-		{
-			return;
-		}
+		return;
 	}
 
 	// Get the time of the event in second
@@ -177,8 +123,10 @@ void ISLContactShapeInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedCom
 	// and the recent overlap end
 	if(SkipOverlapEndEventBroadcast(OtherItem, StartTime))
 	{
+		SL_TRACE(SL_TRACE_CAT_CONTACT, ESLTraceEvent::ContactConcatenated, StartTime, SemanticOwner->Obj, OtherItem->Obj);
 		return;
 	}
+	SL_TRACE(SL_TRACE_CAT_CONTACT, ESLTraceEvent::ContactBegin, StartTime, SemanticOwner->Obj, OtherItem->Obj);
 
 	// Check the type of the other component
 	if (UMeshComponent* OtherAsMeshComp = Cast<UMeshComponent>(OtherComp))
@@ -190,12 +138,8 @@ void ISLContactShapeInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedCom
 
 		if(bLogSupportedByEvents)
 		{
-			// Add candidate and re-start (if paused) timer cb
-			SBCandidates.Emplace(SemanticOverlapResult);
-			if(World->GetTimerManager().IsTimerPaused(SBTimerHandle))
-			{
-				World->GetTimerManager().UnPauseTimer(SBTimerHandle);
-			}
+			// Add candidate, it is checked with all the others in the next evaluator update
+			AddSupportedByCandidate(SemanticOverlapResult);
 		}
 	}
 	else if (ISLContactShapeInterface* OtherContactTrigger = Cast<ISLContactShapeInterface>(OtherComp))
@@ -207,7 +151,7 @@ void ISLContactShapeInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedCom
 		// This allows us to be in sync with the overlap end event 
 		// since the unique ids and the rule of ignoring the one event will not change
 		// Filter out one of the trigger areas (compare unique ids)
-		if (OtherItem.Obj->GetUniqueID() > SemanticOwner.Obj->GetUniqueID())
+		if (OtherItem->Obj->GetUniqueID() > SemanticOwner->Obj->GetUniqueID())
 		{
 			// Broadcast begin of semantic overlap event
 			FSLContactResult SemanticOverlapResult(SemanticOwner, OtherItem,
@@ -216,12 +160,8 @@ void ISLContactShapeInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedCom
 			
 			if(bLogSupportedByEvents)
 			{
-				// Add candidate and re-start (if paused) timer cb
-				SBCandidates.Emplace(SemanticOverlapResult);
-				if(World->GetTimerManager().IsTimerPaused(SBTimerHandle))
-				{
-					World->GetTimerManager().UnPauseTimer(SBTimerHandle);
-				}
+				// Add candidate, it is checked with all the others in the next evaluator update
+				AddSupportedByCandidate(SemanticOverlapResult);
 			}
 		}
 	}
@@ -239,122 +179,98 @@ void ISLContactShapeInterface::OnOverlapEnd(UPrimitiveComponent* OverlappedComp,
 		return;
 	}
 
-	// Check if the component or its outer is semantically annotated
-	FSLEntity OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(OtherComp);
-	if (!OtherItem.IsSet())
+	// Check if the component or its outer is semantically annotated (cached, no entity data is copied)
+	const FSLEntityHandle OtherItem = FSLEntitiesManager::GetInstance(World)->ResolveEntity(OtherComp);
+	if (!OtherItem.IsValid())
 	{
-		// Other not valid, check if its outer is semantically annotated
-		OtherItem = FSLEntitiesManager::GetInstance()->GetEntity(OtherComp->GetOuter());
-		if (!OtherItem.IsSet())
-		{
-			return;
-		}
+		return;
 	}
 
-	// Delay publishing the overlap event in case of possible concatenations
-	RecentlyEndedOverlapEvents.Emplace(FSLOverlapEndEvent(OtherComp, OtherItem, World->GetTimeSeconds()));
+	FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(World);
 
-	// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-	if(!World->GetTimerManager().IsTimerActive(DelayTimerHandle))
+	// A previous end with the same item which could not be concatenated anymore is published right away
+	if (FSLOverlapEndEvent* PrevEv = RecentlyEndedOverlapEvents.Find(OtherItem->Obj))
 	{
-		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate,MaxOverlapEventTimeGap*1.12f, false);
+		TimerWheel->Cancel(PrevEv->TimerHandle);
+		PublishDelayedOverlapEndEvent(*PrevEv);
+		RecentlyEndedOverlapEvents.Remove(OtherItem->Obj);
 	}
+
+	// Delay publishing for a while, in case the new event is of the same type and should be concatenated
+	FSLOverlapEndEvent& Ev = RecentlyEndedOverlapEvents.Emplace(OtherItem->Obj,
+		FSLOverlapEndEvent(OtherComp, OtherItem, World->GetTimeSeconds()));
+	UObject* OtherObj = OtherItem->Obj;
+	Ev.TimerHandle = TimerWheel->Schedule(MaxOverlapEventTimeGap * 1.12f,
+		[this, OtherObj]() { DelayedOverlapEndEventCallback(OtherObj); }, ShapeComponent);
 }
 
-// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-void ISLContactShapeInterface::DelayedOverlapEndEventCallback()
+// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+void ISLContactShapeInterface::DelayedOverlapEndEventCallback(UObject* InOther)
 {
-	// Curr time (keep very recently added events for another delay)
-	const float CurrTime = World->GetTimeSeconds();
-	
-	for (auto OverlapEndEvItr(RecentlyEndedOverlapEvents.CreateIterator()); OverlapEndEvItr; ++OverlapEndEvItr)
+	FSLOverlapEndEvent Ev;
+	if (RecentlyEndedOverlapEvents.RemoveAndCopyValue(InOther, Ev))
 	{
-		if(PublishDelayedOverlapEndEvent(*OverlapEndEvItr, CurrTime))
-		{
-			// Remove event from the pending list
-			OverlapEndEvItr.RemoveCurrent();
-		}
-	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedOverlapEvents.Num() > 0)
-	{
-		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate,MaxOverlapEventTimeGap * 1.12f, false);
+		PublishDelayedOverlapEndEvent(Ev);
 	}
 }
 
-// Broadcast delayed overlaps, if curr time < 0, it guarantees a publish
-bool ISLContactShapeInterface::PublishDelayedOverlapEndEvent(const FSLOverlapEndEvent& Ev, float CurrTime)
+// Broadcast delayed overlap end
+void ISLContactShapeInterface::PublishDelayedOverlapEndEvent(const FSLOverlapEndEvent& Ev)
 {
-	// Check if the event is old enough that it had it chance to be concatenated
-	// if CurrTime < 0, it forces publishing
-	if(CurrTime < 0 ||
-		CurrTime - Ev.Time > MaxOverlapEventTimeGap)
+	SL_TRACE(SL_TRACE_CAT_CONTACT, ESLTraceEvent::ContactEnd, Ev.Time, SemanticOwner->Obj, Ev.OtherItem->Obj);
+
+	// Check the type of the other component
+	if (UMeshComponent* OtherAsMeshComp = Cast<UMeshComponent>(Ev.OtherComp))
 	{
-		// Check the type of the other component
-		if (UMeshComponent* OtherAsMeshComp = Cast<UMeshComponent>(Ev.OtherComp))
+		// Broadcast end of semantic overlap event
+		OnEndSLContact.Broadcast(*SemanticOwner, *Ev.OtherItem, Ev.Time);
+	}
+	else if (ISLContactShapeInterface* OtherContactTrigger = Cast<ISLContactShapeInterface>(Ev.OtherComp))
+	{
+		// If both areas are trigger areas, they will both concurrently trigger overlap events.
+		// To avoid this we consistently ignore one trigger event. This is chosen using
+		// the unique ids of the overlapping actors (GetUniqueID), we compare the two values 
+		// and consistently pick the event with a given (larger or smaller) value.
+		// This allows us to be in sync with the overlap end event 
+		// since the unique ids and the rule of ignoring the one event will not change
+		// Filter out one of the trigger areas (compare unique ids)
+		if (Ev.OtherItem->Obj->GetUniqueID() > SemanticOwner->Obj->GetUniqueID())
 		{
 			// Broadcast end of semantic overlap event
-			OnEndSLContact.Broadcast(SemanticOwner, Ev.OtherItem, Ev.Time);
-		}
-		else if (ISLContactShapeInterface* OtherContactTrigger = Cast<ISLContactShapeInterface>(Ev.OtherComp))
-		{
-			// If both areas are trigger areas, they will both concurrently trigger overlap events.
-			// To avoid this we consistently ignore one trigger event. This is chosen using
-			// the unique ids of the overlapping actors (GetUniqueID), we compare the two values 
-			// and consistently pick the event with a given (larger or smaller) value.
-			// This allows us to be in sync with the overlap end event 
-			// since the unique ids and the rule of ignoring the one event will not change
-			// Filter out one of the trigger areas (compare unique ids)
-			if (Ev.OtherItem.Obj->GetUniqueID() > SemanticOwner.Obj->GetUniqueID())
-			{
-				// Broadcast end of semantic overlap event
-				OnEndSLContact.Broadcast(SemanticOwner, Ev.OtherItem, Ev.Time);
-			}
+			OnEndSLContact.Broadcast(*SemanticOwner, *Ev.OtherItem, Ev.Time);
 		}
+	}
 
-		if(bLogSupportedByEvents)
+	if(bLogSupportedByEvents)
+	{
+		// Ignore and remove if it is a candidate only
+		// (it cannot be a candidate and an event, e.g. contact ended with a candidate only)
+		if(!CheckAndRemoveIfJustCandidate(Ev.OtherItem->Obj))
 		{
-			// Ignore and remove if it is a candidate only
-			// (it cannot be a candidate and an event, e.g. contact ended with a candidate only)
-			if(!CheckAndRemoveIfJustCandidate(Ev.OtherItem.Obj))
+			const uint64 PairId1 = FIds::PairEncodeCantor(SemanticOwner->Obj->GetUniqueID(),Ev.OtherItem->Obj->GetUniqueID());
+			const uint64 PairId2 = FIds::PairEncodeCantor(Ev.OtherItem->Obj->GetUniqueID(), SemanticOwner->Obj->GetUniqueID());
+			OnEndSLSupportedBy.Broadcast(PairId1, PairId2, Ev.Time);
+			PrevSupportedByEndTime =  Ev.Time;
+			if(IsSupportedByPariIds.Remove(PairId1) == 0)
 			{
-				const uint64 PairId1 = FIds::PairEncodeCantor(SemanticOwner.Obj->GetUniqueID(),Ev.OtherItem.Obj->GetUniqueID());
-				const uint64 PairId2 = FIds::PairEncodeCantor(Ev.OtherItem.Obj->GetUniqueID(), SemanticOwner.Obj->GetUniqueID());
-				OnEndSLSupportedBy.Broadcast(PairId1, PairId2, Ev.Time);
-				PrevSupportedByEndTime =  Ev.Time;
-				if(IsSupportedByPariIds.Remove(PairId1) == 0)
-				{
-					IsSupportedByPariIds.Remove(PairId2);
-				}
+				IsSupportedByPariIds.Remove(PairId2);
 			}
 		}
-		return true;
 	}
-	return false;
 }
 
 // Skip publishing overlap event if it can be concatenated with the current event start
-bool ISLContactShapeInterface::SkipOverlapEndEventBroadcast(const FSLEntity& InItem, float StartTime)
+bool ISLContactShapeInterface::SkipOverlapEndEventBroadcast(const FSLEntityHandle& InItem, float StartTime)
 {
-	for (auto OverlapEndEvItr(RecentlyEndedOverlapEvents.CreateIterator()); OverlapEndEvItr; ++OverlapEndEvItr)
+	if (FSLOverlapEndEvent* Ev = RecentlyEndedOverlapEvents.Find(InItem->Obj))
 	{
-		// Check if it is an event between the same entities
-		if(OverlapEndEvItr->OtherItem.EqualsFast(InItem))
+		// Check time difference
+		if(StartTime - Ev->Time < MaxOverlapEventTimeGap)
 		{
-			// Check time difference
-			if(StartTime - OverlapEndEvItr->Time < MaxOverlapEventTimeGap)
-			{
-				OverlapEndEvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedOverlapEvents.Num() == 0)
-				{
-					World->GetTimerManager().ClearTimer(DelayTimerHandle);
-				}
-				
-				return true;
-			}
+			// Cancel the delayed publish
+			FSLTimerWheel::GetInstance(World)->Cancel(Ev->TimerHandle);
+			RecentlyEndedOverlapEvents.Remove(InItem->Obj);
+			return true;
 		}
 	}
 	return false;
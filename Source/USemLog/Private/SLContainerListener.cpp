@@ -39,13 +39,13 @@ bool USLContainerListener::Init()
 	if (!bIsInit)
 	{
 		// Init the semantic entities manager
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(GetWorld());
+			FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 		}
 
 		// Check that the owner is part of the semantic entities
-		SemanticOwner = FSLEntitiesManager::GetInstance()->GetEntity(GetOwner());
+		SemanticOwner = FSLEntitiesManager::GetInstance(GetWorld())->GetEntity(GetOwner());
 		if (!SemanticOwner.IsSet())
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Owner is not semantically annotated.."), *FString(__func__), __LINE__);
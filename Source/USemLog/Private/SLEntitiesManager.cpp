@@ -3,30 +3,27 @@
 
 #include "SLEntitiesManager.h"
 #include "SLVisViewActor.h"
-#include "Tags.h"
+#include "SLTagCache.h"
 #include "Animation/SkeletalMeshActor.h"
+#include "EngineUtils.h"
 
-TSharedPtr<FSLEntitiesManager> FSLEntitiesManager::StaticInstance;
+TSLWorldInstances<FSLEntitiesManager> FSLEntitiesManager::WorldInstances;
 
 // Constructor
 FSLEntitiesManager::FSLEntitiesManager() : bIsInit(false) 
 {
 }
 
-// Get singleton
-FSLEntitiesManager* FSLEntitiesManager::GetInstance()
+// Get the instance of the world
+FSLEntitiesManager* FSLEntitiesManager::GetInstance(UWorld* World)
 {
-	if (!StaticInstance.IsValid())
-	{
-		StaticInstance = MakeShareable(new FSLEntitiesManager());
-	}
-	return StaticInstance.Get();
+	return WorldInstances.FindOrAdd(World, []() { return new FSLEntitiesManager(); });
 }
 
-// Delete instance
-void FSLEntitiesManager::DeleteInstance()
+// Delete the instance of the world
+void FSLEntitiesManager::DeleteInstance(UWorld* World)
 {
-	StaticInstance.Reset();
+	WorldInstances.Remove(World);
 }
 
 // Init data
@@ -34,68 +31,77 @@ void FSLEntitiesManager::Init(UWorld* World)
 {
 	if (!bIsInit)
 	{
-		// Iterate all actors
-		for (TActorIterator<AActor> ActorItr(World); ActorItr; ++ActorItr)
+		const double StartTime = FPlatformTime::Seconds();
+
+		// Parse the tags of the world once, shared with the other consumers
+		FSLTagCache* TagCache = FSLTagCache::GetInstance(World);
+		TagCache->Init(World);
+		const double TagsTime = FPlatformTime::Seconds();
+
+		// Only the objects with SemLog tags are visited
+		ObjectsSemanticData.Reserve(TagCache->GetObjectKeyValuePairsMap().Num());
+		for (const auto& ObjToTagsItr : TagCache->GetObjectKeyValuePairsMap())
 		{
-			// Add to map if key is found in the actor
-			FString ActId = FTags::GetValue(*ActorItr, "SemLog", "Id");
-			FString ActClass = FTags::GetValue(*ActorItr, "SemLog", "Class");
-			if (!ActId.IsEmpty() && !ActClass.IsEmpty())
+			UObject* Obj = ObjToTagsItr.Key.Get();
+			if (!Obj)
 			{
-				ObjectsSemanticData.Emplace(*ActorItr, FSLEntity(*ActorItr, ActId, ActClass,
-					FTags::GetValue(*ActorItr, "SemLog", "VisMask")));
+				continue;
+			}
+			const FString* IdPtr = ObjToTagsItr.Value.Find("Id");
+			const FString* ClassPtr = ObjToTagsItr.Value.Find("Class");
+			if (!IdPtr || !ClassPtr || IdPtr->IsEmpty() || ClassPtr->IsEmpty())
+			{
+				continue;
+			}
+			const FString* VisMaskPtr = ObjToTagsItr.Value.Find("VisMask");
+			ObjectsSemanticData.Emplace(Obj, MakeShared<FSLEntity>(Obj, *IdPtr, *ClassPtr,
+				VisMaskPtr ? *VisMaskPtr : FString()));
 
-				// Create a separate list with the camera views
-				if (ActorItr->IsA(ASLVisViewActor::StaticClass()))
-				{
-					CameraViewSemanticData.Emplace(*ActorItr, FSLEntity(*ActorItr, ActId, ActClass));
-				}
+			// Create a separate list with the camera views
+			if (Obj->IsA(ASLVisViewActor::StaticClass()))
+			{
+				CameraViewSemanticData.Emplace(Obj, FSLEntity(Obj, *IdPtr, *ClassPtr));
+			}
 
-				// Store quick map of id to actor pointer
-				if(AStaticMeshActor* AsSMA = Cast<AStaticMeshActor>(*ActorItr))
+			// Store quick map of id to actor pointer
+			if(AStaticMeshActor* AsSMA = Cast<AStaticMeshActor>(Obj))
+			{
+				IdToStaticMeshActor.Emplace(*IdPtr, AsSMA);
+			}
+			else if(ASkeletalMeshActor* AsSkMA = Cast<ASkeletalMeshActor>(Obj))
+			{
+				// Check if skeletal data component is available
+				if(AsSkMA->GetComponentByClass(USLSkeletalDataComponent::StaticClass()))
 				{
-					IdToStaticMeshActor.Emplace(ActId, AsSMA);
+					IdToSkeletalMeshActor.Emplace(*IdPtr, AsSkMA);
 				}
-				else if(ASkeletalMeshActor* AsSkMA = Cast<ASkeletalMeshActor>(*ActorItr))
+				else
 				{
-					// Check if skeletal data component is available
-					if(AsSkMA->GetComponentByClass(USLSkeletalDataComponent::StaticClass()))
-					{
-						IdToSkeletalMeshActor.Emplace(ActId, AsSkMA);
-					}
-					else
-					{
-						UE_LOG(LogTemp, Error, TEXT("%s::%d %s has no USLSKeletalDataComponent, entity will not be logged.."), 
-							*FString(__func__), __LINE__, *AsSkMA->GetName());
-					}
+					UE_LOG(LogTemp, Error, TEXT("%s::%d %s has no USLSKeletalDataComponent, entity will not be logged.."), 
+						*FString(__func__), __LINE__, *AsSkMA->GetName());
 				}
 			}
+		}
+		const double EntitiesTime = FPlatformTime::Seconds();
 
-			// Iterate components of the actor
-			for (const auto& CompItr : ActorItr->GetComponents())
+		// Skeletal data containers (their owner data is set from the cached tags as well)
+		for (TObjectIterator<USLSkeletalDataComponent> SkelItr; SkelItr; ++SkelItr)
+		{
+			if (SkelItr->GetWorld() == World && SkelItr->Init())
 			{
-				// Add to map if key is found in the actor
-				FString CompId = FTags::GetValue(CompItr, "SemLog", "Id");
-				FString CompClass = FTags::GetValue(CompItr, "SemLog", "Class");
-				if (!CompId.IsEmpty() && !CompClass.IsEmpty())
-				{
-					ObjectsSemanticData.Emplace(CompItr, FSLEntity(CompItr, CompId, CompClass,
-						FTags::GetValue(CompItr, "SemLog", "VisMask")));
-				}
-
-				// Check if the component is a skeletal data container
-				if (USLSkeletalDataComponent* AsSkelData = Cast<USLSkeletalDataComponent>(CompItr))
-				{
-					if (AsSkelData->Init())
-					{
-						ObjectsSemanticSkeletalData.Add(AsSkelData->OwnerSemanticData.Obj, AsSkelData);
-					}
-				}
+				ObjectsSemanticSkeletalData.Add(SkelItr->OwnerSemanticData.Obj, *SkelItr);
 			}
 		}
 
+		// Previously resolved objects might be annotated now
+		ResolveCache.Empty();
+
 		// Mark as initialized
 		bIsInit = true;
+
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Init %d entities (%d skeletal) in %.3fs (tags=%.3fs, entities=%.3fs, skeletal=%.3fs).."),
+			*FString(__func__), __LINE__, ObjectsSemanticData.Num(), ObjectsSemanticSkeletalData.Num(), FPlatformTime::Seconds() - StartTime,
+			TagsTime - StartTime, EntitiesTime - TagsTime, FPlatformTime::Seconds() - EntitiesTime);
 	}
 }
 
@@ -105,6 +111,7 @@ void FSLEntitiesManager::Clear()
 {
 	// Clear any previous data
 	ObjectsSemanticData.Empty();
+	ResolveCache.Empty();
 
 	// Mark as uninitialized
 	bIsInit = false;
@@ -160,9 +167,13 @@ void FSLEntitiesManager::SetReplicates(bool bReplicate, float Priority, float Mi
 bool FSLEntitiesManager::RemoveEntity(UObject* Object)
 {
 	//return FSLMappings::RemoveItem(Object->GetUniqueID());
-	int32 NrOfRemovedItems = ObjectsSemanticData.Remove(Object);
-	if (NrOfRemovedItems > 0)
+	TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object);
+	if (Item)
 	{
+		// The object might be cached as the resolved outer of other objects
+		const TSet<const FSLEntity*> RemovedEntities = { &Item->Get() };
+		PruneResolveCache(RemovedEntities);
+		ObjectsSemanticData.Remove(Object);
 		return true;
 	}
 	else
@@ -175,11 +186,19 @@ bool FSLEntitiesManager::RemoveEntity(UObject* Object)
 bool FSLEntitiesManager::AddObject(UObject* Object)
 {
 	// Add to map if key is found in the actor
-	FString Id = FTags::GetValue(Object, "SemLog", "Id");
-	FString Class = FTags::GetValue(Object, "SemLog", "Class");
+	FSLTagCache* TagCache = FSLTagCache::GetInstance(Object->GetWorld());
+	FString Id = TagCache->GetValue(Object, "Id");
+	FString Class = TagCache->GetValue(Object, "Class");
 	if (!Id.IsEmpty() && !Class.IsEmpty())
 	{
-		ObjectsSemanticData.Emplace(Object, FSLEntity(Object, Id, Class));
+		// Misses are not cached, only the entries resolving to a replaced record, or the object to its outer, are reset
+		if (const TSharedRef<FSLEntity>* PrevItem = ObjectsSemanticData.Find(Object))
+		{
+			const TSet<const FSLEntity*> ReplacedEntities = { &PrevItem->Get() };
+			PruneResolveCache(ReplacedEntities);
+		}
+		ResolveCache.Remove(Object);
+		ObjectsSemanticData.Emplace(Object, MakeShared<FSLEntity>(Object, Id, Class));
 		return true;
 	}
 	else
@@ -188,13 +207,107 @@ bool FSLEntitiesManager::AddObject(UObject* Object)
 	}
 }
 
+// Register the annotated actor and components of an actor spawned at runtime
+int32 FSLEntitiesManager::AddActorEntities(AActor* Actor, TArray<FSLEntity>& OutNewEntities)
+{
+	int32 NumAdded = 0;
+	FSLEntity NewEntity;
+	if (AddObjectIncremental(Actor, NewEntity))
+	{
+		if (AStaticMeshActor* AsSMA = Cast<AStaticMeshActor>(Actor))
+		{
+			IdToStaticMeshActor.Emplace(NewEntity.Id, AsSMA);
+		}
+		OutNewEntities.Emplace(NewEntity);
+		NumAdded++;
+	}
+
+	for (UActorComponent* Comp : Actor->GetComponents())
+	{
+		if (AddObjectIncremental(Comp, NewEntity))
+		{
+			OutNewEntities.Emplace(NewEntity);
+			NumAdded++;
+		}
+		else
+		{
+			// The components fall back to their (possibly new) outer when resolved
+			ResolveCache.Remove(Comp);
+		}
+	}
+	return NumAdded;
+}
+
+// Register an annotated component added at runtime
+bool FSLEntitiesManager::AddComponentEntity(UActorComponent* Component, FSLEntity& OutNewEntity)
+{
+	return AddObjectIncremental(Component, OutNewEntity);
+}
+
+// Unregister the destroyed actor and its components
+int32 FSLEntitiesManager::RemoveActorEntities(AActor* Actor)
+{
+	FSLTagCache* TagCache = FSLTagCache::GetInstance(Actor->GetWorld());
+	TSet<const FSLEntity*> RemovedEntities;
+	if (TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Actor))
+	{
+		IdToStaticMeshActor.Remove((*Item)->Id);
+		RemovedEntities.Add(&Item->Get());
+	}
+	ResolveCache.Remove(Actor);
+	TagCache->RemoveObject(Actor);
+
+	for (UActorComponent* Comp : Actor->GetComponents())
+	{
+		if (TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Comp))
+		{
+			RemovedEntities.Add(&Item->Get());
+		}
+		ResolveCache.Remove(Comp);
+		TagCache->RemoveObject(Comp);
+	}
+
+	// Prune before the records are released, the cached handles are compared by address
+	PruneResolveCache(RemovedEntities);
+	ObjectsSemanticData.Remove(Actor);
+	for (UActorComponent* Comp : Actor->GetComponents())
+	{
+		ObjectsSemanticData.Remove(Comp);
+	}
+	return RemovedEntities.Num();
+}
+
+// Parse the tags and add the object, only the resolve cache entry of the object is reset
+bool FSLEntitiesManager::AddObjectIncremental(UObject* Object, FSLEntity& OutNewEntity)
+{
+	FSLTagCache* TagCache = FSLTagCache::GetInstance(Object->GetWorld());
+	if (ObjectsSemanticData.Contains(Object) || TagCache->AddObject(Object) == 0)
+	{
+		return false;
+	}
+
+	const TMap<FString, FString>* KeyValuePairs = TagCache->Find(Object);
+	const FString Id = KeyValuePairs->FindRef("Id");
+	const FString Class = KeyValuePairs->FindRef("Class");
+	if (Id.IsEmpty() || Class.IsEmpty())
+	{
+		return false;
+	}
+
+	TSharedRef<FSLEntity> Entity = MakeShared<FSLEntity>(Object, Id, Class, KeyValuePairs->FindRef("VisMask"));
+	ObjectsSemanticData.Emplace(Object, Entity);
+	ResolveCache.Remove(Object);
+	OutNewEntity = *Entity;
+	return true;
+}
+
 // Get semantic object structure, from object
 FSLEntity FSLEntitiesManager::GetEntity(UObject* Object) const
 {
 	//return FSLMappings::GetSemanticObject(Object->GetUniqueID());
-	if (const FSLEntity* Item = ObjectsSemanticData.Find(Object))
+	if (const TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
 	{
-		return *Item;
+		return **Item;
 	}
 	else
 	{
@@ -205,16 +318,20 @@ FSLEntity FSLEntitiesManager::GetEntity(UObject* Object) const
 // Get semantic object structure, from object
 FSLEntity* FSLEntitiesManager::GetEntityPtr(UObject* Object)
 {
-	return ObjectsSemanticData.Find(Object);
+	if (TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
+	{
+		return &Item->Get();
+	}
+	return nullptr;
 }
 
 // Get semantic object structure, from object
 bool FSLEntitiesManager::GetEntity(UObject* Object, FSLEntity& OutEntity) const
 {
 	//return FSLMappings::GetSemanticObject(Object->GetUniqueID());
-	if (const FSLEntity* Item = ObjectsSemanticData.Find(Object))
+	if (const TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
 	{
-		OutEntity = *Item;
+		OutEntity = **Item;
 		return true;
 	}
 	else
@@ -223,14 +340,79 @@ bool FSLEntitiesManager::GetEntity(UObject* Object, FSLEntity& OutEntity) const
 	}
 }
 
+// Get the handle to the entity record of the object
+FSLEntityHandle FSLEntitiesManager::GetEntityHandle(UObject* Object) const
+{
+	if (const TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
+	{
+		return *Item;
+	}
+	return FSLEntityHandle();
+}
+
+// Get the handle to the entity record of the object or of its outer
+FSLEntityHandle FSLEntitiesManager::ResolveEntity(UObject* Object)
+{
+	if (Object == nullptr)
+	{
+		return FSLEntityHandle();
+	}
+
+	// The weak key does not match recycled objects allocated at the same address
+	if (const FSLEntityHandle* Cached = ResolveCache.Find(Object))
+	{
+		return *Cached;
+	}
+
+	FSLEntityHandle Handle = GetEntityHandle(Object);
+	if (!Handle.IsValid() || !Handle->IsSet())
+	{
+		// Other not valid, check if its outer is semantically annotated
+		Handle = GetEntityHandle(Object->GetOuter());
+		if (Handle.IsValid() && !Handle->IsSet())
+		{
+			Handle.Reset();
+		}
+	}
+
+	// Misses are not cached, the object or its outer might be annotated later on
+	if (Handle.IsValid())
+	{
+		ResolveCache.Emplace(Object, Handle);
+	}
+	return Handle;
+}
+
+// Remove the resolve cache entries of the destroyed objects and the ones resolving to the removed records
+void FSLEntitiesManager::PruneResolveCache(const TSet<const FSLEntity*>& RemovedEntities)
+{
+	for (auto CacheItr = ResolveCache.CreateIterator(); CacheItr; ++CacheItr)
+	{
+		if (!CacheItr->Key.IsValid() || RemovedEntities.Contains(CacheItr->Value.Get()))
+		{
+			CacheItr.RemoveCurrent();
+		}
+	}
+}
+
+// Get the map of objects to the semantic items
+void FSLEntitiesManager::GetSemanticDataArray(TArray<FSLEntity>& OutArray) const
+{
+	OutArray.Reserve(OutArray.Num() + ObjectsSemanticData.Num());
+	for (const auto& Pair : ObjectsSemanticData)
+	{
+		OutArray.Emplace(*Pair.Value);
+	}
+}
+
 
 // Get semantic id from object
 FString FSLEntitiesManager::GetId(UObject* Object) const
 {
 	//return FSLMappings::GetSemanticId(Object->GetUniqueID());
-	if (const FSLEntity* Item = ObjectsSemanticData.Find(Object))
+	if (const TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
 	{
-		return *Item->Id;
+		return (*Item)->Id;
 	}
 	else
 	{
@@ -242,9 +424,9 @@ FString FSLEntitiesManager::GetId(UObject* Object) const
 FString FSLEntitiesManager::GetClass(UObject* Object) const
 {
 	//return FSLMappings::GetSemanticClass(Object->GetUniqueID());
-	if (const FSLEntity* Item = ObjectsSemanticData.Find(Object))
+	if (const TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
 	{
-		return *Item->Class;
+		return (*Item)->Class;
 	}
 	else
 	{
@@ -256,9 +438,9 @@ FString FSLEntitiesManager::GetClass(UObject* Object) const
 bool FSLEntitiesManager::IsObjectEntitySet(UObject* Object) const
 {
 	//return FSLMappings::HasValidItem(Object->GetUniqueID());
-	if (const FSLEntity* Item = ObjectsSemanticData.Find(Object))
+	if (const TSharedRef<FSLEntity>* Item = ObjectsSemanticData.Find(Object))
 	{
-		return Item->IsSet();
+		return (*Item)->IsSet();
 	}
 	else
 	{
@@ -0,0 +1,137 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLEntityResolveBenchmarkCommandlet.h"
+#include "SLEntitiesManager.h"
+#include "SLTagCache.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+// Ctor
+USLEntityResolveBenchmarkCommandlet::USLEntityResolveBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Run the benchmark
+int32 USLEntityResolveBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumActors = 1000;
+	int32 NumComps = 8;
+	int32 NumLookups = 1000000;
+	int32 NumRuns = 3;
+	FParse::Value(*Params, TEXT("actors="), NumActors);
+	FParse::Value(*Params, TEXT("comps="), NumComps);
+	FParse::Value(*Params, TEXT("lookups="), NumLookups);
+	FParse::Value(*Params, TEXT("runs="), NumRuns);
+	NumActors = FMath::Max(NumActors, 2);
+	NumComps = FMath::Max(NumComps, 1);
+	NumLookups = FMath::Max(NumLookups, 1);
+	NumRuns = FMath::Max(NumRuns, 1);
+
+	// Transient world, every second actor is annotated, the components resolve through their outer
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SLEntityResolveBenchmark"));
+	TArray<AActor*> Actors;
+	TArray<UObject*> Objects;
+	for (int32 ActorIdx = 0; ActorIdx < NumActors; ++ActorIdx)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+		if (ActorIdx % 2 == 0)
+		{
+			Actor->Tags.Add(FName(*FString::Printf(TEXT("SemLog;Id,BenchEntity%d;Class,BenchItem;"), ActorIdx)));
+		}
+		for (int32 CompIdx = 0; CompIdx < NumComps; ++CompIdx)
+		{
+			USceneComponent* Comp = NewObject<USceneComponent>(Actor);
+			Comp->RegisterComponent();
+			Objects.Add(Comp);
+		}
+		Actors.Add(Actor);
+	}
+
+	FSLEntitiesManager* EntitiesManager = FSLEntitiesManager::GetInstance(World);
+	EntitiesManager->Init(World);
+
+	// Lookup without the cache, same steps as the resolve
+	auto ResolveUncached = [EntitiesManager](UObject* Object)
+	{
+		FSLEntityHandle Handle = EntitiesManager->GetEntityHandle(Object);
+		if (!Handle.IsValid() || !Handle->IsSet())
+		{
+			Handle = EntitiesManager->GetEntityHandle(Object->GetOuter());
+			if (Handle.IsValid() && !Handle->IsSet())
+			{
+				Handle.Reset();
+			}
+		}
+		return Handle;
+	};
+
+	// Same random overlap sequence for both lookups
+	auto RunLookups = [&](const TCHAR* Label) -> bool
+	{
+		bool bMatch = true;
+		for (int32 Run = 0; Run < NumRuns; ++Run)
+		{
+			FRandomStream Stream(Run);
+			int32 NumHits = 0;
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Idx = 0; Idx < NumLookups; ++Idx)
+			{
+				NumHits += ResolveUncached(Objects[Stream.RandHelper(Objects.Num())]).IsValid() ? 1 : 0;
+			}
+			const double UncachedTime = FPlatformTime::Seconds() - StartTime;
+
+			Stream.Reset();
+			int32 NumCachedHits = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Idx = 0; Idx < NumLookups; ++Idx)
+			{
+				NumCachedHits += EntitiesManager->ResolveEntity(Objects[Stream.RandHelper(Objects.Num())]).IsValid() ? 1 : 0;
+			}
+			const double CachedTime = FPlatformTime::Seconds() - StartTime;
+			bMatch &= NumHits == NumCachedHits;
+
+			UE_LOG(LogSL, Display, TEXT("%s::%d [%s] Run %d, %d lookups (%d hits, cached %d): uncached %.1f ns/lookup, cached %.1f ns/lookup, speedup x%.2f.."),
+				*FString(__func__), __LINE__, Label, Run, NumLookups, NumHits, NumCachedHits,
+				UncachedTime * 1e9 / NumLookups, CachedTime * 1e9 / NumLookups,
+				UncachedTime / FMath::Max(CachedTime, SMALL_NUMBER));
+		}
+
+		// Every object has to resolve to the same record with and without the cache
+		for (UObject* Object : Objects)
+		{
+			bMatch &= ResolveUncached(Object) == EntitiesManager->ResolveEntity(Object);
+		}
+		return bMatch;
+	};
+
+	bool bMatch = RunLookups(TEXT("All"));
+
+	// Remove a quarter of the actors, their cache entries have to be pruned
+	const double RemoveStart = FPlatformTime::Seconds();
+	int32 NumRemoved = 0;
+	for (int32 ActorIdx = 0; ActorIdx < Actors.Num(); ActorIdx += 4)
+	{
+		NumRemoved += EntitiesManager->RemoveActorEntities(Actors[ActorIdx]);
+	}
+	UE_LOG(LogSL, Display, TEXT("%s::%d Removed %d entities of %d actors in %.3f ms.."),
+		*FString(__func__), __LINE__, NumRemoved, (Actors.Num() + 3) / 4, (FPlatformTime::Seconds() - RemoveStart) * 1000.0);
+	bMatch &= RunLookups(TEXT("AfterRemove"));
+
+	if (!bMatch)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d The cached resolve differs from the uncached one.."), *FString(__func__), __LINE__);
+	}
+
+	FSLEntitiesManager::DeleteInstance(World);
+	FSLTagCache::DeleteInstance(World);
+	World->DestroyWorld(false);
+	return bMatch ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLEventBenchmarkCommandlet.h"
+#include "Events/ISLEventHandler.h"
+#include "Events/SLContactEvent.h"
+#include "Events/SLEventPool.h"
+#include "SLIdGenerator.h"
+#include "Ids.h"
+#include "Misc/Parse.h"
+
+// Ctor
+USLEventBenchmarkCommandlet::USLEventBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Run the benchmark
+int32 USLEventBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumEvents = 200000;
+	int32 NumRuns = 3;
+	FParse::Value(*Params, TEXT("num="), NumEvents);
+	FParse::Value(*Params, TEXT("runs="), NumRuns);
+	NumEvents = FMath::Max(NumEvents, 1);
+	NumRuns = FMath::Max(NumRuns, 1);
+
+	// The events are published like in the event logger (delegate call, stored until the end of the episode)
+	TArray<TSharedPtr<ISLEvent>> FinishedEvents;
+	FSLEventSignature OnSemanticEvent;
+	OnSemanticEvent.BindLambda([&FinishedEvents](TSharedPtr<ISLEvent> Event) { FinishedEvents.Add(Event); });
+
+	const FSLEntityHandle Item1 = MakeShareable(new FSLEntity());
+	const FSLEntityHandle Item2 = MakeShareable(new FSLEntity());
+
+	// Warm up the id generator
+	FSLIdGenerator::GetInstance()->NewId();
+
+	for (int32 Run = 0; Run < NumRuns; ++Run)
+	{
+		// Heap allocated events with ids generated on the spot
+		FinishedEvents.Reset(NumEvents);
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Idx = 0; Idx < NumEvents; ++Idx)
+		{
+			OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLContactEvent(
+				FIds::NewGuidInBase64Url(), Idx, Idx + 1.f, Idx, Item1, Item2)));
+		}
+		const double HeapPublishTime = FPlatformTime::Seconds() - StartTime;
+		StartTime = FPlatformTime::Seconds();
+		FinishedEvents.Empty();
+		const double HeapFreeTime = FPlatformTime::Seconds() - StartTime;
+
+		// Pooled events with pre-generated ids
+		TSLEventPool<FSLContactEvent> EventPool;
+		FinishedEvents.Reset(NumEvents);
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Idx = 0; Idx < NumEvents; ++Idx)
+		{
+			OnSemanticEvent.ExecuteIfBound(EventPool.Create(
+				FSLIdGenerator::GetInstance()->NewId(), Idx, Idx + 1.f, Idx, Item1, Item2));
+		}
+		const double PoolPublishTime = FPlatformTime::Seconds() - StartTime;
+		StartTime = FPlatformTime::Seconds();
+		FinishedEvents.Empty();
+		const double PoolFreeTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogSL, Display, TEXT("%s::%d Run %d, %d events: heap %.1f ev/ms (free %.2f ms), pooled %.1f ev/ms (free %.2f ms), speedup x%.2f.."),
+			*FString(__func__), __LINE__, Run, NumEvents,
+			NumEvents / (HeapPublishTime * 1000.0), HeapFreeTime * 1000.0,
+			NumEvents / (PoolPublishTime * 1000.0), PoolFreeTime * 1000.0,
+			HeapPublishTime / FMath::Max(PoolPublishTime, SMALL_NUMBER));
+	}
+
+	FSLIdGenerator::DeleteInstance();
+	return 0;
+}
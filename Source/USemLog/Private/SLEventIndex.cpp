@@ -0,0 +1,336 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLEventIndex.h"
+#include "Events/ISLEvent.h"
+#include "Misc/ScopeRWLock.h"
+#include "HAL/FileManager.h"
+
+/* Interval tree */
+// Insert the interval of the entry
+void FSLEventIntervalTree::Insert(float Start, float End, int32 Entry)
+{
+	const int32 NewIdx = Nodes.Add(FNode{ Start, End, End, Entry, INDEX_NONE, INDEX_NONE, 1 });
+	Root = Insert(Root, NewIdx);
+}
+
+// Entries of the intervals overlapping [T0, T1]
+void FSLEventIntervalTree::Query(float T0, float T1, TArray<int32>& OutEntries) const
+{
+	Query(Root, T0, T1, OutEntries);
+}
+
+// Insert the node in the subtree, returns the new subtree root
+int32 FSLEventIntervalTree::Insert(int32 InRoot, int32 NewIdx)
+{
+	if (InRoot == INDEX_NONE)
+	{
+		return NewIdx;
+	}
+
+	// Ordered by start time, equal start times by insertion order
+	const FNode& New = Nodes[NewIdx];
+	const FNode& Node = Nodes[InRoot];
+	if (New.Start < Node.Start || (New.Start == Node.Start && New.Entry < Node.Entry))
+	{
+		const int32 Left = Insert(Node.Left, NewIdx);
+		Nodes[InRoot].Left = Left;
+	}
+	else
+	{
+		const int32 Right = Insert(Node.Right, NewIdx);
+		Nodes[InRoot].Right = Right;
+	}
+	Update(InRoot);
+	return Rebalance(InRoot);
+}
+
+// Query the subtree
+void FSLEventIntervalTree::Query(int32 InRoot, float T0, float T1, TArray<int32>& OutEntries) const
+{
+	// No interval of the subtree ends after the query start
+	if (InRoot == INDEX_NONE || Nodes[InRoot].MaxEnd < T0)
+	{
+		return;
+	}
+
+	const FNode& Node = Nodes[InRoot];
+	Query(Node.Left, T0, T1, OutEntries);
+
+	// The right subtree starts after the node, nothing overlaps if the node starts after the query end
+	if (Node.Start <= T1)
+	{
+		if (Node.End >= T0)
+		{
+			OutEntries.Add(Node.Entry);
+		}
+		Query(Node.Right, T0, T1, OutEntries);
+	}
+}
+
+// Recompute the height and max end of the node from its children
+void FSLEventIntervalTree::Update(int32 Idx)
+{
+	FNode& Node = Nodes[Idx];
+	Node.Height = 1 + FMath::Max(GetHeight(Node.Left), GetHeight(Node.Right));
+	Node.MaxEnd = Node.End;
+	if (Node.Left != INDEX_NONE)
+	{
+		Node.MaxEnd = FMath::Max(Node.MaxEnd, Nodes[Node.Left].MaxEnd);
+	}
+	if (Node.Right != INDEX_NONE)
+	{
+		Node.MaxEnd = FMath::Max(Node.MaxEnd, Nodes[Node.Right].MaxEnd);
+	}
+}
+
+// Rotate left, returns the new subtree root
+int32 FSLEventIntervalTree::RotateLeft(int32 Idx)
+{
+	const int32 NewRoot = Nodes[Idx].Right;
+	Nodes[Idx].Right = Nodes[NewRoot].Left;
+	Nodes[NewRoot].Left = Idx;
+	Update(Idx);
+	Update(NewRoot);
+	return NewRoot;
+}
+
+// Rotate right, returns the new subtree root
+int32 FSLEventIntervalTree::RotateRight(int32 Idx)
+{
+	const int32 NewRoot = Nodes[Idx].Left;
+	Nodes[Idx].Left = Nodes[NewRoot].Right;
+	Nodes[NewRoot].Right = Idx;
+	Update(Idx);
+	Update(NewRoot);
+	return NewRoot;
+}
+
+// Restore the AVL balance of the node, returns the new subtree root
+int32 FSLEventIntervalTree::Rebalance(int32 Idx)
+{
+	const int32 Balance = GetHeight(Nodes[Idx].Left) - GetHeight(Nodes[Idx].Right);
+	if (Balance > 1)
+	{
+		const int32 Left = Nodes[Idx].Left;
+		if (GetHeight(Nodes[Left].Left) < GetHeight(Nodes[Left].Right))
+		{
+			Nodes[Idx].Left = RotateLeft(Left);
+		}
+		return RotateRight(Idx);
+	}
+	else if (Balance < -1)
+	{
+		const int32 Right = Nodes[Idx].Right;
+		if (GetHeight(Nodes[Right].Right) < GetHeight(Nodes[Right].Left))
+		{
+			Nodes[Idx].Right = RotateRight(Right);
+		}
+		return RotateLeft(Idx);
+	}
+	return Idx;
+}
+
+
+/* Event index */
+// Add the finished event to the index (its type and entities are taken from its owl representation)
+void FSLEventIndex::Add(const ISLEvent& Event)
+{
+	Add(GetEntry(Event));
+}
+
+// Add the entry to the index
+void FSLEventIndex::Add(const FSLEventIndexEntry& Entry)
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+	AddUnlocked(Entry);
+}
+
+// Indexed data of the event (from its type name and entity ids, or from its owl representation if these are not implemented)
+FSLEventIndexEntry FSLEventIndex::GetEntry(const ISLEvent& Event)
+{
+	FSLEventIndexEntry Entry;
+	Entry.Id = Event.Id;
+	Entry.Start = Event.Start;
+	Entry.End = Event.End;
+
+	// Cheap path, no owl node is created
+	Entry.Type = Event.GetTypeName();
+	if (!Entry.Type.IsNone())
+	{
+		Event.GetEntityIds(Entry.EntityIds);
+		return Entry;
+	}
+
+	// The type is the rdf:type of the individual, the entities are the referenced individuals of the episode,
+	// except the timepoints (same representation as in the written experiment document)
+	const FSLOwlNode EventNode = Event.ToOwlNode();
+	for (const auto& Child : EventNode.ChildNodes)
+	{
+		if (Child.Attributes.Num() != 1)
+		{
+			continue;
+		}
+		const FSLOwlAttribute& Attr = Child.Attributes[0];
+		if (Child.Name.Prefix.Equals("rdf") && Child.Name.LocalName.Equals("type"))
+		{
+			Entry.Type = FName(*Attr.Value.LocalValue);
+		}
+		else if (Attr.Key.Prefix.Equals("rdf") && Attr.Key.LocalName.Equals("resource")
+			&& Attr.Value.Ns.Equals("log")
+			&& !Child.Name.LocalName.Equals("startTime")
+			&& !Child.Name.LocalName.Equals("endTime"))
+		{
+			Entry.EntityIds.AddUnique(Attr.Value.LocalValue);
+		}
+	}
+	return Entry;
+}
+
+// Events overlapping [T0, T1], optionally filtered by type (NAME_None for all) and by an involved entity (empty for all)
+void FSLEventIndex::Query(float T0, float T1, FName Type, const FString& EntityId, TArray<FSLEventIndexEntry>& OutEvents) const
+{
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+
+	// The postings list of an entity is usually shorter than the overlapping events of a type
+	if (!EntityId.IsEmpty())
+	{
+		if (const TArray<int32>* Postings = EntityPostings.Find(EntityId))
+		{
+			for (const int32 EntryIdx : *Postings)
+			{
+				if (Matches(Entries[EntryIdx], T0, T1, Type))
+				{
+					OutEvents.Add(Entries[EntryIdx]);
+				}
+			}
+		}
+		return;
+	}
+
+	TArray<int32> EntryIdxs;
+	if (Type.IsNone())
+	{
+		for (const auto& TypeTreePair : TypeTrees)
+		{
+			TypeTreePair.Value.Query(T0, T1, EntryIdxs);
+		}
+	}
+	else if (const FSLEventIntervalTree* Tree = TypeTrees.Find(Type))
+	{
+		Tree->Query(T0, T1, EntryIdxs);
+	}
+
+	OutEvents.Reserve(OutEvents.Num() + EntryIdxs.Num());
+	for (const int32 EntryIdx : EntryIdxs)
+	{
+		OutEvents.Add(Entries[EntryIdx]);
+	}
+}
+
+// All the events involving the entity
+void FSLEventIndex::QueryEntity(const FString& EntityId, TArray<FSLEventIndexEntry>& OutEvents) const
+{
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+	if (const TArray<int32>* Postings = EntityPostings.Find(EntityId))
+	{
+		for (const int32 EntryIdx : *Postings)
+		{
+			OutEvents.Add(Entries[EntryIdx]);
+		}
+	}
+}
+
+// Indexed event types
+void FSLEventIndex::GetTypes(TArray<FName>& OutTypes) const
+{
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+	TypeTrees.GetKeys(OutTypes);
+}
+
+// Number of indexed events
+int32 FSLEventIndex::Num() const
+{
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+	return Entries.Num();
+}
+
+// Remove all the events
+void FSLEventIndex::Reset()
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+	Entries.Empty();
+	TypeTrees.Empty();
+	EntityPostings.Empty();
+}
+
+// Write the index entries to file
+bool FSLEventIndex::SaveToFile(const FString& Path) const
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__func__), __LINE__, *Path);
+		return false;
+	}
+
+	// Only the entries are written, the trees and postings are rebuilt on load
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	int32 NumEntries = Entries.Num();
+	*Writer << Magic << Version << NumEntries;
+	for (const auto& Entry : Entries)
+	{
+		*Writer << const_cast<FSLEventIndexEntry&>(Entry);
+	}
+	return Writer->Close();
+}
+
+// Load an index written with an episode
+TSharedPtr<FSLEventIndex, ESPMode::ThreadSafe> FSLEventIndex::LoadFromFile(const FString& Path)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+	if (!Reader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s.."), *FString(__func__), __LINE__, *Path);
+		return nullptr;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 NumEntries = 0;
+	*Reader << Magic << Version << NumEntries;
+	if (Magic != FileMagic || Version != FileVersion || NumEntries < 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is not a compatible event index file.."), *FString(__func__), __LINE__, *Path);
+		return nullptr;
+	}
+
+	TSharedPtr<FSLEventIndex, ESPMode::ThreadSafe> Index = MakeShared<FSLEventIndex, ESPMode::ThreadSafe>();
+	Index->Entries.Reserve(NumEntries);
+	for (int32 Idx = 0; Idx < NumEntries && !Reader->IsError(); ++Idx)
+	{
+		FSLEventIndexEntry Entry;
+		*Reader << Entry;
+		Index->AddUnlocked(Entry);
+	}
+
+	if (Reader->IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is truncated.."), *FString(__func__), __LINE__, *Path);
+		return nullptr;
+	}
+	return Index;
+}
+
+// Add the entry (write lock held)
+void FSLEventIndex::AddUnlocked(const FSLEventIndexEntry& Entry)
+{
+	const int32 EntryIdx = Entries.Add(Entry);
+	TypeTrees.FindOrAdd(Entry.Type).Insert(Entry.Start, Entry.End, EntryIdx);
+	for (const FString& EntityId : Entry.EntityIds)
+	{
+		EntityPostings.FindOrAdd(EntityId).Add(EntryIdx);
+	}
+}
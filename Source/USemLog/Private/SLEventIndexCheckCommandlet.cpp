@@ -0,0 +1,182 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLEventIndexCheckCommandlet.h"
+#include "SLEventIndex.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+// Ctor
+USLEventIndexCheckCommandlet::USLEventIndexCheckCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Run the check
+int32 USLEventIndexCheckCommandlet::Main(const FString& Params)
+{
+	int32 NumEvents = 100000;
+	int32 NumChunks = 10;
+	int32 NumQueries = 1000;
+	int32 NumTypes = 8;
+	int32 NumEntities = 200;
+	float Duration = 3600.f;
+	int32 Seed = 0;
+	FParse::Value(*Params, TEXT("events="), NumEvents);
+	FParse::Value(*Params, TEXT("chunks="), NumChunks);
+	FParse::Value(*Params, TEXT("queries="), NumQueries);
+	FParse::Value(*Params, TEXT("types="), NumTypes);
+	FParse::Value(*Params, TEXT("entities="), NumEntities);
+	FParse::Value(*Params, TEXT("duration="), Duration);
+	FParse::Value(*Params, TEXT("seed="), Seed);
+	NumEvents = FMath::Max(NumEvents, 1);
+	NumChunks = FMath::Clamp(NumChunks, 1, NumEvents);
+	NumQueries = FMath::Max(NumQueries, 1);
+	NumTypes = FMath::Max(NumTypes, 1);
+	NumEntities = FMath::Max(NumEntities, 2);
+	Duration = FMath::Max(Duration, 1.f);
+
+	TArray<FName> Types;
+	for (int32 Idx = 0; Idx < NumTypes; ++Idx)
+	{
+		Types.Add(FName(*FString::Printf(TEXT("BenchEventType%d"), Idx)));
+	}
+
+	FRandomStream Stream(Seed);
+	FSLEventIndex EventIndex;
+	TArray<FSLEventIndexEntry> AllEntries;
+	AllEntries.Reserve(NumEvents);
+	int32 NumMismatches = 0;
+	int64 NumResults = 0;
+	double IndexTime = 0.0;
+	double LinearTime = 0.0;
+	TArray<FSLEventIndexEntry> IndexResults;
+	TArray<FString> IndexIds;
+	TArray<FString> LinearIds;
+	const int32 ChunkSize = FMath::DivideAndRoundUp(NumEvents, NumChunks);
+	for (int32 Chunk = 0; Chunk < NumChunks && AllEntries.Num() < NumEvents; ++Chunk)
+	{
+		// Events are added incrementally, mostly short ones with a few long lasting ones (e.g. supported by)
+		const int32 ChunkEnd = FMath::Min(AllEntries.Num() + ChunkSize, NumEvents);
+		while (AllEntries.Num() < ChunkEnd)
+		{
+			FSLEventIndexEntry& Entry = AllEntries.AddDefaulted_GetRef();
+			Entry.Id = FString::Printf(TEXT("BenchEvent%d"), AllEntries.Num() - 1);
+			Entry.Type = Types[Stream.RandHelper(Types.Num())];
+			Entry.Start = Stream.FRandRange(0.f, Duration);
+			const float Length = Stream.FRand() < 0.05f ? Stream.FRandRange(0.f, Duration * 0.25f) : Stream.FRandRange(0.f, 5.f);
+			Entry.End = Entry.Start + Length;
+			Entry.EntityIds.AddUnique(FString::Printf(TEXT("BenchEntity%d"), Stream.RandHelper(NumEntities)));
+			Entry.EntityIds.AddUnique(FString::Printf(TEXT("BenchEntity%d"), Stream.RandHelper(NumEntities)));
+			EventIndex.Add(Entry);
+		}
+
+		// Random windows, a third of them filtered by type, a third by entity
+		const int32 NumChunkQueries = FMath::Max(NumQueries / NumChunks, 1);
+		for (int32 QueryIdx = 0; QueryIdx < NumChunkQueries; ++QueryIdx)
+		{
+			const float T0 = Stream.FRandRange(-10.f, Duration);
+			const float T1 = T0 + (Stream.FRand() < 0.1f ? Stream.FRandRange(0.f, Duration) : Stream.FRandRange(0.f, 30.f));
+			const int32 Filter = Stream.RandHelper(3);
+			const FName Type = Filter == 1 ? Types[Stream.RandHelper(Types.Num())] : NAME_None;
+			const FString EntityId = Filter == 2 ? FString::Printf(TEXT("BenchEntity%d"), Stream.RandHelper(NumEntities)) : FString();
+
+			IndexResults.Reset();
+			double StartTime = FPlatformTime::Seconds();
+			EventIndex.Query(T0, T1, Type, EntityId, IndexResults);
+			IndexTime += FPlatformTime::Seconds() - StartTime;
+
+			LinearIds.Reset();
+			StartTime = FPlatformTime::Seconds();
+			for (const FSLEventIndexEntry& Entry : AllEntries)
+			{
+				if (Entry.Start <= T1 && Entry.End >= T0
+					&& (Type.IsNone() || Entry.Type == Type)
+					&& (EntityId.IsEmpty() || Entry.EntityIds.Contains(EntityId)))
+				{
+					LinearIds.Add(Entry.Id);
+				}
+			}
+			LinearTime += FPlatformTime::Seconds() - StartTime;
+
+			// The result order is not part of the query contract
+			IndexIds.Reset();
+			for (const FSLEventIndexEntry& Entry : IndexResults)
+			{
+				IndexIds.Add(Entry.Id);
+			}
+			IndexIds.Sort();
+			LinearIds.Sort();
+			NumResults += LinearIds.Num();
+			if (IndexIds != LinearIds)
+			{
+				NumMismatches++;
+				UE_LOG(LogSL, Error, TEXT("%s::%d Mismatch for [%.3f, %.3f] type=%s entity=%s: index %d events, linear scan %d events.."),
+					*FString(__func__), __LINE__, T0, T1, *Type.ToString(), *EntityId, IndexIds.Num(), LinearIds.Num());
+			}
+		}
+		UE_LOG(LogSL, Display, TEXT("%s::%d Chunk %d: %d events indexed, %d queries checked.."),
+			*FString(__func__), __LINE__, Chunk, EventIndex.Num(), NumChunkQueries);
+	}
+
+	// Save and load the index, every type and entity has to return the same events as before
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("SLEventIndexCheck_EI.bin");
+	TSharedPtr<FSLEventIndex, ESPMode::ThreadSafe> LoadedIndex;
+	if (EventIndex.SaveToFile(Path))
+	{
+		LoadedIndex = FSLEventIndex::LoadFromFile(Path);
+		IFileManager::Get().Delete(*Path);
+	}
+	if (!LoadedIndex.IsValid() || LoadedIndex->Num() != EventIndex.Num())
+	{
+		NumMismatches++;
+		UE_LOG(LogSL, Error, TEXT("%s::%d Save/load round trip through %s failed.."), *FString(__func__), __LINE__, *Path);
+	}
+	else
+	{
+		auto GetSortedIds = [](const FSLEventIndex& Index, FName Type, const FString& EntityId, TArray<FString>& OutIds)
+		{
+			TArray<FSLEventIndexEntry> Results;
+			Index.Query(-BIG_NUMBER, BIG_NUMBER, Type, EntityId, Results);
+			OutIds.Reset();
+			for (const FSLEventIndexEntry& Entry : Results)
+			{
+				OutIds.Add(Entry.Id);
+			}
+			OutIds.Sort();
+		};
+
+		TArray<FName> IndexedTypes;
+		TArray<FName> LoadedTypes;
+		EventIndex.GetTypes(IndexedTypes);
+		LoadedIndex->GetTypes(LoadedTypes);
+		int32 NumRoundTripMismatches = LoadedTypes.Num() == IndexedTypes.Num() ? 0 : 1;
+		for (const FName& Type : Types)
+		{
+			GetSortedIds(EventIndex, Type, FString(), LinearIds);
+			GetSortedIds(*LoadedIndex, Type, FString(), IndexIds);
+			NumRoundTripMismatches += IndexIds == LinearIds ? 0 : 1;
+		}
+		for (int32 Idx = 0; Idx < NumEntities; ++Idx)
+		{
+			const FString EntityId = FString::Printf(TEXT("BenchEntity%d"), Idx);
+			GetSortedIds(EventIndex, NAME_None, EntityId, LinearIds);
+			GetSortedIds(*LoadedIndex, NAME_None, EntityId, IndexIds);
+			NumRoundTripMismatches += IndexIds == LinearIds ? 0 : 1;
+		}
+		NumMismatches += NumRoundTripMismatches;
+		UE_LOG(LogSL, Display, TEXT("%s::%d Save/load round trip: %d events, %d types, %d mismatches.."),
+			*FString(__func__), __LINE__, LoadedIndex->Num(), LoadedTypes.Num(), NumRoundTripMismatches);
+	}
+
+	const int32 NumChecked = FMath::Max(NumQueries / NumChunks, 1) * NumChunks;
+	UE_LOG(LogSL, Display, TEXT("%s::%d %d events, %d queries (%lld results), %d mismatches; index %.3f us/query, linear scan %.3f us/query, speedup x%.2f.."),
+		*FString(__func__), __LINE__, EventIndex.Num(), NumChecked, NumResults, NumMismatches,
+		IndexTime * 1e6 / NumChecked, LinearTime * 1e6 / NumChecked, LinearTime / FMath::Max(IndexTime, SMALL_NUMBER));
+	return NumMismatches == 0 ? 0 : 1;
+}
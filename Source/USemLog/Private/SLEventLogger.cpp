@@ -20,6 +20,9 @@
 #include "SLPickAndPlaceListener.h"
 #include "SLContainerListener.h"
 #include "SLGoogleCharts.h"
+#include "SLTimelineWriter.h"
+#include "SLEventIndex.h"
+#include "SLLivePublisher.h"
 
 // UUtils
 #include "Ids.h"
@@ -42,6 +45,8 @@ USLEventLogger::USLEventLogger()
 	bIsStarted = false;
 	bIsFinished = false;
 	bWriteTimelines = false;
+	bLogContactEvents = false;
+	bLogSupportedByEvents = false;
 }
 
 // Destructor
@@ -71,11 +76,14 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 		bWriteTimelines = bInWriteTimelines;
 
 		// Init the semantic mappings (if not already init)
-		FSLEntitiesManager::GetInstance()->Init(GetWorld());
+		FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 
 		// Create the document template
 		ExperimentDoc = CreateEventsDocTemplate(TemplateType, EpisodeId);
 
+		// Index of the finished events, can be queried during the episode
+		EventIndex = MakeShared<FSLEventIndex, ESPMode::ThreadSafe>();
+
 		// TODO create one handler for each event type
 		// bind all the objects to one handler
 		// Instead of Init -> AddParent
@@ -83,34 +91,11 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 		// rename FSLContactEventHandler,FSLSupportedByEventHandler,FSLFixationGraspEventHandler -> Events
 
 		// Init all contact trigger handlers
+		bLogContactEvents = bInLogContactEvents;
+		bLogSupportedByEvents = bInLogSupportedByEvents;
 		for (TObjectIterator<UShapeComponent> Itr; Itr; ++Itr)
 		{
-			//if (Itr->GetClass()->ImplementsInterface(USLContactShapeInterface::StaticClass()))
-			if (ISLContactShapeInterface* ContactShape = Cast<ISLContactShapeInterface>(*Itr))
-			{
-				if (IsValidAndAnnotated(*Itr))
-				{
-					ContactShape->Init(bInLogSupportedByEvents);
-
-					ContactShapes.Emplace(ContactShape);
-
-					if (bInLogContactEvents)
-					{
-						// Create a contact event handler 
-						TSharedPtr<FSLContactEventHandler> CEHandler = MakeShareable(new FSLContactEventHandler());
-						CEHandler->Init(*Itr);
-						if (CEHandler->IsInit())
-						{
-							EventHandlers.Add(CEHandler);
-						}
-						else
-						{
-							UE_LOG(LogTemp, Warning, TEXT("%s::%d Handler could not be init with parent %s.."),
-								*FString(__func__), __LINE__, *Itr->GetName());
-						}
-					}
-				}
-			}
+			AddContactShape(*Itr);
 		}
 
 		// Init fixation or normal grasp handlers
@@ -119,7 +104,7 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 			// Init all grasp listeners
 			for (TObjectIterator<USLManipulatorListener> Itr; Itr; ++Itr)
 			{
-				if (IsValidAndAnnotated(*Itr))
+				if (!GraspListeners.Contains(*Itr) && IsValidAndAnnotated(*Itr))
 				{
 					if (Itr->Init(bInLogGraspEvents, bInLogContactEvents))
 					{
@@ -182,7 +167,7 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 			// Init all reach listeners
 			for (TObjectIterator<USLReachListener> Itr; Itr; ++Itr)
 			{
-				if (IsValidAndAnnotated(*Itr))
+				if (!ReachListeners.Contains(*Itr) && IsValidAndAnnotated(*Itr))
 				{
 					if (Itr->Init())
 					{
@@ -206,7 +191,7 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 			// Init all container manipulation listeners
 			for (TObjectIterator<USLContainerListener> Itr; Itr; ++Itr)
 			{
-				if (IsValidAndAnnotated(*Itr))
+				if (!ContainerListeners.Contains(*Itr) && IsValidAndAnnotated(*Itr))
 				{
 					if (Itr->Init())
 					{
@@ -233,7 +218,7 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 			// Init all pick and place listeners
 			for (TObjectIterator<USLPickAndPlaceListener> Itr; Itr; ++Itr)
 			{
-				if (IsValidAndAnnotated(*Itr))
+				if (!PickAndPlaceListeners.Contains(*Itr) && IsValidAndAnnotated(*Itr))
 				{
 					if (Itr->Init())
 					{
@@ -285,6 +270,89 @@ void USLEventLogger::Init(ESLOwlExperimentTemplate TemplateType,
 	}
 }
 
+// Init the contact shape and its event handler (false if the component is not an annotated contact shape)
+bool USLEventLogger::AddContactShape(UShapeComponent* ShapeComp)
+{
+	//if (ShapeComp->GetClass()->ImplementsInterface(USLContactShapeInterface::StaticClass()))
+	ISLContactShapeInterface* ContactShape = Cast<ISLContactShapeInterface>(ShapeComp);
+	if (!ContactShape || !IsValidAndAnnotated(ShapeComp))
+	{
+		return false;
+	}
+
+	// Already listening, the delegates would be bound twice
+	if (ContactShapes.Contains(ContactShape) || ContactShapeHandlers.Contains(ShapeComp))
+	{
+		return false;
+	}
+
+	ContactShape->Init(bLogSupportedByEvents);
+	ContactShapes.Emplace(ContactShape);
+
+	if (bLogContactEvents)
+	{
+		// Create a contact event handler 
+		TSharedPtr<FSLContactEventHandler> CEHandler = MakeShareable(new FSLContactEventHandler());
+		CEHandler->Init(ShapeComp);
+		if (CEHandler->IsInit())
+		{
+			EventHandlers.Add(CEHandler);
+			ContactShapeHandlers.Emplace(ShapeComp, CEHandler);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Handler could not be init with parent %s.."),
+				*FString(__func__), __LINE__, *ShapeComp->GetName());
+		}
+	}
+	return true;
+}
+
+// Init and start the listeners of an actor registered at runtime
+void USLEventLogger::AddActorListeners(AActor* Actor)
+{
+	if (!bIsInit)
+	{
+		return;
+	}
+
+	for (UActorComponent* Comp : Actor->GetComponents())
+	{
+		UShapeComponent* ShapeComp = Cast<UShapeComponent>(Comp);
+		if (ShapeComp && AddContactShape(ShapeComp) && bIsStarted)
+		{
+			if (TSharedPtr<ISLEventHandler>* Handler = ContactShapeHandlers.Find(ShapeComp))
+			{
+				(*Handler)->Start();
+				(*Handler)->OnSemanticEvent.BindUObject(this, &USLEventLogger::OnSemanticEvent);
+			}
+			Cast<ISLContactShapeInterface>(ShapeComp)->Start();
+		}
+	}
+}
+
+// Finish the listeners of a destroyed actor, their pending events end at the given time
+void USLEventLogger::RemoveActorListeners(AActor* Actor, float Time)
+{
+	for (UActorComponent* Comp : Actor->GetComponents())
+	{
+		if (ISLContactShapeInterface* ContactShape = Cast<ISLContactShapeInterface>(Comp))
+		{
+			if (ContactShapes.Remove(ContactShape) > 0)
+			{
+				// Publishes the delayed events first
+				ContactShape->Finish(true);
+			}
+			TSharedPtr<ISLEventHandler> Handler;
+			if (ContactShapeHandlers.RemoveAndCopyValue(Comp, Handler))
+			{
+				Handler->Finish(Time);
+				EventHandlers.Remove(Handler);
+			}
+		}
+	}
+}
+
 // Check if the component is valid in the world and has a semantically annotated owner
 bool USLEventLogger::IsValidAndAnnotated(UActorComponent* Comp) const
 {
@@ -297,7 +365,7 @@ bool USLEventLogger::IsValidAndAnnotated(UActorComponent* Comp) const
 	}
 
 	// Skip objects that do not have a semantically annotated ancestor
-	if (!FSLEntitiesManager::GetInstance()->GetValidAncestor(Comp))
+	if (!FSLEntitiesManager::GetInstance(GetWorld())->GetValidAncestor(Comp))
 	{
 		//UE_LOG(LogTemp, Error, TEXT("%s::%d %s has no semantically annotated ancestor.."),
 		//	*FString(__func__), __LINE__, *Comp->GetName());
@@ -368,6 +436,7 @@ void USLEventLogger::Finish(const float Time, bool bForced)
 			EvHandler->Finish(Time, bForced);
 		}
 		EventHandlers.Empty();
+		ContactShapeHandlers.Empty();
 
 		// Finish semantic overlap events publishing
 		for (auto& SLContactShape : ContactShapes)
@@ -429,17 +498,45 @@ void USLEventLogger::OnSemanticEvent(TSharedPtr<ISLEvent> Event)
 	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("%s::%d %s"), *FString(__func__), __LINE__, *Event->ToString()));
 	//UE_LOG(LogTemp, Error, TEXT(">> %s::%d %s"), *FString(__func__), __LINE__, *Event->ToString());
 	FinishedEvents.Add(Event);
+
+	// The index entry (type and entity ids, no owl node) is only built once for the index and the live subscribers
+	const bool bPublishLive = FSLLivePublisher::GetInstance()->IsRunning();
+	if (EventIndex.IsValid() || bPublishLive)
+	{
+		const FSLEventIndexEntry Entry = FSLEventIndex::GetEntry(*Event);
+		if (EventIndex.IsValid())
+		{
+			EventIndex->Add(Entry);
+		}
+		if (bPublishLive)
+		{
+			FSLLivePublisher::GetInstance()->PublishEvent(EpisodeId, Entry);
+		}
+	}
 }
 
 // Write to file
 bool USLEventLogger::WriteToFile()
 {
-	// Write events timelines to file
+	// Write events timelines to file (the html charts cannot render large event sets, the columnar timelines are always written)
 	if (bWriteTimelines)
 	{
-		FSLGoogleChartsParameters Params;
-		Params.bTooltips = true;
-		FSLGoogleCharts::WriteTimelines(FinishedEvents, LogDirectory, EpisodeId, Params);
+		FSLTimelineWriter::WriteTimelines(FinishedEvents, LogDirectory, EpisodeId);
+		if (FinishedEvents.Num() <= FSLTimelineWriter::MaxHtmlEvents)
+		{
+			FSLGoogleChartsParameters Params;
+			Params.bTooltips = true;
+			FSLGoogleCharts::WriteTimelines(FinishedEvents, LogDirectory, EpisodeId, Params);
+		}
+	}
+
+	// Write the event index (load it offline with FSLEventIndex::LoadFromFile)
+	if (EventIndex.IsValid())
+	{
+		FString IndexFilePath = FPaths::ProjectDir() + "/SemLog/" +
+			LogDirectory + TEXT("/Episodes/") + EpisodeId + TEXT("_EI.bin");
+		FPaths::RemoveDuplicateSlashes(IndexFilePath);
+		EventIndex->SaveToFile(IndexFilePath);
 	}
 
 	if (!ExperimentDoc.IsValid())
@@ -0,0 +1,87 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLIdGenerator.h"
+#include "Ids.h"
+#include "Misc/ScopeLock.h"
+
+TUniquePtr<FSLIdGenerator> FSLIdGenerator::StaticInstance;
+
+// Generate the batch
+void FSLIdBatchWorker::DoWork()
+{
+	Ids.Reset(BatchSize);
+	for (int32 Idx = 0; Idx < BatchSize; ++Idx)
+	{
+		Ids.Emplace(FIds::NewGuidInBase64Url());
+	}
+}
+
+// Constructor
+FSLIdGenerator::FSLIdGenerator() : ReadyIdx(0), bIsBatchPending(false)
+{
+	// Prepare the first batch right away
+	BatchWorker = new FAsyncTask<FSLIdBatchWorker>();
+	RequestNextBatch();
+}
+
+// Destructor
+FSLIdGenerator::~FSLIdGenerator()
+{
+	if (BatchWorker)
+	{
+		BatchWorker->EnsureCompletion();
+		delete BatchWorker;
+		BatchWorker = nullptr;
+	}
+}
+
+// Get singleton
+FSLIdGenerator* FSLIdGenerator::GetInstance()
+{
+	if (!StaticInstance.IsValid())
+	{
+		StaticInstance.Reset(new FSLIdGenerator());
+	}
+	return StaticInstance.Get();
+}
+
+// Delete instance
+void FSLIdGenerator::DeleteInstance()
+{
+	StaticInstance.Reset();
+}
+
+// Get a new unique id (thread safe)
+FString FSLIdGenerator::NewId()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (ReadyIdx >= ReadyIds.Num())
+	{
+		// Take over the prepared batch (generated on this thread if the worker did not start yet)
+		if (!bIsBatchPending)
+		{
+			RequestNextBatch();
+		}
+		BatchWorker->EnsureCompletion();
+		Swap(ReadyIds, BatchWorker->GetTask().Ids);
+		ReadyIdx = 0;
+		bIsBatchPending = false;
+	}
+
+	// Prepare the next batch while the current one is half used
+	if (!bIsBatchPending && ReadyIdx >= ReadyIds.Num() / 2)
+	{
+		RequestNextBatch();
+	}
+
+	return MoveTemp(ReadyIds[ReadyIdx++]);
+}
+
+// Start generating the next batch
+void FSLIdGenerator::RequestNextBatch()
+{
+	BatchWorker->GetTask().BatchSize = BatchSize;
+	BatchWorker->StartBackgroundTask();
+	bIsBatchPending = true;
+}
@@ -0,0 +1,124 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLImageStatsCommandlet.h"
+#include "SLImageStats.h"
+#include "Misc/Parse.h"
+
+// Ctor
+USLImageStatsCommandlet::USLImageStatsCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Run the checks
+int32 USLImageStatsCommandlet::Main(const FString& Params)
+{
+	int32 Width = 1920;
+	int32 Height = 1080;
+	int32 NumColors = 8;
+	int32 NumRuns = 3;
+	FParse::Value(*Params, TEXT("width="), Width);
+	FParse::Value(*Params, TEXT("height="), Height);
+	FParse::Value(*Params, TEXT("colors="), NumColors);
+	FParse::Value(*Params, TEXT("runs="), NumRuns);
+	Width = FMath::Max(Width, 1);
+	Height = FMath::Max(Height, 1);
+	NumColors = FMath::Max(NumColors, 1);
+	NumRuns = FMath::Max(NumRuns, 1);
+
+	int32 NumErrors = 0;
+	FRandomStream Rand(42);
+	for (int32 Run = 0; Run < NumRuns; ++Run)
+	{
+		// Distinct mask colors, the last one is never in the image
+		TArray<FColor> Colors;
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			Colors.Emplace(FColor(CIdx * 29 + 1, 255 - CIdx * 17, CIdx * 7 + 3, 255));
+		}
+
+		// Mask like image, black background with rectangles of the colors and some noise
+		TArray<FColor> Image;
+		Image.Init(FColor::Black, Width * Height);
+		for (int32 CIdx = 0; CIdx < NumColors - 1; ++CIdx)
+		{
+			const int32 X0 = Rand.RandRange(0, Width - 1);
+			const int32 Y0 = Rand.RandRange(0, Height - 1);
+			const int32 X1 = FMath::Min(X0 + Rand.RandRange(1, Width / 2 + 1), Width);
+			const int32 Y1 = FMath::Min(Y0 + Rand.RandRange(1, Height / 2 + 1), Height);
+			for (int32 Y = Y0; Y < Y1; ++Y)
+			{
+				for (int32 X = X0; X < X1; ++X)
+				{
+					Image[Y * Width + X] = Colors[CIdx];
+				}
+			}
+		}
+		for (int32 Idx = 0; Idx < Image.Num() / 100; ++Idx)
+		{
+			Image[Rand.RandRange(0, Image.Num() - 1)] = FColor(Rand.RandRange(0, 255), Rand.RandRange(0, 255), Rand.RandRange(0, 255), 255);
+		}
+
+		// Counts
+		TArray<int32> Counts, ScalarCounts;
+		double StartTime = FPlatformTime::Seconds();
+		FSLImageStats::CountColors(Image, Colors, Counts);
+		const double CountTime = FPlatformTime::Seconds() - StartTime;
+		StartTime = FPlatformTime::Seconds();
+		FSLImageStats::CountColorsScalar(Image, Colors, ScalarCounts);
+		const double ScalarCountTime = FPlatformTime::Seconds() - StartTime;
+		if (Counts != ScalarCounts)
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Run %d, color counts differ from the scalar version.."), *FString(__func__), __LINE__, Run);
+			NumErrors++;
+		}
+
+		// Counts, bounding boxes and centroids
+		TArray<FSLColorStats> Stats, ScalarStats;
+		StartTime = FPlatformTime::Seconds();
+		FSLImageStats::ComputeColorStats(Image, Width, Colors, Stats);
+		const double StatsTime = FPlatformTime::Seconds() - StartTime;
+		StartTime = FPlatformTime::Seconds();
+		FSLImageStats::ComputeColorStatsScalar(Image, Width, Colors, ScalarStats);
+		const double ScalarStatsTime = FPlatformTime::Seconds() - StartTime;
+		if (Stats != ScalarStats)
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Run %d, color stats differ from the scalar version.."), *FString(__func__), __LINE__, Run);
+			NumErrors++;
+		}
+
+		// The histogram has to agree with the counts
+		TMap<FColor, int32> Histogram;
+		FSLImageStats::ComputeHistogram(Image, Histogram);
+		int32 HistogramTotal = 0;
+		for (const auto& Pair : Histogram)
+		{
+			HistogramTotal += Pair.Value;
+		}
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			if (Histogram.FindRef(Colors[CIdx]) != ScalarCounts[CIdx])
+			{
+				UE_LOG(LogSL, Error, TEXT("%s::%d Run %d, histogram count of color %s differs.."),
+					*FString(__func__), __LINE__, Run, *Colors[CIdx].ToString());
+				NumErrors++;
+			}
+		}
+		if (HistogramTotal != Image.Num())
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Run %d, histogram total %d differs from the number of pixels %d.."),
+				*FString(__func__), __LINE__, Run, HistogramTotal, Image.Num());
+			NumErrors++;
+		}
+
+		UE_LOG(LogSL, Display, TEXT("%s::%d Run %d, %dx%d, %d colors: count %.2f ms (scalar %.2f ms), stats %.2f ms (scalar %.2f ms), %d distinct colors.."),
+			*FString(__func__), __LINE__, Run, Width, Height, NumColors,
+			CountTime * 1000.0, ScalarCountTime * 1000.0, StatsTime * 1000.0, ScalarStatsTime * 1000.0, Histogram.Num());
+	}
+
+	return NumErrors > 0 ? 1 : 0;
+}
@@ -2,8 +2,9 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "SLItemScanner.h"
-#include "Tags.h"
+#include "SLTagCache.h"
 #include "SLContactShapeInterface.h"
+#include "SLImageStats.h"
 #include "Engine/StaticMeshActor.h"
 #include "EngineUtils.h"
 #include "Async.h"
@@ -17,6 +18,50 @@
 #include "Materials/MaterialInstanceDynamic.h"
 #include "SLMetadataLogger.h"
 #include "Engine/Light.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "RenderingThread.h"
+#include "Materials/MaterialInstance.h"
+#include "Misc/SecureHash.h"
+#include "Misc/PackageName.h"
+#include "HAL/FileManager.h"
+
+// FAsyncTask - async work done here
+void FSLScanEncodeWorker::DoWork()
+{
+	// Count how many pixels does the item occupy in the image (works with view mode mask/unlit)
+	if(ViewMode == ESLItemScannerViewMode::Mask)
+	{
+		USLItemScanner::GetColorsPixelNum(Image->Bitmap, FColor::Black, Image->BackgroundPixelNum, FColor::White, Image->ItemPixelNum);
+	}
+	else if(ViewMode == ESLItemScannerViewMode::Unlit)
+	{
+		Image->BackgroundPixelNum = USLItemScanner::GetColorPixelNum(Image->Bitmap, FColor::Black);
+		Image->ItemPixelNum = Resolution.X * Resolution.Y - Image->BackgroundPixelNum;
+	}
+
+	// The render target alpha is not used, make the image opaque
+	for (auto& C : Image->Bitmap)
+	{
+		C.A = 255;
+	}
+
+	// Compress image, the raw pixels are no longer needed
+	FImageUtils::CompressImageArray(Resolution.X, Resolution.Y, Image->Bitmap, Image->CompressedBitmap);
+	Image->Bitmap.Empty();
+
+	// Save the png locally
+	if(!Path.IsEmpty())
+	{
+		FFileHelper::SaveArrayToFile(Image->CompressedBitmap, *Path);
+	}
+
+	// Add the png to the scan cache
+	if(!CachePath.IsEmpty())
+	{
+		USLItemScanner::SaveToScanCache(CachePath, Image->CompressedBitmap);
+	}
+}
 
 // Ctor
 USLItemScanner::USLItemScanner()
@@ -30,6 +75,12 @@ USLItemScanner::USLItemScanner()
 	CurrItemIdx = INDEX_NONE;
 	ItemPixelNum = INDEX_NONE;
 	PrevViewMode = ESLItemScannerViewMode::NONE;
+	BatchSize = 0;
+	bIsTickable = false;
+	BatchFirstJobIdx = INDEX_NONE;
+	BatchNumJobs = 0;
+	bReadbackPending = false;
+	bUseScanCache = false;
 }
 
 // Dtor
@@ -43,11 +94,13 @@ USLItemScanner::~USLItemScanner()
 
 // Init scanner
 void USLItemScanner::Init(const FString& InTaskId, const FString InServerIp, uint16 InServerPort,
-		 FIntPoint InResolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally)
+		 FIntPoint InResolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally, int32 InBatchSize, bool bInUseScanCache)
 {
 	if (!bIsInit)
 	{
 		Location = InTaskId;
+		BatchSize = FMath::Max(InBatchSize, 0);
+		bUseScanCache = bInUseScanCache;
 		ViewModes = InViewModes.Array();
 		bIncludeLocally = bIncludeScansLocally;
 		Resolution = InResolution;
@@ -103,6 +156,32 @@ void USLItemScanner::Start(USLMetadataLogger* InParent)
 	if(!bIsStarted && bIsInit)
 	{
 		Parent = InParent;
+
+		// Write the already cached scans, only the rest is rendered
+		if(bUseScanCache)
+		{
+			LoadScanCache();
+			if(CachedJobs.Num() == ScanItems.Num() * ScanPoses.Num())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s::%d All scans are cached, nothing to render.."), *FString(__func__), __LINE__);
+				bIsStarted = true;
+				QuitEditor();
+				return;
+			}
+		}
+
+		// Render many scans per frame with scene captures instead of screenshots
+		if(BatchSize > 0)
+		{
+			if(!StartBatched())
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not start the batched scanning.."), *FString(__func__), __LINE__);
+				return;
+			}
+			bIsStarted = true;
+			return;
+		}
+
 		if(!SetupFirstScanItem())
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set the first item for scanning.."), *FString(__func__), __LINE__);
@@ -125,7 +204,7 @@ void USLItemScanner::Start(USLMetadataLogger* InParent)
 		RequestScreenshot();
 
 		// Create scan document
-		Parent->StartScanEntry();
+		Parent->StartScanEntry(CurrItemIdx, ScanItems[CurrItemIdx].Value, CurrPoseIdx);
 
 		bIsStarted = true;
 	}
@@ -138,6 +217,20 @@ void USLItemScanner::Finish()
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Finish"),
 			*FString(__func__), __LINE__);
+
+		// Stop the batched scanning, the render thread can still write into the images
+		bIsTickable = false;
+		if(bReadbackPending)
+		{
+			ReadbackFence.Wait();
+			bReadbackPending = false;
+		}
+		for(auto& Worker : EncodeWorkers)
+		{
+			Worker->EnsureCompletion();
+			delete Worker;
+		}
+		EncodeWorkers.Empty();
 		
 		bIsStarted = false;
 		bIsInit = false;
@@ -176,7 +269,7 @@ bool USLItemScanner::LoadScanCameraPoseActor()
 // Load scanning points
 bool USLItemScanner::LoadScanPoints()
 {
-	GenerateSphereScanPoses(128, 50.f, ScanPoses);
+	GenerateSphereScanPoses(NumScanPoses, ScanRadius, ScanPoses);
 
 	if(ScanPoses.Num() == 0)
 	{
@@ -186,12 +279,69 @@ bool USLItemScanner::LoadScanPoints()
 	return true;
 }
 
+/** Begin FTickableGameObject interface */
+// Called after ticking all actors, DeltaTime is the time passed since the last call.
+void USLItemScanner::Tick(float DeltaTime)
+{
+	// Wait until the render thread read back the images of the batch
+	if(!bReadbackPending || !ReadbackFence.IsFenceComplete())
+	{
+		return;
+	}
+	bReadbackPending = false;
+
+	// Encode the images in the background
+	StartBatchEncoding();
+
+	// Render the next view mode while the previous images are encoded
+	CurrViewModeIdx++;
+	if(ViewModes.IsValidIndex(CurrViewModeIdx))
+	{
+		ApplyBatchViewMode(ViewModes[CurrViewModeIdx]);
+		CaptureBatch();
+		return;
+	}
+
+	// All the view modes are rendered, write the scan entries
+	FinishBatch();
+
+	if(SetupNextBatch())
+	{
+		CaptureBatch();
+	}
+	else
+	{
+		// No more items, or camera scan poses
+		bIsTickable = false;
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] Finished scanning.."),
+			*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+		QuitEditor();
+	}
+}
+
+// Return if object is ready to be ticked
+bool USLItemScanner::IsTickable() const
+{
+	return bIsTickable;
+}
+
+// Return the stat id to use for this tickable
+TStatId USLItemScanner::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USLItemScanner, STATGROUP_Tickables);
+}
+/** End FTickableGameObject interface */
+
 // Load items to scan
 bool USLItemScanner::LoadScanItems(bool bWithContactShape)
 {
 	// Cache the classes that were already iterated
 	TSet<FString> ConsultedClasses;
 
+	// The tags are parsed once per world and shared with the loggers
+	FSLTagCache* TagCache = FSLTagCache::GetInstance(GetWorld());
+	TagCache->Init(GetWorld());
+
 	// Iterate all actors
 	for (TActorIterator<AActor> ActItr(GetWorld()); ActItr; ++ActItr)
 	{
@@ -201,7 +351,7 @@ bool USLItemScanner::LoadScanItems(bool bWithContactShape)
 			// Everything is hidden by default
 			AsSMA->SetActorHiddenInGame(true);
 			
-			const FString Class = FTags::GetValue(*ActItr, "SemLog", "Class");
+			const FString Class = TagCache->GetValue(*ActItr, "Class");
 
 			// Skip if class was already checked
 			if(ConsultedClasses.Contains(Class))
@@ -329,6 +479,10 @@ bool USLItemScanner::SetupNextViewMode()
 bool USLItemScanner::SetupFirstScanItem()
 {
 	CurrItemIdx = 0;
+	while(ScanItems.IsValidIndex(CurrItemIdx) && IsItemCached(CurrItemIdx))
+	{
+		CurrItemIdx++;
+	}
 	if(!ScanItems.IsValidIndex(CurrItemIdx))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Invalid item index [%ld].."), *FString(__func__), __LINE__, CurrItemIdx);
@@ -346,7 +500,10 @@ bool USLItemScanner::SetupNextItem()
 	ScanItems[CurrItemIdx].Key->GetOwner()->SetActorHiddenInGame(true);
 	
 	// Bring next item
-	CurrItemIdx++;
+	do
+	{
+		CurrItemIdx++;
+	} while(ScanItems.IsValidIndex(CurrItemIdx) && IsItemCached(CurrItemIdx));
 	if(!ScanItems.IsValidIndex(CurrItemIdx))
 	{
 		//UE_LOG(LogTemp, Warning, TEXT("%s::%d Last item [%ld] reached.."), *FString(__func__), __LINE__, CurrItemIdx-1);
@@ -361,6 +518,10 @@ bool USLItemScanner::SetupNextItem()
 bool USLItemScanner::SetupFirstScanPose()
 {
 	CurrPoseIdx = 0;
+	while(ScanPoses.IsValidIndex(CurrPoseIdx) && IsScanCached(CurrItemIdx, CurrPoseIdx))
+	{
+		CurrPoseIdx++;
+	}
 	if(!ScanPoses.IsValidIndex(CurrPoseIdx))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Invalid pose index [%ld].."), *FString(__func__), __LINE__, CurrPoseIdx);
@@ -374,7 +535,10 @@ bool USLItemScanner::SetupFirstScanPose()
 // Scan item from the next camera pose, return false if there are no more poses
 bool USLItemScanner::SetupNextScanPose()
 {
-	CurrPoseIdx++;
+	do
+	{
+		CurrPoseIdx++;
+	} while(ScanPoses.IsValidIndex(CurrPoseIdx) && IsScanCached(CurrItemIdx, CurrPoseIdx));
 	if(!ScanPoses.IsValidIndex(CurrPoseIdx))
 	{
 		//UE_LOG(LogTemp, Warning, TEXT("%s::%d Last pose [%ld] reached .."), *FString(__func__), __LINE__, CurrPoseIdx-1)
@@ -436,6 +600,12 @@ void USLItemScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 		FFileHelper::SaveArrayToFile(CompressedBitmap, *Path);
 	}
 
+	// Add the png to the scan cache
+	if(bUseScanCache)
+	{
+		SaveToScanCache(GetScanCachePath(CurrItemIdx, CurrPoseIdx, ViewModes[CurrViewModeIdx]), CompressedBitmap);
+	}
+
 	Parent->AddImageEntry(GetViewModeName(ViewModes[CurrViewModeIdx]), CompressedBitmap);
 
 	// Item and camera in position, check for other view modes
@@ -461,7 +631,7 @@ void USLItemScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 		if(SetupNextScanPose())
 		{
 			Parent->WriteScanEntry();
-			Parent->StartScanEntry();
+			Parent->StartScanEntry(CurrItemIdx, ScanItems[CurrItemIdx].Value, CurrPoseIdx);
 			RequestScreenshot();
 		}
 		else 
@@ -469,7 +639,6 @@ void USLItemScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 			if(SetupNextItem())
 			{
 				Parent->WriteScanEntry();
-				Parent->StartScanEntry();
 				// If in mask mode, apply the mask material on the current item as well
 				if(ViewModes[CurrViewModeIdx] == ESLItemScannerViewMode::Mask)
 				{
@@ -479,6 +648,7 @@ void USLItemScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 			
 				// No other scan poses found, set next item and first camera scan pose
 				SetupFirstScanPose();
+				Parent->StartScanEntry(CurrItemIdx, ScanItems[CurrItemIdx].Value, CurrPoseIdx);
 			
 				RequestScreenshot();
 			}
@@ -541,35 +711,19 @@ void USLItemScanner::CountItemPixelNum(const TArray<FColor>& Bitmap)
 }
 
 // Get the number of pixels of the given color in the image
-int32 USLItemScanner::GetColorPixelNum(const TArray<FColor>& Bitmap, const FColor& Color) const
+int32 USLItemScanner::GetColorPixelNum(const TArray<FColor>& Bitmap, const FColor& Color)
 {
-	int32 Num = 0;
-	for (const auto& C : Bitmap)
-	{
-		if(C == Color)
-		{
-			Num++;
-		}
-	}
-	return Num++;
+	return FSLImageStats::CountColor(Bitmap, Color);
 }
 
 // Get the number of pixels of the given two colors in the image
 void USLItemScanner::GetColorsPixelNum(const TArray<FColor>& Bitmap, const FColor& ColorA, int32& OutNumA, const FColor& ColorB, int32& OutNumB)
 {
-	OutNumA = 0;
-	OutNumB = 0;
-	for (const auto& C : Bitmap)
-	{
-		if(C == ColorA)
-		{
-			OutNumA++;
-		}
-		else if(C == ColorB)
-		{
-			OutNumB++;
-		}
-	}
+	// Both colors are counted in one pass
+	TArray<int32> Counts;
+	FSLImageStats::CountColors(Bitmap, TArray<FColor>{ ColorA, ColorB }, Counts);
+	OutNumA = Counts[0];
+	OutNumB = Counts[1];
 }
 
 // Apply view mode
@@ -849,6 +1003,442 @@ FString USLItemScanner::GetViewModeName(ESLItemScannerViewMode Mode) const
 	}
 }
 
+// Start scanning in batches with scene captures
+bool USLItemScanner::StartBatched()
+{
+	if(!SetupBatchCaptures())
+	{
+		return false;
+	}
+
+	PlaceItemsInCells();
+
+	// Only the uncached scans are rendered
+	PendingJobs.Empty(ScanItems.Num() * ScanPoses.Num() - CachedJobs.Num());
+	for(int32 JobIdx = 0; JobIdx < ScanItems.Num() * ScanPoses.Num(); ++JobIdx)
+	{
+		if(!CachedJobs.Contains(JobIdx))
+		{
+			PendingJobs.Emplace(JobIdx);
+		}
+	}
+
+	// Hide default pawn
+	GetWorld()->GetFirstPlayerController()->GetPawnOrSpectator()->SetActorHiddenInGame(true);
+
+	if(!SetupNextBatch())
+	{
+		return false;
+	}
+
+	// Start the dominoes, the rest is driven from tick
+	CaptureBatch();
+	bIsTickable = true;
+	return true;
+}
+
+// Move every item in its own isolated cell
+void USLItemScanner::PlaceItemsInCells()
+{
+	// The cells are far enough apart so the items never overlap the camera poses of the neighbours
+	const float CellSize = 2.f * (ScanRadius + LengthLimit);
+	const int32 NumCols = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(ScanItems.Num())));
+
+	CellLocations.Empty(ScanItems.Num());
+	for(int32 Idx = 0; Idx < ScanItems.Num(); ++Idx)
+	{
+		const FVector CellLoc((Idx % NumCols) * CellSize, (Idx / NumCols) * CellSize, 0.f);
+		CellLocations.Emplace(CellLoc);
+		ScanItems[Idx].Key->GetOwner()->SetActorLocation(CellLoc);
+		ScanItems[Idx].Key->GetOwner()->SetActorHiddenInGame(false);
+	}
+}
+
+// Create the scene captures and their render targets
+bool USLItemScanner::SetupBatchCaptures()
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Name = TEXT("SL_ScanCaptures");
+	CaptureActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), SpawnParams);
+	if(!CaptureActor)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not spawn the scene captures owner.."), *FString(__func__), __LINE__);
+		return false;
+	}
+#if WITH_EDITOR
+	CaptureActor->SetActorLabel(FString(TEXT("SL_ScanCaptures")));
+#endif // WITH_EDITOR
+
+	for(int32 Idx = 0; Idx < BatchSize; ++Idx)
+	{
+		UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+		RenderTarget->InitCustomFormat(Resolution.X, Resolution.Y, PF_B8G8R8A8, false);
+		RenderTargets.Emplace(RenderTarget);
+
+		// Captures are triggered manually, and only render the scanned item
+		USceneCaptureComponent2D* Capture = NewObject<USceneCaptureComponent2D>(CaptureActor);
+		Capture->bCaptureEveryFrame = false;
+		Capture->bCaptureOnMovement = false;
+		Capture->PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList;
+		Capture->CaptureSource = ESceneCaptureSource::SCS_FinalColorLDR;
+		Capture->TextureTarget = RenderTarget;
+		Capture->RegisterComponent();
+		Captures.Emplace(Capture);
+	}
+
+	// Every scan of the batch keeps its images of all the view modes until the entries are written
+	BatchImages.SetNum(BatchSize * ViewModes.Num());
+	return true;
+}
+
+// Set the jobs of the next batch, return false if there are no more scans
+bool USLItemScanner::SetupNextBatch()
+{
+	const int32 NumJobs = PendingJobs.Num();
+	BatchFirstJobIdx = BatchFirstJobIdx == INDEX_NONE ? 0 : BatchFirstJobIdx + BatchNumJobs;
+	if(BatchFirstJobIdx >= NumJobs)
+	{
+		BatchNumJobs = 0;
+		return false;
+	}
+	BatchNumJobs = FMath::Min(BatchSize, NumJobs - BatchFirstJobIdx);
+
+	// Start with the first view mode
+	CurrViewModeIdx = 0;
+	ApplyBatchViewMode(ViewModes[CurrViewModeIdx]);
+	return true;
+}
+
+// Apply the view mode on the scene captures
+void USLItemScanner::ApplyBatchViewMode(ESLItemScannerViewMode Mode)
+{
+	// Get the console variable for switching buffer views
+	static IConsoleVariable* BufferVisTargetCV = IConsoleManager::Get().FindConsoleVariable(TEXT("r.BufferVisualizationTarget"));
+
+	ApplyBatchMaskMaterial(Mode == ESLItemScannerViewMode::Mask);
+
+	const bool bLighting = Mode == ESLItemScannerViewMode::Lit
+		|| Mode == ESLItemScannerViewMode::Depth || Mode == ESLItemScannerViewMode::Normal;
+	const bool bBufferVis = Mode == ESLItemScannerViewMode::Depth || Mode == ESLItemScannerViewMode::Normal;
+	if(Mode == ESLItemScannerViewMode::Depth)
+	{
+		BufferVisTargetCV->Set(*FString("SLSceneDepthToCameraPlane"));
+	}
+	else if(Mode == ESLItemScannerViewMode::Normal)
+	{
+		BufferVisTargetCV->Set(*FString("WorldNormal"));
+	}
+
+	for(auto& Capture : Captures)
+	{
+		Capture->ShowFlags.SetLighting(bLighting);
+		Capture->ShowFlags.SetVisualizeBuffer(bBufferVis);
+	}
+}
+
+// Apply or remove the mask material on the items of the batch
+void USLItemScanner::ApplyBatchMaskMaterial(bool bApply)
+{
+	if(bApply)
+	{
+		for(int32 Slot = 0; Slot < BatchNumJobs; ++Slot)
+		{
+			UStaticMeshComponent* SMC = ScanItems[PendingJobs[BatchFirstJobIdx + Slot] / ScanPoses.Num()].Key;
+			if(!BatchOriginalMaterials.Contains(SMC))
+			{
+				BatchOriginalMaterials.Emplace(SMC, SMC->GetMaterials());
+				for (int32 Idx = 0; Idx < SMC->GetNumMaterials(); ++Idx)
+				{
+					SMC->SetMaterial(Idx, DynamicMaskMaterial);
+				}
+			}
+		}
+	}
+	else
+	{
+		for(const auto& Pair : BatchOriginalMaterials)
+		{
+			for (int32 Idx = 0; Idx < Pair.Value.Num(); ++Idx)
+			{
+				Pair.Key->SetMaterial(Idx, Pair.Value[Idx]);
+			}
+		}
+		BatchOriginalMaterials.Empty();
+	}
+}
+
+// Render all the scans of the batch in the current view mode and enqueue their readback
+void USLItemScanner::CaptureBatch()
+{
+	const int32 NumViewModes = ViewModes.Num();
+	const FIntRect Rect(0, 0, Resolution.X, Resolution.Y);
+
+	for(int32 Slot = 0; Slot < BatchNumJobs; ++Slot)
+	{
+		const int32 JobIdx = PendingJobs[BatchFirstJobIdx + Slot];
+		const int32 ItemIdx = JobIdx / ScanPoses.Num();
+		const int32 PoseIdx = JobIdx % ScanPoses.Num();
+
+		// Move the capture to the pose relative to the cell of the item
+		USceneCaptureComponent2D* Capture = Captures[Slot];
+		Capture->ShowOnlyComponents.Reset();
+		Capture->ShowOnlyComponent(ScanItems[ItemIdx].Key);
+		Capture->SetWorldLocationAndRotation(CellLocations[ItemIdx] + ScanPoses[PoseIdx].GetLocation(), ScanPoses[PoseIdx].GetRotation());
+
+		// Enqueues the rendering commands, does not block the game thread
+		Capture->CaptureScene();
+
+		// Read back after the capture is rendered (the render commands are executed in order)
+		FTextureRenderTargetResource* RTResource = RenderTargets[Slot]->GameThread_GetRenderTargetResource();
+		TArray<FColor>* OutBitmap = &BatchImages[Slot * NumViewModes + CurrViewModeIdx].Bitmap;
+		ENQUEUE_RENDER_COMMAND(SLScanReadback)(
+			[RTResource, OutBitmap, Rect](FRHICommandListImmediate& RHICmdList)
+		{
+			RHICmdList.ReadSurfaceData(RTResource->GetRenderTargetTexture(), Rect, *OutBitmap, FReadSurfaceDataFlags(RCM_UNorm));
+		});
+	}
+
+	ReadbackFence.BeginFence();
+	bReadbackPending = true;
+}
+
+// Encode the read back images of the current view mode on worker threads
+void USLItemScanner::StartBatchEncoding()
+{
+	const ESLItemScannerViewMode Mode = ViewModes[CurrViewModeIdx];
+	for(int32 Slot = 0; Slot < BatchNumJobs; ++Slot)
+	{
+		const int32 JobIdx = PendingJobs[BatchFirstJobIdx + Slot];
+
+		FString Path;
+		if(bIncludeLocally)
+		{
+			Path = FPaths::ProjectDir() + "/SemLog/" + Location + "/Meta/" +
+				GetScanName(JobIdx / ScanPoses.Num(), JobIdx % ScanPoses.Num(), Mode) + ".png";
+			FPaths::RemoveDuplicateSlashes(Path);
+		}
+
+		const FString CachePath = GetScanCachePath(JobIdx / ScanPoses.Num(), JobIdx % ScanPoses.Num(), Mode);
+
+		FSLScanImage* Image = &BatchImages[Slot * ViewModes.Num() + CurrViewModeIdx];
+		FAsyncTask<FSLScanEncodeWorker>* Worker = new FAsyncTask<FSLScanEncodeWorker>(Image, Mode, Resolution, Path, CachePath);
+		Worker->StartBackgroundTask();
+		EncodeWorkers.Emplace(Worker);
+	}
+}
+
+// Wait for the workers and write the scan entries of the batch
+void USLItemScanner::FinishBatch()
+{
+	for(auto& Worker : EncodeWorkers)
+	{
+		Worker->EnsureCompletion();
+		delete Worker;
+	}
+	EncodeWorkers.Reset();
+
+	// Write the entries in the same order as the sequential scanning
+	const int32 NumViewModes = ViewModes.Num();
+	for(int32 Slot = 0; Slot < BatchNumJobs; ++Slot)
+	{
+		const int32 JobIdx = PendingJobs[BatchFirstJobIdx + Slot];
+		const int32 ItemIdx = JobIdx / ScanPoses.Num();
+		Parent->StartScanEntry(ItemIdx, ScanItems[ItemIdx].Value, JobIdx % ScanPoses.Num());
+		int32 PrevItemPixelNum = INDEX_NONE;
+		for(int32 ModeIdx = 0; ModeIdx < NumViewModes; ++ModeIdx)
+		{
+			FSLScanImage& Image = BatchImages[Slot * NumViewModes + ModeIdx];
+
+			// Check the number of item pixels against the other view modes
+			if(Image.ItemPixelNum != INDEX_NONE)
+			{
+				if(ViewModes[ModeIdx] == ESLItemScannerViewMode::Mask && Image.ItemPixelNum + Image.BackgroundPixelNum != Resolution.X * Resolution.Y)
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d Number of item [%ld] + background [%ld] pixels, differs of number image total [%ld]."),
+						*FString(__func__), __LINE__, Image.ItemPixelNum, Image.BackgroundPixelNum, Resolution.X * Resolution.Y);
+				}
+				if(PrevItemPixelNum != INDEX_NONE && Image.ItemPixelNum != PrevItemPixelNum)
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d Prev number [%ld] of item pixels differs of current one [%ld]."),
+						*FString(__func__), __LINE__, PrevItemPixelNum, Image.ItemPixelNum);
+				}
+				PrevItemPixelNum = Image.ItemPixelNum;
+			}
+
+			Parent->AddImageEntry(GetViewModeName(ViewModes[ModeIdx]), Image.CompressedBitmap);
+
+			// Reset the image for the next batch
+			Image.CompressedBitmap.Reset();
+			Image.ItemPixelNum = INDEX_NONE;
+			Image.BackgroundPixelNum = INDEX_NONE;
+		}
+		Parent->WriteScanEntry();
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] Progress=[Scan=%ld/%ld; ViewModes=%ld]"),
+		*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(),
+		BatchFirstJobIdx + BatchNumJobs, PendingJobs.Num(), NumViewModes);
+}
+
+// Get the scan name (for saving locally)
+FString USLItemScanner::GetScanName(int32 ItemIdx, int32 PoseIdx, ESLItemScannerViewMode Mode) const
+{
+	FString ScanName = FString::FromInt(ItemIdx) + "_" + ScanItems[ItemIdx].Value + "_" + FString::FromInt(PoseIdx);
+	if(Mode == ESLItemScannerViewMode::Lit)
+	{
+		ScanName.Append("_L");
+	}
+	else if(Mode == ESLItemScannerViewMode::Unlit)
+	{
+		ScanName.Append("_U");
+	}
+	else if(Mode == ESLItemScannerViewMode::Mask)
+	{
+		ScanName.Append("_M");
+	}
+	else if(Mode == ESLItemScannerViewMode::Depth)
+	{
+		ScanName.Append("_D");
+	}
+	else if(Mode == ESLItemScannerViewMode::Normal)
+	{
+		ScanName.Append("_N");
+	}
+	return ScanName;
+}
+
+// Hash the scan inputs of every item, write the already cached scans and report the hit rate
+void USLItemScanner::LoadScanCache()
+{
+	const FString CacheRoot = FPaths::ProjectSavedDir() / TEXT("SLScanCache");
+
+	ScanCacheDirs.Empty(ScanItems.Num());
+	CachedJobs.Empty();
+	for(int32 ItemIdx = 0; ItemIdx < ScanItems.Num(); ++ItemIdx)
+	{
+		ScanCacheDirs.Emplace(CacheRoot / GetItemScanHash(ScanItems[ItemIdx].Key));
+
+		// A scan is reused only if all its view modes were written (resumes an interrupted run from the last complete pose)
+		for(int32 PoseIdx = 0; PoseIdx < ScanPoses.Num(); ++PoseIdx)
+		{
+			bool bAllModesCached = true;
+			for(const auto Mode : ViewModes)
+			{
+				if(!FPaths::FileExists(GetScanCachePath(ItemIdx, PoseIdx, Mode)))
+				{
+					bAllModesCached = false;
+					break;
+				}
+			}
+			if(!bAllModesCached)
+			{
+				continue;
+			}
+
+			// Write the cached scan entry
+			TArray<TArray<uint8>> CompressedBitmaps;
+			for(const auto Mode : ViewModes)
+			{
+				if(!FFileHelper::LoadFileToArray(CompressedBitmaps.AddDefaulted_GetRef(), *GetScanCachePath(ItemIdx, PoseIdx, Mode)))
+				{
+					bAllModesCached = false;
+					break;
+				}
+			}
+			if(!bAllModesCached)
+			{
+				continue;
+			}
+			Parent->StartScanEntry(ItemIdx, ScanItems[ItemIdx].Value, PoseIdx);
+			for(int32 ModeIdx = 0; ModeIdx < ViewModes.Num(); ++ModeIdx)
+			{
+				Parent->AddImageEntry(GetViewModeName(ViewModes[ModeIdx]), CompressedBitmaps[ModeIdx]);
+			}
+			Parent->WriteScanEntry();
+			CachedJobs.Emplace(ItemIdx * ScanPoses.Num() + PoseIdx);
+		}
+	}
+
+	const int32 NumJobs = ScanItems.Num() * ScanPoses.Num();
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d Scan cache hit rate %.1f%% (%ld/%ld scans cached) in %s.."),
+		*FString(__func__), __LINE__, NumJobs > 0 ? 100.f * CachedJobs.Num() / NumJobs : 0.f,
+		CachedJobs.Num(), NumJobs, *CacheRoot);
+}
+
+// Content hash of the item scan inputs (mesh, materials, resolution, view modes, poses)
+FString USLItemScanner::GetItemScanHash(UStaticMeshComponent* SMC) const
+{
+	// Hash of the asset package file, falls back to the asset path for assets without a package file
+	auto GetAssetHash = [](const UObject* Asset) -> FString
+	{
+		FString Filename;
+		if(FPackageName::DoesPackageExist(Asset->GetOutermost()->GetName(), nullptr, &Filename))
+		{
+			return LexToString(FMD5Hash::HashFile(*Filename));
+		}
+		return Asset->GetPathName();
+	};
+
+	FString Key = FString::Printf(TEXT("v%d;%dx%d;%d;%.2f;"), ScanCacheVersion, Resolution.X, Resolution.Y, ScanPoses.Num(), ScanRadius);
+	for(const auto Mode : ViewModes)
+	{
+		Key.Append(GetViewModeName(Mode) + ";");
+	}
+
+	if(UStaticMesh* SM = SMC->GetStaticMesh())
+	{
+		Key.Append(GetAssetHash(SM) + ";");
+	}
+
+	// Include the whole material instance chain, the parameters live in the instances
+	for(UMaterialInterface* Mat : SMC->GetMaterials())
+	{
+		while(Mat)
+		{
+			Key.Append(GetAssetHash(Mat) + ";");
+			UMaterialInstance* MatInst = Cast<UMaterialInstance>(Mat);
+			Mat = MatInst ? MatInst->Parent : nullptr;
+		}
+	}
+
+	return FMD5::HashAnsiString(*Key);
+}
+
+// Get the cache file path of the scan image (empty if the cache is not used)
+FString USLItemScanner::GetScanCachePath(int32 ItemIdx, int32 PoseIdx, ESLItemScannerViewMode Mode) const
+{
+	if(!bUseScanCache || !ScanCacheDirs.IsValidIndex(ItemIdx))
+	{
+		return FString();
+	}
+	return ScanCacheDirs[ItemIdx] / FString::FromInt(PoseIdx) + "_" + GetViewModeName(Mode) + ".png";
+}
+
+// Check if all the scans of the item are cached
+bool USLItemScanner::IsItemCached(int32 ItemIdx) const
+{
+	for(int32 PoseIdx = 0; PoseIdx < ScanPoses.Num(); ++PoseIdx)
+	{
+		if(!IsScanCached(ItemIdx, PoseIdx))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Write the image to the cache (through a temporary file, a crash never leaves a partial image behind)
+bool USLItemScanner::SaveToScanCache(const FString& CachePath, const TArray<uint8>& CompressedBitmap)
+{
+	if(CachePath.IsEmpty())
+	{
+		return false;
+	}
+	const FString TmpPath = CachePath + ".tmp";
+	return FFileHelper::SaveArrayToFile(CompressedBitmap, *TmpPath)
+		&& IFileManager::Get().Move(*CachePath, *TmpPath, true);
+}
+
 // Apply mask material to current item
 void USLItemScanner::ApplyMaskMaterial()
 {
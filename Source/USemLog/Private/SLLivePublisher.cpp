@@ -0,0 +1,613 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLLivePublisher.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+TSharedPtr<FSLLivePublisher> FSLLivePublisher::StaticInstance;
+
+// Sender thread loop
+uint32 FSLLivePublisherRunnable::Run()
+{
+	while (!bStop)
+	{
+		if (!Publisher->Tick())
+		{
+			// Nothing to send, wait for new messages (timeout for checking the connections and the blocked sockets)
+			Publisher->WorkEvent->Wait(FSLLivePublisher::MaxWaitMs);
+		}
+	}
+
+	// Send what was published before stopping, as long as the subscribers keep up
+	const double FlushEnd = FPlatformTime::Seconds() + FSLLivePublisher::FlushTimeout;
+	while (FPlatformTime::Seconds() < FlushEnd)
+	{
+		Publisher->Tick();
+		bool bHasPending = !Publisher->Messages.IsEmpty();
+		for (const auto& Subscriber : Publisher->Subscribers)
+		{
+			bHasPending |= Subscriber.PendingBytes > 0;
+		}
+		if (!bHasPending)
+		{
+			break;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return 0;
+}
+
+// Constructor
+FSLLivePublisher::FSLLivePublisher() : bIsRunning(false), Port(0), NumStarts(0), Listener(nullptr),
+	WorkEvent(nullptr), Sender(nullptr), SenderThread(nullptr)
+{
+}
+
+// Destructor
+FSLLivePublisher::~FSLLivePublisher()
+{
+	Shutdown();
+}
+
+// Get singleton
+FSLLivePublisher* FSLLivePublisher::GetInstance()
+{
+	if (!StaticInstance.IsValid())
+	{
+		StaticInstance = MakeShareable(new FSLLivePublisher());
+	}
+	return StaticInstance.Get();
+}
+
+// Delete instance
+void FSLLivePublisher::DeleteInstance()
+{
+	StaticInstance.Reset();
+}
+
+// Listen on the local port and start the sender thread
+bool FSLLivePublisher::Start(uint16 InPort)
+{
+	if (bIsRunning)
+	{
+		if (Port != InPort)
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Publisher is already listening on port %d, cannot listen on %d.."),
+				*FString(__func__), __LINE__, Port, InPort);
+			return false;
+		}
+		NumStarts++;
+		return true;
+	}
+
+	// Only local subscribers, the send time is compared to the local clock
+	Listener = FTcpSocketBuilder(TEXT("SLLivePublisher"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToEndpoint(FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), InPort))
+		.Listening(MaxSubscribers)
+		.Build();
+	if (!Listener)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Could not listen on 127.0.0.1:%d.."), *FString(__func__), __LINE__, InPort);
+		return false;
+	}
+	Port = InPort;
+
+	// Reset the stats of a previous run
+	ClosedStats = FSLLivePublisherStats();
+	NumPublished.Reset();
+	UpdateStats();
+
+	// Start the sender thread
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Sender = new FSLLivePublisherRunnable(this);
+	SenderThread = FRunnableThread::Create(Sender, TEXT("SLLivePublisher"), 0, TPri_AboveNormal);
+
+	NumStarts = 1;
+	bIsRunning = true;
+	UE_LOG(LogSL, Log, TEXT("%s::%d Publishing on 127.0.0.1:%d.."), *FString(__func__), __LINE__, Port);
+	return true;
+}
+
+// Release a start, the last one stops the channel
+void FSLLivePublisher::Stop()
+{
+	if (!bIsRunning)
+	{
+		return;
+	}
+
+	// Other worlds are still publishing
+	if (--NumStarts > 0)
+	{
+		return;
+	}
+	Shutdown();
+}
+
+// Send the queued messages, close the subscribers and stop the sender thread (regardless of the starts)
+void FSLLivePublisher::Shutdown()
+{
+	if (!bIsRunning)
+	{
+		return;
+	}
+
+	// No new messages are queued from here on
+	bIsRunning = false;
+	NumStarts = 0;
+
+	// The sender thread flushes the queues before exiting
+	Sender->Stop();
+	WorkEvent->Trigger();
+	SenderThread->WaitForCompletion();
+	delete SenderThread;
+	SenderThread = nullptr;
+	delete Sender;
+	Sender = nullptr;
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+
+	for (auto& Subscriber : Subscribers)
+	{
+		CloseSubscriber(Subscriber);
+	}
+	Subscribers.Empty();
+	Messages.Empty();
+	UpdateStats();
+
+	Listener->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Listener);
+	Listener = nullptr;
+
+	UE_LOG(LogSL, Log, TEXT("%s::%d Live publisher stats: %s"), *FString(__func__), __LINE__, *GetStats().ToString());
+}
+
+// Publish the poses of the episode (any thread)
+void FSLLivePublisher::PublishPoses(const FString& InEpisode, TSharedPtr<FSLLivePoseFrame, ESPMode::ThreadSafe> InPoses, bool bKeyframe)
+{
+	if (bIsRunning && InPoses.IsValid() && InPoses->Num() > 0)
+	{
+		Messages.Enqueue(FMessage{ bKeyframe ? ESLLiveMsgType::Keyframe : ESLLiveMsgType::Poses,
+			FPlatformTime::Seconds(), InEpisode, InPoses, nullptr });
+		NumPublished.Increment();
+		WorkEvent->Trigger();
+	}
+}
+
+// Publish the finished event of the episode (any thread)
+void FSLLivePublisher::PublishEvent(const FString& InEpisode, const FSLEventIndexEntry& InEvent)
+{
+	if (bIsRunning)
+	{
+		Messages.Enqueue(FMessage{ ESLLiveMsgType::Event, FPlatformTime::Seconds(), InEpisode, nullptr,
+			MakeShared<FSLEventIndexEntry, ESPMode::ThreadSafe>(InEvent) });
+		NumPublished.Increment();
+		WorkEvent->Trigger();
+	}
+}
+
+// Get the channel stats
+FSLLivePublisherStats FSLLivePublisher::GetStats() const
+{
+	FScopeLock ScopeLock(&StatsLock);
+	FSLLivePublisherStats OutStats = Stats;
+	OutStats.NumPublished = NumPublished.GetValue();
+	return OutStats;
+}
+
+// Called by the sender thread, returns true if there was any work done
+bool FSLLivePublisher::Tick()
+{
+	bool bDidWork = AcceptSubscribers();
+
+	FMessage Message;
+	while (Messages.Dequeue(Message))
+	{
+		Dispatch(Message);
+		bDidWork = true;
+	}
+
+	for (int32 Idx = Subscribers.Num() - 1; Idx >= 0; --Idx)
+	{
+		FSubscriber& Subscriber = Subscribers[Idx];
+		const int32 PrevPendingBytes = Subscriber.PendingBytes;
+		if (Subscriber.bClose || !ReceiveFromSubscriber(Subscriber) || !SendToSubscriber(Subscriber))
+		{
+			CloseSubscriber(Subscriber);
+			Subscribers.RemoveAtSwap(Idx);
+			bDidWork = true;
+		}
+		else if (Subscriber.PendingBytes != PrevPendingBytes)
+		{
+			bDidWork = true;
+		}
+	}
+
+	if (bDidWork)
+	{
+		UpdateStats();
+	}
+	return bDidWork;
+}
+
+// Accept the pending connections
+bool FSLLivePublisher::AcceptSubscribers()
+{
+	bool bAccepted = false;
+	bool bHasPendingConnection = false;
+	while (Listener->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+	{
+		FSocket* Socket = Listener->Accept(TEXT("SLLiveSubscriber"));
+		if (!Socket)
+		{
+			break;
+		}
+
+		if (Subscribers.Num() >= MaxSubscribers)
+		{
+			UE_LOG(LogSL, Warning, TEXT("%s::%d Max number of subscribers (%d) reached, connection refused.."),
+				*FString(__func__), __LINE__, MaxSubscribers);
+			Socket->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+			continue;
+		}
+
+		// Small frames, do not wait for coalescing
+		Socket->SetNonBlocking(true);
+		Socket->SetNoDelay(true);
+
+		Subscribers.AddDefaulted_GetRef().Socket = Socket;
+		bAccepted = true;
+
+		// The poses are published as deltas, the new subscriber needs the current poses of all the entities
+		KeyframeGeneration.Increment();
+		UE_LOG(LogSL, Log, TEXT("%s::%d New subscriber, %d connected.."), *FString(__func__), __LINE__, Subscribers.Num());
+	}
+	return bAccepted;
+}
+
+// Read the subscribe messages, false if the subscriber disconnected
+bool FSLLivePublisher::ReceiveFromSubscriber(FSubscriber& Subscriber)
+{
+	// Non blocking streaming socket, the receive fails only if the connection is closed
+	uint8 Buffer[4096];
+	int32 BytesRead = 0;
+	do
+	{
+		if (!Subscriber.Socket->Recv(Buffer, sizeof(Buffer), BytesRead))
+		{
+			return false;
+		}
+		Subscriber.InBuffer.Append(Buffer, BytesRead);
+	} while (BytesRead == sizeof(Buffer));
+
+	// Parse the complete frames
+	while (Subscriber.InBuffer.Num() >= (int32)sizeof(uint32))
+	{
+		uint32 Size = 0;
+		FMemory::Memcpy(&Size, Subscriber.InBuffer.GetData(), sizeof(uint32));
+		if (Size < FSLLiveFrameHeader::HeaderSize || Size > FSLLiveFrameHeader::MaxSubscribeSize)
+		{
+			UE_LOG(LogSL, Warning, TEXT("%s::%d Invalid frame size (%u), closing the subscriber.."),
+				*FString(__func__), __LINE__, Size);
+			return false;
+		}
+		const int32 FrameSize = sizeof(uint32) + Size;
+		if (Subscriber.InBuffer.Num() < FrameSize)
+		{
+			break;
+		}
+
+		TArray<uint8> FrameData(Subscriber.InBuffer.GetData(), FrameSize);
+		Subscriber.InBuffer.RemoveAt(0, FrameSize, false);
+
+		// The string lengths in the frame are bounded by its size
+		FMemoryReader Reader(FrameData);
+		Reader.ArMaxSerializeSize = FrameSize;
+		uint8 Type = 0;
+		uint32 Seq = 0;
+		double SendTime = 0.0;
+		FString Episode;
+		Reader << Size << Type << Seq << SendTime << Episode;
+		if (Type == (uint8)ESLLiveMsgType::Subscribe)
+		{
+			FSLLiveTopicFilter Filter;
+			Reader << Filter;
+			if (Reader.IsError())
+			{
+				UE_LOG(LogSL, Warning, TEXT("%s::%d Invalid subscribe message, closing the subscriber.."),
+					*FString(__func__), __LINE__);
+				return false;
+			}
+			Subscriber.Filter = MoveTemp(Filter);
+			UE_LOG(LogSL, Log, TEXT("%s::%d Subscribed to Poses:%d Events:%d Types:[%s] Entities:[%s] Episodes:[%s].."),
+				*FString(__func__), __LINE__, Subscriber.Filter.bPoses, Subscriber.Filter.bEvents,
+				*FString::Join(Subscriber.Filter.EventTypes, TEXT(",")), *FString::Join(Subscriber.Filter.EntityIds, TEXT(",")),
+				*FString::Join(Subscriber.Filter.Episodes, TEXT(",")));
+
+			// The keyframes sent so far might have been filtered out
+			KeyframeGeneration.Increment();
+		}
+	}
+	return true;
+}
+
+// Add the message to the queues of the subscribers it passes the filter of
+void FSLLivePublisher::Dispatch(const FMessage& Message)
+{
+	// Serialized once for all the subscribers without an entity filter
+	static const TSet<FString> AllEntities;
+	TArray<uint8> AllPayload;
+
+	for (auto& Subscriber : Subscribers)
+	{
+		if (Subscriber.bClose || !PassesFilter(Message, Subscriber.Filter))
+		{
+			continue;
+		}
+
+		if (Message.Type != ESLLiveMsgType::Event && Subscriber.Filter.EntityIds.Num() > 0)
+		{
+			TArray<uint8> Payload;
+			EncodePayload(Message, Subscriber.Filter.EntityIds, Payload);
+			AddFrame(Subscriber, Message, Payload);
+		}
+		else
+		{
+			if (AllPayload.Num() == 0)
+			{
+				EncodePayload(Message, AllEntities, AllPayload);
+			}
+			AddFrame(Subscriber, Message, AllPayload);
+		}
+
+		if (!ApplyBackpressure(Subscriber))
+		{
+			Subscriber.bClose = true;
+		}
+	}
+}
+
+// True if the message (or a part of it) passes the filter
+bool FSLLivePublisher::PassesFilter(const FMessage& Message, const FSLLiveTopicFilter& Filter)
+{
+	if (Filter.Episodes.Num() > 0 && !Filter.Episodes.Contains(Message.Episode))
+	{
+		return false;
+	}
+
+	if (Message.Type == ESLLiveMsgType::Poses || Message.Type == ESLLiveMsgType::Keyframe)
+	{
+		if (!Filter.bPoses)
+		{
+			return false;
+		}
+		if (Filter.EntityIds.Num() == 0)
+		{
+			return true;
+		}
+		for (const FString& Id : Message.Poses->Ids)
+		{
+			if (Filter.EntityIds.Contains(Id))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	else if (Message.Type == ESLLiveMsgType::Event)
+	{
+		if (!Filter.bEvents)
+		{
+			return false;
+		}
+		if (Filter.EventTypes.Num() > 0 && !Filter.EventTypes.Contains(Message.Event->Type.ToString()))
+		{
+			return false;
+		}
+		if (Filter.EntityIds.Num() == 0)
+		{
+			return true;
+		}
+		for (const FString& Id : Message.Event->EntityIds)
+		{
+			if (Filter.EntityIds.Contains(Id))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	return false;
+}
+
+// Serialize the message payload, the poses are restricted to the given entities (all if empty)
+void FSLLivePublisher::EncodePayload(const FMessage& Message, const TSet<FString>& EntityIds, TArray<uint8>& OutPayload)
+{
+	FMemoryWriter Writer(OutPayload);
+	if (Message.Type == ESLLiveMsgType::Poses || Message.Type == ESLLiveMsgType::Keyframe)
+	{
+		const FSLLivePoseFrame& Poses = *Message.Poses;
+		float Timestamp = Poses.Timestamp;
+		int32 Num = Poses.Num();
+		if (EntityIds.Num() > 0)
+		{
+			Num = 0;
+			for (const FString& Id : Poses.Ids)
+			{
+				Num += EntityIds.Contains(Id) ? 1 : 0;
+			}
+		}
+		Writer << Timestamp << Num;
+		for (int32 Idx = 0; Idx < Poses.Num(); ++Idx)
+		{
+			if (EntityIds.Num() == 0 || EntityIds.Contains(Poses.Ids[Idx]))
+			{
+				Writer << const_cast<FString&>(Poses.Ids[Idx])
+					<< const_cast<FVector&>(Poses.Locations[Idx])
+					<< const_cast<FQuat&>(Poses.Quats[Idx]);
+			}
+		}
+	}
+	else if (Message.Type == ESLLiveMsgType::Event)
+	{
+		const FSLEventIndexEntry& Event = *Message.Event;
+		FString Type = Event.Type.ToString();
+		float Start = Event.Start;
+		float End = Event.End;
+		Writer << const_cast<FString&>(Event.Id) << Type << Start << End << const_cast<TArray<FString>&>(Event.EntityIds);
+	}
+}
+
+// Add the frame with the payload to the queue of the subscriber
+void FSLLivePublisher::AddFrame(FSubscriber& Subscriber, const FMessage& Message, const TArray<uint8>& Payload)
+{
+	FOutFrame& Frame = Subscriber.OutFrames.AddDefaulted_GetRef();
+	Frame.bDroppable = Message.Type == ESLLiveMsgType::Poses;
+	Frame.Data.Reserve(sizeof(uint32) + FSLLiveFrameHeader::HeaderSize + (Message.Episode.Len() + 5) + Payload.Num());
+
+	// The size is set once the variable length episode id is written
+	FMemoryWriter Writer(Frame.Data);
+	uint32 Size = 0;
+	uint8 Type = (uint8)Message.Type;
+	uint32 Seq = Subscriber.NextSeq++;
+	double SendTime = Message.SendTime;
+	FString Episode = Message.Episode;
+	Writer << Size << Type << Seq << SendTime << Episode;
+	Frame.Data.Append(Payload);
+	Size = Frame.Data.Num() - sizeof(uint32);
+	FMemory::Memcpy(Frame.Data.GetData(), &Size, sizeof(uint32));
+
+	Subscriber.PendingBytes += Frame.Data.Num();
+
+	// The keyframe restores the poses of the dropped frames
+	if (Message.Type == ESLLiveMsgType::Keyframe)
+	{
+		Subscriber.bKeyframeRequested = false;
+	}
+}
+
+// Drop the oldest pose frames of a slow subscriber (and request a keyframe), false if it is too far behind with the events
+bool FSLLivePublisher::ApplyBackpressure(FSubscriber& Subscriber)
+{
+	if (Subscriber.PendingBytes <= MaxPendingBytes)
+	{
+		return true;
+	}
+
+	// Drop the oldest pose frames, the partially sent frame has to be completed
+	const uint64 PrevNumDropped = Subscriber.Stats.NumDropped;
+	for (int32 Idx = 0; Idx < Subscriber.OutFrames.Num() && Subscriber.PendingBytes > MaxPendingBytes;)
+	{
+		const FOutFrame& Frame = Subscriber.OutFrames[Idx];
+		if (Frame.bDroppable && Frame.NumSent == 0)
+		{
+			Subscriber.PendingBytes -= Frame.Data.Num();
+			Subscriber.OutFrames.RemoveAt(Idx, 1, false);
+			Subscriber.Stats.NumDropped++;
+		}
+		else
+		{
+			Idx++;
+		}
+	}
+
+	// The pose frames are deltas, entities which stopped moving after a dropped frame would keep a stale pose,
+	// request a keyframe from the publishers (once until it arrives)
+	if (Subscriber.Stats.NumDropped > PrevNumDropped && !Subscriber.bKeyframeRequested)
+	{
+		Subscriber.bKeyframeRequested = true;
+		KeyframeGeneration.Increment();
+	}
+
+	// The events are never dropped
+	if (Subscriber.PendingBytes > MaxPendingEventBytes)
+	{
+		UE_LOG(LogSL, Warning, TEXT("%s::%d Subscriber is %d bytes behind with the events, disconnecting it.."),
+			*FString(__func__), __LINE__, Subscriber.PendingBytes);
+		Subscriber.Stats.NumSlowDisconnects++;
+		return false;
+	}
+	return true;
+}
+
+// Send the queued frames, false if the subscriber disconnected
+bool FSLLivePublisher::SendToSubscriber(FSubscriber& Subscriber)
+{
+	int32 NumSentFrames = 0;
+	bool bConnected = true;
+	for (FOutFrame& Frame : Subscriber.OutFrames)
+	{
+		while (Frame.NumSent < Frame.Data.Num())
+		{
+			int32 BytesSent = 0;
+			if (!Subscriber.Socket->Send(Frame.Data.GetData() + Frame.NumSent, Frame.Data.Num() - Frame.NumSent, BytesSent))
+			{
+				// A full send buffer is the backpressure of the subscriber, any other error is a disconnect
+				bConnected = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK;
+				break;
+			}
+			if (BytesSent <= 0)
+			{
+				break;
+			}
+			Frame.NumSent += BytesSent;
+			Subscriber.PendingBytes -= BytesSent;
+			Subscriber.Stats.SentBytes += BytesSent;
+		}
+
+		if (Frame.NumSent < Frame.Data.Num())
+		{
+			break;
+		}
+		NumSentFrames++;
+	}
+
+	Subscriber.OutFrames.RemoveAt(0, NumSentFrames, false);
+	Subscriber.Stats.NumSent += NumSentFrames;
+	return bConnected;
+}
+
+// Close the subscriber connection
+void FSLLivePublisher::CloseSubscriber(FSubscriber& Subscriber)
+{
+	if (Subscriber.Socket)
+	{
+		Subscriber.Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Subscriber.Socket);
+		Subscriber.Socket = nullptr;
+	}
+
+	ClosedStats.NumSent += Subscriber.Stats.NumSent;
+	ClosedStats.NumDropped += Subscriber.Stats.NumDropped;
+	ClosedStats.NumSlowDisconnects += Subscriber.Stats.NumSlowDisconnects;
+	ClosedStats.SentBytes += Subscriber.Stats.SentBytes;
+	Subscriber.Stats = FSLLivePublisherStats();
+	UE_LOG(LogSL, Log, TEXT("%s::%d Subscriber disconnected.."), *FString(__func__), __LINE__);
+}
+
+// Update the stats snapshot from the ones of the subscribers
+void FSLLivePublisher::UpdateStats()
+{
+	FSLLivePublisherStats NewStats = ClosedStats;
+	NewStats.NumSubscribers = Subscribers.Num();
+	for (const auto& Subscriber : Subscribers)
+	{
+		NewStats.NumSent += Subscriber.Stats.NumSent;
+		NewStats.NumDropped += Subscriber.Stats.NumDropped;
+		NewStats.NumSlowDisconnects += Subscriber.Stats.NumSlowDisconnects;
+		NewStats.SentBytes += Subscriber.Stats.SentBytes;
+	}
+
+	FScopeLock ScopeLock(&StatsLock);
+	Stats = NewStats;
+}
@@ -0,0 +1,192 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLLiveSubscriberCommandlet.h"
+#include "SLLivePublisher.h"
+#include "Misc/Parse.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+// Ctor
+USLLiveSubscriberCommandlet::USLLiveSubscriberCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Subscribe and measure the latency
+int32 USLLiveSubscriberCommandlet::Main(const FString& Params)
+{
+	int32 Port = 9595;
+	int32 NumFrames = 10000;
+	float Timeout = 60.f;
+	FString Types;
+	FString Entities;
+	FString Episodes;
+	FParse::Value(*Params, TEXT("port="), Port);
+	FParse::Value(*Params, TEXT("num="), NumFrames);
+	FParse::Value(*Params, TEXT("timeout="), Timeout);
+	FParse::Value(*Params, TEXT("types="), Types, false);
+	FParse::Value(*Params, TEXT("entities="), Entities, false);
+	FParse::Value(*Params, TEXT("episodes="), Episodes, false);
+
+	FSLLiveTopicFilter Filter;
+	Filter.bPoses = !FParse::Param(*Params, TEXT("noposes"));
+	Filter.bEvents = !FParse::Param(*Params, TEXT("noevents"));
+	TArray<FString> Values;
+	Types.ParseIntoArray(Values, TEXT(","), true);
+	Filter.EventTypes.Append(Values);
+	Entities.ParseIntoArray(Values, TEXT(","), true);
+	Filter.EntityIds.Append(Values);
+	Episodes.ParseIntoArray(Values, TEXT(","), true);
+	Filter.Episodes.Append(Values);
+
+	// Connect to the publisher
+	FSocket* Socket = FTcpSocketBuilder(TEXT("SLLiveSubscriber")).AsBlocking().Build();
+	const FIPv4Endpoint Endpoint(FIPv4Address(127, 0, 0, 1), Port);
+	if (!Socket || !Socket->Connect(*Endpoint.ToInternetAddr()))
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Could not connect to %s.."), *FString(__func__), __LINE__, *Endpoint.ToString());
+		if (Socket)
+		{
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		}
+		return 1;
+	}
+	Socket->SetNoDelay(true);
+
+	// Send the topic filter
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	PayloadWriter << Filter;
+	TArray<uint8> OutFrame;
+	FMemoryWriter FrameWriter(OutFrame);
+	uint32 Size = 0;
+	uint8 Type = (uint8)ESLLiveMsgType::Subscribe;
+	uint32 Seq = 0;
+	double SendTime = FPlatformTime::Seconds();
+	FString Episode;
+	FrameWriter << Size << Type << Seq << SendTime << Episode;
+	OutFrame.Append(Payload);
+	Size = OutFrame.Num() - sizeof(uint32);
+	FMemory::Memcpy(OutFrame.GetData(), &Size, sizeof(uint32));
+	int32 TotalSent = 0;
+	while (TotalSent < OutFrame.Num())
+	{
+		int32 BytesSent = 0;
+		if (!Socket->Send(OutFrame.GetData() + TotalSent, OutFrame.Num() - TotalSent, BytesSent))
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Could not send the subscribe message.."), *FString(__func__), __LINE__);
+			Socket->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+			return 1;
+		}
+		TotalSent += BytesSent;
+	}
+	UE_LOG(LogSL, Display, TEXT("%s::%d Subscribed to %s, waiting for %d frames (timeout %.1fs).."),
+		*FString(__func__), __LINE__, *Endpoint.ToString(), NumFrames, Timeout);
+
+	// Receive until enough frames arrived, the publisher stopped or the timeout
+	TArray<double> Latencies;
+	Latencies.Reserve(NumFrames);
+	int32 NumPoseFrames = 0;
+	int32 NumKeyframes = 0;
+	int64 NumPoses = 0;
+	int32 NumEvents = 0;
+	int64 NumDropped = 0;
+	uint32 ExpectedSeq = 0;
+	TArray<uint8> InBuffer;
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(64 * 1024);
+	const double EndTime = FPlatformTime::Seconds() + Timeout;
+	while (Latencies.Num() < NumFrames && FPlatformTime::Seconds() < EndTime)
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100)))
+		{
+			continue;
+		}
+		int32 BytesRead = 0;
+		if (!Socket->Recv(Buffer.GetData(), Buffer.Num(), BytesRead))
+		{
+			UE_LOG(LogSL, Display, TEXT("%s::%d Publisher closed the connection.."), *FString(__func__), __LINE__);
+			break;
+		}
+		const double RecvTime = FPlatformTime::Seconds();
+		InBuffer.Append(Buffer.GetData(), BytesRead);
+
+		// Parse the complete frames
+		int32 Offset = 0;
+		while (InBuffer.Num() - Offset >= (int32)sizeof(uint32))
+		{
+			FMemory::Memcpy(&Size, InBuffer.GetData() + Offset, sizeof(uint32));
+			if (InBuffer.Num() - Offset < (int32)(sizeof(uint32) + Size))
+			{
+				break;
+			}
+
+			FMemoryReader Reader(InBuffer);
+			Reader.Seek(Offset + sizeof(uint32));
+			Reader << Type << Seq << SendTime << Episode;
+			Latencies.Add((RecvTime - SendTime) * 1000.0);
+
+			// Gaps in the sequence are the frames dropped by the backpressure of the publisher
+			NumDropped += (int64)(Seq - ExpectedSeq);
+			ExpectedSeq = Seq + 1;
+
+			if (Type == (uint8)ESLLiveMsgType::Poses || Type == (uint8)ESLLiveMsgType::Keyframe)
+			{
+				float Timestamp = 0.f;
+				int32 Num = 0;
+				Reader << Timestamp << Num;
+				NumPoseFrames++;
+				NumPoses += Num;
+				if (Type == (uint8)ESLLiveMsgType::Keyframe)
+				{
+					NumKeyframes++;
+					UE_LOG(LogSL, Log, TEXT("%s::%d [%s] Keyframe at %.3f with %d poses.."), *FString(__func__), __LINE__,
+						*Episode, Timestamp, Num);
+				}
+			}
+			else if (Type == (uint8)ESLLiveMsgType::Event)
+			{
+				FString Id;
+				FString EventType;
+				float Start = 0.f;
+				float End = 0.f;
+				TArray<FString> EntityIds;
+				Reader << Id << EventType << Start << End << EntityIds;
+				NumEvents++;
+				UE_LOG(LogSL, Log, TEXT("%s::%d [%s] Event %s [%.3f, %.3f] %s [%s].."), *FString(__func__), __LINE__,
+					*Episode, *EventType, Start, End, *Id, *FString::Join(EntityIds, TEXT(",")));
+			}
+			Offset += sizeof(uint32) + Size;
+		}
+		InBuffer.RemoveAt(0, Offset, false);
+	}
+
+	Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+
+	if (Latencies.Num() == 0)
+	{
+		UE_LOG(LogSL, Warning, TEXT("%s::%d No frames received.."), *FString(__func__), __LINE__);
+		return 1;
+	}
+
+	Latencies.Sort();
+	auto Percentile = [&Latencies](double P)
+	{
+		return Latencies[FMath::Clamp(FMath::FloorToInt(P * (Latencies.Num() - 1)), 0, Latencies.Num() - 1)];
+	};
+	UE_LOG(LogSL, Display, TEXT("%s::%d Received %d frames (%d pose frames of which %d keyframes with %lld poses, %d events), %lld dropped by the publisher.."),
+		*FString(__func__), __LINE__, Latencies.Num(), NumPoseFrames, NumKeyframes, NumPoses, NumEvents, NumDropped);
+	UE_LOG(LogSL, Display, TEXT("%s::%d Latency (ms): min %.3f, p50 %.3f, p90 %.3f, p99 %.3f, max %.3f.."),
+		*FString(__func__), __LINE__, Latencies[0], Percentile(0.5), Percentile(0.9), Percentile(0.99), Latencies.Last());
+	return 0;
+}
@@ -3,9 +3,16 @@
 
 #include "SLManager.h"
 #include "SLEntitiesManager.h"
+#include "SLMongoService.h"
+#include "SLLivePublisher.h"
+#include "SLSupportedByEvaluator.h"
+#include "SLTimerWheel.h"
+#include "SLTagCache.h"
+#include "SLTrace.h"
 #include "Ids.h"
 #if SL_WITH_SLVIS
 #include "Engine/DemoNetDriver.h"
+#include "Engine/World.h"
 #endif //SL_WITH_SLVIS
 
 // Sets default values
@@ -18,6 +25,7 @@ ASLManager::ASLManager()
 	bIsInit = false;
 	bIsStarted = false;
 	bIsFinished = false;
+	bLivePublisherStarted = false;
 
 	// Semantic logger default values
 	TaskId = TEXT("DefaultTaskId");
@@ -47,6 +55,9 @@ ASLManager::ASLManager()
 	ScanViewModes.Add(ESLItemScannerViewMode::Depth);
 	ScanViewModes.Add(ESLItemScannerViewMode::Normal);
 	bIncludeScansLocally = false;
+	ScanBatchSize = 0;
+	bUseScanCache = false;
+	ScanUploadBudgetMB = 64;
 	bOverwriteMetadata = false;
 
 	
@@ -54,9 +65,13 @@ ASLManager::ASLManager()
 	bLogWorldState = true;
 	bOverwriteWorldState = false;
 	UpdateRate = 0.0f;
+	bFixedRateSampling = false;
 	LinearDistance = 0.5f; // cm
 	AngularDistance = 0.1f; // rad
 	WriterType = ESLWorldStateWriterType::MongoC;
+	BucketMaxSamples = 200;
+	BucketMaxDuration = 10.f;
+	bUseTimeSeriesCollection = false;
 
 	
 	// Events logger default values
@@ -67,6 +82,7 @@ ASLManager::ASLManager()
 	bLogPickAndPlaceEvents = true;
 	bLogSlicingEvents = true;
 	bWriteTimelines = true;
+	bWriteEventTrace = true;
 	bWriteEpisodeMetadata = false;
 	ExperimentTemplateType = ESLOwlExperimentTemplate::Default;
 
@@ -76,6 +92,10 @@ ASLManager::ASLManager()
 	MaxRecordHz = 120.f;
 	MinRecordHz = 30.f;
 
+	// Live publisher default values
+	bPublishLive = false;
+	LivePublishPort = 9595;
+
 #if WITH_EDITOR
 	// Make manager sprite smaller (used to easily find the actor in the world)
 	SpriteScale = 0.5;
@@ -162,7 +182,7 @@ void ASLManager::Init()
 	if (!bIsInit)
 	{
 		// Init the semantic items content singleton
-		FSLEntitiesManager::GetInstance()->Init(GetWorld());
+		FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 
 		// If the episode Id is not manually added, generate new unique id
 		if (!bUseCustomEpisodeId)
@@ -178,16 +198,23 @@ void ASLManager::Init()
 			// Create and init world state logger
 			MetadataLogger = NewObject<USLMetadataLogger>(this);
 			MetadataLogger->Init(TaskId, ServerIp, ServerPort,
-				bScanItems, ScanResolution, ScanViewModes, bIncludeScansLocally, bOverwriteMetadata);
+				bScanItems, ScanResolution, ScanViewModes, bIncludeScansLocally, bOverwriteMetadata, ScanBatchSize, bUseScanCache, ScanUploadBudgetMB);
 		}
 		else
 		{
+			// Start the live channel first, the loggers check at init if they should publish to it
+			if (bPublishLive)
+			{
+				bLivePublisherStarted = FSLLivePublisher::GetInstance()->Start(LivePublishPort);
+			}
+
 			if (bLogWorldState)
 			{
 				// Create and init world state logger
 				WorldStateLogger = NewObject<USLWorldStateLogger>(this);
 				WorldStateLogger->Init(WriterType, FSLWorldStateWriterParams(
-					LinearDistance, AngularDistance, TaskId, EpisodeId, ServerIp, ServerPort, bOverwriteWorldState));
+					LinearDistance, AngularDistance, TaskId, EpisodeId, ServerIp, ServerPort, bOverwriteWorldState,
+					BucketMaxSamples, BucketMaxDuration, bUseTimeSeriesCollection));
 			}
 
 			if (bLogEventData)
@@ -232,12 +259,13 @@ void ASLManager::Start()
 			// Start world state logger
 			if (bLogWorldState && WorldStateLogger)
 			{
-				WorldStateLogger->Start(UpdateRate);
+				WorldStateLogger->Start(UpdateRate, bFixedRateSampling);
 			}
 
 			// Start event data logger
 			if (bLogEventData && EventDataLogger)
 			{
+				FSLTrace::Reset(GetWorld());
 				EventDataLogger->Start();
 			}
 
@@ -248,6 +276,12 @@ void ASLManager::Start()
 			}
 		}
 
+		// Keep the loggers up to date with the spawned and destroyed entities
+		if (!bLogMetadata && (bLogWorldState || bLogEventData))
+		{
+			StartEntityRegistration();
+		}
+
 		// Mark manager as started
 		bIsStarted = true;
 	}
@@ -281,10 +315,42 @@ void ASLManager::Finish(const float Time, bool bForced)
 			{
 				VisionDataLogger->Finish(bForced);
 			}
+
+			// Send the last messages of the finished loggers and close the subscribers
+			if (bLivePublisherStarted)
+			{
+				FSLLivePublisher::GetInstance()->Stop();
+				bLivePublisherStarted = false;
+			}
+		}
+
+		// Wait for the queued database writes
+		if (FSLMongoService::GetInstance()->IsConnected())
+		{
+			FSLMongoService::GetInstance()->Drain();
+			UE_LOG(LogSL, Log, TEXT("%s::%d Mongo writes: %s"),
+				*FString(__func__), __LINE__, *FSLMongoService::GetInstance()->GetStats().ToString());
+		}
+
+		// Stop the incremental entity registration before the loggers data is deleted
+		FinishEntityRegistration();
+
+		// Dump the listener traces (the entity names are needed before deleting the semantic data)
+		if (!bLogMetadata && bLogEventData && bWriteEventTrace)
+		{
+			FSLTrace::DumpToFile(GetWorld(), FPaths::RemoveDuplicateSlashes(
+				FPaths::ProjectDir() + "/SemLog/" + TaskId + "/Episodes/" + EpisodeId + "_TR.bin"));
 		}
 
 		// Delete the semantic items content instance
-		FSLEntitiesManager::DeleteInstance();
+		FSLEntitiesManager::DeleteInstance(GetWorld());
+		FSLTagCache::DeleteInstance(GetWorld());
+
+		// Delete the supported by candidates of the finished contact shapes
+		FSLSupportedByEvaluator::DeleteInstance(GetWorld());
+
+		// Delete the delayed event timers (the finished listeners already published their pending events)
+		FSLTimerWheel::DeleteInstance(GetWorld());
 
 		// Mark manager as finished
 		bIsStarted = false;
@@ -293,6 +359,137 @@ void ASLManager::Finish(const float Time, bool bForced)
 	}
 }
 
+// Register an actor whose semantic tags were set after it was spawned
+bool ASLManager::RegisterActor(AActor* Actor)
+{
+	if (!bIsStarted || !Actor || Actor->IsPendingKill())
+	{
+		return false;
+	}
+
+	// Only the actor and its components are parsed, the world is not rescanned
+	TArray<FSLEntity> NewEntities;
+	if (FSLEntitiesManager::GetInstance(GetWorld())->AddActorEntities(Actor, NewEntities) == 0)
+	{
+		return false;
+	}
+
+	if (bLogWorldState && WorldStateLogger)
+	{
+		WorldStateLogger->AddEntities(NewEntities);
+	}
+	if (bLogEventData && EventDataLogger)
+	{
+		EventDataLogger->AddActorListeners(Actor);
+	}
+	Actor->OnDestroyed.AddUniqueDynamic(this, &ASLManager::OnEntityActorDestroyed);
+	return true;
+}
+
+// Register an annotated component added at runtime to an existing actor
+bool ASLManager::RegisterComponent(UActorComponent* Component)
+{
+	if (!bIsStarted || !Component || !Component->GetOwner())
+	{
+		return false;
+	}
+
+	FSLEntity NewEntity;
+	if (!FSLEntitiesManager::GetInstance(GetWorld())->AddComponentEntity(Component, NewEntity))
+	{
+		return false;
+	}
+
+	if (bLogWorldState && WorldStateLogger)
+	{
+		WorldStateLogger->AddEntities({ NewEntity });
+	}
+	if (bLogEventData && EventDataLogger)
+	{
+		EventDataLogger->AddActorListeners(Component->GetOwner());
+	}
+	Component->GetOwner()->OnDestroyed.AddUniqueDynamic(this, &ASLManager::OnEntityActorDestroyed);
+	return true;
+}
+
+// Hook the actor spawn and destroy callbacks
+void ASLManager::StartEntityRegistration()
+{
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &ASLManager::OnActorSpawned));
+
+	// Destroyed entities are removed as they go
+	for (const auto& Pair : FSLEntitiesManager::GetInstance(GetWorld())->GetObjectsSemanticData())
+	{
+		AActor* Actor = Cast<AActor>(Pair.Key);
+		if (!Actor)
+		{
+			if (UActorComponent* AsComp = Cast<UActorComponent>(Pair.Key))
+			{
+				Actor = AsComp->GetOwner();
+			}
+		}
+		if (Actor)
+		{
+			Actor->OnDestroyed.AddUniqueDynamic(this, &ASLManager::OnEntityActorDestroyed);
+		}
+	}
+}
+
+// Remove the actor spawn and destroy callbacks
+void ASLManager::FinishEntityRegistration()
+{
+	if (ActorSpawnedHandle.IsValid())
+	{
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		ActorSpawnedHandle.Reset();
+
+		for (const auto& Pair : FSLEntitiesManager::GetInstance(GetWorld())->GetObjectsSemanticData())
+		{
+			if (AActor* Actor = Cast<AActor>(Pair.Key))
+			{
+				Actor->OnDestroyed.RemoveDynamic(this, &ASLManager::OnEntityActorDestroyed);
+			}
+			else if (UActorComponent* AsComp = Cast<UActorComponent>(Pair.Key))
+			{
+				if (AsComp->GetOwner())
+				{
+					AsComp->GetOwner()->OnDestroyed.RemoveDynamic(this, &ASLManager::OnEntityActorDestroyed);
+				}
+			}
+		}
+	}
+}
+
+// Called when an actor is spawned in the world
+void ASLManager::OnActorSpawned(AActor* Actor)
+{
+	if (!RegisterActor(Actor))
+	{
+		// The tags are usually set right after spawning, check once more on the next tick
+		TWeakObjectPtr<AActor> WeakActor = Actor;
+		FSLTimerWheel::GetInstance(GetWorld())->Schedule(0.f, [this, WeakActor]()
+		{
+			if (WeakActor.IsValid())
+			{
+				RegisterActor(WeakActor.Get());
+			}
+		}, this);
+	}
+}
+
+// Called when a registered actor is destroyed
+void ASLManager::OnEntityActorDestroyed(AActor* DestroyedActor)
+{
+	if (bLogEventData && EventDataLogger)
+	{
+		EventDataLogger->RemoveActorListeners(DestroyedActor, GetWorld()->GetTimeSeconds());
+	}
+
+	// The world state writers drop the entity on their own once its weak pointer is invalid
+	FSLEntitiesManager::GetInstance(GetWorld())->RemoveActorEntities(DestroyedActor);
+}
+
 #if WITH_EDITOR
 // Called when a property is changed in the editor
 void ASLManager::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
@@ -341,15 +538,30 @@ bool ASLManager::CanEditChange(const UProperty* InProperty) const
 	// HostIP and HostPort can only be edited if the world state writer is of type Mongo
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, ServerIp))
 	{
-		return (WriterType == ESLWorldStateWriterType::MongoCxx) || (WriterType == ESLWorldStateWriterType::MongoC);
+		return (WriterType == ESLWorldStateWriterType::MongoCxx) || (WriterType == ESLWorldStateWriterType::MongoC)
+			|| (WriterType == ESLWorldStateWriterType::MongoCBuckets);
 	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, ServerPort))
 	{
-		return (WriterType == ESLWorldStateWriterType::MongoCxx) || (WriterType == ESLWorldStateWriterType::MongoC);
+		return (WriterType == ESLWorldStateWriterType::MongoCxx) || (WriterType == ESLWorldStateWriterType::MongoC)
+			|| (WriterType == ESLWorldStateWriterType::MongoCBuckets);
 	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, bLogMetadata))
 	{
-		return (WriterType == ESLWorldStateWriterType::MongoCxx) || (WriterType == ESLWorldStateWriterType::MongoC);
+		return (WriterType == ESLWorldStateWriterType::MongoCxx) || (WriterType == ESLWorldStateWriterType::MongoC)
+			|| (WriterType == ESLWorldStateWriterType::MongoCBuckets);
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, BucketMaxSamples))
+	{
+		return WriterType == ESLWorldStateWriterType::MongoCBuckets && !bUseTimeSeriesCollection;
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, BucketMaxDuration))
+	{
+		return WriterType == ESLWorldStateWriterType::MongoCBuckets && !bUseTimeSeriesCollection;
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, bUseTimeSeriesCollection))
+	{
+		return WriterType == ESLWorldStateWriterType::MongoCBuckets;
 	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLManager, bLogVisionData))
 	{
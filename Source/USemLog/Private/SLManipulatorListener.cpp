@@ -5,6 +5,7 @@
 #include "SLManipulatorOverlapSphere.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "SLEntitiesManager.h"
+#include "SLTrace.h"
 #include "GameFramework/PlayerController.h"
 #if SL_WITH_MC_GRASP
 #include "MCGraspAnimController.h"
@@ -53,13 +54,13 @@ bool USLManipulatorListener::Init(bool bInDetectGrasps, bool bInDetectContacts)
 		bDetectContacts = bInDetectContacts;
 		
 		// Init the semantic entities manager
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(GetWorld());
+			FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 		}
 
 		// Check that the owner is part of the semantic entities
-		SemanticOwner = FSLEntitiesManager::GetInstance()->GetEntity(GetOwner());
+		SemanticOwner = FSLEntitiesManager::GetInstance(GetWorld())->GetEntity(GetOwner());
 		if (!SemanticOwner.IsSet())
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Owner is not semantically annotated.."), *FString(__func__), __LINE__);
@@ -198,16 +199,19 @@ void USLManipulatorListener::Finish(bool bForced)
 		}
 		
 		// Publish dangling recently finished events
-		for (const auto& EvItr : RecentlyEndedGraspEvents)
+		FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+		for (auto& Pair : RecentlyEndedGraspEvents)
 		{
-			OnEndManipulatorGrasp.Broadcast(SemanticOwner, EvItr.OtherActor, EvItr.Time);
+			TimerWheel->Cancel(Pair.Value.TimerHandle);
+			OnEndManipulatorGrasp.Broadcast(SemanticOwner, Pair.Value.OtherActor, Pair.Value.Time);
 		}
 		RecentlyEndedGraspEvents.Empty();
 
 		// Publish dangling recently finished events
-		for (const auto& EvItr : RecentlyEndedContactEvents)
+		for (auto& Pair : RecentlyEndedContactEvents)
 		{
-			OnEndManipulatorContact.Broadcast(SemanticOwner, EvItr.OtherItem, EvItr.Time);
+			TimerWheel->Cancel(Pair.Value.TimerHandle);
+			OnEndManipulatorContact.Broadcast(SemanticOwner, Pair.Value.OtherItem, Pair.Value.Time);
 		}
 		RecentlyEndedContactEvents.Empty();
 
@@ -397,14 +401,12 @@ void USLManipulatorListener::BeginGrasp(AActor* OtherActor)
 	GraspedObjects.AddUnique(OtherActor);
 	if(!SkipRecentGraspEndEventBroadcast(OtherActor, GetWorld()->GetTimeSeconds()))
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] \t ~~~~~~~~~~~~~~~~~~~~~~~~~~ *BEGIN GRASP BCAST* with %s ~~~~~~~~~~~~~~~~~~~~~~~~~~"),
-		//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *OtherActor->GetName());
+		SL_TRACE(SL_TRACE_CAT_GRASP, ESLTraceEvent::GraspBegin, GetWorld()->GetTimeSeconds(), SemanticOwner.Obj, OtherActor);
 		OnBeginManipulatorGrasp.Broadcast(SemanticOwner, OtherActor, GetWorld()->GetTimeSeconds(), ActiveGraspType);
 	}
 	else
 	{
-		//UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t\t ~~~~~~~~~~ *END GRASP* cancelled (concatenation) ~~~~~~~~~~"),
-		//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+		SL_TRACE(SL_TRACE_CAT_GRASP, ESLTraceEvent::GraspConcatenated, GetWorld()->GetTimeSeconds(), SemanticOwner.Obj, OtherActor);
 	}
 }
 
@@ -413,67 +415,47 @@ void USLManipulatorListener::EndGrasp(AActor* OtherActor)
 {
 	if (GraspedObjects.Remove(OtherActor) > 0)
 	{
-		// Grasp ended
-		RecentlyEndedGraspEvents.Emplace(FSLGraspEndEvent(OtherActor, GetWorld()->GetTimeSeconds()));
-		
-		// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-		if(!GetWorld()->GetTimerManager().IsTimerActive(GraspDelayTimerHandle))
+		FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+
+		// A previous end with the same actor which could not be concatenated anymore is published right away
+		if (FSLGraspEndEvent* PrevEv = RecentlyEndedGraspEvents.Find(OtherActor))
 		{
-			GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this, &USLManipulatorListener::DelayedGraspEndEventCallback,
-				MaxGraspEventTimeGap * 1.2f, false);
+			TimerWheel->Cancel(PrevEv->TimerHandle);
+			OnEndManipulatorGrasp.Broadcast(SemanticOwner, PrevEv->OtherActor, PrevEv->Time);
+			RecentlyEndedGraspEvents.Remove(OtherActor);
 		}
+
+		// Grasp ended, delay publishing for a while, in case the new event is of the same type and should be concatenated
+		FSLGraspEndEvent& Ev = RecentlyEndedGraspEvents.Emplace(OtherActor, FSLGraspEndEvent(OtherActor, GetWorld()->GetTimeSeconds()));
+		Ev.TimerHandle = TimerWheel->Schedule(MaxGraspEventTimeGap * 1.2f,
+			[this, OtherActor]() { DelayedGraspEndEventCallback(OtherActor); }, this);
 	}
 }
 
-// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-void USLManipulatorListener::DelayedGraspEndEventCallback()
+// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+void USLManipulatorListener::DelayedGraspEndEventCallback(AActor* OtherActor)
 {
-	// Curr time (keep very recently added events for another delay)
-	const float CurrTime = GetWorld()->GetTimeSeconds();
-	
-	for (auto EvItr(RecentlyEndedGraspEvents.CreateIterator()); EvItr; ++EvItr)
-	{
-		// If enough time has passed, publish the event
-		if(CurrTime - EvItr->Time > MaxGraspEventTimeGap)
-		{
-			//UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ~~~~~~~~~~~~~~~~~~~~~~~~~~ *END GRASP BCAST* (with delay) GraspEnd=%f; with %s;  ~~~~~~~~~~~~~~~~~~~~~~~~~~"),
-			//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), EvItr->Time, *EvItr->OtherActor->GetName());
-			// Broadcast delayed event
-			OnEndManipulatorGrasp.Broadcast(SemanticOwner, EvItr->OtherActor, EvItr->Time);
-			
-			// Remove event from the pending list
-			EvItr.RemoveCurrent();
-		}
-	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedGraspEvents.Num() > 0)
+	FSLGraspEndEvent Ev;
+	if (RecentlyEndedGraspEvents.RemoveAndCopyValue(OtherActor, Ev))
 	{
-		GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this, &USLManipulatorListener::DelayedGraspEndEventCallback,
-			MaxGraspEventTimeGap * 1.2f, false);
+		// Broadcast delayed event
+		SL_TRACE(SL_TRACE_CAT_GRASP, ESLTraceEvent::GraspEnd, Ev.Time, SemanticOwner.Obj, Ev.OtherActor, GetWorld()->GetTimeSeconds());
+		OnEndManipulatorGrasp.Broadcast(SemanticOwner, Ev.OtherActor, Ev.Time);
 	}
 }
 
 // Check if this begin event happened right after the previous one ended, if so remove it from the array, and cancel publishing the begin event
 bool USLManipulatorListener::SkipRecentGraspEndEventBroadcast(AActor* OtherActor, float StartTime)
 {
-	for (auto EvItr(RecentlyEndedGraspEvents.CreateIterator()); EvItr; ++EvItr)
+	if (FSLGraspEndEvent* Ev = RecentlyEndedGraspEvents.Find(OtherActor))
 	{
-		// Check if it is an event between the same entities
-		if(EvItr->OtherActor == OtherActor)
+		// Check time difference
+		if(StartTime - Ev->Time < MaxGraspEventTimeGap)
 		{
-			// Check time difference
-			if(StartTime - EvItr->Time < MaxGraspEventTimeGap)
-			{
-				EvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedGraspEvents.Num() == 0)
-				{
-					GetWorld()->GetTimerManager().ClearTimer(GraspDelayTimerHandle);
-				}
-				return true;
-			}
+			// Cancel the delayed publish
+			FSLTimerWheel::GetInstance(GetWorld())->Cancel(Ev->TimerHandle);
+			RecentlyEndedGraspEvents.Remove(OtherActor);
+			return true;
 		}
 	}
 	return false;
@@ -485,7 +467,7 @@ bool USLManipulatorListener::SkipRecentGraspEndEventBroadcast(AActor* OtherActor
 // Process beginning of contact
 void USLManipulatorListener::OnBeginOverlapContact(AActor* OtherActor)
 {
-	if (FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(OtherActor))
+	if (FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(GetWorld())->GetEntityPtr(OtherActor))
 	{
 		if (int32* NumContacts = ObjectsInContact.Find(OtherActor))
 		{
@@ -498,8 +480,11 @@ void USLManipulatorListener::OnBeginOverlapContact(AActor* OtherActor)
 			const float CurrTime = GetWorld()->GetTimeSeconds();
 			if(!SkipRecentContactEndEventBroadcast(*OtherItem, CurrTime))
 			{
+				SL_TRACE(SL_TRACE_CAT_GRASP, ESLTraceEvent::ManipulatorContactBegin, CurrTime, SemanticOwner.Obj, OtherActor);
 				// Broadcast begin of semantic overlap event
-				OnBeginManipulatorContact.Broadcast(FSLContactResult(SemanticOwner, *OtherItem, CurrTime, false));
+				FSLEntitiesManager* EntitiesManager = FSLEntitiesManager::GetInstance(GetWorld());
+				OnBeginManipulatorContact.Broadcast(FSLContactResult(EntitiesManager->GetEntityHandle(SemanticOwner.Obj),
+					EntitiesManager->GetEntityHandle(OtherActor), CurrTime, false));
 			}
 		}
 	}
@@ -508,7 +493,7 @@ void USLManipulatorListener::OnBeginOverlapContact(AActor* OtherActor)
 // Process ending of contact
 void USLManipulatorListener::OnEndOverlapContact(AActor* OtherActor)
 {
-	if (FSLEntity* OtherItem = FSLEntitiesManager::GetInstance()->GetEntityPtr(OtherActor))
+	if (FSLEntity* OtherItem = FSLEntitiesManager::GetInstance(GetWorld())->GetEntityPtr(OtherActor))
 	{
 		if (int32* NumContacts = ObjectsInContact.Find(OtherActor))
 		{
@@ -519,15 +504,21 @@ void USLManipulatorListener::OnEndOverlapContact(AActor* OtherActor)
 				// Remove contact object
 				ObjectsInContact.Remove(OtherActor);
 				
-				// Manipulator contact ended
-				RecentlyEndedContactEvents.Emplace(FSLContactEndEvent(*OtherItem, GetWorld()->GetTimeSeconds()));
-				
-				// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-				if(!GetWorld()->GetTimerManager().IsTimerActive(ContactDelayTimerHandle))
+				FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+				UObject* OtherObj = OtherItem->Obj;
+
+				// A previous end with the same item which could not be concatenated anymore is published right away
+				if (FSLContactEndEvent* PrevEv = RecentlyEndedContactEvents.Find(OtherObj))
 				{
-					GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this, &USLManipulatorListener::DelayedContactEndEventCallback,
-						MaxContactEventTimeGap * 1.2f, false);
+					TimerWheel->Cancel(PrevEv->TimerHandle);
+					OnEndManipulatorContact.Broadcast(SemanticOwner, PrevEv->OtherItem, PrevEv->Time);
+					RecentlyEndedContactEvents.Remove(OtherObj);
 				}
+
+				// Manipulator contact ended, delay publishing for a while, in case the new event is of the same type and should be concatenated
+				FSLContactEndEvent& Ev = RecentlyEndedContactEvents.Emplace(OtherObj, FSLContactEndEvent(*OtherItem, GetWorld()->GetTimeSeconds()));
+				Ev.TimerHandle = TimerWheel->Schedule(MaxContactEventTimeGap * 1.2f,
+					[this, OtherObj]() { DelayedContactEndEventCallback(OtherObj); }, this);
 			}
 		}
 		else
@@ -537,52 +528,31 @@ void USLManipulatorListener::OnEndOverlapContact(AActor* OtherActor)
 	}
 }
 
-// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-void USLManipulatorListener::DelayedContactEndEventCallback()
+// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+void USLManipulatorListener::DelayedContactEndEventCallback(UObject* OtherObj)
 {
-	// Curr time (keep very recently added events for another delay)
-	const float CurrTime = GetWorld()->GetTimeSeconds();
-	
-	for (auto EvItr(RecentlyEndedContactEvents.CreateIterator()); EvItr; ++EvItr)
+	FSLContactEndEvent Ev;
+	if (RecentlyEndedContactEvents.RemoveAndCopyValue(OtherObj, Ev))
 	{
-		// If enough time has passed, publish the event
-		if(CurrTime - EvItr->Time > MaxContactEventTimeGap)
-		{
-			OnEndManipulatorContact.Broadcast(SemanticOwner, EvItr->OtherItem, EvItr->Time);
-			EvItr.RemoveCurrent();
-		}
-	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedContactEvents.Num() > 0)
-	{
-		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this, &USLManipulatorListener::DelayedContactEndEventCallback,
-			MaxContactEventTimeGap * 1.2f, false);
+		SL_TRACE(SL_TRACE_CAT_GRASP, ESLTraceEvent::ManipulatorContactEnd, Ev.Time, SemanticOwner.Obj, OtherObj, GetWorld()->GetTimeSeconds());
+		OnEndManipulatorContact.Broadcast(SemanticOwner, Ev.OtherItem, Ev.Time);
 	}
 }
 
 // Check if this begin event happened right after the previous one ended, if so remove it from the array, and cancel publishing the begin event
 bool USLManipulatorListener::SkipRecentContactEndEventBroadcast(const FSLEntity& OtherItem, float StartTime)
 {
-	for (auto EvItr(RecentlyEndedContactEvents.CreateIterator()); EvItr; ++EvItr)
+	if (FSLContactEndEvent* Ev = RecentlyEndedContactEvents.Find(OtherItem.Obj))
 	{
-		// Check if it is an event between the same entities
-		if(EvItr->OtherItem.EqualsFast(OtherItem))
+		// Check time difference between the previous and current event
+		const float TimeGap = StartTime - Ev->Time;
+		if(TimeGap < MaxContactEventTimeGap)
 		{
-			// Check time difference between the previous and current event
-			const float TimeGap = StartTime - EvItr->Time;
-			if(TimeGap < MaxContactEventTimeGap)
-			{
-				// Event will be concatenated
-				EvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedContactEvents.Num() == 0)
-				{
-					GetWorld()->GetTimerManager().ClearTimer(ContactDelayTimerHandle);
-				}
-				return true;
-			}
+			// Event will be concatenated, cancel the delayed publish
+			SL_TRACE(SL_TRACE_CAT_GRASP, ESLTraceEvent::ManipulatorContactConcatenated, StartTime, SemanticOwner.Obj, OtherItem.Obj, TimeGap);
+			FSLTimerWheel::GetInstance(GetWorld())->Cancel(Ev->TimerHandle);
+			RecentlyEndedContactEvents.Remove(OtherItem.Obj);
+			return true;
 		}
 	}
 	return false;
@@ -2,7 +2,6 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "SLManipulatorOverlapSphere.h"
-#include "TimerManager.h"
 
 // Ctor
 USLManipulatorOverlapSphere::USLManipulatorOverlapSphere()
@@ -143,16 +142,19 @@ void USLManipulatorOverlapSphere::Finish(bool bForced)
 	if (!bIsFinished && (bIsInit || bIsStarted))
 	{
 		// Publish dangling recently finished events
-		for (const auto& EvItr : RecentlyEndedGraspOverlapEvents)
+		FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+		for (auto& Pair : RecentlyEndedGraspOverlapEvents)
 		{
-			OnEndManipulatorGraspOverlap.Broadcast(EvItr.OtherActor);
+			TimerWheel->Cancel(Pair.Value.TimerHandle);
+			OnEndManipulatorGraspOverlap.Broadcast(Pair.Value.OtherActor);
 		}
 		RecentlyEndedGraspOverlapEvents.Empty();
 
 		// Publish dangling recently finished events
-		for (const auto& EvItr : RecentlyEndedContactOverlapEvents)
+		for (auto& Pair : RecentlyEndedContactOverlapEvents)
 		{
-			OnEndManipulatorContactOverlap.Broadcast(EvItr.OtherActor);
+			TimerWheel->Cancel(Pair.Value.TimerHandle);
+			OnEndManipulatorContactOverlap.Broadcast(Pair.Value.OtherActor);
 		}
 		RecentlyEndedContactOverlapEvents.Empty();
 
@@ -377,16 +379,21 @@ void USLManipulatorOverlapSphere::OnGraspOverlapEnd(UPrimitiveComponent* Overlap
 	{
 		if (ActiveContacts.Remove(OtherActor) > 0)
 		{
-			// Grasp overlap ended ended
-			RecentlyEndedGraspOverlapEvents.Emplace(FSLManipulatorOverlapEndEvent(
-				OtherActor, GetWorld()->GetTimeSeconds()));
-			
-			// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-			if(!GetWorld()->GetTimerManager().IsTimerActive(GraspDelayTimerHandle))
+			FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+
+			// A previous end with the same actor which could not be concatenated anymore is published right away
+			if (FSLManipulatorOverlapEndEvent* PrevEv = RecentlyEndedGraspOverlapEvents.Find(OtherActor))
 			{
-				GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this, 
-					&USLManipulatorOverlapSphere::DelayedGraspOverlapEndEventCallback, MaxOverlapEventTimeGap*1.1f, false);
+				TimerWheel->Cancel(PrevEv->TimerHandle);
+				OnEndManipulatorGraspOverlap.Broadcast(PrevEv->OtherActor);
+				RecentlyEndedGraspOverlapEvents.Remove(OtherActor);
 			}
+
+			// Grasp overlap ended, delay publishing for a while, in case the new event is of the same type and should be concatenated
+			FSLManipulatorOverlapEndEvent& Ev = RecentlyEndedGraspOverlapEvents.Emplace(OtherActor,
+				FSLManipulatorOverlapEndEvent(OtherActor, GetWorld()->GetTimeSeconds()));
+			Ev.TimerHandle = TimerWheel->Schedule(MaxOverlapEventTimeGap * 1.1f,
+				[this, OtherActor]() { DelayedGraspOverlapEndEventCallback(OtherActor); }, this);
 		}
 
 		if (bVisualDebug)
@@ -399,53 +406,29 @@ void USLManipulatorOverlapSphere::OnGraspOverlapEnd(UPrimitiveComponent* Overlap
 	}
 }
 
-// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-void USLManipulatorOverlapSphere::DelayedGraspOverlapEndEventCallback()
+// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+void USLManipulatorOverlapSphere::DelayedGraspOverlapEndEventCallback(AActor* OtherActor)
 {
-	// Curr time (keep very recently added events for another delay)
-	const float CurrTime = GetWorld()->GetTimeSeconds();
-	
-	for (auto EvItr(RecentlyEndedGraspOverlapEvents.CreateIterator()); EvItr; ++EvItr)
-	{
-		// If enough time has passed, publish the event
-		if(CurrTime - EvItr->Time > MaxOverlapEventTimeGap)
-		{
-			// Broadcast delayed event
-			OnEndManipulatorGraspOverlap.Broadcast(EvItr->OtherActor);
-			
-			// Remove event from the pending list
-			EvItr.RemoveCurrent();
-		}
-	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedGraspOverlapEvents.Num() > 0)
+	FSLManipulatorOverlapEndEvent Ev;
+	if (RecentlyEndedGraspOverlapEvents.RemoveAndCopyValue(OtherActor, Ev))
 	{
-		GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this, &USLManipulatorOverlapSphere::DelayedGraspOverlapEndEventCallback,
-			MaxOverlapEventTimeGap*1.1f, false);
+		// Broadcast delayed event
+		OnEndManipulatorGraspOverlap.Broadcast(Ev.OtherActor);
 	}
 }
 
 // Check if this begin event happened right after the previous one ended, if so remove it from the array, and cancel publishing the begin event
 bool USLManipulatorOverlapSphere::SkipRecentGraspOverlapEndEventBroadcast(AActor* OtherActor, float StartTime)
 {
-	for (auto EvItr(RecentlyEndedGraspOverlapEvents.CreateIterator()); EvItr; ++EvItr)
+	if (FSLManipulatorOverlapEndEvent* Ev = RecentlyEndedGraspOverlapEvents.Find(OtherActor))
 	{
-		// Check if it is an event between the same entities
-		if(EvItr->OtherActor == OtherActor)
+		// Check time difference
+		if(StartTime - Ev->Time < MaxOverlapEventTimeGap)
 		{
-			// Check time difference
-			if(StartTime - EvItr->Time < MaxOverlapEventTimeGap)
-			{
-				EvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedGraspOverlapEvents.Num() == 0)
-				{
-					GetWorld()->GetTimerManager().ClearTimer(GraspDelayTimerHandle);
-				}
-				return true;
-			}
+			// Cancel the delayed publish
+			FSLTimerWheel::GetInstance(GetWorld())->Cancel(Ev->TimerHandle);
+			RecentlyEndedGraspOverlapEvents.Remove(OtherActor);
+			return true;
 		}
 	}
 	return false;
@@ -506,43 +489,32 @@ void USLManipulatorOverlapSphere::OnContactOverlapEnd(UPrimitiveComponent* Overl
 	if (OtherActor->IsA(AStaticMeshActor::StaticClass())
 		&& !IgnoreList.Contains(OtherActor))
 	{
-		// Contact overlap ended ended
-		RecentlyEndedContactOverlapEvents.Emplace(FSLManipulatorOverlapEndEvent(
-			OtherActor, GetWorld()->GetTimeSeconds()));
-		
-		// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-		if(!GetWorld()->GetTimerManager().IsTimerActive(ContactDelayTimerHandle))
+		FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+
+		// A previous end with the same actor which could not be concatenated anymore is published right away
+		if (FSLManipulatorOverlapEndEvent* PrevEv = RecentlyEndedContactOverlapEvents.Find(OtherActor))
 		{
-			GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this, 
-				&USLManipulatorOverlapSphere::DelayedContactOverlapEndEventCallback, MaxOverlapEventTimeGap*1.1f, false);
+			TimerWheel->Cancel(PrevEv->TimerHandle);
+			OnEndManipulatorContactOverlap.Broadcast(PrevEv->OtherActor);
+			RecentlyEndedContactOverlapEvents.Remove(OtherActor);
 		}
+
+		// Contact overlap ended, delay publishing for a while, in case the new event is of the same type and should be concatenated
+		FSLManipulatorOverlapEndEvent& Ev = RecentlyEndedContactOverlapEvents.Emplace(OtherActor,
+			FSLManipulatorOverlapEndEvent(OtherActor, GetWorld()->GetTimeSeconds()));
+		Ev.TimerHandle = TimerWheel->Schedule(MaxOverlapEventTimeGap * 1.1f,
+			[this, OtherActor]() { DelayedContactOverlapEndEventCallback(OtherActor); }, this);
 	}
 }
 
-// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-void USLManipulatorOverlapSphere::DelayedContactOverlapEndEventCallback()
+// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+void USLManipulatorOverlapSphere::DelayedContactOverlapEndEventCallback(AActor* OtherActor)
 {
-	// Curr time (keep very recently added events for another delay)
-	const float CurrTime = GetWorld()->GetTimeSeconds();
-	
-	for (auto EvItr(RecentlyEndedContactOverlapEvents.CreateIterator()); EvItr; ++EvItr)
-	{
-		// If enough time has passed, publish the event
-		if(CurrTime - EvItr->Time > MaxOverlapEventTimeGap)
-		{
-			// Broadcast delayed event
-			OnEndManipulatorContactOverlap.Broadcast(EvItr->OtherActor);
-			
-			// Remove event from the pending list
-			EvItr.RemoveCurrent();
-		}
-	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedContactOverlapEvents.Num() > 0)
+	FSLManipulatorOverlapEndEvent Ev;
+	if (RecentlyEndedContactOverlapEvents.RemoveAndCopyValue(OtherActor, Ev))
 	{
-		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this, &USLManipulatorOverlapSphere::DelayedContactOverlapEndEventCallback,
-			MaxOverlapEventTimeGap*1.1f, false);
+		// Broadcast delayed event
+		OnEndManipulatorContactOverlap.Broadcast(Ev.OtherActor);
 	}
 }
 
@@ -550,23 +522,15 @@ void USLManipulatorOverlapSphere::DelayedContactOverlapEndEventCallback()
 // if so remove it from the array, and cancel publishing the begin event
 bool USLManipulatorOverlapSphere::SkipRecentContactOverlapEndEventBroadcast(AActor* OtherActor, float StartTime)
 {
-	for (auto EvItr(RecentlyEndedContactOverlapEvents.CreateIterator()); EvItr; ++EvItr)
+	if (FSLManipulatorOverlapEndEvent* Ev = RecentlyEndedContactOverlapEvents.Find(OtherActor))
 	{
-		// Check if it is an event between the same entities
-		if(EvItr->OtherActor == OtherActor)
+		// Check time difference
+		if(StartTime - Ev->Time < MaxOverlapEventTimeGap)
 		{
-			// Check time difference
-			if(StartTime - EvItr->Time < MaxOverlapEventTimeGap)
-			{
-				EvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedContactOverlapEvents.Num() == 0)
-				{
-					GetWorld()->GetTimerManager().ClearTimer(ContactDelayTimerHandle);
-				}
-				return true;
-			}
+			// Cancel the delayed publish
+			FSLTimerWheel::GetInstance(GetWorld())->Cancel(Ev->TimerHandle);
+			RecentlyEndedContactOverlapEvents.Remove(OtherActor);
+			return true;
 		}
 	}
 	return false;
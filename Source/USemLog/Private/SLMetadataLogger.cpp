@@ -3,6 +3,7 @@
 
 #include "SLMetadataLogger.h"
 #include "SLEntitiesManager.h"
+#include "SLMongoService.h"
 #include "Conversions.h"
 #include "Tags.h"
 #include "Components/SkeletalMeshComponent.h"
@@ -29,7 +30,7 @@ USLMetadataLogger::~USLMetadataLogger()
 
 // Init logger
 void USLMetadataLogger::Init(const FString& InTaskId, const FString InServerIp, uint16 InServerPort,
-		 bool bScanItems, FIntPoint Resolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally, bool bOverwrite)
+		 bool bScanItems, FIntPoint Resolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally, bool bOverwrite, int32 ScanBatchSize, bool bUseScanCache, int32 ScanUploadBudgetMB)
 {
 	if (!bIsInit)
 	{
@@ -40,9 +41,19 @@ void USLMetadataLogger::Init(const FString& InTaskId, const FString InServerIp,
 
 		if(bScanItems)
 		{
+#if SL_WITH_LIBMONGO_C
+			// The images are uploaded while the next scans are rendered
+			ScanUploader = MakeUnique<FSLScanUploader>();
+			if(!ScanUploader->Start(gridfs, DatabaseName, MetaCollName, int64(ScanUploadBudgetMB) * 1024 * 1024))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not start the scan uploader.."), *FString(__func__), __LINE__);
+				ScanUploader.Reset();
+			}
+#endif //SL_WITH_LIBMONGO_C
+
 			ItemsScanner = NewObject<USLItemScanner>(this);
 			ItemsScanner->Init(InTaskId, InServerIp, InServerPort,
-				Resolution, InViewModes, bIncludeScansLocally);
+				Resolution, InViewModes, bIncludeScansLocally, ScanBatchSize, bUseScanCache);
 		}
 
 		bIsInit = true;
@@ -66,13 +77,8 @@ void USLMetadataLogger::Start(const FString& InTaskDescription)
 		AddEnvironmentData(doc);
 		AddCameraViews(doc);
 
-		// Write document to the collection
-		bson_error_t error;
-		if (!mongoc_collection_insert_one(collection, doc, NULL, NULL, &error))
-		{
-			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
-				*FString(__func__), __LINE__, *FString(error.message));
-		}
+		// Queue the document for writing (the service takes care of the clean up)
+		FSLMongoService::GetInstance()->Submit(DatabaseName, MetaCollName, doc);
 
 		// Start the item scanner, for every finished scan it will trigger an update call on the logger
 		if(ItemsScanner)
@@ -93,6 +99,12 @@ void USLMetadataLogger::Finish(bool bForced)
 		{
 			ItemsScanner->Finish();
 		}
+
+		// Upload the remaining images and write their scan entries
+		if(ScanUploader)
+		{
+			ScanUploader->Finish();
+		}
 		
 		bIsStarted = false;
 		bIsInit = false;
@@ -103,35 +115,26 @@ void USLMetadataLogger::Finish(bool bForced)
 // Connect to the database
 bool USLMetadataLogger::Connect(const FString& DBName, const FString& ServerIp, uint16 ServerPort, bool bOverwrite)
 {
-	const FString MetaCollName = DBName + ".meta";
+	MetaCollName = DBName + ".meta";
 	
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
-	// Stores any error that might appear during the connection
-	bson_error_t error;
-
-	// Safely create a MongoDB URI object from the given string
-	FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
-	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Uri), &error);
-	if (!uri)
+	// Make sure the shared client pool and writer threads are running
+	if (!FSLMongoService::GetInstance()->Connect(ServerIp, ServerPort))
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s; [Uri=%s]"),
-			*FString(__func__), __LINE__, *FString(error.message), *Uri);
 		return false;
 	}
 
-	// Create a new client instance
-	client = mongoc_client_new_from_uri(uri);
+	// Stores any error that might appear during the connection
+	bson_error_t error;
+
+	// Client kept for the gridfs handle and the synchronous operations, the writes go through the service
+	client = FSLMongoService::GetInstance()->PopClient();
 	if (!client)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create a mongo client.."), *FString(__func__), __LINE__);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not get a mongo client from the pool.."), *FString(__func__), __LINE__);
 		return false;
 	}
-
-	// Register the application name so we can track it in the profile logs on the server
-	mongoc_client_set_appname(client, TCHAR_TO_UTF8(*("SL_" + MetaCollName)));
+	DatabaseName = DBName;
 	
 	// Get a handle on the database "db_name" and collection "coll_name"
 	database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
@@ -165,28 +168,35 @@ bool USLMetadataLogger::Connect(const FString& DBName, const FString& ServerIp,
 
 	collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*MetaCollName));
 
+	// Remove the scan images of the previous run as well (the gridfs collections are created with the handle)
+	if (bOverwrite)
+	{
+		for (const FString& GridFSCollName : { MetaCollName + ".files", MetaCollName + ".chunks" })
+		{
+			if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*GridFSCollName), &error))
+			{
+				mongoc_collection_t* gridfs_coll = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*GridFSCollName));
+				const bool bDropped = mongoc_collection_drop(gridfs_coll, &error);
+				mongoc_collection_destroy(gridfs_coll);
+				if (!bDropped)
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d Could not drop collection %s, err.:%s;"),
+						*FString(__func__), __LINE__, *GridFSCollName, *FString(error.message));
+					return false;
+				}
+			}
+		}
+	}
 
-	// Create a gridfs handle prefixed by fs */
+	// Create a gridfs handle prefixed by the meta collection name
 	gridfs = mongoc_client_get_gridfs(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*MetaCollName), &error);
 	if (!gridfs)
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
-			*FString(__func__), __LINE__, *Uri, *FString(error.message));
-		return false;
-	}
-
-	// Double check that the server is alive. Ping the "admin" database
-	bson_t* server_ping_cmd;
-	server_ping_cmd = BCON_NEW("ping", BCON_INT32(1));
-	if (!mongoc_client_command_simple(client, "admin", server_ping_cmd, NULL, NULL, &error))
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Check server err.: %s"),
 			*FString(__func__), __LINE__, *FString(error.message));
-		bson_destroy(server_ping_cmd);
 		return false;
 	}
 
-	bson_destroy(server_ping_cmd);
 	return true;
 #else
 	return false;
@@ -197,83 +207,58 @@ bool USLMetadataLogger::Connect(const FString& DBName, const FString& ServerIp,
 void USLMetadataLogger::Disconnect()
 {
 #if SL_WITH_LIBMONGO_C
-	// Release handles and clean up mongoc
+	// The uploader thread uses the gridfs handle
+	ScanUploader.Reset();
+
+	// Release handles and return the client to the pool
 	if(gridfs)
 	{
 		mongoc_gridfs_destroy(gridfs);
+		gridfs = nullptr;
 	}
-	if(uri)
-	{
-		mongoc_uri_destroy(uri);
-	}
-	if(client)
+	if(collection)
 	{
-		mongoc_client_destroy(client);
+		mongoc_collection_destroy(collection);
+		collection = nullptr;
 	}
 	if(database)
 	{
 		mongoc_database_destroy(database);
+		database = nullptr;
 	}
-	if(collection)
-	{
-		mongoc_collection_destroy(collection);
-	}
-	if(scan_doc)
+	if(client)
 	{
-		bson_destroy(scan_doc);
+		FSLMongoService::GetInstance()->PushClient(client);
+		client = nullptr;
 	}
-	mongoc_cleanup();
 #endif //SL_WITH_LIBMONGO_C
 }
 
-// Create the scan entry bson document
-void USLMetadataLogger::StartScanEntry()
+// Start a new scan entry
+void USLMetadataLogger::StartScanEntry(int32 ItemIdx, const FString& Class, int32 PoseIdx)
 {
-#if SL_WITH_LIBMONGO_C
-	scan_doc = bson_new();
-	scan_img_arr_doc = bson_new();
-	img_arr_idx = 0;
-	BSON_APPEND_ARRAY_BEGIN(scan_doc, "images", scan_img_arr_doc);
-#endif //SL_WITH_LIBMONGO_C
+	if(ScanUploader)
+	{
+		ScanUploader->BeginEntry(ItemIdx, Class, PoseIdx);
+	}
 }
 
-// Add image to gridfs and the oid to the array doc
+// Queue the image for the gridfs upload, its file id is added to the scan entry once uploaded
 void USLMetadataLogger::AddImageEntry(const FString& ViewType, const TArray<uint8>& CompressedBitmap)
 {
-#if SL_WITH_LIBMONGO_C
-	bson_t img_arr_obj;
-	char k_str[16];
-	const char *k_key;
-	
-	bson_uint32_to_string(img_arr_idx, &k_key, k_str, sizeof k_str);
-	
-	BSON_APPEND_DOCUMENT_BEGIN(scan_img_arr_doc, k_key, &img_arr_obj);
-		BSON_APPEND_UTF8(&img_arr_obj, "type", TCHAR_TO_UTF8(*ViewType));
-		//BSON_APPEND_OID(&img_arr_obj, "file_id", (const bson_oid_t*)&img_file_id);
-	bson_append_document_end(scan_img_arr_doc, &img_arr_obj);
-	
-	img_arr_idx++;
-#endif //SL_WITH_LIBMONGO_C
+	if(ScanUploader)
+	{
+		ScanUploader->AddImage(ViewType, CompressedBitmap);
+	}
 }
 
-// Write the document to the database
+// Close the scan entry, written once all its images are uploaded
 void USLMetadataLogger::WriteScanEntry()
 {
-#if SL_WITH_LIBMONGO_C
-	if(scan_doc && scan_img_arr_doc)
+	if(ScanUploader)
 	{
-		bson_append_array_end(scan_doc, scan_img_arr_doc);
-
-		bson_error_t error;
-		if (!mongoc_collection_insert_one(collection, scan_doc, NULL, NULL, &error))
-		{
-			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
-				*FString(__func__), __LINE__, *FString(error.message));
-		}
-		bson_destroy(scan_img_arr_doc);
-		bson_destroy(scan_doc);
+		ScanUploader->EndEntry();
 	}
-#endif //SL_WITH_LIBMONGO_C
 }
 
 
@@ -297,9 +282,9 @@ void USLMetadataLogger::AddEnvironmentData(bson_t* in_doc)
 	// Add entities to array
 	BSON_APPEND_ARRAY_BEGIN(in_doc, "entities", &arr);
 	// Iterate non skeletal semantic entities
-	for (const auto& Pair : FSLEntitiesManager::GetInstance()->GetObjectsSemanticData())
+	for (const auto& Pair : FSLEntitiesManager::GetInstance(GetWorld())->GetObjectsSemanticData())
 	{
-		const FSLEntity SemEntity = Pair.Value;
+		const FSLEntity& SemEntity = *Pair.Value;
 
 		// Ignore skeletal entities
 		if (Cast<ASkeletalMeshActor>(SemEntity.Obj) || Cast<USkeletalMeshComponent>(SemEntity.Obj))
@@ -345,7 +330,7 @@ void USLMetadataLogger::AddEnvironmentData(bson_t* in_doc)
 	// Reset array index
 	idx=0;
 	// Iterate skeletal semantic entities
-	for (const auto& Pair : FSLEntitiesManager::GetInstance()->GetObjectsSkeletalSemanticData())
+	for (const auto& Pair : FSLEntitiesManager::GetInstance(GetWorld())->GetObjectsSkeletalSemanticData())
 	{
 		USLSkeletalDataComponent* SkelDataComp = Pair.Value;
 		USkeletalMeshComponent* SkMComp = SkelDataComp->SkeletalMeshParent;
@@ -434,7 +419,7 @@ void USLMetadataLogger::AddCameraViews(bson_t* in_doc)
 	BSON_APPEND_ARRAY_BEGIN(in_doc, "camera_views", &arr);
 
 	// Iterate non skeletal semantic entities
-	for (const auto& Pair : FSLEntitiesManager::GetInstance()->GetCameraViewsSemanticData())
+	for (const auto& Pair : FSLEntitiesManager::GetInstance(GetWorld())->GetCameraViewsSemanticData())
 	{
 		const FSLEntity SemEntity = Pair.Value;
 
@@ -0,0 +1,151 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLMongoIndexesCommandlet.h"
+#include "SLMongoService.h"
+#include "WorldState/SLWorldStateWriterMongoC.h"
+#include "WorldState/SLWorldStateWriterMongoCBuckets.h"
+#include "Misc/Parse.h"
+
+// Ctor
+USLMongoIndexesCommandlet::USLMongoIndexesCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Build the indexes
+int32 USLMongoIndexesCommandlet::Main(const FString& Params)
+{
+	FString DBName;
+	if (!FParse::Value(*Params, TEXT("db="), DBName))
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Missing -db=<TaskId>.."), *FString(__func__), __LINE__);
+		return 1;
+	}
+	FString ServerIp = TEXT("127.0.0.1");
+	FParse::Value(*Params, TEXT("ip="), ServerIp);
+	int32 ServerPort = 27017;
+	FParse::Value(*Params, TEXT("port="), ServerPort);
+	int32 NumParallel = 4;
+	FParse::Value(*Params, TEXT("parallel="), NumParallel);
+
+	// Indexes to build, explicit keys or the ones of the given writer type
+	TArray<FString> Keys;
+	FString KeysStr;
+	FString Type = TEXT("ws");
+	FParse::Value(*Params, TEXT("type="), Type);
+	if (FParse::Value(*Params, TEXT("keys="), KeysStr, false))
+	{
+		KeysStr.ParseIntoArray(Keys, TEXT(","));
+	}
+	else if (Type.Equals(TEXT("ws")))
+	{
+		Keys = FSLWorldStateWriterMongoC::GetIndexKeys();
+	}
+	else if (Type.Equals(TEXT("buckets")) || Type.Equals(TEXT("timeseries")))
+	{
+		Keys = FSLWorldStateWriterMongoCBuckets::GetIndexKeys(Type.Equals(TEXT("timeseries")));
+	}
+	else
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Unknown type %s (ws|buckets|timeseries), or set the -keys= explicitly.."),
+			*FString(__func__), __LINE__, *Type);
+		return 1;
+	}
+
+	FSLMongoService* Service = FSLMongoService::GetInstance();
+	if (!Service->Connect(ServerIp, ServerPort))
+	{
+		return 1;
+	}
+
+	// Episodes to index
+	TArray<FString> CollNames;
+	FString CollsStr;
+	if (FParse::Value(*Params, TEXT("colls="), CollsStr, false))
+	{
+		CollsStr.ParseIntoArray(CollNames, TEXT(","));
+	}
+	else if (FParse::Param(*Params, TEXT("all")))
+	{
+		GetEpisodeCollections(DBName, CollNames);
+	}
+	if (CollNames.Num() == 0)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d No episodes to index, set -colls=<Ep1,Ep2,..> or -all.."),
+			*FString(__func__), __LINE__);
+		FSLMongoService::DeleteInstance();
+		return 1;
+	}
+
+	UE_LOG(LogSL, Display, TEXT("%s::%d Building [%s] on %d episodes of %s (%d in parallel).."),
+		*FString(__func__), __LINE__, *FString::Join(Keys, TEXT(",")), CollNames.Num(), *DBName, NumParallel);
+	const double StartTime = FPlatformTime::Seconds();
+	Service->SetMaxParallelIndexBuilds(NumParallel);
+	for (const FString& CollName : CollNames)
+	{
+		Service->BuildIndexesAsync(DBName, CollName, Keys);
+	}
+
+	// Report the progress until all the builds are finished
+	int32 NumFinished = 0;
+	int32 NumFailed = 0;
+	int32 NumTotal = 0;
+	int32 LastNumFinished = -1;
+	do
+	{
+		FPlatformProcess::Sleep(0.5f);
+		Service->GetIndexJobsProgress(NumFinished, NumFailed, NumTotal);
+		if (NumFinished != LastNumFinished)
+		{
+			UE_LOG(LogSL, Display, TEXT("%s::%d Progress: %d/%d (%d failed) after %.1fs.."),
+				*FString(__func__), __LINE__, NumFinished, NumTotal, NumFailed, FPlatformTime::Seconds() - StartTime);
+			LastNumFinished = NumFinished;
+		}
+	} while (NumFinished < NumTotal);
+
+	for (const FSLMongoIndexJobStatus& Job : Service->GetIndexJobs())
+	{
+		UE_LOG(LogSL, Display, TEXT("\t%s"), *Job.ToString());
+	}
+	FSLMongoService::DeleteInstance();
+	return NumFailed > 0 ? 1 : 0;
+}
+
+// Get the names of all the episode collections of the database
+bool USLMongoIndexesCommandlet::GetEpisodeCollections(const FString& DBName, TArray<FString>& OutCollNames) const
+{
+#if SL_WITH_LIBMONGO_C
+	mongoc_client_t* client = FSLMongoService::GetInstance()->PopClient();
+	mongoc_database_t* database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
+	bson_error_t error;
+	char** coll_names = mongoc_database_get_collection_names_with_opts(database, NULL, &error);
+	const bool bSuccess = coll_names != nullptr;
+	if (!bSuccess)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Could not list the collections of %s, err.:%s;"),
+			*FString(__func__), __LINE__, *DBName, *FString(error.message));
+	}
+	else
+	{
+		for (int32 Idx = 0; coll_names[Idx]; ++Idx)
+		{
+			// Skip the metadata (<TaskId>.meta), gridfs (<Ep>.files/chunks) and system collections
+			const FString CollName = UTF8_TO_TCHAR(coll_names[Idx]);
+			if (!CollName.Contains(TEXT(".")))
+			{
+				OutCollNames.Add(CollName);
+			}
+		}
+		bson_strfreev(coll_names);
+	}
+	mongoc_database_destroy(database);
+	FSLMongoService::GetInstance()->PushClient(client);
+	return bSuccess;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
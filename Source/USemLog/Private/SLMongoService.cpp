@@ -0,0 +1,711 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLMongoService.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+
+TSharedPtr<FSLMongoService> FSLMongoService::StaticInstance;
+bool FSLMongoService::bIsDriverInit = false;
+
+// Build the indexes
+void FSLMongoIndexBuildTask::DoWork()
+{
+	Service->RunIndexJob(Namespace);
+}
+
+// Writer thread loop
+uint32 FSLMongoWriterRunnable::Run()
+{
+#if SL_WITH_LIBMONGO_C
+	while (!bStop)
+	{
+		if (!Service->ProcessNextBatch())
+		{
+			// Nothing to write, wait for new submissions (timeout in case of a missed trigger)
+			Service->WorkEvent->Wait(10);
+		}
+	}
+#endif //SL_WITH_LIBMONGO_C
+	return 0;
+}
+
+// Constructor
+FSLMongoService::FSLMongoService() : bIsConnected(false), NumRunningIndexJobs(0), MaxParallelIndexBuilds(2),
+	NextQueueIdx(0), WorkEvent(nullptr)
+{
+#if SL_WITH_LIBMONGO_C
+	uri = nullptr;
+	pool = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Destructor
+FSLMongoService::~FSLMongoService()
+{
+	Disconnect();
+}
+
+// Get singleton
+FSLMongoService* FSLMongoService::GetInstance()
+{
+	if (!StaticInstance.IsValid())
+	{
+		StaticInstance = MakeShareable(new FSLMongoService());
+	}
+	return StaticInstance.Get();
+}
+
+// Delete instance
+void FSLMongoService::DeleteInstance()
+{
+	StaticInstance.Reset();
+}
+
+// Initialize libmongoc once for the plugin
+void FSLMongoService::InitDriver()
+{
+#if SL_WITH_LIBMONGO_C
+	if (!bIsDriverInit)
+	{
+		mongoc_init();
+		bIsDriverInit = true;
+	}
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Clean up libmongoc
+void FSLMongoService::CleanupDriver()
+{
+#if SL_WITH_LIBMONGO_C
+	if (bIsDriverInit)
+	{
+		mongoc_cleanup();
+		bIsDriverInit = false;
+	}
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// True if the client pool is created
+bool FSLMongoService::IsConnected() const
+{
+	FScopeLock Lock(&ConnectionLock);
+	return bIsConnected;
+}
+
+// Create the client pool and the writer threads
+bool FSLMongoService::Connect(const FString& ServerIp, uint16 ServerPort)
+{
+#if SL_WITH_LIBMONGO_C
+	FScopeLock Lock(&ConnectionLock);
+	const FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
+	if (bIsConnected)
+	{
+		if (!Uri.Equals(ConnectedUri))
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Service is already connected to %s, cannot connect to %s.."),
+				*FString(__func__), __LINE__, *ConnectedUri, *Uri);
+			return false;
+		}
+		return true;
+	}
+
+	// Stores any error that might appear during the connection
+	bson_error_t error;
+
+	// Safely create a MongoDB URI object from the given string
+	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Uri), &error);
+	if (!uri)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Err.:%s; [Uri=%s]"),
+			*FString(__func__), __LINE__, *FString(error.message), *Uri);
+		return false;
+	}
+
+	// Create the thread safe pool
+	pool = mongoc_client_pool_new(uri);
+	if (!pool)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Could not create a mongo client pool.."), *FString(__func__), __LINE__);
+		mongoc_uri_destroy(uri);
+		uri = nullptr;
+		return false;
+	}
+	mongoc_client_pool_max_size(pool, MaxPoolSize);
+	mongoc_client_pool_set_error_api(pool, MONGOC_ERROR_API_VERSION_2);
+
+	// Register the application name so we can track it in the profile logs on the server
+	mongoc_client_pool_set_appname(pool, "SL");
+
+	// Check server. Ping the "admin" database
+	mongoc_client_t* client = mongoc_client_pool_pop(pool);
+	bson_t* server_ping_cmd = BCON_NEW("ping", BCON_INT32(1));
+	const bool bServerIsAlive = mongoc_client_command_simple(client, "admin", server_ping_cmd, NULL, NULL, &error);
+	bson_destroy(server_ping_cmd);
+	mongoc_client_pool_push(pool, client);
+	if (!bServerIsAlive)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Check server err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		mongoc_client_pool_destroy(pool);
+		pool = nullptr;
+		mongoc_uri_destroy(uri);
+		uri = nullptr;
+		return false;
+	}
+
+	// Start the writer threads
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	for (int32 Idx = 0; Idx < NumWriters; ++Idx)
+	{
+		FSLMongoWriterRunnable* Writer = new FSLMongoWriterRunnable(this);
+		Writers.Add(Writer);
+		WriterThreads.Add(FRunnableThread::Create(Writer,
+			*FString::Printf(TEXT("SLMongoWriter_%d"), Idx), 0, TPri_BelowNormal));
+	}
+
+	ConnectedUri = Uri;
+	bIsConnected = true;
+	return true;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Drain the queues, stop the writer threads and destroy the client pool
+void FSLMongoService::Disconnect()
+{
+	FScopeLock Lock(&ConnectionLock);
+	if (!bIsConnected)
+	{
+		return;
+	}
+
+	// Index builds hold clients from the pool
+	WaitForIndexJobs();
+
+	// Write everything that was submitted
+	Drain();
+	UE_LOG(LogSL, Log, TEXT("%s::%d Mongo service stats: %s"),
+		*FString(__func__), __LINE__, *GetStats().ToString());
+
+	// Stop the writers
+	for (FSLMongoWriterRunnable* Writer : Writers)
+	{
+		Writer->Stop();
+	}
+	WorkEvent->Trigger();
+	for (FRunnableThread* Thread : WriterThreads)
+	{
+		Thread->WaitForCompletion();
+		delete Thread;
+	}
+	for (FSLMongoWriterRunnable* Writer : Writers)
+	{
+		delete Writer;
+	}
+	WriterThreads.Empty();
+	Writers.Empty();
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+
+#if SL_WITH_LIBMONGO_C
+	Queues.Empty();
+	mongoc_client_pool_destroy(pool);
+	pool = nullptr;
+	mongoc_uri_destroy(uri);
+	uri = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+
+	ConnectedUri.Empty();
+	bIsConnected = false;
+}
+
+// Block until all the submitted documents are written
+void FSLMongoService::Drain()
+{
+#if SL_WITH_LIBMONGO_C
+	while (IsConnected())
+	{
+		{
+			FScopeLock Lock(&QueuesLock);
+			bool bIsEmpty = true;
+			for (const auto& Pair : Queues)
+			{
+				if (Pair.Value->bInProgress || Pair.Value->Pending.Num() > 0)
+				{
+					bIsEmpty = false;
+					break;
+				}
+			}
+			if (bIsEmpty)
+			{
+				return;
+			}
+		}
+		WorkEvent->Trigger();
+		FPlatformProcess::Sleep(0.005f);
+	}
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Get the stats of all the collections
+FSLMongoServiceStats FSLMongoService::GetStats() const
+{
+	FSLMongoServiceStats Stats;
+#if SL_WITH_LIBMONGO_C
+	FScopeLock Lock(&QueuesLock);
+	for (const auto& Pair : Queues)
+	{
+		Stats.Append(Pair.Value->Stats);
+	}
+#endif //SL_WITH_LIBMONGO_C
+	return Stats;
+}
+
+// Get the stats of the given collection
+FSLMongoServiceStats FSLMongoService::GetStats(const FString& DBName, const FString& CollName) const
+{
+#if SL_WITH_LIBMONGO_C
+	FScopeLock Lock(&QueuesLock);
+	if (const TSharedPtr<FCollectionQueue>* Queue = Queues.Find(DBName + TEXT(".") + CollName))
+	{
+		return (*Queue)->Stats;
+	}
+#endif //SL_WITH_LIBMONGO_C
+	return FSLMongoServiceStats();
+}
+
+// Create the indexes and wait for the result
+bool FSLMongoService::CreateIndexes(const FString& DBName, const FString& CollName, const TArray<FString>& Keys, FString* OutError)
+{
+	FString Error;
+	bool bSuccess = false;
+#if SL_WITH_LIBMONGO_C
+	if (mongoc_client_t* client = PopClient())
+	{
+		bSuccess = WriteIndexes(client, DBName, CollName, Keys, Error);
+		PushClient(client);
+	}
+	else
+	{
+		Error = TEXT("Service is not connected");
+	}
+#else
+	Error = TEXT("Built without libmongoc");
+#endif //SL_WITH_LIBMONGO_C
+	if (!bSuccess)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Create indexes on %s.%s err.: %s"),
+			*FString(__func__), __LINE__, *DBName, *CollName, *Error);
+	}
+	if (OutError)
+	{
+		*OutError = Error;
+	}
+	return bSuccess;
+}
+
+// Queue an index build which runs in the background
+void FSLMongoService::BuildIndexesAsync(const FString& DBName, const FString& CollName, const TArray<FString>& Keys)
+{
+	if (!IsConnected())
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Service is not connected, cannot build the indexes of %s.%s.."),
+			*FString(__func__), __LINE__, *DBName, *CollName);
+		return;
+	}
+
+	FScopeLock Lock(&IndexJobsLock);
+	const FString Namespace = DBName + TEXT(".") + CollName;
+	if (const FSLMongoIndexJobStatus* Existing = IndexJobs.Find(Namespace))
+	{
+		if (!Existing->IsFinished())
+		{
+			UE_LOG(LogSL, Warning, TEXT("%s::%d Index build of %s is already queued.."),
+				*FString(__func__), __LINE__, *Namespace);
+			return;
+		}
+		// Re-queued jobs go to the back of the queue
+		IndexJobs.Remove(Namespace);
+	}
+
+	FSLMongoIndexJobStatus& Job = IndexJobs.Add(Namespace);
+	Job.DBName = DBName;
+	Job.CollName = CollName;
+	Job.Keys = Keys;
+	Job.State = ESLMongoIndexJobState::Pending;
+	Job.SubmitTime = FPlatformTime::Seconds();
+	StartPendingIndexJobs();
+}
+
+// Max number of index builds running in parallel
+void FSLMongoService::SetMaxParallelIndexBuilds(int32 InNum)
+{
+	FScopeLock Lock(&IndexJobsLock);
+	MaxParallelIndexBuilds = FMath::Max(InNum, 1);
+	StartPendingIndexJobs();
+}
+
+// Get the status of the index build of the collection
+FSLMongoIndexJobStatus FSLMongoService::GetIndexJobStatus(const FString& DBName, const FString& CollName) const
+{
+	FScopeLock Lock(&IndexJobsLock);
+	if (const FSLMongoIndexJobStatus* Job = IndexJobs.Find(DBName + TEXT(".") + CollName))
+	{
+		return *Job;
+	}
+	return FSLMongoIndexJobStatus();
+}
+
+// Get the status of all the index builds
+TArray<FSLMongoIndexJobStatus> FSLMongoService::GetIndexJobs() const
+{
+	FScopeLock Lock(&IndexJobsLock);
+	TArray<FSLMongoIndexJobStatus> Jobs;
+	IndexJobs.GenerateValueArray(Jobs);
+	return Jobs;
+}
+
+// Get the number of finished, failed and total index builds
+void FSLMongoService::GetIndexJobsProgress(int32& OutNumFinished, int32& OutNumFailed, int32& OutNumTotal) const
+{
+	FScopeLock Lock(&IndexJobsLock);
+	OutNumFinished = 0;
+	OutNumFailed = 0;
+	OutNumTotal = IndexJobs.Num();
+	for (const auto& Pair : IndexJobs)
+	{
+		if (Pair.Value.IsFinished())
+		{
+			OutNumFinished++;
+		}
+		if (Pair.Value.State == ESLMongoIndexJobState::Failed)
+		{
+			OutNumFailed++;
+		}
+	}
+}
+
+// Called by the index build tasks
+void FSLMongoService::RunIndexJob(const FString& Namespace)
+{
+	FString DBName;
+	FString CollName;
+	TArray<FString> Keys;
+	{
+		FScopeLock Lock(&IndexJobsLock);
+		FSLMongoIndexJobStatus& Job = IndexJobs.FindChecked(Namespace);
+		Job.State = ESLMongoIndexJobState::Building;
+		Job.StartTime = FPlatformTime::Seconds();
+		DBName = Job.DBName;
+		CollName = Job.CollName;
+		Keys = Job.Keys;
+	}
+
+	FString Error;
+	bool bSuccess = false;
+#if SL_WITH_LIBMONGO_C
+	mongoc_client_t* client = mongoc_client_pool_pop(pool);
+	bSuccess = WriteIndexes(client, DBName, CollName, Keys, Error);
+	mongoc_client_pool_push(pool, client);
+#endif //SL_WITH_LIBMONGO_C
+
+	FScopeLock Lock(&IndexJobsLock);
+	FSLMongoIndexJobStatus& Job = IndexJobs.FindChecked(Namespace);
+	Job.State = bSuccess ? ESLMongoIndexJobState::Done : ESLMongoIndexJobState::Failed;
+	Job.EndTime = FPlatformTime::Seconds();
+	Job.Error = Error;
+	UE_LOG(LogSL, Log, TEXT("%s::%d Index build finished: %s"), *FString(__func__), __LINE__, *Job.ToString());
+	NumRunningIndexJobs--;
+	StartPendingIndexJobs();
+}
+
+// Start pending jobs while there are free build slots
+void FSLMongoService::StartPendingIndexJobs()
+{
+	for (auto& Pair : IndexJobs)
+	{
+		if (NumRunningIndexJobs >= MaxParallelIndexBuilds)
+		{
+			return;
+		}
+		if (Pair.Value.State == ESLMongoIndexJobState::Pending)
+		{
+			// Marked as building here, so the next call does not start it twice
+			Pair.Value.State = ESLMongoIndexJobState::Building;
+			NumRunningIndexJobs++;
+			(new FAutoDeleteAsyncTask<FSLMongoIndexBuildTask>(this, Pair.Key))->StartBackgroundTask();
+		}
+	}
+}
+
+// Cancel the pending jobs and wait for the running ones
+void FSLMongoService::WaitForIndexJobs()
+{
+	{
+		FScopeLock Lock(&IndexJobsLock);
+		for (auto& Pair : IndexJobs)
+		{
+			if (Pair.Value.State == ESLMongoIndexJobState::Pending)
+			{
+				Pair.Value.State = ESLMongoIndexJobState::Failed;
+				Pair.Value.Error = TEXT("Cancelled");
+			}
+		}
+	}
+	while (true)
+	{
+		{
+			FScopeLock Lock(&IndexJobsLock);
+			if (NumRunningIndexJobs == 0)
+			{
+				return;
+			}
+		}
+		FPlatformProcess::Sleep(0.01f);
+	}
+}
+
+#if SL_WITH_LIBMONGO_C
+// Get a client from the pool for synchronous operations
+mongoc_client_t* FSLMongoService::PopClient()
+{
+	FScopeLock Lock(&ConnectionLock);
+	return bIsConnected ? mongoc_client_pool_pop(pool) : nullptr;
+}
+
+// Return the client to the pool
+void FSLMongoService::PushClient(mongoc_client_t* InClient)
+{
+	if (InClient && pool)
+	{
+		mongoc_client_pool_push(pool, InClient);
+	}
+}
+
+// Queue the document for writing, the service takes ownership of the document
+void FSLMongoService::Submit(const FString& DBName, const FString& CollName, bson_t* doc)
+{
+	// The queues are not emptied by a disconnect while the document is queued
+	FScopeLock ConnectionScope(&ConnectionLock);
+	if (!bIsConnected)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Service is not connected, dropping document for %s.%s.."),
+			*FString(__func__), __LINE__, *DBName, *CollName);
+		bson_destroy(doc);
+		return;
+	}
+
+	// Set the _id before queuing, this makes the retries idempotent
+	if (!bson_has_field(doc, "_id"))
+	{
+		bson_oid_t oid;
+		bson_oid_init(&oid, NULL);
+		BSON_APPEND_OID(doc, "_id", &oid);
+	}
+
+	{
+		FScopeLock Lock(&QueuesLock);
+		const FString Namespace = DBName + TEXT(".") + CollName;
+		TSharedPtr<FCollectionQueue>& Queue = Queues.FindOrAdd(Namespace);
+		if (!Queue.IsValid())
+		{
+			Queue = MakeShareable(new FCollectionQueue());
+			Queue->DBName = DBName;
+			Queue->CollName = CollName;
+		}
+		Queue->Pending.Add(FWriteRequest{ doc, FPlatformTime::Seconds() });
+		Queue->Stats.NumSubmitted++;
+		Queue->Stats.QueueDepth = Queue->Pending.Num();
+		Queue->Stats.MaxQueueDepth = FMath::Max(Queue->Stats.MaxQueueDepth, Queue->Stats.QueueDepth);
+	}
+	WorkEvent->Trigger();
+}
+
+// Called by the writer threads, writes the next available batch
+bool FSLMongoService::ProcessNextBatch()
+{
+	TSharedPtr<FCollectionQueue> Queue;
+	TArray<FWriteRequest> Batch;
+
+	// Take the next batch of a collection which is not being written by another thread
+	{
+		FScopeLock Lock(&QueuesLock);
+		TArray<TSharedPtr<FCollectionQueue>> AllQueues;
+		Queues.GenerateValueArray(AllQueues);
+		for (int32 Offset = 0; Offset < AllQueues.Num(); ++Offset)
+		{
+			const int32 Idx = (NextQueueIdx + Offset) % AllQueues.Num();
+			if (!AllQueues[Idx]->bInProgress && AllQueues[Idx]->Pending.Num() > 0)
+			{
+				Queue = AllQueues[Idx];
+				NextQueueIdx = Idx + 1;
+				break;
+			}
+		}
+		if (!Queue.IsValid())
+		{
+			return false;
+		}
+
+		const int32 BatchSize = FMath::Min(Queue->Pending.Num(), MaxBatchSize);
+		Batch.Append(Queue->Pending.GetData(), BatchSize);
+		Queue->Pending.RemoveAt(0, BatchSize, false);
+		Queue->Stats.QueueDepth = Queue->Pending.Num();
+		Queue->bInProgress = true;
+	}
+
+	// Write outside of the lock
+	bool bSuccess = false;
+	mongoc_client_t* client = mongoc_client_pool_pop(pool);
+	const int32 NumRetries = WriteBatch(client, Queue->DBName, Queue->CollName, Batch, bSuccess);
+	mongoc_client_pool_push(pool, client);
+	const double WriteTime = FPlatformTime::Seconds();
+
+	{
+		FScopeLock Lock(&QueuesLock);
+		Queue->Stats.NumRetries += NumRetries;
+		if (bSuccess)
+		{
+			Queue->Stats.NumWritten += Batch.Num();
+			for (const FWriteRequest& Req : Batch)
+			{
+				const double Latency = WriteTime - Req.SubmitTime;
+				Queue->Stats.TotalLatency += Latency;
+				Queue->Stats.MaxLatency = FMath::Max(Queue->Stats.MaxLatency, Latency);
+			}
+		}
+		else
+		{
+			Queue->Stats.NumFailed += Batch.Num();
+		}
+		Queue->bInProgress = false;
+	}
+
+	for (const FWriteRequest& Req : Batch)
+	{
+		bson_destroy(Req.doc);
+	}
+	return true;
+}
+
+// Insert the batch, retry on failures
+int32 FSLMongoService::WriteBatch(mongoc_client_t* InClient, const FString& DBName, const FString& CollName,
+	const TArray<FWriteRequest>& Batch, bool& bOutSuccess)
+{
+	mongoc_collection_t* collection = mongoc_client_get_collection(InClient, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollName));
+
+	TArray<const bson_t*> docs;
+	docs.Reserve(Batch.Num());
+	for (const FWriteRequest& Req : Batch)
+	{
+		docs.Add(Req.doc);
+	}
+
+	// Unordered, a retry of a partially inserted batch only fails on the already inserted _ids
+	bson_t* opts = BCON_NEW("ordered", BCON_BOOL(false));
+	bson_error_t error;
+	int32 Try = 0;
+	bOutSuccess = false;
+	while (!bOutSuccess && Try < MaxRetries)
+	{
+		bson_t reply;
+		bOutSuccess = mongoc_collection_insert_many(collection, docs.GetData(), docs.Num(), opts, &reply, &error);
+		if (!bOutSuccess && Try > 0)
+		{
+			// Duplicate keys from a previous partially successful try are not an error
+			bson_iter_t iter;
+			bson_iter_t err_iter;
+			bool bOnlyDuplicates = bson_iter_init_find(&iter, &reply, "writeErrors") && BSON_ITER_HOLDS_ARRAY(&iter)
+				&& bson_iter_recurse(&iter, &err_iter);
+			while (bOnlyDuplicates && bson_iter_next(&err_iter))
+			{
+				bson_iter_t code_iter;
+				bOnlyDuplicates = bson_iter_recurse(&err_iter, &code_iter) && bson_iter_find(&code_iter, "code")
+					&& (bson_iter_as_int64(&code_iter) == 11000);
+			}
+			bOutSuccess = bOnlyDuplicates;
+		}
+		bson_destroy(&reply);
+		Try++;
+
+		if (!bOutSuccess)
+		{
+			UE_LOG(LogSL, Warning, TEXT("%s::%d Writing %d docs to %s.%s failed (try %d/%d), err.: %s"),
+				*FString(__func__), __LINE__, docs.Num(), *DBName, *CollName, Try, MaxRetries, *FString(error.message));
+			if (Try < MaxRetries)
+			{
+				// Back off before retrying
+				FPlatformProcess::Sleep(0.1f * (1 << Try));
+			}
+		}
+	}
+
+	if (!bOutSuccess)
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Dropping %d docs for %s.%s after %d tries.."),
+			*FString(__func__), __LINE__, docs.Num(), *DBName, *CollName, MaxRetries);
+	}
+
+	bson_destroy(opts);
+	mongoc_collection_destroy(collection);
+	return Try - 1;
+}
+
+// Run the createIndexes command with the given client
+bool FSLMongoService::WriteIndexes(mongoc_client_t* InClient, const FString& DBName, const FString& CollName,
+	const TArray<FString>& Keys, FString& OutError)
+{
+	if (Keys.Num() == 0)
+	{
+		OutError = TEXT("No indexes given");
+		return false;
+	}
+
+	// { createIndexes: coll, indexes: [ { key: { f0: 1, f1: 1 }, name: "f0_1_f1_1" }, .. ] }
+	bson_t* index_command = bson_new();
+	BSON_APPEND_UTF8(index_command, "createIndexes", TCHAR_TO_UTF8(*CollName));
+	bson_t indexes_arr;
+	BSON_APPEND_ARRAY_BEGIN(index_command, "indexes", &indexes_arr);
+	for (int32 Idx = 0; Idx < Keys.Num(); ++Idx)
+	{
+		char idx_str[16];
+		const char* idx_key;
+		bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+
+		bson_t key_doc;
+		bson_init(&key_doc);
+		TArray<FString> Fields;
+		Keys[Idx].ParseIntoArray(Fields, TEXT("+"));
+		for (const FString& Field : Fields)
+		{
+			BSON_APPEND_INT32(&key_doc, TCHAR_TO_UTF8(*Field), 1);
+		}
+		char* index_name = mongoc_collection_keys_to_index_string(&key_doc);
+
+		bson_t index_doc;
+		BSON_APPEND_DOCUMENT_BEGIN(&indexes_arr, idx_key, &index_doc);
+		BSON_APPEND_DOCUMENT(&index_doc, "key", &key_doc);
+		BSON_APPEND_UTF8(&index_doc, "name", index_name);
+		bson_append_document_end(&indexes_arr, &index_doc);
+
+		bson_free(index_name);
+		bson_destroy(&key_doc);
+	}
+	bson_append_array_end(index_command, &indexes_arr);
+
+	bson_error_t error;
+	mongoc_database_t* database = mongoc_client_get_database(InClient, TCHAR_TO_UTF8(*DBName));
+	const bool bSuccess = mongoc_database_write_command_with_opts(database, index_command, NULL/*opts*/, NULL/*reply*/, &error);
+	if (!bSuccess)
+	{
+		OutError = FString(error.message);
+	}
+
+	// Clean up
+	mongoc_database_destroy(database);
+	bson_destroy(index_command);
+	return bSuccess;
+}
+#endif //SL_WITH_LIBMONGO_C
@@ -5,6 +5,7 @@
 #include "SLManipulatorListener.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "SLEntitiesManager.h"
+#include "SLTrace.h"
 #include "GameFramework/PlayerController.h"
 
 // Sets default values for this component's properties
@@ -27,7 +28,7 @@ USLPickAndPlaceListener::USLPickAndPlaceListener()
 	bLiftOffHappened = false;
 
 	/* PutDown */
-	RecentMovementBuffer.Reserve(RecentMovementBufferSize);
+	RecentMovementBuffer.Init(RecentMovementBufferSize);
 }
 
 // Dtor
@@ -45,13 +46,13 @@ bool USLPickAndPlaceListener::Init()
 	if (!bIsInit)
 	{
 		// Init the semantic entities manager
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(GetWorld());
+			FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 		}
 
 		// Check that the owner is part of the semantic entities
-		SemanticOwner = FSLEntitiesManager::GetInstance()->GetEntity(GetOwner());
+		SemanticOwner = FSLEntitiesManager::GetInstance(GetWorld())->GetEntity(GetOwner());
 		if (!SemanticOwner.IsSet())
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Owner is not semantically annotated.."), *FString(__func__), __LINE__);
@@ -264,30 +265,11 @@ void USLPickAndPlaceListener::FinishActiveEvent()
 	UpdateFunctionPtr = &USLPickAndPlaceListener::Update_NONE;
 }
 
-// Backtrace and check if a put-down event happened
-bool USLPickAndPlaceListener::HasPutDownEventHappened(const float CurrTime, const FVector& CurrObjLocation, uint32& OutPutDownEndIdx)
+// Check if a put-down event happened, returns the newest sample where the object was still above the put-down height
+bool USLPickAndPlaceListener::HasPutDownEventHappened(const float CurrTime, const FVector& CurrObjLocation, uint32& OutPutDownEndSeq)
 {
-	OutPutDownEndIdx = RecentMovementBuffer.Num() - 1;
-	while(OutPutDownEndIdx > 0 && CurrTime - RecentMovementBuffer[OutPutDownEndIdx].Key < PutDownMovementBacktrackDuration)
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t\t\t [%f] [%f/%f] MinPutDownHeight"),
-			*FString(__func__), __LINE__,
-			GetWorld()->GetTimeSeconds(), 
-			RecentMovementBuffer[OutPutDownEndIdx].Key,
-			RecentMovementBuffer[OutPutDownEndIdx].Value.Z - CurrObjLocation.Z,
-			MinPutDownHeight);
-
-		if(RecentMovementBuffer[OutPutDownEndIdx].Value.Z - CurrObjLocation.Z > MinPutDownHeight)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f]  \t\t\t\t PUT DOWN HAPPENED"),
-				*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
-			return true;
-		}
-		OutPutDownEndIdx--;
-	}
-	UE_LOG(LogTemp, Error, TEXT("%s::%d [%f]  \t\t\t\t PUT DOWN HAS NOT HAPPENED"),
-		*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
-	return false;
+	return RecentMovementBuffer.FindNewestAbove(CurrTime, PutDownMovementBacktrackDuration,
+		CurrObjLocation.Z + MinPutDownHeight, OutPutDownEndSeq);
 }
 
 // Update callback
@@ -301,7 +283,7 @@ void USLPickAndPlaceListener::Update()
 // Default update function
 void USLPickAndPlaceListener::Update_NONE()
 {
-	UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] This should not happen.."), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+	SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPUnexpectedState, GetWorld()->GetTimeSeconds(), CurrGraspedObj);
 }
 
 // Check for slide events
@@ -309,7 +291,7 @@ void USLPickAndPlaceListener::Update_Slide()
 {
 	if(CurrGraspedObj == nullptr || GraspedObjectContactShape == nullptr)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] This should not happen.."), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+		SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPUnexpectedState, GetWorld()->GetTimeSeconds(), CurrGraspedObj);
 		return;
 	}
 
@@ -320,15 +302,14 @@ void USLPickAndPlaceListener::Update_Slide()
 	// Sliding events can only end when the object is not supported by the surface anymore
 	if(!GraspedObjectContactShape->IsSupportedBySomething())
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d [%f]  \t\t **** END SupportedBy ****"), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+		SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPSupportedByEnd, CurrTime, CurrGraspedObj, nullptr, CurrDistXY);
 
 		// Check if enough distance and time has passed for a sliding event
 		if(CurrDistXY > MinSlideDistXY && CurrTime - PrevRelevantTime > MinSlideDuration)
 		{
 			const float ExactSupportedByEndTime = GraspedObjectContactShape->GetLastSupportedByEndTime();
 
-			UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## SLIDE ##############  [%f <--> %f]"),
-				*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PrevRelevantTime, ExactSupportedByEndTime);
+			SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPSlide, CurrTime, CurrGraspedObj, nullptr, PrevRelevantTime, ExactSupportedByEndTime);
 
 			// Broadcast event
 			OnManipulatorSlideEvent.Broadcast(SemanticOwner, CurrGraspedObj, PrevRelevantTime, ExactSupportedByEndTime);
@@ -357,9 +338,8 @@ void USLPickAndPlaceListener::Update_PickUp()
 			if(CurrObjLocation.Z - LiftOffLocation.Z > MaxPickUpHeight ||
 				FVector::DistXY(LiftOffLocation, CurrObjLocation) > MaxPickUpDistXY)
 			{
+				SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPPickUp, CurrTime, CurrGraspedObj, nullptr, PrevRelevantTime, CurrTime);
 
-				UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## PICK UP ##############  [%f <--> %f]"),
-					*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PrevRelevantTime, CurrTime);
 				// Broadcast event
 				OnManipulatorPickUpEvent.Broadcast(SemanticOwner, CurrGraspedObj, PrevRelevantTime, CurrTime);
 
@@ -373,7 +353,7 @@ void USLPickAndPlaceListener::Update_PickUp()
 		}
 		else if(CurrObjLocation.Z - PrevRelevantLocation.Z > MinPickUpHeight)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f]  \t **** LiftOFF **** \t\t\t\t\t\t\t\t LIFTOFF"), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+			SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPLiftOff, CurrTime, CurrGraspedObj, nullptr, CurrObjLocation.Z - PrevRelevantLocation.Z);
 
 			// This is not going to be the start time of the PickUp event, we use the SupportedBy end time
 			// we save the LiftOffLocation to check against the ending of the PickUp event by comparing distances against
@@ -382,19 +362,18 @@ void USLPickAndPlaceListener::Update_PickUp()
 		}
 		else if(FVector::DistXY(LiftOffLocation, PrevRelevantLocation) > MaxPickUpDistXY)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f]  \t **** Skip PickUp **** \t\t\t\t\t\t\t\t SKIP PICKUP"), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+			SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPSkipPickUp, CurrTime, CurrGraspedObj, nullptr, FVector::DistXY(LiftOffLocation, PrevRelevantLocation));
 			EventCheck = ESLPaPStateCheck::TransportOrPutDown;
 			UpdateFunctionPtr = &USLPickAndPlaceListener::Update_TransportOrPutDown;
 		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] \t\t **** START SupportedBy ****"), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+		SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPSupportedByBegin, CurrTime, CurrGraspedObj);
 
 		if(bLiftOffHappened)
 		{
-			UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## PICK UP ##############  [%f <--> %f]"),
-				*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PrevRelevantTime, CurrTime);
+			SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPPickUp, CurrTime, CurrGraspedObj, nullptr, PrevRelevantTime, CurrTime);
 			OnManipulatorPickUpEvent.Broadcast(SemanticOwner, CurrGraspedObj, PrevRelevantTime, CurrTime);
 		}
 
@@ -414,58 +393,53 @@ void USLPickAndPlaceListener::Update_TransportOrPutDown()
 
 	if(GraspedObjectContactShape->IsSupportedBySomething())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f]  \t\t **** START SupportedBy ****"), *FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
+		SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPSupportedByBegin, CurrTime, CurrGraspedObj);
 
 		// Check for the PutDown movement start time
-		uint32 PutDownEndIdx = 0;
-		if(HasPutDownEventHappened(CurrTime, CurrObjLocation, PutDownEndIdx))
+		uint32 PutDownEndSeq = 0;
+		if(HasPutDownEventHappened(CurrTime, CurrObjLocation, PutDownEndSeq))
 		{
 			float PutDownStartTime = -1.f;
-			while(PutDownEndIdx > 0)
+			while(PutDownEndSeq != RecentMovementBuffer.GetFirstSeq())
 			{
 				// Check when the 
-				if(RecentMovementBuffer[PutDownEndIdx].Value.Z - CurrObjLocation.Z > MaxPutDownHeight
-					|| FVector::Distance(RecentMovementBuffer[PutDownEndIdx].Value, CurrObjLocation) > MaxPutDownDistXY)
+				const FVector& PastLocation = RecentMovementBuffer.GetLocation(PutDownEndSeq);
+				if(PastLocation.Z - CurrObjLocation.Z > MaxPutDownHeight
+					|| FVector::Distance(PastLocation, CurrObjLocation) > MaxPutDownDistXY)
 				{
-					PutDownStartTime = RecentMovementBuffer[PutDownEndIdx].Key;
+					PutDownStartTime = RecentMovementBuffer.GetTime(PutDownEndSeq);
 
-					UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## TRANSPORT ##############  [%f <--> %f]"),
-						*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PrevRelevantTime, PutDownStartTime);
+					SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPTransport, CurrTime, CurrGraspedObj, nullptr, PrevRelevantTime, PutDownStartTime);
 					OnManipulatorTransportEvent.Broadcast(SemanticOwner, CurrGraspedObj, PrevRelevantTime, PutDownStartTime);
 
 
-					UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## PUT DOWN ##############  [%f <--> %f]"),
-						*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PutDownStartTime, CurrTime);
+					SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPPutDown, CurrTime, CurrGraspedObj, nullptr, PutDownStartTime, CurrTime);
 					OnManipulatorPutDownEvent.Broadcast(SemanticOwner, CurrGraspedObj, PutDownStartTime, CurrTime);
 					break;
 				}
-				PutDownEndIdx--;
+				PutDownEndSeq--;
 			}
 
 			// If the limits are not crossed in the buffer the oldest available time is used (TODO, or should we ignore the action?)
 			if(PutDownStartTime < 0)
 			{
-				UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] The limits were not crossed in the available data in the buffer, the oldest available time is used"),
-					*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds());
-				PutDownStartTime = RecentMovementBuffer[0].Key;
+				PutDownStartTime = RecentMovementBuffer.GetTime(RecentMovementBuffer.GetFirstSeq());
+				SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPPutDownLimitsNotCrossed, CurrTime, CurrGraspedObj, nullptr, PutDownStartTime);
 
-				UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## TRANSPORT ##############  [%f <--> %f]"),
-					*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PrevRelevantTime, PutDownStartTime);
+				SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPTransport, CurrTime, CurrGraspedObj, nullptr, PrevRelevantTime, PutDownStartTime);
 				OnManipulatorPutDownEvent.Broadcast(SemanticOwner, CurrGraspedObj, PrevRelevantTime, PutDownStartTime);
 
-				UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## PUT DOWN ##############  [%f <--> %f]"),
-					*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PutDownStartTime, CurrTime);
+				SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPPutDown, CurrTime, CurrGraspedObj, nullptr, PutDownStartTime, CurrTime);
 				OnManipulatorPutDownEvent.Broadcast(SemanticOwner, CurrGraspedObj, PutDownStartTime, CurrTime);
 			}
 		}
 		else
 		{
-			UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] \t ############## TRANSPORT ##############  [%f <--> %f]"),
-				*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), PrevRelevantTime, CurrTime);
+			SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPTransport, CurrTime, CurrGraspedObj, nullptr, PrevRelevantTime, CurrTime);
 			OnManipulatorTransportEvent.Broadcast(SemanticOwner, CurrGraspedObj, PrevRelevantTime, CurrTime);
 		}
 
-		RecentMovementBuffer.Reset(RecentMovementBufferSize);
+		RecentMovementBuffer.Reset();
 
 		PrevRelevantTime = CurrTime;
 		PrevRelevantLocation = CurrObjLocation;
@@ -474,26 +448,8 @@ void USLPickAndPlaceListener::Update_TransportOrPutDown()
 	}
 	else
 	{
-		// Cache recent movements 
-		if(RecentMovementBuffer.Num() > 1)
-		{
-			RecentMovementBuffer.Push(TPair<float, FVector>(CurrTime, CurrObjLocation));
-
-			// Remove values older than RecentMovementBufferDuration
-			int32 Count = 0;
-			while(RecentMovementBuffer.Last().Key - RecentMovementBuffer[Count].Key > RecentMovementBufferDuration)
-			{
-				Count++;
-			}
-			if(Count > 0)
-			{
-				RecentMovementBuffer.RemoveAt(0, Count, false);
-			}
-		}
-		else
-		{
-			RecentMovementBuffer.Push(TPair<float, FVector>(CurrTime, CurrObjLocation));
-		}
+		// Cache recent movements (values older than RecentMovementBufferDuration are dropped)
+		RecentMovementBuffer.Add(CurrTime, CurrObjLocation, RecentMovementBufferDuration);
 	}
 }
 
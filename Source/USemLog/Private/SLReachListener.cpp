@@ -8,6 +8,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "SLManipulatorListener.h"
 #include "SLEntitiesManager.h"
+#include "SLTrace.h"
 
 // Set default values
 USLReachListener::USLReachListener()
@@ -43,13 +44,13 @@ bool USLReachListener::Init()
 	if (!bIsInit)
 	{
 		// Init the semantic entities manager
-		if (!FSLEntitiesManager::GetInstance()->IsInit())
+		if (!FSLEntitiesManager::GetInstance(GetWorld())->IsInit())
 		{
-			FSLEntitiesManager::GetInstance()->Init(GetWorld());
+			FSLEntitiesManager::GetInstance(GetWorld())->Init(GetWorld());
 		}
 
 		// Check that the owner is part of the semantic entities
-		SemanticOwner = FSLEntitiesManager::GetInstance()->GetEntity(GetOwner());
+		SemanticOwner = FSLEntitiesManager::GetInstance(GetWorld())->GetEntity(GetOwner());
 		if (!SemanticOwner.IsSet())
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Owner is not semantically annotated.."), *FString(__func__), __LINE__);
@@ -102,6 +103,9 @@ void USLReachListener::Finish(bool bForced)
 			OnComponentEndOverlap.RemoveDynamic(this, &USLReachListener::OnOverlapEnd);
 			bCallbacksAreBound = false;
 		}
+
+		// Drop the pending delayed callbacks
+		CancelRecentManipulatorContactEndEvents();
 		
 		// Mark as finished
 		bIsStarted = false;
@@ -246,7 +250,7 @@ void USLReachListener::TriggerInitialOverlaps()
 bool USLReachListener::CanBeACandidate(AStaticMeshActor* InObject) const
 {
 	// Make sure the object is semantically annotated
-	if (!FSLEntitiesManager::GetInstance()->IsObjectEntitySet(InObject))
+	if (!FSLEntitiesManager::GetInstance(GetWorld())->IsObjectEntitySet(InObject))
 	{
 		//UE_LOG(LogTemp, Error, TEXT("%s::%d %s is not semantically annotated, ignoring as candidate.."),
 		//	*FString(__func__), __LINE__, *InObject->GetName());
@@ -299,8 +303,7 @@ void USLReachListener::OnOverlapBegin(UPrimitiveComponent* OverlappedComp,
 			const float Dist = FVector::Distance(GetOwner()->GetActorLocation(), AsSMA->GetActorLocation());
 			CandidatesWithTimeAndDistance.Emplace(AsSMA, MakeTuple(GetWorld()->GetTimeSeconds(), Dist));
 
-			//UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] %s added as candidate.."),
-			//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *AsSMA->GetName());
+			SL_TRACE(SL_TRACE_CAT_REACH, ESLTraceEvent::ReachCandidateAdded, GetWorld()->GetTimeSeconds(), SemanticOwner.Obj, AsSMA, Dist);
 			
 			// New candidate added, make sure update callback timer is running
 			GetWorld()->GetTimerManager().UnPauseTimer(UpdateTimerHandle);
@@ -319,8 +322,7 @@ void USLReachListener::OnOverlapEnd(UPrimitiveComponent* OverlappedComp,
 		// Remove candidate
 		if (CandidatesWithTimeAndDistance.Remove(AsSMA) > 0)
 		{
-			//UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] %s removed as candidate.."),
-			//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *AsSMA->GetName());
+			SL_TRACE(SL_TRACE_CAT_REACH, ESLTraceEvent::ReachCandidateRemoved, GetWorld()->GetTimeSeconds(), SemanticOwner.Obj, AsSMA);
 
 			// If it was the last element, pause timer
 			if(CandidatesWithTimeAndDistance.Num() == 0)
@@ -357,12 +359,13 @@ void USLReachListener::OnSLGraspBegin(const FSLEntity& Self, AActor* Other, floa
 				//UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] %s set as grasped object.."),
 				//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *Other->GetName());
 
-				// Cancel delay callback if active
-				GetWorld()->GetTimerManager().ClearTimer(ManipulatorContactDelayTimerHandle);
+				// Cancel the delayed callbacks if active
+				CancelRecentManipulatorContactEndEvents();
 
 				// Broadcast reach and pre grasp events
 				const float ReachStartTime = CandidateTimeAndDist->Get<ESLTimeAndDist::Time>();
 				const float ReachEndTime = *ContactTime;
+				SL_TRACE(SL_TRACE_CAT_REACH, ESLTraceEvent::ReachPreGraspAndReach, Time, SemanticOwner.Obj, Other, ReachStartTime, ReachEndTime);
 				OnPreGraspAndReachEvent.Broadcast(SemanticOwner, Other, ReachStartTime, ReachEndTime, Time);
 
 				// Remove existing candidates and pause the update callback while the hand is grasping
@@ -437,7 +440,7 @@ void USLReachListener::OnSLManipulatorContactBegin(const FSLContactResult& Conta
 		return;
 	}
 	
-	if (AStaticMeshActor* AsSMA = Cast<AStaticMeshActor>(ContactResult.Other.Obj))
+	if (AStaticMeshActor* AsSMA = Cast<AStaticMeshActor>(ContactResult.Other->Obj))
 	{
 		// Check if the object in contact with is one of the candidates (should be)
 		if (CandidatesWithTimeAndDistance.Contains(AsSMA))
@@ -473,15 +476,17 @@ void USLReachListener::OnSLManipulatorContactEnd(const FSLEntity& Self, const FS
 		// Check contact with manipulator (remove in delay callback, give concatenation a chance)
 		if (ObjectsInContactWithManipulator.Contains(AsSMA))
 		{
-			// Cache the event
-			RecentlyEndedManipulatorContactEvents.Emplace(AsSMA, Time);
-
-			// Delay reseting the reach time, it might be a small disconnection with the hand
-			if(!GetWorld()->GetTimerManager().IsTimerActive(ManipulatorContactDelayTimerHandle))
+			// A newer end with the same object supersedes the previous one
+			FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+			if (FSLPreGraspEndEvent* PrevEv = RecentlyEndedManipulatorContactEvents.Find(AsSMA))
 			{
-				GetWorld()->GetTimerManager().SetTimer(ManipulatorContactDelayTimerHandle, this, &USLReachListener::DelayedManipulatorContactEndEventCallback,
-					MaxPreGraspEventTimeGap * 1.2f, false);
+				TimerWheel->Cancel(PrevEv->TimerHandle);
 			}
+
+			// Cache the event, delay reseting the reach time, it might be a small disconnection with the hand
+			FSLPreGraspEndEvent& Ev = RecentlyEndedManipulatorContactEvents.Emplace(AsSMA, FSLPreGraspEndEvent(AsSMA, Time));
+			Ev.TimerHandle = TimerWheel->Schedule(MaxPreGraspEventTimeGap * 1.2f,
+				[this, AsSMA]() { DelayedManipulatorContactEndEventCallback(AsSMA); }, this);
 		}
 		else
 		{
@@ -492,74 +497,61 @@ void USLReachListener::OnSLManipulatorContactEnd(const FSLEntity& Self, const FS
 	}
 }
 
-// Delayed call of setting finished event to check for possible concatenation of jittering events of the same type
-void USLReachListener::DelayedManipulatorContactEndEventCallback()
+// Delayed call of resetting the reach time, called by the timer wheel if no concatenation happened
+void USLReachListener::DelayedManipulatorContactEndEventCallback(AStaticMeshActor* Other)
 {
-	// Curr time (keep very recently added events for another delay)
-	const float CurrTime = GetWorld()->GetTimeSeconds();
-	
-	for (auto EvItr(RecentlyEndedManipulatorContactEvents.CreateIterator()); EvItr; ++EvItr)
+	if (RecentlyEndedManipulatorContactEvents.Remove(Other) == 0)
+	{
+		return;
+	}
+
+	// Reset reach start in the candidate
+	if(FSLTimeAndDist* TimeAndDist = CandidatesWithTimeAndDistance.Find(Other))
 	{
-		// If enough time has passed, reset the reach time
-		if(CurrTime - EvItr->Time > MaxPreGraspEventTimeGap)
+		// No new contact happened, remove and reset reach time
+		if(ObjectsInContactWithManipulator.Remove(Other) > 0)
 		{
-			// Reset reach start in the candidate
-			if(FSLTimeAndDist* TimeAndDist = CandidatesWithTimeAndDistance.Find(EvItr->Other))
-			{
-				// No new contact happened, remove and reset reach time
-				if(ObjectsInContactWithManipulator.Remove(EvItr->Other) > 0)
-				{
-					//UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] %s removed as object in contact with the manipulator.. (after delay, contact end time=%f)"),
-					//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *EvItr->Other->GetName(), EvItr->Time);
-					TimeAndDist->Get<ESLTimeAndDist::Time>() = GetWorld()->GetTimeSeconds();
-				}
-				else
-				{
-					UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] %s is not in the contact list.. this should not happen.."),
-						*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *EvItr->Other->GetName());
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] %s is not in the candidates list.. this should not happen.."),
-					*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *EvItr->Other->GetName());
-			}
-			
-			EvItr.RemoveCurrent();
+			SL_TRACE(SL_TRACE_CAT_REACH, ESLTraceEvent::ReachContactReset, GetWorld()->GetTimeSeconds(), SemanticOwner.Obj, Other);
+			TimeAndDist->Get<ESLTimeAndDist::Time>() = GetWorld()->GetTimeSeconds();
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] %s is not in the contact list.. this should not happen.."),
+				*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *Other->GetName());
 		}
 	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedManipulatorContactEvents.Num() > 0)
+	else
 	{
-		GetWorld()->GetTimerManager().SetTimer(ManipulatorContactDelayTimerHandle, this, &USLReachListener::DelayedManipulatorContactEndEventCallback,
-			MaxPreGraspEventTimeGap * 1.2f, false);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] %s is not in the candidates list.. this should not happen.."),
+			*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *Other->GetName());
 	}
 }
 
 // Check if this begin event happened right after the previous one ended, if so remove it from the array, and cancel publishing the begin event
 bool USLReachListener::SkipRecentManipulatorContactEndEventTime(AStaticMeshActor* Other, float StartTime)
 {
-	for (auto EvItr(RecentlyEndedManipulatorContactEvents.CreateIterator()); EvItr; ++EvItr)
+	if (FSLPreGraspEndEvent* Ev = RecentlyEndedManipulatorContactEvents.Find(Other))
 	{
-		// Check if it is an event between the same entities
-		if(EvItr->Other == Other)
+		// Check time difference between the previous and current event
+		const float TimeGap = StartTime - Ev->Time;
+		if(TimeGap < MaxPreGraspEventTimeGap)
 		{
-			// Check time difference between the previous and current event
-			const float TimeGap = StartTime - EvItr->Time;
-			if(TimeGap < MaxPreGraspEventTimeGap)
-			{
-				// Event will be concatenated
-				EvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedManipulatorContactEvents.Num() == 0)
-				{
-					GetWorld()->GetTimerManager().ClearTimer(ManipulatorContactDelayTimerHandle);
-				}
-				return true;
-			}
+			// Event will be concatenated, cancel the delayed reset
+			FSLTimerWheel::GetInstance(GetWorld())->Cancel(Ev->TimerHandle);
+			RecentlyEndedManipulatorContactEvents.Remove(Other);
+			return true;
 		}
 	}
 	return false;
 }
+
+// Cancel all the delayed reach time resets
+void USLReachListener::CancelRecentManipulatorContactEndEvents()
+{
+	FSLTimerWheel* TimerWheel = FSLTimerWheel::GetInstance(GetWorld());
+	for (auto& Pair : RecentlyEndedManipulatorContactEvents)
+	{
+		TimerWheel->Cancel(Pair.Value.TimerHandle);
+	}
+	RecentlyEndedManipulatorContactEvents.Empty();
+}
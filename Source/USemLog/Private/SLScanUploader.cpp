@@ -0,0 +1,265 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLScanUploader.h"
+#include "SLMongoService.h"
+#include "HAL/RunnableThread.h"
+
+// Ctor
+FSLScanUploader::FSLScanUploader() : MaxInFlightBytes(0), WorkEvent(nullptr), UploadedEvent(nullptr),
+	Thread(nullptr), bStop(false), NumUploaded(0), NumFailed(0)
+{
+#if SL_WITH_LIBMONGO_C
+	gridfs = nullptr;
+	scan_doc = nullptr;
+	img_arr_idx = 0;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Dtor, waits for the pending uploads
+FSLScanUploader::~FSLScanUploader()
+{
+	Finish();
+}
+
+#if SL_WITH_LIBMONGO_C
+// Start the upload thread, the gridfs handle is used exclusively by the thread until finished
+bool FSLScanUploader::Start(mongoc_gridfs_t* InGridFS, const FString& InDBName, const FString& InCollName, int64 InMaxInFlightBytes)
+{
+	if (Thread || !InGridFS)
+	{
+		return false;
+	}
+	gridfs = InGridFS;
+	DBName = InDBName;
+	CollName = InCollName;
+	MaxInFlightBytes = FMath::Max<int64>(InMaxInFlightBytes, UploadChunkSize);
+	bStop = false;
+
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	UploadedEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("SLScanUploader"), 0, TPri_BelowNormal);
+	return Thread != nullptr;
+}
+#endif //SL_WITH_LIBMONGO_C
+
+// Upload the remaining images, write the remaining documents and stop the thread
+void FSLScanUploader::Finish()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// The thread exits once the queue is empty
+	Stop();
+	WorkEvent->Trigger();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+	FPlatformProcess::ReturnSynchEventToPool(UploadedEvent);
+	UploadedEvent = nullptr;
+
+#if SL_WITH_LIBMONGO_C
+	// Unclosed document
+	if (scan_doc)
+	{
+		bson_destroy(scan_doc);
+		scan_doc = nullptr;
+	}
+	gridfs = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+
+	UE_LOG(LogSL, Log, TEXT("%s::%d Scan uploads: %d uploaded, %d failed.."),
+		*FString(__func__), __LINE__, NumUploaded, NumFailed);
+}
+
+// Start a new scan document
+void FSLScanUploader::BeginEntry(int32 ItemIdx, const FString& Class, int32 PoseIdx)
+{
+	if (Thread)
+	{
+		FUploadJob Job;
+		Job.Type = FUploadJob::EType::BeginEntry;
+		Job.Class = Class;
+		Job.ItemIdx = ItemIdx;
+		Job.PoseIdx = PoseIdx;
+		Jobs.Enqueue(MoveTemp(Job));
+		WorkEvent->Trigger();
+	}
+}
+
+// Queue the image for upload, its file id is added to the current scan document
+void FSLScanUploader::AddImage(const FString& ViewType, const TArray<uint8>& CompressedBitmap)
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// Block while over budget, the uploads overlap with the rendering of the next scans otherwise
+	while (InFlightBytes.GetValue() > 0 && InFlightBytes.GetValue() + CompressedBitmap.Num() > MaxInFlightBytes)
+	{
+		UploadedEvent->Wait(10);
+	}
+
+	FUploadJob Job;
+	Job.Type = FUploadJob::EType::Image;
+	Job.ViewType = ViewType;
+	Job.Data = CompressedBitmap;
+	InFlightBytes.Add(Job.Data.Num());
+	Jobs.Enqueue(MoveTemp(Job));
+	WorkEvent->Trigger();
+}
+
+// Close the current scan document, it is written once its images are uploaded
+void FSLScanUploader::EndEntry()
+{
+	if (Thread)
+	{
+		FUploadJob Job;
+		Job.Type = FUploadJob::EType::EndEntry;
+		Jobs.Enqueue(MoveTemp(Job));
+		WorkEvent->Trigger();
+	}
+}
+
+/** Begin FRunnable interface */
+uint32 FSLScanUploader::Run()
+{
+	FUploadJob Job;
+	while (true)
+	{
+		if (Jobs.Dequeue(Job))
+		{
+			ProcessJob(Job);
+		}
+		else if (bStop)
+		{
+			break;
+		}
+		else
+		{
+			// Nothing to upload, wait for new jobs (timeout in case of a missed trigger)
+			WorkEvent->Wait(10);
+		}
+	}
+	return 0;
+}
+/** End FRunnable interface */
+
+// Process the job on the upload thread
+void FSLScanUploader::ProcessJob(FUploadJob& Job)
+{
+#if SL_WITH_LIBMONGO_C
+	if (Job.Type == FUploadJob::EType::BeginEntry)
+	{
+		if (scan_doc)
+		{
+			bson_destroy(scan_doc);
+		}
+		scan_doc = bson_new();
+
+		// The entries are written in upload order, the item and pose identify the scan
+		BSON_APPEND_INT32(scan_doc, "item_idx", Job.ItemIdx);
+		BSON_APPEND_UTF8(scan_doc, "class", TCHAR_TO_UTF8(*Job.Class));
+		BSON_APPEND_INT32(scan_doc, "pose_idx", Job.PoseIdx);
+		img_arr_idx = 0;
+		BSON_APPEND_ARRAY_BEGIN(scan_doc, "images", &img_arr);
+	}
+	else if (Job.Type == FUploadJob::EType::Image)
+	{
+		bson_oid_t file_oid;
+		const bool bUploaded = UploadImage(Job.Data, &file_oid);
+		bUploaded ? NumUploaded++ : NumFailed++;
+		InFlightBytes.Subtract(Job.Data.Num());
+		UploadedEvent->Trigger();
+
+		if (scan_doc)
+		{
+			bson_t img_arr_obj;
+			char k_str[16];
+			const char *k_key;
+			bson_uint32_to_string(img_arr_idx, &k_key, k_str, sizeof k_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&img_arr, k_key, &img_arr_obj);
+				BSON_APPEND_UTF8(&img_arr_obj, "type", TCHAR_TO_UTF8(*Job.ViewType));
+				if (bUploaded)
+				{
+					BSON_APPEND_OID(&img_arr_obj, "file_id", &file_oid);
+				}
+			bson_append_document_end(&img_arr, &img_arr_obj);
+			img_arr_idx++;
+		}
+	}
+	else if (Job.Type == FUploadJob::EType::EndEntry)
+	{
+		if (scan_doc)
+		{
+			bson_append_array_end(scan_doc, &img_arr);
+
+			// Queue the document for writing (the service takes care of the clean up)
+			FSLMongoService::GetInstance()->Submit(DBName, CollName, scan_doc);
+			scan_doc = nullptr;
+		}
+	}
+#endif //SL_WITH_LIBMONGO_C
+	Job.Data.Empty();
+}
+
+#if SL_WITH_LIBMONGO_C
+// Write the data to gridfs in chunks, return the file id
+bool FSLScanUploader::UploadImage(const TArray<uint8>& Data, bson_oid_t* out_oid)
+{
+	mongoc_gridfs_file_t *file;
+	mongoc_gridfs_file_opt_t file_opt = { 0 };
+	mongoc_iovec_t iov;
+	bson_error_t error;
+
+	// Create new file
+	file_opt.chunk_size = UploadChunkSize;
+	file = mongoc_gridfs_create_file(gridfs, &file_opt);
+	if (!file)
+	{
+		UE_LOG(LogSL, Warning, TEXT("%s::%d Could not create gridfs file.."), *FString(__func__), __LINE__);
+		return false;
+	}
+
+	// Write the data one chunk at a time
+	int32 Offset = 0;
+	while (Offset < Data.Num())
+	{
+		const int32 NumBytes = FMath::Min<int32>(UploadChunkSize, Data.Num() - Offset);
+		iov.iov_base = (char*)(Data.GetData() + Offset);
+		iov.iov_len = NumBytes;
+		if (mongoc_gridfs_file_writev(file, &iov, 1, 0) != NumBytes)
+		{
+			if (mongoc_gridfs_file_error(file, &error))
+			{
+				UE_LOG(LogSL, Warning, TEXT("%s::%d Err.:%s"),
+					*FString(__func__), __LINE__, *FString(error.message));
+			}
+			mongoc_gridfs_file_destroy(file);
+			return false;
+		}
+		Offset += NumBytes;
+	}
+
+	// Saves modifications to file to the MongoDB server
+	if (!mongoc_gridfs_file_save(file))
+	{
+		mongoc_gridfs_file_error(file, &error);
+		UE_LOG(LogSL, Warning, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		mongoc_gridfs_file_destroy(file);
+		return false;
+	}
+
+	// Set the out oid
+	bson_oid_copy(&mongoc_gridfs_file_get_id(file)->value.v_oid, out_oid);
+	mongoc_gridfs_file_destroy(file);
+	return true;
+}
+#endif //SL_WITH_LIBMONGO_C
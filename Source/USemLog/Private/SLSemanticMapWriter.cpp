@@ -7,18 +7,21 @@
 #include "Engine/StaticMeshActor.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "Misc/Paths.h"
-#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Async/ParallelFor.h"
+#include "Serialization/MemoryWriter.h"
+#include "Misc/SecureHash.h"
 
 // UOwl
 #include "SLOwlSemanticMapStatics.h"
 
 // UUtils
-#include "Tags.h"
+#include "SLTagCache.h"
 #include "Ids.h"
 #include "Conversions.h"
 
 // Default constructor
-FSLSemanticMapWriter::FSLSemanticMapWriter()
+FSLSemanticMapWriter::FSLSemanticMapWriter() : TagCache(nullptr)
 {
 }
 
@@ -26,19 +29,115 @@ FSLSemanticMapWriter::FSLSemanticMapWriter()
 bool FSLSemanticMapWriter::WriteToFile(UWorld* World,
 	ESLOwlSemanticMapTemplate TemplateType,
 	const FString& InDirectory,
-	const FString& InFilename)
+	const FString& InFilename,
+	bool bIncremental)
 {
-	// Create the semantic map template
-	TSharedPtr<FSLOwlSemanticMap> SemMap = CreateSemanticMapDocTemplate(TemplateType);
-
-	// Add individuals to map
-	AddAllIndividuals(SemMap, World);
+	const double StartTime = FPlatformTime::Seconds();
 
-	// Write map to file
 	FString FullFilePath = FPaths::ProjectDir() +
 		InDirectory + TEXT("/") + InFilename + TEXT(".owl");
 	FPaths::RemoveDuplicateSlashes(FullFilePath);
-	return FFileHelper::SaveStringToFile(SemMap->ToString(), *FullFilePath);
+	const FString CachePath = FPaths::ProjectSavedDir() / TEXT("SLSemanticMapCache") / InDirectory.Replace(TEXT("/"), TEXT("_")) + TEXT("_") + InFilename + TEXT(".cache");
+
+	// Read phase, snapshot the objects data on the game thread
+	TArray<FSLSemanticMapObjectData> Objects;
+	TArray<FSLSemanticMapClassData> Classes;
+	ReadAllObjects(World, Objects, Classes);
+	const double ReadTime = FPlatformTime::Seconds();
+
+	// Load the previous write, the document id is kept so that the cached individuals stay valid
+	FString DocId;
+	FString PrevClassesFingerprint;
+	TMap<FString, FSLSemanticMapCacheEntry> PrevEntries;
+	bool bHasCache = false;
+	if (bIncremental)
+	{
+		bHasCache = LoadCache(CachePath, TemplateType, DocId, PrevClassesFingerprint, PrevEntries);
+		if (!bHasCache)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d No compatible previous write found in %s, the map is fully regenerated.."),
+				*FString(__func__), __LINE__, *CachePath);
+		}
+	}
+
+	// Create the semantic map template
+	TSharedPtr<FSLOwlSemanticMap> SemMap = CreateSemanticMapDocTemplate(TemplateType, DocId);
+	const FString MapPrefix = SemMap->Prefix;
+	DocId = SemMap->Id;
+
+	// Build phase, create and serialize the individuals on the worker threads, every object writes its own slot,
+	// the individuals of the objects with an unchanged fingerprint are taken from the previous write
+	TArray<FString> Ids;
+	TArray<FSLSemanticMapCacheEntry> Entries;
+	TArray<bool> Rebuilt;
+	Ids.SetNum(Objects.Num());
+	Entries.SetNum(Objects.Num());
+	Rebuilt.Init(false, Objects.Num());
+	ParallelFor(Objects.Num(), [&](int32 Idx)
+	{
+		const FSLSemanticMapObjectData& Data = Objects[Idx];
+		Ids[Idx] = Data.Id;
+		Entries[Idx].Fingerprint = GetFingerprint(Data);
+		if (const FSLSemanticMapCacheEntry* PrevEntry = PrevEntries.Find(Data.Id))
+		{
+			if (PrevEntry->Fingerprint == Entries[Idx].Fingerprint)
+			{
+				Entries[Idx].IndividualStr = PrevEntry->IndividualStr;
+				return;
+			}
+		}
+		Entries[Idx].IndividualStr = Data.bIsConstraint
+			? BuildConstraintIndividuals(MapPrefix, DocId, Data)
+			: BuildObjectIndividuals(MapPrefix, DocId, Data);
+		Rebuilt[Idx] = true;
+	});
+
+	// Class definitions are few, they are part of the document header
+	for (const auto& ClassData : Classes)
+	{
+		SemMap->AddClassDefinition(BuildClassDefinition(ClassData));
+	}
+	const FString ClassesFingerprint = GetClassesFingerprint(Classes);
+	const double BuildTime = FPlatformTime::Seconds();
+
+	// Diff against the previous write
+	int32 NumRebuilt = 0;
+	int32 NumRemoved = PrevEntries.Num();
+	for (int32 Idx = 0; Idx < Objects.Num(); ++Idx)
+	{
+		NumRebuilt += Rebuilt[Idx] ? 1 : 0;
+		NumRemoved -= PrevEntries.Contains(Ids[Idx]) ? 1 : 0;
+	}
+
+	// Nothing changed, the existing file is up to date
+	if (bHasCache && NumRebuilt == 0 && NumRemoved == 0 && ClassesFingerprint == PrevClassesFingerprint
+		&& IFileManager::Get().FileExists(*FullFilePath))
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Semantic map with %d objects is up to date (%.3fs).."),
+			*FString(__func__), __LINE__, Objects.Num(), FPlatformTime::Seconds() - StartTime);
+		return true;
+	}
+
+	// Write map to file, the individuals are streamed in the id order
+	TArray<FString> IndividualStrs;
+	IndividualStrs.Reserve(Entries.Num());
+	for (const auto& Entry : Entries)
+	{
+		IndividualStrs.Emplace(Entry.IndividualStr);
+	}
+	const bool bWritten = StreamToFile(FullFilePath, SemMap, IndividualStrs);
+
+	// Save the fingerprints for the next incremental write (also after a full regeneration)
+	if (bWritten)
+	{
+		SaveCache(CachePath, TemplateType, DocId, ClassesFingerprint, Ids, Entries);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Semantic map with %d objects and %d classes written in %.3fs (read=%.3fs; build=%.3fs; write=%.3fs), rebuilt=%d; reused=%d; removed=%d.."),
+		*FString(__func__), __LINE__, Objects.Num(), Classes.Num(), FPlatformTime::Seconds() - StartTime,
+		ReadTime - StartTime, BuildTime - ReadTime, FPlatformTime::Seconds() - BuildTime,
+		NumRebuilt, Objects.Num() - NumRebuilt, NumRemoved);
+	return bWritten;
 }
 
 // Create semantic map template
@@ -61,15 +160,45 @@ TSharedPtr<FSLOwlSemanticMap> FSLSemanticMapWriter::CreateSemanticMapDocTemplate
 	return MakeShareable(new FSLOwlSemanticMap());
 }
 
-// Add individuals to the semantic map
-void FSLSemanticMapWriter::AddAllIndividuals(TSharedPtr<FSLOwlSemanticMap> InSemMap, UWorld* World)
+// Snapshot the data of the semantically annotated objects and classes (game thread)
+void FSLSemanticMapWriter::ReadAllObjects(UWorld* World,
+	TArray<FSLSemanticMapObjectData>& OutObjects,
+	TArray<FSLSemanticMapClassData>& OutClasses)
 {
-	// Iterate objects with SemLog tag key
-	for (const auto& ObjToTagsItr : FTags::GetObjectKeyValuePairsMap(World, "SemLog"))
+	// Parse the tags once (re-parsed on every write, the tags might have been edited since), the other lookups hit the cache;
+	// a cache created only for the write (e.g. of the editor world) is deleted afterwards, it would go stale with the edits
+	TagCache = FSLTagCache::GetInstance(World);
+	const bool bWasCached = TagCache->IsInitFor(World);
+	TagCache->Build(World);
+
+	// Sort the objects by their id (or path if they have none), the output does not depend on the map iteration order
+	TArray<TPair<FString, UObject*>> SortedObjects;
+	SortedObjects.Reserve(TagCache->GetObjectKeyValuePairsMap().Num());
+	for (const auto& ObjToTagsItr : TagCache->GetObjectKeyValuePairsMap())
 	{
+		if (UObject* Object = ObjToTagsItr.Key.Get())
+		{
+			const FString* IdPtr = ObjToTagsItr.Value.Find("Id");
+			SortedObjects.Emplace(IdPtr ? *IdPtr : Object->GetPathName(), Object);
+		}
+	}
+	SortedObjects.Sort([](const TPair<FString, UObject*>& A, const TPair<FString, UObject*>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	// Classes are defined by their first object
+	TSet<FString> DefinedClasses;
+
+	OutObjects.Reserve(SortedObjects.Num());
+	for (const auto& KeyObjPair : SortedObjects)
+	{
+		UObject* Object = KeyObjPair.Value;
+		const TMap<FString, FString>& KeyValuePairs = *TagCache->Find(Object);
+
 		// Get Id and Class of items
-		const FString* IdPtr = ObjToTagsItr.Value.Find("Id");
-		const FString* ClassPtr = ObjToTagsItr.Value.Find("Class");
+		const FString* IdPtr = KeyValuePairs.Find("Id");
+		const FString* ClassPtr = KeyValuePairs.Find("Class");
 
 		// Take into account only objects with an id
 		if (IdPtr)
@@ -77,373 +206,488 @@ void FSLSemanticMapWriter::AddAllIndividuals(TSharedPtr<FSLOwlSemanticMap> InSem
 			// Check if class is also available
 			if (ClassPtr)
 			{
-				AddObjectIndividual(InSemMap, ObjToTagsItr.Key, *IdPtr, *ClassPtr);
+				FSLSemanticMapObjectData& Data = OutObjects.AddDefaulted_GetRef();
+				Data.Id = *IdPtr;
+				Data.Class = *ClassPtr;
+				ReadObjectData(Object, Data);
 			}
 			// No class is available, check for other types, e.g. constraints can be actors or components
-			else if (APhysicsConstraintActor* ConstrAct = Cast<APhysicsConstraintActor>(ObjToTagsItr.Key))
+			else if (APhysicsConstraintActor* ConstrAct = Cast<APhysicsConstraintActor>(Object))
 			{
-				AddConstraintIndividual(InSemMap, ConstrAct->GetConstraintComp(), *IdPtr, ConstrAct->Tags);
+				FSLSemanticMapObjectData Data;
+				Data.Id = *IdPtr;
+				if (ReadConstraintData(ConstrAct->GetConstraintComp(), ConstrAct->Tags, Data))
+				{
+					OutObjects.Emplace(MoveTemp(Data));
+				}
 			}
-			else if (UPhysicsConstraintComponent* ConstrComp = Cast<UPhysicsConstraintComponent>(ObjToTagsItr.Key))
+			else if (UPhysicsConstraintComponent* ConstrComp = Cast<UPhysicsConstraintComponent>(Object))
 			{
-				AddConstraintIndividual(InSemMap, ConstrComp, *IdPtr, ConstrComp->ComponentTags);
+				FSLSemanticMapObjectData Data;
+				Data.Id = *IdPtr;
+				if (ReadConstraintData(ConstrComp, ConstrComp->ComponentTags, Data))
+				{
+					OutObjects.Emplace(MoveTemp(Data));
+				}
 			}
 		}
 
-		// Add class individuals (Id not mandatory)
-		if (ClassPtr)
+		// Add class definitions (Id not mandatory)
+		if (ClassPtr && !DefinedClasses.Contains(*ClassPtr))
+		{
+			DefinedClasses.Add(*ClassPtr);
+			FSLSemanticMapClassData& ClassData = OutClasses.AddDefaulted_GetRef();
+			ClassData.Class = *ClassPtr;
+			ClassData.SubClassOf = KeyValuePairs.FindRef("SubClassOf");
+			ReadClassData(Object, ClassData);
+		}
+	}
+
+	if (!bWasCached)
+	{
+		FSLTagCache::DeleteInstance(World);
+	}
+	TagCache = nullptr;
+}
+
+// Snapshot the object data
+void FSLSemanticMapWriter::ReadObjectData(UObject* Object, FSLSemanticMapObjectData& OutData)
+{
+	OutData.ParentId = GetParentId(Object);
+	GetChildIds(Object, OutData.ChildIds);
+	OutData.Mobility = GetMobility(Object);
+	OutData.ColorHex = TagCache->GetValue(Object, "VisMask");
+
+	// Lambda to remove path before and including "Models/", after and including ".", and the "SM_" prefixes 
+	auto GetPathToCadModelLambda = [](UObject* Obj)->FString
+	{
+		FString Path = Obj->GetFullName();
+		const FString SubStr("Models/");
+		int32 FindIdx = Path.Find(SubStr, ESearchCase::CaseSensitive);
+		Path.RemoveAt(0, FindIdx + SubStr.Len());
+		Path.FindLastChar('.', FindIdx);
+		Path.RemoveAt(FindIdx, Path.Len() - FindIdx);
+		Path.ReplaceInline(*FString("SM_"), *FString(""));
+		return Path;
+	};
+
+	// Physics properties (gravity, overlap events, mass) and cad model of the static meshes
+	UStaticMeshComponent* SMC = nullptr;
+	if (AStaticMeshActor* ObjAsSMA = Cast<AStaticMeshActor>(Object))
+	{
+		SMC = ObjAsSMA->GetStaticMeshComponent();
+	}
+	else
+	{
+		SMC = Cast<UStaticMeshComponent>(Object);
+	}
+	if (SMC)
+	{
+		OutData.bHasPhysics = true;
+		OutData.Mass = SMC->IsSimulatingPhysics() ? SMC->GetMass() : SMC->CalculateMass();
+		OutData.bGenerateOverlapEvents = SMC->GetGenerateOverlapEvents();
+		OutData.bGravity = SMC->IsGravityEnabled();
+		if (UStaticMesh* SM = SMC->GetStaticMesh())
 		{
-			const FString* SubClassOfPtr = ObjToTagsItr.Value.Find("SubClassOf");
-			const FString SubClassOf = SubClassOfPtr ? *SubClassOfPtr : "";
-			AddClassDefinition(InSemMap, ObjToTagsItr.Key, *ClassPtr, SubClassOf);
+			OutData.PathToCadModel = GetPathToCadModelLambda(SM);
 		}
 	}
+
+	// Pose and tags
+	if (AActor* ObjAsAct = Cast<AActor>(Object))
+	{
+		OutData.bHasPose = true;
+		OutData.ROSLoc = FConversions::UToROS(ObjAsAct->GetActorLocation());
+		OutData.ROSQuat = FConversions::UToROS(ObjAsAct->GetActorQuat());
+		OutData.Tags = ObjAsAct->Tags;
+	}
+	else if (USceneComponent* ObjAsSceneComp = Cast<USceneComponent>(Object))
+	{
+		OutData.bHasPose = true;
+		OutData.ROSLoc = FConversions::UToROS(ObjAsSceneComp->GetComponentLocation());
+		OutData.ROSQuat = FConversions::UToROS(ObjAsSceneComp->GetComponentQuat());
+		OutData.Tags = ObjAsSceneComp->ComponentTags;
+	}
 }
 
-// Add object individual to the semantic map
-void FSLSemanticMapWriter::AddObjectIndividual(TSharedPtr<FSLOwlSemanticMap> InSemMap,
-	UObject* Object, const FString& InId, const FString& InClass)
+// Snapshot the constraint data, false if the constrained actors are not annotated
+bool FSLSemanticMapWriter::ReadConstraintData(UPhysicsConstraintComponent* ConstraintComp,
+	const TArray<FName>& InTags,
+	FSLSemanticMapObjectData& OutData)
 {
-	// Get map data
-	const FString MapPrefix = InSemMap->Prefix;
-	const FString DocId = InSemMap->Id;
+	if (!ConstraintComp)
+	{
+		return false;
+	}
+
+	AActor* ParentAct = ConstraintComp->ConstraintActor1;
+	AActor* ChildAct = ConstraintComp->ConstraintActor2;
+	if (!ParentAct || !ChildAct)
+	{
+		return false;
+	}
+
+	OutData.ConstrParentId = TagCache->GetValue(ParentAct, "Id");
+	OutData.ConstrChildId = TagCache->GetValue(ChildAct, "Id");
+	if (OutData.ConstrParentId.IsEmpty() || OutData.ConstrChildId.IsEmpty())
+	{
+		return false;
+	}
+
+	OutData.bIsConstraint = true;
+	OutData.Tags = InTags;
+	OutData.bHasPose = true;
+	OutData.ROSLoc = FConversions::UToROS(ConstraintComp->GetComponentLocation());
+	OutData.ROSQuat = FConversions::UToROS(ConstraintComp->GetComponentQuat());
+
+	// Linear constraint
+	const FConstraintInstance& CI = ConstraintComp->ConstraintInstance;
+	OutData.LinMotion[0] = CI.GetLinearXMotion();
+	OutData.LinMotion[1] = CI.GetLinearYMotion();
+	OutData.LinMotion[2] = CI.GetLinearZMotion();
+	OutData.LinLimit = FConversions::CmToM(CI.GetLinearLimit());
+	OutData.bLinSoftConstraint = CI.ProfileInstance.LinearLimit.bSoftConstraint;
+	OutData.LinStiffness = CI.ProfileInstance.LinearLimit.Stiffness;
+	OutData.LinDamping = CI.ProfileInstance.LinearLimit.Damping;
+
+	// Angular constraint
+	OutData.AngMotion[0] = CI.GetAngularSwing1Motion();
+	OutData.AngMotion[1] = CI.GetAngularSwing2Motion();
+	OutData.AngMotion[2] = CI.GetAngularTwistMotion();
+	OutData.AngLimit[0] = FMath::DegreesToRadians(CI.GetAngularSwing1Limit());
+	OutData.AngLimit[1] = FMath::DegreesToRadians(CI.GetAngularSwing2Limit());
+	OutData.AngLimit[2] = FMath::DegreesToRadians(CI.GetAngularTwistLimit());
+	OutData.bAngSoftSwingConstraint = CI.ProfileInstance.ConeLimit.bSoftConstraint;
+	OutData.AngSwingStiffness = CI.ProfileInstance.ConeLimit.Stiffness;
+	OutData.AngSwingDamping = CI.ProfileInstance.ConeLimit.Damping;
+	OutData.bAngSoftTwistConstraint = CI.ProfileInstance.TwistLimit.bSoftConstraint;
+	OutData.AngTwistStiffness = CI.ProfileInstance.TwistLimit.Stiffness;
+	OutData.AngTwistDamping = CI.ProfileInstance.TwistLimit.Damping;
+	return true;
+}
+
+// Snapshot the class data
+void FSLSemanticMapWriter::ReadClassData(UObject* Object, FSLSemanticMapClassData& OutData)
+{
+	// Bounds and bones if available
+	UPrimitiveComponent* PrimComp = nullptr;
+	if (AStaticMeshActor* ObjAsSMAct = Cast<AStaticMeshActor>(Object))
+	{
+		PrimComp = ObjAsSMAct->GetStaticMeshComponent();
+	}
+	else if (ASkeletalMeshActor* ObjAsSkelAct = Cast<ASkeletalMeshActor>(Object))
+	{
+		PrimComp = ObjAsSkelAct->GetSkeletalMeshComponent();
+	}
+	else
+	{
+		PrimComp = Cast<UPrimitiveComponent>(Object);
+	}
+
+	if (PrimComp)
+	{
+		OutData.BBSize = FConversions::CmToM(PrimComp->Bounds.GetBox().GetSize());
+		if (USkeletalMeshComponent* SkelComp = Cast<USkeletalMeshComponent>(PrimComp))
+		{
+			TArray<FName> BoneNames;
+			SkelComp->GetBoneNames(BoneNames);
+			for (const auto& BoneName : BoneNames)
+			{
+				OutData.BoneNames.Emplace(BoneName.ToString());
+			}
+		}
+	}
+}
 
+// Build and serialize the individuals of the object (thread safe)
+FString FSLSemanticMapWriter::BuildObjectIndividuals(const FString& MapPrefix, const FString& DocId, const FSLSemanticMapObjectData& Data)
+{
 	// Create the object individual
-	FSLOwlNode ObjIndividual = FSLOwlSemanticMapStatics::CreateObjectIndividual(MapPrefix, InId, InClass);
+	FSLOwlNode ObjIndividual = FSLOwlSemanticMapStatics::CreateObjectIndividual(MapPrefix, Data.Id, Data.Class);
 
 	// Add describedInMap property
 	ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateDescribedInMapProperty(MapPrefix, DocId));
 	
 	// Add parent property
-	const FString ParentId = GetParentId(Object);
-	if (!ParentId.IsEmpty())
+	if (!Data.ParentId.IsEmpty())
 	{
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateParentProperty(MapPrefix, ParentId));
+		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateParentProperty(MapPrefix, Data.ParentId));
 	}
 
 	// Add child properties
-	TArray<FString> ChildIds;
-	GetChildIds(Object, ChildIds);
-	for (const auto& ChildId : ChildIds)
+	for (const auto& ChildId : Data.ChildIds)
 	{
 		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateChildProperty(MapPrefix, ChildId));
 	}
 
 	// Add mobility property
-	const FString Mobility = GetMobility(Object);
-	if (!Mobility.IsEmpty())
+	if (!Data.Mobility.IsEmpty())
 	{
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateMobilityProperty(Mobility));
+		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateMobilityProperty(Data.Mobility));
 	}
 
 	// Add physics properties (gravity, overlap events, mass)
-	TArray<FSLOwlNode> PhysicsProperties = GetIndividualPhysicsProperties(Object);
-	if (PhysicsProperties.Num() > 0)
+	if (Data.bHasPhysics)
 	{
-		ObjIndividual.AddChildNodes(PhysicsProperties);
+		ObjIndividual.AddChildNodes(FSLOwlSemanticMapStatics::CreatePhysicsProperties(
+			Data.Mass, Data.bGenerateOverlapEvents, Data.bGravity));
 	}
 	
 	// Add color property
-	FString ColorHex = FTags::GetValue(Object, "SemLog", "VisMask");
-	if (!ColorHex.IsEmpty())
+	if (!Data.ColorHex.IsEmpty())
 	{
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateMaskColorProperty(ColorHex));
+		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateMaskColorProperty(Data.ColorHex));
 	}
 
-	// Lambda to remove path before and including "Models/", after and including ".", and the "SM_" prefixes 
-	auto GetPathToCadModelLambda = [](UObject* Obj)->FString
+	// Individuals are children of the document root
+	FString Indent = INDENT_STEP;
+	if (!Data.bHasPose)
 	{
-		FString Path = Obj->GetFullName();
-		const FString SubStr("Models/");
-		int32 FindIdx = Path.Find(SubStr, ESearchCase::CaseSensitive);
-		Path.RemoveAt(0, FindIdx + SubStr.Len());
-		Path.FindLastChar('.', FindIdx);
-		Path.RemoveAt(FindIdx, Path.Len() - FindIdx);
-		Path.ReplaceInline(*FString("SM_"), *FString(""));
-		return Path;
-	};
+		// Obj has no pose info
+		return ObjIndividual.ToString(Indent);
+	}
 
-	// Add various properties
-	if (AActor* ObjAsAct = Cast<AActor>(Object))
-	{
-		// Generate unique id for the properties
-		const FString PoseId = FIds::NewGuidInBase64Url();
+	// Generate unique id for the properties
+	const FString PoseId = FIds::NewGuidInBase64Url();
 
-		/* Add properties */
-		// Pose property
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePoseProperty(MapPrefix, PoseId));
+	// Pose property
+	ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePoseProperty(MapPrefix, PoseId));
 
+	// If static mesh, add pathToCadModel property
+	if (!Data.PathToCadModel.IsEmpty())
+	{
+		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePathToCadModelProperty(Data.PathToCadModel));
+	}
 
-		// If static mesh, add pathToCadModel property
-		if (AStaticMeshActor* ActAsSMA = Cast<AStaticMeshActor>(ObjAsAct))
-		{
-			if (UStaticMeshComponent* SMC = ActAsSMA->GetStaticMeshComponent())
-			{
-				if (UStaticMesh* SM = SMC->GetStaticMesh())
-				{
-					ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePathToCadModelProperty(GetPathToCadModelLambda(SM)));
-				}
-			}
-		}
+	// Add tags data property
+	ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateTagsDataProperty(Data.Tags));
 
-		// Add tags data property
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateTagsDataProperty(
-			ObjAsAct->Tags));
+	// Create pose individual
+	FSLOwlNode PoseIndividual = FSLOwlSemanticMapStatics::CreatePoseIndividual(
+		MapPrefix, PoseId, Data.ROSLoc, Data.ROSQuat);
 
-		// Add individuals 
-		InSemMap->AddIndividual(ObjIndividual);
+	return ObjIndividual.ToString(Indent) + PoseIndividual.ToString(Indent);
+}
 
-		// Create pose individual
-		const FVector ROSLoc = FConversions::UToROS(ObjAsAct->GetActorLocation());
-		const FQuat ROSQuat = FConversions::UToROS(ObjAsAct->GetActorQuat());
-		InSemMap->AddIndividual(FSLOwlSemanticMapStatics::CreatePoseIndividual(
-			MapPrefix, PoseId, ROSLoc, ROSQuat));
-	}
-	else if (USceneComponent* ObjAsSceneComp = Cast<USceneComponent>(Object))
-	{
-		// Generate unique id for the properties
-		const FString PoseId = FIds::NewGuidInBase64Url();
-		const FString TagsId = FIds::NewGuidInBase64Url();
+// Build and serialize the individuals of the constraint (thread safe)
+FString FSLSemanticMapWriter::BuildConstraintIndividuals(const FString& MapPrefix, const FString& DocId, const FSLSemanticMapObjectData& Data)
+{
+	// Create the object individual
+	FSLOwlNode ConstrIndividual = FSLOwlSemanticMapStatics::CreateConstraintIndividual(
+		MapPrefix, Data.Id, Data.ConstrParentId, Data.ConstrChildId);
 
-		// Add properties
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePoseProperty(
-			MapPrefix, PoseId));
+	// Add describedInMap property
+	ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateDescribedInMapProperty(
+		MapPrefix, DocId));
+
+	// Add tags data property
+	ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateTagsDataProperty(
+		Data.Tags));
+
+	// Generate unique ids 
+	const FString PoseId = FIds::NewGuidInBase64Url();
+	const FString LinId = FIds::NewGuidInBase64Url();
+	const FString AngId = FIds::NewGuidInBase64Url();
+
+	// Add properties
+	ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePoseProperty(
+		MapPrefix, PoseId));
+	ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateLinearConstraintProperty(
+		MapPrefix, LinId));
+	ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateAngularConstraintProperty(
+		MapPrefix, AngId));
+
+	// Create pose individual
+	FSLOwlNode PoseIndividual = FSLOwlSemanticMapStatics::CreatePoseIndividual(
+		MapPrefix, PoseId, Data.ROSLoc, Data.ROSQuat);
+
+	// Create linear constraint individual
+	FSLOwlNode LinIndividual = FSLOwlSemanticMapStatics::CreateLinearConstraintProperties(
+		MapPrefix, LinId, Data.LinMotion[0], Data.LinMotion[1], Data.LinMotion[2], Data.LinLimit,
+		Data.bLinSoftConstraint, Data.LinStiffness, Data.LinDamping);
+
+	// Create angular constraint individual
+	FSLOwlNode AngIndividual = FSLOwlSemanticMapStatics::CreateAngularConstraintProperties(
+		MapPrefix, AngId, Data.AngMotion[0], Data.AngMotion[1], Data.AngMotion[2],
+		Data.AngLimit[0], Data.AngLimit[1], Data.AngLimit[2], Data.bAngSoftSwingConstraint,
+		Data.AngSwingStiffness, Data.AngSwingDamping, Data.bAngSoftTwistConstraint,
+		Data.AngTwistStiffness, Data.AngTwistDamping);
+
+	// Individuals are children of the document root
+	FString Indent = INDENT_STEP;
+	return ConstrIndividual.ToString(Indent) + PoseIndividual.ToString(Indent)
+		+ LinIndividual.ToString(Indent) + AngIndividual.ToString(Indent);
+}
 
-		// If static mesh, add pathToCadModel property
-		if (UStaticMeshComponent* CompAsSMC = Cast<UStaticMeshComponent>(ObjAsSceneComp))
-		{
-			if (UStaticMesh* SM = CompAsSMC->GetStaticMesh())
-			{
-				ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePathToCadModelProperty(GetPathToCadModelLambda(SM)));
-			}
-		}
+// Build the class definition
+FSLOwlNode FSLSemanticMapWriter::BuildClassDefinition(const FSLSemanticMapClassData& Data)
+{
+	// Create class definition individual
+	FSLOwlNode ClassDefinition = FSLOwlSemanticMapStatics::CreateClassDefinition(Data.Class);
+	ClassDefinition.Comment = TEXT("Class ") + Data.Class;
 
-		// Add tags data property
-		ObjIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateTagsDataProperty(
-			ObjAsSceneComp->ComponentTags));
-		
-		// Add individuals 
-		InSemMap->AddIndividual(ObjIndividual);
+	// Check if subclass is known
+	if (!Data.SubClassOf.IsEmpty())
+	{
+		ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateSubClassOfProperty(Data.SubClassOf));
+	}
 
-		// Create pose individual
-		const FVector ROSLoc = FConversions::UToROS(ObjAsSceneComp->GetComponentLocation());
-		const FQuat ROSQuat = FConversions::UToROS(ObjAsSceneComp->GetComponentQuat());
-		InSemMap->AddIndividual(FSLOwlSemanticMapStatics::CreatePoseIndividual(
-			MapPrefix, PoseId, ROSLoc, ROSQuat));
+	// Add bounds if available
+	if (!Data.BBSize.IsZero())
+	{
+		ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateDepthProperty(Data.BBSize.X));
+		ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateWidthProperty(Data.BBSize.Y));
+		ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateHeightProperty(Data.BBSize.Z));
 	}
-	else
+
+	// Add skeletal bones
+	for (const auto& BoneName : Data.BoneNames)
 	{
-		// Obj has no pose info
-		InSemMap->AddIndividual(ObjIndividual);
+		ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateSkeletalBoneProperty(BoneName));
 	}
+	return ClassDefinition;
 }
 
-// Add class individual
-void FSLSemanticMapWriter::AddClassDefinition(TSharedPtr<FSLOwlSemanticMap> InSemMap,
-	UObject* Object,
-	const FString& InClass,
-	const FString& InSubClassOf)
+// Hash of the object snapshot (tags, pose, parent/child links, properties)
+FString FSLSemanticMapWriter::GetFingerprint(const FSLSemanticMapObjectData& Data)
 {
-	// Return if class was already defined
-	for (const auto& ClassDef : InSemMap->ClassDefinitions)
+	// Archives take non-const refs, the data is only read
+	FSLSemanticMapObjectData& D = const_cast<FSLSemanticMapObjectData&>(Data);
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+	Ar << D.Id << D.Class << D.ParentId << D.ChildIds << D.Mobility;
+	Ar << D.bHasPhysics << D.Mass << D.bGenerateOverlapEvents << D.bGravity;
+	Ar << D.ColorHex << D.PathToCadModel << D.Tags;
+	Ar << D.bHasPose << D.ROSLoc << D.ROSQuat;
+	Ar << D.bIsConstraint << D.ConstrParentId << D.ConstrChildId;
+	Ar.Serialize(D.LinMotion, sizeof(D.LinMotion));
+	Ar << D.LinLimit << D.bLinSoftConstraint << D.LinStiffness << D.LinDamping;
+	Ar.Serialize(D.AngMotion, sizeof(D.AngMotion));
+	Ar.Serialize(D.AngLimit, sizeof(D.AngLimit));
+	Ar << D.bAngSoftSwingConstraint << D.AngSwingStiffness << D.AngSwingDamping;
+	Ar << D.bAngSoftTwistConstraint << D.AngTwistStiffness << D.AngTwistDamping;
+	return FMD5::HashBytes(Bytes.GetData(), Bytes.Num());
+}
+
+// Hash of the class definitions snapshots
+FString FSLSemanticMapWriter::GetClassesFingerprint(const TArray<FSLSemanticMapClassData>& Classes)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+	for (const auto& ClassData : Classes)
 	{
-		for (const auto& ClassAttr : ClassDef.Attributes)
-		{
-			if (ClassAttr.Key.Prefix.Equals("rdf") &&
-				ClassAttr.Key.LocalName.Equals("about") &&
-				ClassAttr.Value.LocalValue.Equals(InClass))
-			{
-				return;
-			}
-		}
+		FSLSemanticMapClassData& C = const_cast<FSLSemanticMapClassData&>(ClassData);
+		Ar << C.Class << C.SubClassOf << C.BBSize << C.BoneNames;
 	}
+	return FMD5::HashBytes(Bytes.GetData(), Bytes.Num());
+}
 
-	// Create class definition individual
-	FSLOwlNode ClassDefinition = FSLOwlSemanticMapStatics::CreateClassDefinition(InClass);
-	ClassDefinition.Comment = TEXT("Class ") + InClass;
-
-	// Check if subclass is known
-	if (!InSubClassOf.IsEmpty())
+// Load the fingerprints and individuals of the previous write, false if missing or incompatible
+bool FSLSemanticMapWriter::LoadCache(const FString& Path, ESLOwlSemanticMapTemplate TemplateType,
+	FString& OutDocId, FString& OutClassesFingerprint, TMap<FString, FSLSemanticMapCacheEntry>& OutEntries)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+	if (!Reader)
 	{
-		ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateSubClassOfProperty(InSubClassOf));
+		return false;
 	}
 
-	// Add bounds if available
-	if (AStaticMeshActor* ObjAsSMAct = Cast<AStaticMeshActor>(Object))
+	int32 Version = 0;
+	uint8 Template = 0;
+	*Reader << Version << Template;
+	if (Version != CacheVersion || Template != static_cast<uint8>(TemplateType))
 	{
-		if (UStaticMeshComponent* SMComp = ObjAsSMAct->GetStaticMeshComponent())
-		{
-			const FVector BBSize = FConversions::CmToM(
-				SMComp->Bounds.GetBox().GetSize());
-			if (!BBSize.IsZero())
-			{
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateDepthProperty(BBSize.X));
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateWidthProperty(BBSize.Y));
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateHeightProperty(BBSize.Z));
-			}
-		}
+		return false;
 	}
-	else if (ASkeletalMeshActor* ObjAsSkelAct = Cast<ASkeletalMeshActor>(Object))
+
+	int32 Num = 0;
+	*Reader << OutDocId << OutClassesFingerprint << Num;
+	OutEntries.Reserve(Num);
+	for (int32 Idx = 0; Idx < Num && !Reader->IsError(); ++Idx)
 	{
-		if (USkeletalMeshComponent* SkelComp = ObjAsSkelAct->GetSkeletalMeshComponent())
-		{
-			const FVector BBSize = FConversions::CmToM(
-				SkelComp->Bounds.GetBox().GetSize());
-			if (!BBSize.IsZero())
-			{
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateDepthProperty(BBSize.X));
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateWidthProperty(BBSize.Y));
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateHeightProperty(BBSize.Z));
-			}
+		FString Id;
+		*Reader << Id;
+		*Reader << OutEntries.Add(Id);
+	}
 
-			TArray<FName> BoneNames;
-			SkelComp->GetBoneNames(BoneNames);
-			for (const auto& BoneName : BoneNames)
-			{
-				ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateSkeletalBoneProperty(BoneName.ToString()));
-			}
-		}
+	// A truncated file is ignored
+	if (Reader->IsError())
+	{
+		OutDocId.Empty();
+		OutClassesFingerprint.Empty();
+		OutEntries.Empty();
+		return false;
 	}
-	else if (USkeletalMeshComponent* ObjAsSkelComp = Cast<USkeletalMeshComponent>(Object))
+	return true;
+}
+
+// Save the fingerprints and individuals of the current write
+bool FSLSemanticMapWriter::SaveCache(const FString& Path, ESLOwlSemanticMapTemplate TemplateType,
+	const FString& DocId, const FString& ClassesFingerprint, const TArray<FString>& Ids, const TArray<FSLSemanticMapCacheEntry>& Entries)
+{
+	// Write through a temporary file, a crash never leaves a partial cache behind
+	const FString TmpPath = Path + TEXT(".tmp");
 	{
-		const FVector BBSize = FConversions::CmToM(ObjAsSkelComp->Bounds.GetBox().GetSize());
-		if (!BBSize.IsZero())
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TmpPath));
+		if (!Writer)
 		{
-			ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateDepthProperty(BBSize.X));
-			ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateWidthProperty(BBSize.Y));
-			ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateHeightProperty(BBSize.Z));
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__func__), __LINE__, *TmpPath);
+			return false;
 		}
 
-		TArray<FName> BoneNames;
-		ObjAsSkelComp->GetBoneNames(BoneNames);
-		for (const auto& BoneName : BoneNames)
+		int32 Version = CacheVersion;
+		uint8 Template = static_cast<uint8>(TemplateType);
+		int32 Num = Entries.Num();
+		*Writer << Version << Template;
+		*Writer << const_cast<FString&>(DocId) << const_cast<FString&>(ClassesFingerprint) << Num;
+		for (int32 Idx = 0; Idx < Num; ++Idx)
 		{
-			ClassDefinition.AddChildNode(
-				FSLOwlSemanticMapStatics::CreateSkeletalBoneProperty(BoneName.ToString()));
+			*Writer << const_cast<FString&>(Ids[Idx]);
+			*Writer << const_cast<FSLSemanticMapCacheEntry&>(Entries[Idx]);
 		}
-	}
-	else if(UPrimitiveComponent* ObjAsPrimComp = Cast<UPrimitiveComponent>(Object))
-	{
-		const FVector BBSize = FConversions::CmToM(
-			ObjAsPrimComp->Bounds.GetBox().GetSize());
-		if (!BBSize.IsZero())
+		if (!Writer->Close())
 		{
-			ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateDepthProperty(BBSize.X));
-			ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateWidthProperty(BBSize.Y));
-			ClassDefinition.AddChildNode(FSLOwlSemanticMapStatics::CreateHeightProperty(BBSize.Z));
+			return false;
 		}
 	}
-	InSemMap->ClassDefinitions.Add(ClassDefinition);
+	return IFileManager::Get().Move(*Path, *TmpPath, true);
 }
 
-// Add constraint individual
-void FSLSemanticMapWriter::AddConstraintIndividual(TSharedPtr<FSLOwlSemanticMap> InSemMap,
-	UPhysicsConstraintComponent* ConstraintComp,
-	const FString& InId,
-	const TArray<FName>& InTags)
+// Write the document with the serialized individuals appended, without building the whole document string
+bool FSLSemanticMapWriter::StreamToFile(const FString& Path, TSharedPtr<FSLOwlSemanticMap> InSemMap, const TArray<FString>& IndividualStrs)
 {
-	const FString MapPrefix = InSemMap->Prefix;
-	const FString DocId = InSemMap->Id;
-
-	AActor* ParentAct = ConstraintComp->ConstraintActor1;
-	AActor* ChildAct = ConstraintComp->ConstraintActor2;
-
-	if (ParentAct && ChildAct)
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Writer)
 	{
-		const FString ParentId = FTags::GetValue(ParentAct, "SemLog", "Id");
-		const FString ChildId = FTags::GetValue(ChildAct, "SemLog", "Id");
-		if (!ParentId.IsEmpty() && !ChildId.IsEmpty())
-		{
-			// Create the object individual
-			FSLOwlNode ConstrIndividual = FSLOwlSemanticMapStatics::CreateConstraintIndividual(
-				MapPrefix, InId, ParentId, ChildId);
-
-			// Add describedInMap property
-			ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateDescribedInMapProperty(
-				MapPrefix, DocId));
-
-			// Add tags data property
-			ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateTagsDataProperty(
-				InTags));
-
-			// Generate unique ids 
-			const FString PoseId = FIds::NewGuidInBase64Url();
-			const FString LinId = FIds::NewGuidInBase64Url();
-			const FString AngId = FIds::NewGuidInBase64Url();
-
-			// Add properties
-			ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreatePoseProperty(
-				MapPrefix, PoseId));
-			ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateLinearConstraintProperty(
-				MapPrefix, LinId));
-			ConstrIndividual.AddChildNode(FSLOwlSemanticMapStatics::CreateAngularConstraintProperty(
-				MapPrefix, AngId));
-			
-			// Add individuals to the map
-			InSemMap->AddIndividual(ConstrIndividual);
-
-			// Create pose individual
-			const FVector ROSLoc = FConversions::UToROS(ConstraintComp->GetComponentLocation());
-			const FQuat ROSQuat = FConversions::UToROS(ConstraintComp->GetComponentQuat());
-			InSemMap->AddIndividual(FSLOwlSemanticMapStatics::CreatePoseIndividual(
-				MapPrefix, PoseId, ROSLoc, ROSQuat));
-
-			// Create linear constraint individual
-			const uint8 LinXMotion = ConstraintComp->ConstraintInstance.GetLinearXMotion();
-			const uint8 LinYMotion = ConstraintComp->ConstraintInstance.GetLinearYMotion();
-			const uint8 LinZMotion = ConstraintComp->ConstraintInstance.GetLinearZMotion();
-			const float LinLimit = FConversions::CmToM(ConstraintComp->ConstraintInstance.GetLinearLimit());
-			const bool bLinSoftConstraint = ConstraintComp->ConstraintInstance.ProfileInstance.LinearLimit.bSoftConstraint;
-			const float LinStiffness = ConstraintComp->ConstraintInstance.ProfileInstance.LinearLimit.Stiffness;
-			const float LinDamping = ConstraintComp->ConstraintInstance.ProfileInstance.LinearLimit.Damping;
-			
-			InSemMap->AddIndividual(FSLOwlSemanticMapStatics::CreateLinearConstraintProperties(
-				MapPrefix, LinId, LinXMotion, LinYMotion, LinZMotion, LinLimit, 
-				bLinSoftConstraint, LinStiffness, LinDamping));
-
-			// Create angular constraint individual
-			const uint8 AngSwing1Motion = ConstraintComp->ConstraintInstance.GetAngularSwing1Motion();
-			const uint8 AngSwing2Motion = ConstraintComp->ConstraintInstance.GetAngularSwing2Motion();
-			const uint8 AngTwistMotion = ConstraintComp->ConstraintInstance.GetAngularTwistMotion();
-			const float AngSwing1Limit = FMath::DegreesToRadians(ConstraintComp->ConstraintInstance.GetAngularSwing1Limit());
-			const float AngSwing2Limit = FMath::DegreesToRadians(ConstraintComp->ConstraintInstance.GetAngularSwing2Limit());
-			const float AngTwistLimit = FMath::DegreesToRadians(ConstraintComp->ConstraintInstance.GetAngularTwistLimit());
-			const bool bAngSoftSwingConstraint = ConstraintComp->ConstraintInstance.ProfileInstance.ConeLimit.bSoftConstraint;
-			const float AngSwingStiffness = ConstraintComp->ConstraintInstance.ProfileInstance.ConeLimit.Stiffness;
-			const float AngSwingDamping = ConstraintComp->ConstraintInstance.ProfileInstance.ConeLimit.Damping;
-			const bool bAngSoftTwistConstraint = ConstraintComp->ConstraintInstance.ProfileInstance.TwistLimit.bSoftConstraint;
-			const float AngTwistStiffness = ConstraintComp->ConstraintInstance.ProfileInstance.TwistLimit.Stiffness;
-			const float AngTwistDamping = ConstraintComp->ConstraintInstance.ProfileInstance.TwistLimit.Damping;
-
-			InSemMap->AddIndividual(FSLOwlSemanticMapStatics::CreateAngularConstraintProperties(
-				MapPrefix, AngId, AngSwing1Motion, AngSwing2Motion, AngTwistMotion,
-				AngSwing1Limit, AngSwing2Limit, AngTwistLimit, bAngSoftSwingConstraint,
-				AngSwingStiffness, AngSwingDamping, bAngSoftTwistConstraint,
-				AngTwistStiffness, AngTwistDamping));
-		}
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__func__), __LINE__, *Path);
+		return false;
 	}
-}
 
-// Add individual physics properties
-TArray<FSLOwlNode> FSLSemanticMapWriter::GetIndividualPhysicsProperties(UObject* Object)
-{
-	// Check object type
-	if (AStaticMeshActor* ObjAsSMA = Cast<AStaticMeshActor>(Object))
+	// Lambda to write the string as utf-8 (as declared in the xml header)
+	auto WriteLambda = [&Writer](const FString& Str)
 	{
-		if (UStaticMeshComponent* SMC = ObjAsSMA->GetStaticMeshComponent())
-		{
-			float Mass = SMC->IsSimulatingPhysics() ? SMC->GetMass() : SMC->CalculateMass();
-			return FSLOwlSemanticMapStatics::CreatePhysicsProperties(
-				Mass, SMC->GetGenerateOverlapEvents(), SMC->IsGravityEnabled());
-		}
+		FTCHARToUTF8 UTF8Str(*Str);
+		Writer->Serialize(const_cast<ANSICHAR*>(UTF8Str.Get()), UTF8Str.Length());
+	};
+
+	// The template document (header, definitions and template individuals) is small, 
+	// it is serialized as a whole and the individuals are streamed before its closing tag
+	const FString DocStr = InSemMap->ToString();
+	const FString CloseTag = TEXT("</rdf:RDF>");
+	const int32 CloseIdx = DocStr.Find(CloseTag, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+	if (CloseIdx == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not find the document closing tag.."), *FString(__func__), __LINE__);
+		return false;
 	}
-	else if (UStaticMeshComponent* ObjAsSMC = Cast<UStaticMeshComponent>(Object))
+
+	WriteLambda(DocStr.Left(CloseIdx));
+	for (const FString& Str : IndividualStrs)
 	{
-		float Mass = ObjAsSMC->IsSimulatingPhysics() ? ObjAsSMC->GetMass() : ObjAsSMC->CalculateMass();
-		return FSLOwlSemanticMapStatics::CreatePhysicsProperties(
-			Mass, ObjAsSMC->GetGenerateOverlapEvents(), ObjAsSMC->IsGravityEnabled());
+		WriteLambda(Str);
 	}
-	return TArray<FSLOwlNode>();
+	WriteLambda(DocStr.Mid(CloseIdx));
+	return Writer->Close();
 }
 
 // Get parent id (empty string if none)
@@ -454,8 +698,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 	{
 		if (AActor* ParentAct = ObjAsAct->GetParentActor())
 		{
-			const FString ParentId = FTags::GetValue(ParentAct, "SemLog", "Id");
-			if (!ParentId.IsEmpty() && FTags::HasKey(ParentAct, "SemLog", "Class"))
+			const FString ParentId = TagCache->GetValue(ParentAct, "Id");
+			if (!ParentId.IsEmpty() && TagCache->HasKey(ParentAct, "Class"))
 			{
 				return ParentId;
 			}
@@ -463,8 +707,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 
 		if (AActor* ParentAttAct = ObjAsAct->GetAttachParentActor())
 		{
-			const FString Id = FTags::GetValue(ParentAttAct, "SemLog", "Id");
-			if (!Id.IsEmpty() && FTags::HasKey(ParentAttAct, "SemLog", "Class"))
+			const FString Id = TagCache->GetValue(ParentAttAct, "Id");
+			if (!Id.IsEmpty() && TagCache->HasKey(ParentAttAct, "Class"))
 			{
 				return Id;
 			}
@@ -472,8 +716,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 		
 		if (UChildActorComponent* ParentComp = ObjAsAct->GetParentComponent())
 		{
-			const FString Id = FTags::GetValue(ParentComp, "SemLog", "Id");
-			if (!Id.IsEmpty() && FTags::HasKey(ParentComp, "SemLog", "Class"))
+			const FString Id = TagCache->GetValue(ParentComp, "Id");
+			if (!Id.IsEmpty() && TagCache->HasKey(ParentComp, "Class"))
 			{
 				return Id;
 			}
@@ -481,8 +725,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 
 		if (USceneComponent* ParentSceneComp = ObjAsAct->GetDefaultAttachComponent())
 		{
-			const FString Id = FTags::GetValue(ParentSceneComp, "SemLog", "Id");
-			if (!Id.IsEmpty() && FTags::HasKey(ParentSceneComp, "SemLog", "Class"))
+			const FString Id = TagCache->GetValue(ParentSceneComp, "Id");
+			if (!Id.IsEmpty() && TagCache->HasKey(ParentSceneComp, "Class"))
 			{
 				return Id;
 			}
@@ -492,8 +736,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 	{
 		if (USceneComponent* ParentAttComp = ObjAsSceneComp->GetAttachParent())
 		{
-			const FString Id = FTags::GetValue(ParentAttComp, "SemLog", "Id");
-			if (!Id.IsEmpty() && FTags::HasKey(ParentAttComp, "SemLog", "Class"))
+			const FString Id = TagCache->GetValue(ParentAttComp, "Id");
+			if (!Id.IsEmpty() && TagCache->HasKey(ParentAttComp, "Class"))
 			{
 				return Id;
 			}
@@ -501,8 +745,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 
 		if (AActor* ParentAttRootAct = ObjAsSceneComp->GetAttachmentRootActor())
 		{
-			const FString Id = FTags::GetValue(ParentAttRootAct, "SemLog", "Id");
-			if (!Id.IsEmpty() && FTags::HasKey(ParentAttRootAct, "SemLog", "Class"))
+			const FString Id = TagCache->GetValue(ParentAttRootAct, "Id");
+			if (!Id.IsEmpty() && TagCache->HasKey(ParentAttRootAct, "Class"))
 			{
 				return Id;
 			}
@@ -512,8 +756,8 @@ FString FSLSemanticMapWriter::GetParentId(UObject* Object)
 	{
 		if (AActor* Owner = ObjAsActComp->GetOwner())
 		{
-			const FString Id = FTags::GetValue(Owner, "SemLog", "Id");
-			if (!Id.IsEmpty() && FTags::HasKey(Owner, "SemLog", "Class"))
+			const FString Id = TagCache->GetValue(Owner, "Id");
+			if (!Id.IsEmpty() && TagCache->HasKey(Owner, "Class"))
 			{
 				return Id;
 			}
@@ -534,8 +778,8 @@ void FSLSemanticMapWriter::GetChildIds(UObject* Object, TArray<FString>& OutChil
 		ObjAsActor->GetAttachedActors(AttachedActors);
 		for (const auto& ChildAct : AttachedActors)
 		{
-			const FString ChildId = FTags::GetValue(ChildAct, "SemLog", "Id");
-			if (!ChildId.IsEmpty() && FTags::HasKey(ChildAct, "SemLog", "Class"))
+			const FString ChildId = TagCache->GetValue(ChildAct, "Id");
+			if (!ChildId.IsEmpty() && TagCache->HasKey(ChildAct, "Class"))
 			{
 				OutChildIds.AddUnique(ChildId);
 			}
@@ -546,8 +790,8 @@ void FSLSemanticMapWriter::GetChildIds(UObject* Object, TArray<FString>& OutChil
 		ObjAsActor->GetComponents(ChildComponents, false);
 		for (const auto& ChildComp : ChildComponents)
 		{
-			const FString ChildId = FTags::GetValue(ChildComp, "SemLog", "Id");
-			if (!ChildId.IsEmpty() && FTags::HasKey(ChildComp, "SemLog", "Class"))
+			const FString ChildId = TagCache->GetValue(ChildComp, "Id");
+			if (!ChildId.IsEmpty() && TagCache->HasKey(ChildComp, "Class"))
 			{
 				OutChildIds.AddUnique(ChildId);
 			}
@@ -561,8 +805,8 @@ void FSLSemanticMapWriter::GetChildIds(UObject* Object, TArray<FString>& OutChil
 		ObjAsSceneComp->GetChildrenComponents(false, ChildComponents);
 		for (const auto& ChildComp : ChildComponents)
 		{
-			const FString ChildId = FTags::GetValue(ChildComp, "SemLog", "Id");
-			if (!ChildId.IsEmpty() && FTags::HasKey(ChildComp, "SemLog", "Class"))
+			const FString ChildId = TagCache->GetValue(ChildComp, "Id");
+			if (!ChildId.IsEmpty() && TagCache->HasKey(ChildComp, "Class"))
 			{
 				OutChildIds.AddUnique(ChildId);
 			}
@@ -0,0 +1,198 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLSupportedByEvaluator.h"
+#include "SLContactShapeInterface.h"
+#include "Components/MeshComponent.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "Ids.h"
+
+TSLWorldInstances<FSLSupportedByEvaluator> FSLSupportedByEvaluator::WorldInstances;
+
+// Evaluation results of a candidate
+namespace ESLSBResult
+{
+	enum Type : uint8
+	{
+		None,
+		SelfIsSupported,
+		OtherIsSupported
+	};
+}
+
+// Constructor
+FSLSupportedByEvaluator::FSLSupportedByEvaluator(UWorld* InWorld) : World(InWorld), TimeSinceUpdate(0.f), bParallel(true)
+{
+}
+
+// Get the instance of the world
+FSLSupportedByEvaluator* FSLSupportedByEvaluator::GetInstance(UWorld* World)
+{
+	return WorldInstances.FindOrAdd(World, [World]() { return new FSLSupportedByEvaluator(World); });
+}
+
+// Delete the instance of the world
+void FSLSupportedByEvaluator::DeleteInstance(UWorld* World)
+{
+	WorldInstances.Remove(World);
+}
+
+// Add a candidate of the shape
+void FSLSupportedByEvaluator::AddCandidate(ISLContactShapeInterface* Shape, UObject* ShapeObj, const FSLContactResult& Contact)
+{
+	FSLSBCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+	Candidate.Shape = Shape;
+	Candidate.ShapeObj = ShapeObj;
+	Candidate.Contact = Contact;
+	Candidate.SelfIdx = INDEX_NONE;
+	Candidate.OtherIdx = INDEX_NONE;
+}
+
+// Remove the candidate of the shape with the other object
+bool FSLSupportedByEvaluator::RemoveCandidate(ISLContactShapeInterface* Shape, UObject* Other)
+{
+	for (int32 Idx = 0; Idx < Candidates.Num(); ++Idx)
+	{
+		if (Candidates[Idx].Shape == Shape && Candidates[Idx].Contact.Other->Obj == Other)
+		{
+			Candidates.RemoveAtSwap(Idx);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Remove all the candidates of the shape
+void FSLSupportedByEvaluator::RemoveShape(ISLContactShapeInterface* Shape)
+{
+	Candidates.RemoveAllSwap([Shape](const FSLSBCandidate& Candidate) { return Candidate.Shape == Shape; });
+}
+
+/** Begin FTickableGameObject interface */
+// Called after ticking all actors, DeltaTime is the time passed since the last call.
+void FSLSupportedByEvaluator::Tick(float DeltaTime)
+{
+	// The update rate is in (dilated) game time of the world
+	TimeSinceUpdate += World.IsValid() ? World->GetDeltaSeconds() : DeltaTime;
+	if (TimeSinceUpdate >= UpdateRate)
+	{
+		TimeSinceUpdate = 0.f;
+		Evaluate();
+	}
+}
+
+// Return if object is ready to be ticked
+bool FSLSupportedByEvaluator::IsTickable() const
+{
+	return Candidates.Num() > 0 && World.IsValid() && !World->IsPaused();
+}
+
+// Return the stat id to use for this tickable
+TStatId FSLSupportedByEvaluator::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSLSupportedByEvaluator, STATGROUP_Tickables);
+}
+
+// Return the world the tickable belongs to
+UWorld* FSLSupportedByEvaluator::GetTickableGameObjectWorld() const
+{
+	return World.Get();
+}
+/** End FTickableGameObject interface */
+
+// Check all the candidates and notify the shapes
+void FSLSupportedByEvaluator::Evaluate()
+{
+	// Drop the candidates of removed shapes or meshes, and cache the mesh data (component calls, game thread only)
+	MeshIndexes.Reset();
+	MeshVelZ.Reset();
+	MeshLocZ.Reset();
+	for (int32 Idx = Candidates.Num() - 1; Idx >= 0; --Idx)
+	{
+		FSLSBCandidate& Candidate = Candidates[Idx];
+		if (!Candidate.ShapeObj.IsValid() || !Candidate.Contact.SelfMeshComponent.IsValid() || !Candidate.Contact.OtherMeshComponent.IsValid())
+		{
+			Candidates.RemoveAtSwap(Idx);
+			continue;
+		}
+		Candidate.SelfIdx = CacheMeshData(Candidate.Contact.SelfMeshComponent.Get());
+		Candidate.OtherIdx = CacheMeshData(Candidate.Contact.OtherMeshComponent.Get());
+	}
+
+	// Single pass over the flat data
+	Results.SetNumUninitialized(Candidates.Num());
+	auto EvaluateCandidate = [this](int32 Idx)
+	{
+		const FSLSBCandidate& Candidate = Candidates[Idx];
+
+		// Check that the relative speed on Z between the two objects is smaller than the threshold
+		if (FMath::Abs(MeshVelZ[Candidate.SelfIdx] - MeshVelZ[Candidate.OtherIdx]) >= MaxVertSpeed)
+		{
+			Results[Idx] = ESLSBResult::None;
+		}
+		else if (Candidate.Contact.bIsOtherASemanticOverlapArea)
+		{
+			// Check which is supporting and which is supported
+			// TODO simple height comparison for now
+			Results[Idx] = MeshLocZ[Candidate.SelfIdx] > MeshLocZ[Candidate.OtherIdx] ?
+				ESLSBResult::SelfIsSupported : ESLSBResult::OtherIsSupported;
+		}
+		else
+		{
+			// Other can only support, self can only be supported
+			Results[Idx] = ESLSBResult::SelfIsSupported;
+		}
+	};
+	if (bParallel && Candidates.Num() >= MinParallelNum)
+	{
+		ParallelFor(Candidates.Num(), EvaluateCandidate);
+	}
+	else
+	{
+		for (int32 Idx = 0; Idx < Candidates.Num(); ++Idx)
+		{
+			EvaluateCandidate(Idx);
+		}
+	}
+
+	// Group the started events by shape, remove the candidates (they are now part of a started event)
+	TMap<ISLContactShapeInterface*, TArray<FSLSBBeginResult>> Batches;
+	int32 WriteIdx = 0;
+	for (int32 Idx = 0; Idx < Candidates.Num(); ++Idx)
+	{
+		FSLSBCandidate& Candidate = Candidates[Idx];
+		if (Results[Idx] == ESLSBResult::None)
+		{
+			if (WriteIdx != Idx)
+			{
+				Candidates[WriteIdx] = MoveTemp(Candidate);
+			}
+			WriteIdx++;
+			continue;
+		}
+
+		FSLSBBeginResult& Result = Batches.FindOrAdd(Candidate.Shape).AddDefaulted_GetRef();
+		Result.bSelfIsSupported = Results[Idx] == ESLSBResult::SelfIsSupported;
+		Result.Supported = Result.bSelfIsSupported ? Candidate.Contact.Self : Candidate.Contact.Other;
+		Result.Supporting = Result.bSelfIsSupported ? Candidate.Contact.Other : Candidate.Contact.Self;
+		Result.PairId = FIds::PairEncodeCantor(Result.Supported->Obj->GetUniqueID(), Result.Supporting->Obj->GetUniqueID());
+	}
+	Candidates.SetNum(WriteIdx, false);
+
+	for (const auto& Pair : Batches)
+	{
+		Pair.Key->OnSupportedByBegin(Pair.Value);
+	}
+}
+
+// Read the velocity and height of the mesh once per update
+int32 FSLSupportedByEvaluator::CacheMeshData(UMeshComponent* Mesh)
+{
+	if (const int32* Idx = MeshIndexes.Find(Mesh))
+	{
+		return *Idx;
+	}
+	MeshVelZ.Add(Mesh->GetComponentVelocity().Z);
+	return MeshIndexes.Add(Mesh, MeshLocZ.Add(Mesh->GetComponentLocation().Z));
+}
@@ -0,0 +1,401 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLTimelineWriter.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+
+// Write the columnar timelines of the events
+bool FSLTimelineWriter::WriteTimelines(const TArray<TSharedPtr<ISLEvent>>& InEvents,
+	const FString& InLogDir,
+	const FString& InEpId)
+{
+	FString Dir = FPaths::ProjectDir() + InLogDir + TEXT("/Episodes/") + InEpId + TEXT("_TL/");
+	FPaths::RemoveDuplicateSlashes(Dir);
+
+	// Intern the contexts, the context strings are computed once per event
+	TArray<FString> Contexts;
+	TMap<FString, int32> ContextIndexes;
+	TArray<int32> EventContexts;
+	EventContexts.Reserve(InEvents.Num());
+	float MinTime = TNumericLimits<float>::Max();
+	float MaxTime = TNumericLimits<float>::Lowest();
+	for (const auto& Ev : InEvents)
+	{
+		const FString Context = Ev->Context();
+		int32 ContextIdx;
+		if (const int32* ContextIdxPtr = ContextIndexes.Find(Context))
+		{
+			ContextIdx = *ContextIdxPtr;
+		}
+		else
+		{
+			ContextIdx = Contexts.Emplace(Context);
+			ContextIndexes.Emplace(Context, ContextIdx);
+		}
+		EventContexts.Emplace(ContextIdx);
+		MinTime = FMath::Min(MinTime, Ev->Start);
+		MaxTime = FMath::Max(MaxTime, Ev->End);
+	}
+	if (InEvents.Num() == 0)
+	{
+		MinTime = MaxTime = 0.f;
+	}
+
+	// Contexts are shown sorted by name
+	TArray<int32> ContextOrder;
+	for (int32 Idx = 0; Idx < Contexts.Num(); ++Idx)
+	{
+		ContextOrder.Emplace(Idx);
+	}
+	ContextOrder.Sort([&Contexts](int32 A, int32 B) { return Contexts[A] < Contexts[B]; });
+	TArray<int32> ContextRank;
+	ContextRank.SetNum(Contexts.Num());
+	for (int32 Rank = 0; Rank < ContextOrder.Num(); ++Rank)
+	{
+		ContextRank[ContextOrder[Rank]] = Rank;
+	}
+
+	// Group the events by context and sort them by start time
+	TArray<int32> EventOrder;
+	EventOrder.Reserve(InEvents.Num());
+	for (int32 Idx = 0; Idx < InEvents.Num(); ++Idx)
+	{
+		EventOrder.Emplace(Idx);
+	}
+	EventOrder.Sort([&](int32 A, int32 B)
+	{
+		const int32 RankA = ContextRank[EventContexts[A]];
+		const int32 RankB = ContextRank[EventContexts[B]];
+		return RankA != RankB ? RankA < RankB : InEvents[A]->Start < InEvents[B]->Start;
+	});
+
+	// Raw level columns
+	TArray<uint32> ContextOffsets;
+	ContextOffsets.Init(0, Contexts.Num() + 1);
+	TArray<float> Starts;
+	TArray<float> Ends;
+	TArray<uint32> Counts;
+	TArray<FString> Ids;
+	float MaxEventDuration = 0.f;
+	Starts.Reserve(InEvents.Num());
+	Ends.Reserve(InEvents.Num());
+	Ids.Reserve(InEvents.Num());
+	for (const int32 EvIdx : EventOrder)
+	{
+		ContextOffsets[ContextRank[EventContexts[EvIdx]] + 1]++;
+		Starts.Emplace(InEvents[EvIdx]->Start);
+		Ends.Emplace(InEvents[EvIdx]->End);
+		Ids.Emplace(InEvents[EvIdx]->Id);
+		MaxEventDuration = FMath::Max(MaxEventDuration, InEvents[EvIdx]->End - InEvents[EvIdx]->Start);
+	}
+	for (int32 Idx = 1; Idx < ContextOffsets.Num(); ++Idx)
+	{
+		ContextOffsets[Idx] += ContextOffsets[Idx - 1];
+	}
+
+	if (!WriteLevel(Dir / TEXT("L0.bin"), 0, ContextOffsets, Starts, Ends, Counts, &Ids))
+	{
+		return false;
+	}
+
+	// Merged levels, from coarse to fine, the intervals of a context closer than the resolution are merged,
+	// the max duration of the rows is stored for every level (the viewer finds the first visible raw event from it)
+	FString LevelsJson = FString::Printf(TEXT("\t\t{\"file\": \"L0.bin\", \"resolution\": 0, \"rows\": %d, \"max_duration\": %f}"),
+		InEvents.Num(), MaxEventDuration);
+	const float Duration = FMath::Max(MaxTime - MinTime, KINDA_SMALL_NUMBER);
+	float Resolution = Duration / CoarsestBins;
+	for (int32 Level = 1; Level <= MaxLevels; ++Level, Resolution /= LevelRatio)
+	{
+		TArray<uint32> LevelContextOffsets;
+		TArray<float> LevelStarts;
+		TArray<float> LevelEnds;
+		TArray<uint32> LevelCounts;
+		LevelContextOffsets.Emplace(0);
+		for (int32 Rank = 0; Rank < ContextOrder.Num(); ++Rank)
+		{
+			for (uint32 Row = ContextOffsets[Rank]; Row < ContextOffsets[Rank + 1]; ++Row)
+			{
+				if (LevelStarts.Num() > (int32)LevelContextOffsets.Last() && Starts[Row] - LevelEnds.Last() <= Resolution)
+				{
+					LevelEnds.Last() = FMath::Max(LevelEnds.Last(), Ends[Row]);
+					LevelCounts.Last()++;
+				}
+				else
+				{
+					LevelStarts.Emplace(Starts[Row]);
+					LevelEnds.Emplace(Ends[Row]);
+					LevelCounts.Emplace(1);
+				}
+			}
+			LevelContextOffsets.Emplace(LevelStarts.Num());
+		}
+
+		// The level does not reduce the rows enough, the viewer can use the raw events instead
+		if (LevelStarts.Num() * 2 >= InEvents.Num())
+		{
+			break;
+		}
+
+		const FString LevelFile = FString::Printf(TEXT("L%d.bin"), Level);
+		if (!WriteLevel(Dir / LevelFile, Level, LevelContextOffsets, LevelStarts, LevelEnds, LevelCounts))
+		{
+			return false;
+		}
+		float LevelMaxDuration = 0.f;
+		for (int32 Row = 0; Row < LevelStarts.Num(); ++Row)
+		{
+			LevelMaxDuration = FMath::Max(LevelMaxDuration, LevelEnds[Row] - LevelStarts[Row]);
+		}
+		LevelsJson.Append(FString::Printf(TEXT(",\n\t\t{\"file\": \"%s\", \"resolution\": %g, \"rows\": %d, \"max_duration\": %f}"),
+			*LevelFile, Resolution, LevelStarts.Num(), LevelMaxDuration));
+	}
+
+	// Index with the interned contexts
+	FString ContextsJson;
+	for (int32 Rank = 0; Rank < ContextOrder.Num(); ++Rank)
+	{
+		ContextsJson.Append(FString::Printf(TEXT("%s\t\t\"%s\""), Rank > 0 ? TEXT(",\n") : TEXT(""), *EscapeJson(Contexts[ContextOrder[Rank]])));
+	}
+	const FString IndexJson = FString::Printf(
+		TEXT("{\n\t\"version\": %d,\n\t\"episode\": \"%s\",\n\t\"start\": %f,\n\t\"end\": %f,\n\t\"events\": %d,\n\t\"contexts\": [\n%s\n\t],\n\t\"levels\": [\n%s\n\t]\n}\n"),
+		FileVersion, *EscapeJson(InEpId), MinTime, MaxTime, InEvents.Num(), *ContextsJson, *LevelsJson);
+
+	return FFileHelper::SaveStringToFile(IndexJson, *(Dir / TEXT("index.json")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+		&& FFileHelper::SaveStringToFile(GetViewerPage(), *(Dir / TEXT("viewer.html")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+// Write a level file, the rows are grouped by context (ContextOffsets) and sorted by start time
+bool FSLTimelineWriter::WriteLevel(const FString& Path, uint32 Level,
+	const TArray<uint32>& ContextOffsets,
+	const TArray<float>& Starts,
+	const TArray<float>& Ends,
+	const TArray<uint32>& Counts,
+	const TArray<FString>* Ids)
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__func__), __LINE__, *Path);
+		return false;
+	}
+
+	// Header, every field and column is 4 bytes wide (aligned typed arrays in the viewer)
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	uint32 NumRows = Starts.Num();
+	uint32 NumContexts = ContextOffsets.Num() - 1;
+	*Writer << Magic << Version << Level << NumRows << NumContexts;
+
+	// Columns
+	Writer->Serialize(const_cast<uint32*>(ContextOffsets.GetData()), ContextOffsets.Num() * sizeof(uint32));
+	Writer->Serialize(const_cast<float*>(Starts.GetData()), Starts.Num() * sizeof(float));
+	Writer->Serialize(const_cast<float*>(Ends.GetData()), Ends.Num() * sizeof(float));
+	if (Ids)
+	{
+		// Id string table, offsets into an utf-8 blob
+		TArray<uint32> IdOffsets;
+		TArray<ANSICHAR> IdBlob;
+		IdOffsets.Reserve(Ids->Num() + 1);
+		IdOffsets.Emplace(0);
+		for (const FString& Id : *Ids)
+		{
+			FTCHARToUTF8 UTF8Id(*Id);
+			IdBlob.Append(UTF8Id.Get(), UTF8Id.Length());
+			IdOffsets.Emplace(IdBlob.Num());
+		}
+		Writer->Serialize(IdOffsets.GetData(), IdOffsets.Num() * sizeof(uint32));
+		Writer->Serialize(IdBlob.GetData(), IdBlob.Num());
+	}
+	else
+	{
+		Writer->Serialize(const_cast<uint32*>(Counts.GetData()), Counts.Num() * sizeof(uint32));
+	}
+	return Writer->Close();
+}
+
+// Escape the string for json
+FString FSLTimelineWriter::EscapeJson(const FString& Str)
+{
+	FString Out;
+	Out.Reserve(Str.Len());
+	for (const TCHAR Char : Str)
+	{
+		switch (Char)
+		{
+		case TEXT('"'): Out.Append(TEXT("\\\"")); break;
+		case TEXT('\\'): Out.Append(TEXT("\\\\")); break;
+		case TEXT('\n'): Out.Append(TEXT("\\n")); break;
+		case TEXT('\r'): Out.Append(TEXT("\\r")); break;
+		case TEXT('\t'): Out.Append(TEXT("\\t")); break;
+		default:
+			if (Char < 0x20)
+			{
+				Out.Append(FString::Printf(TEXT("\\u%04x"), (int32)Char));
+			}
+			else
+			{
+				Out.AppendChar(Char);
+			}
+		}
+	}
+	return Out;
+}
+
+// Html and javascript of the viewer page
+const TCHAR* FSLTimelineWriter::GetViewerPage()
+{
+	return TEXT(R"SLTL(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>Timelines</title>
+<style>
+	body { margin: 0; font: 12px sans-serif; }
+	#bar { padding: 4px 8px; background: #eee; }
+	#view { position: relative; overflow-y: auto; height: calc(100vh - 26px); }
+	#tip { position: fixed; display: none; background: #fff; border: 1px solid #888; padding: 4px; pointer-events: none; }
+</style>
+</head>
+<body>
+<div id="bar">Scroll to zoom, drag to pan. <span id="info"></span></div>
+<div id="view"><canvas id="tl"></canvas></div>
+<div id="tip"></div>
+<script>
+const RowH = 18, LabelW = 220;
+const canvas = document.getElementById('tl'), ctx = canvas.getContext('2d');
+const tip = document.getElementById('tip'), info = document.getElementById('info');
+let index = null, levels = {}, pending = {}, t0 = 0, t1 = 1, active = 0;
+
+// Load a level file once, the columns are views on the buffer
+function loadLevel(i) {
+	if (levels[i] || pending[i]) { return; }
+	pending[i] = true;
+	fetch(index.levels[i].file).then(r => r.arrayBuffer()).then(buf => {
+		const h = new Uint32Array(buf, 0, 5), n = h[3], c = h[4];
+		let o = 20;
+		const L = { offsets: new Uint32Array(buf, o, c + 1) }; o += (c + 1) * 4;
+		L.starts = new Float32Array(buf, o, n); o += n * 4;
+		L.ends = new Float32Array(buf, o, n); o += n * 4;
+		if (h[2] == 0) {
+			L.idOffsets = new Uint32Array(buf, o, n + 1); o += (n + 1) * 4;
+			L.idBlob = new Uint8Array(buf, o);
+		} else {
+			L.counts = new Uint32Array(buf, o, n);
+		}
+		levels[i] = L; draw();
+	});
+}
+
+// Coarsest level whose merged gaps are smaller than a pixel, raw events when zoomed in
+function pickLevel(secPerPx) {
+	let best = 0;
+	for (let i = 1; i < index.levels.length; ++i) {
+		if (index.levels[i].resolution <= secPerPx) { best = i; break; }
+	}
+	return best;
+}
+
+// First row of the context range starting after the time
+function upperBound(a, lo, hi, t) {
+	while (lo < hi) { const m = (lo + hi) >> 1; if (a[m] <= t) { lo = m + 1; } else { hi = m; } }
+	return lo;
+}
+
+// First row of the context range at or after the time
+function lowerBound(a, lo, hi, t) {
+	while (lo < hi) { const m = (lo + hi) >> 1; if (a[m] < t) { lo = m + 1; } else { hi = m; } }
+	return lo;
+}
+
+// First row of the context range which can end after the time, the merged intervals do not overlap (their ends are sorted),
+// the raw events can, none of them is longer than the max duration of the level
+function firstVisible(L, i, lo, hi, t) {
+	return L.idOffsets ? lowerBound(L.starts, lo, hi, t - index.levels[i].max_duration) : lowerBound(L.ends, lo, hi, t);
+}
+
+function color(i) { return 'hsl(' + ((i * 137) % 360) + ',60%,55%)'; }
+
+function draw() {
+	const w = canvas.width = document.getElementById('view').clientWidth;
+	canvas.height = index.contexts.length * RowH;
+	const secPerPx = (t1 - t0) / (w - LabelW);
+	const want = pickLevel(secPerPx);
+	loadLevel(want);
+	// Keep drawing the previous level until the wanted one is loaded
+	if (levels[want]) { active = want; }
+	const L = levels[active];
+	info.textContent = '[' + t0.toFixed(3) + 's, ' + t1.toFixed(3) + 's] level ' + active;
+	ctx.clearRect(0, 0, w, canvas.height);
+	for (let c = 0; c < index.contexts.length; ++c) {
+		const y = c * RowH;
+		ctx.fillStyle = c % 2 ? '#f6f6f6' : '#fff'; ctx.fillRect(0, y, w, RowH);
+		ctx.fillStyle = '#000'; ctx.fillText(index.contexts[c], 4, y + 13, LabelW - 8);
+		if (!L) { continue; }
+		ctx.fillStyle = color(c);
+		const end = upperBound(L.starts, L.offsets[c], L.offsets[c + 1], t1);
+		for (let r = firstVisible(L, active, L.offsets[c], end, t0); r < end; ++r) {
+			if (L.ends[r] < t0) { continue; }
+			const x0 = LabelW + Math.max(0, (L.starts[r] - t0) / secPerPx);
+			const x1 = LabelW + Math.min(w - LabelW, (L.ends[r] - t0) / secPerPx);
+			ctx.fillRect(x0, y + 2, Math.max(1, x1 - x0), RowH - 4);
+		}
+	}
+}
+
+// Interval under the mouse
+function hit(e) {
+	const L = levels[active], r = canvas.getBoundingClientRect();
+	const c = Math.floor((e.clientY - r.top) / RowH), x = e.clientX - r.left - LabelW;
+	if (!L || x < 0 || c < 0 || c >= index.contexts.length) { return null; }
+	const secPerPx = (t1 - t0) / (canvas.width - LabelW), t = t0 + x * secPerPx;
+	const end = upperBound(L.starts, L.offsets[c], L.offsets[c + 1], t + secPerPx);
+	// Raw events can overlap, look back to the first row which can reach the time
+	const first = firstVisible(L, active, L.offsets[c], end, t - secPerPx);
+	for (let i = end - 1; i >= first; --i) {
+		if (L.ends[i] >= t - secPerPx) { return { L: L, i: i, c: c }; }
+	}
+	return null;
+}
+
+canvas.addEventListener('mousemove', e => {
+	const h = hit(e);
+	if (!h) { tip.style.display = 'none'; return; }
+	const L = h.L, i = h.i;
+	let s = '<b>' + index.contexts[h.c] + '</b><br>';
+	if (L.idOffsets) {
+		s += new TextDecoder().decode(L.idBlob.subarray(L.idOffsets[i], L.idOffsets[i + 1])) + '<br>';
+	} else {
+		s += L.counts[i] + ' events<br>';
+	}
+	s += L.starts[i].toFixed(3) + 's - ' + L.ends[i].toFixed(3) + 's (' + (L.ends[i] - L.starts[i]).toFixed(3) + 's)';
+	tip.innerHTML = s; tip.style.display = 'block';
+	tip.style.left = (e.clientX + 12) + 'px'; tip.style.top = (e.clientY + 12) + 'px';
+});
+
+canvas.addEventListener('wheel', e => {
+	e.preventDefault();
+	const r = canvas.getBoundingClientRect(), x = Math.max(0, e.clientX - r.left - LabelW);
+	const t = t0 + x * (t1 - t0) / (canvas.width - LabelW), k = e.deltaY > 0 ? 1.25 : 0.8;
+	t0 = t - (t - t0) * k; t1 = t + (t1 - t) * k; draw();
+}, { passive: false });
+
+let dragX = null;
+canvas.addEventListener('mousedown', e => { dragX = e.clientX; });
+window.addEventListener('mouseup', () => { dragX = null; });
+window.addEventListener('mousemove', e => {
+	if (dragX === null) { return; }
+	const dt = (e.clientX - dragX) * (t1 - t0) / (canvas.width - LabelW);
+	t0 -= dt; t1 -= dt; dragX = e.clientX; draw();
+});
+window.addEventListener('resize', draw);
+
+fetch('index.json').then(r => r.json()).then(j => {
+	index = j; t0 = j.start; t1 = Math.max(j.end, j.start + 0.001); draw();
+});
+</script>
+</body>
+</html>
+)SLTL");
+}
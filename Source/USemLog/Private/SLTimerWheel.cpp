@@ -0,0 +1,244 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLTimerWheel.h"
+#include "Engine/World.h"
+
+TSLWorldInstances<FSLTimerWheel> FSLTimerWheel::WorldInstances;
+
+// Slot value of the nodes which expired but were not fired yet
+static constexpr int32 SLExpiredSlot = -2;
+
+// Constructor
+FSLTimerWheel::FSLTimerWheel(UWorld* InWorld) : World(InWorld), FreeHead(INDEX_NONE), CurrTick(0), TimeAccumulator(0.f), NumPending(0)
+{
+	SlotHeads.Init(INDEX_NONE, NumLevels * NumSlots);
+}
+
+// Get the instance of the world
+FSLTimerWheel* FSLTimerWheel::GetInstance(UWorld* World)
+{
+	return WorldInstances.FindOrAdd(World, [World]() { return new FSLTimerWheel(World); });
+}
+
+// Delete the instance of the world
+void FSLTimerWheel::DeleteInstance(UWorld* World)
+{
+	WorldInstances.Remove(World);
+}
+
+// Fire the callback after the delay, unless cancelled
+FSLTimerWheelHandle FSLTimerWheel::Schedule(float Delay, TFunction<void()>&& Callback, const UObject* Owner)
+{
+	// Reuse a free node if available
+	int32 NodeIdx = FreeHead;
+	if (NodeIdx != INDEX_NONE)
+	{
+		FreeHead = Nodes[NodeIdx].Next;
+	}
+	else
+	{
+		NodeIdx = Nodes.AddDefaulted();
+		Nodes[NodeIdx].Generation = 0;
+	}
+
+	FTimerNode& Node = Nodes[NodeIdx];
+	Node.Callback = MoveTemp(Callback);
+	Node.Owner = Owner;
+	Node.bHasOwner = Owner != nullptr;
+
+	// Round up and add the partially passed tick, the timer never fires before the delay
+	const uint64 NumTicks = (uint64)FMath::CeilToInt(FMath::Max(Delay, 0.f) / TickResolution) + 1;
+	Node.ExpireTick = CurrTick + NumTicks;
+	Insert(NodeIdx);
+	NumPending++;
+
+	FSLTimerWheelHandle Handle;
+	Handle.Index = NodeIdx;
+	Handle.Generation = Node.Generation;
+	return Handle;
+}
+
+// Remove the timer without firing it
+bool FSLTimerWheel::Cancel(FSLTimerWheelHandle& Handle)
+{
+	const bool bWasPending = IsPending(Handle);
+	if (bWasPending)
+	{
+		if (Nodes[Handle.Index].Slot != SLExpiredSlot)
+		{
+			Unlink(Handle.Index);
+		}
+		Release(Handle.Index);
+	}
+	Handle.Invalidate();
+	return bWasPending;
+}
+
+// True if the timer is still waiting to fire
+bool FSLTimerWheel::IsPending(const FSLTimerWheelHandle& Handle) const
+{
+	return Nodes.IsValidIndex(Handle.Index)
+		&& Nodes[Handle.Index].Generation == Handle.Generation
+		&& Nodes[Handle.Index].Slot != INDEX_NONE;
+}
+
+/** Begin FTickableGameObject interface */
+// Called after ticking all actors, DeltaTime is the time passed since the last call.
+void FSLTimerWheel::Tick(float DeltaTime)
+{
+	// Advance the wheel with the (dilated) game time of the world, collect the expired timers of all the passed ticks
+	TimeAccumulator += World.IsValid() ? World->GetDeltaSeconds() : DeltaTime;
+	while (TimeAccumulator >= TickResolution)
+	{
+		TimeAccumulator -= TickResolution;
+		Step();
+	}
+
+	// Fire the expired timers in one pass (the callbacks are free to schedule or cancel timers)
+	for (int32 Idx = 0; Idx < Expired.Num(); ++Idx)
+	{
+		const int32 NodeIdx = Expired[Idx];
+		if (Nodes[NodeIdx].Slot != SLExpiredSlot)
+		{
+			// Cancelled by a previous callback
+			continue;
+		}
+
+		TFunction<void()> Callback = MoveTemp(Nodes[NodeIdx].Callback);
+		const bool bOwnerIsGone = Nodes[NodeIdx].bHasOwner && !Nodes[NodeIdx].Owner.IsValid();
+		Release(NodeIdx);
+		if (!bOwnerIsGone && Callback)
+		{
+			Callback();
+		}
+	}
+	Expired.Reset();
+}
+
+// Return if object is ready to be ticked
+bool FSLTimerWheel::IsTickable() const
+{
+	return NumPending > 0 && World.IsValid() && !World->IsPaused();
+}
+
+// Return the stat id to use for this tickable
+TStatId FSLTimerWheel::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSLTimerWheel, STATGROUP_Tickables);
+}
+
+// Return the world the tickable belongs to
+UWorld* FSLTimerWheel::GetTickableGameObjectWorld() const
+{
+	return World.Get();
+}
+/** End FTickableGameObject interface */
+
+// Link the node in the slot matching its expire tick
+void FSLTimerWheel::Insert(int32 NodeIdx)
+{
+	FTimerNode& Node = Nodes[NodeIdx];
+	const uint64 Delta = Node.ExpireTick > CurrTick ? Node.ExpireTick - CurrTick : 0;
+
+	// Pick the lowest level which spans the remaining time
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= (1ull << ((Level + 1) * SlotBits)))
+	{
+		Level++;
+	}
+
+	// Beyond the last level, park it in the last slot which is reached, it is re-inserted when cascaded
+	const uint64 MaxDelta = (1ull << (NumLevels * SlotBits)) - 1;
+	const uint64 SlotTick = Delta > MaxDelta ? CurrTick + MaxDelta : FMath::Max(Node.ExpireTick, CurrTick);
+	const int32 Slot = Level * NumSlots + (int32)((SlotTick >> (Level * SlotBits)) & SlotMask);
+
+	// Push front
+	Node.Slot = Slot;
+	Node.Prev = INDEX_NONE;
+	Node.Next = SlotHeads[Slot];
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = NodeIdx;
+	}
+	SlotHeads[Slot] = NodeIdx;
+}
+
+// Unlink the node from its slot
+void FSLTimerWheel::Unlink(int32 NodeIdx)
+{
+	FTimerNode& Node = Nodes[NodeIdx];
+	if (Node.Prev != INDEX_NONE)
+	{
+		Nodes[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		SlotHeads[Node.Slot] = Node.Next;
+	}
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = Node.Prev;
+	}
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+}
+
+// Give the node back to the free list
+void FSLTimerWheel::Release(int32 NodeIdx)
+{
+	FTimerNode& Node = Nodes[NodeIdx];
+	Node.Callback.Reset();
+	Node.Owner.Reset();
+	Node.Slot = INDEX_NONE;
+	Node.Generation++;
+	Node.Prev = INDEX_NONE;
+	Node.Next = FreeHead;
+	FreeHead = NodeIdx;
+	NumPending--;
+}
+
+// Move the timers of the slot of the given level down the hierarchy
+void FSLTimerWheel::Cascade(int32 Level)
+{
+	const int32 Slot = Level * NumSlots + (int32)((CurrTick >> (Level * SlotBits)) & SlotMask);
+	int32 NodeIdx = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+	while (NodeIdx != INDEX_NONE)
+	{
+		const int32 NextIdx = Nodes[NodeIdx].Next;
+		Insert(NodeIdx);
+		NodeIdx = NextIdx;
+	}
+}
+
+// Advance the wheel one tick and collect the expired timers
+void FSLTimerWheel::Step()
+{
+	CurrTick++;
+
+	// Every time a level wraps around, the next slot of the level above is spread over the lower levels
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		if ((CurrTick & ((1ull << (Level * SlotBits)) - 1)) != 0)
+		{
+			break;
+		}
+		Cascade(Level);
+	}
+
+	// All the timers of the current first level slot are due
+	const int32 Slot = (int32)(CurrTick & SlotMask);
+	int32 NodeIdx = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+	while (NodeIdx != INDEX_NONE)
+	{
+		FTimerNode& Node = Nodes[NodeIdx];
+		const int32 NextIdx = Node.Next;
+		Node.Slot = SLExpiredSlot;
+		Node.Prev = INDEX_NONE;
+		Node.Next = INDEX_NONE;
+		Expired.Add(NodeIdx);
+		NodeIdx = NextIdx;
+	}
+}
@@ -0,0 +1,343 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLTrace.h"
+#include "USemLog.h"
+#include "SLEntitiesManager.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+/**
+* Ring of the records of one thread, single writer, read when dumped
+*/
+struct FSLTraceRing
+{
+	// Ctor
+	FSLTraceRing(uint32 InThreadId) : ThreadId(InThreadId), Head(0)
+	{
+		Records.SetNumZeroed(FSLTrace::RingCapacity);
+	}
+
+	// Owner thread
+	uint32 ThreadId;
+
+	// Total number of written records (the write position is Head % RingCapacity)
+	TAtomic<uint64> Head;
+
+	// Record slots
+	TArray<FSLTraceRecord> Records;
+};
+
+// All the rings, a thread registers its ring with the first record
+static TArray<TSharedPtr<FSLTraceRing, ESPMode::ThreadSafe>> SLTraceRings;
+
+// Protects the rings array (not the records)
+static FCriticalSection SLTraceRingsLock;
+
+// Incremented when the rings are released, the threads then register new rings with their next record
+static TAtomic<uint32> SLTraceRingsGeneration(0);
+
+// Ring of the calling thread (shared, a released ring is freed once its thread lets go of it as well) and its generation
+static thread_local TSharedPtr<FSLTraceRing, ESPMode::ThreadSafe> SLTraceThreadRing;
+static thread_local uint32 SLTraceThreadRingGeneration = 0;
+
+// Traced worlds by slot (slot 0 is unused), written by Reset and DumpToFile on the game thread
+static UWorld* SLTraceSlotWorlds[256] = { nullptr };
+
+// Next slot to hand out, the slots rotate so that the stale records of a world are not matched by a new one
+static uint8 SLTraceNextSlot = 1;
+
+// World of the last record of the calling thread and its slot
+static thread_local const UWorld* SLTraceThreadWorld = nullptr;
+static thread_local uint8 SLTraceThreadSlot = 0;
+
+// Slot of the world (0 if not traced)
+static uint8 SLTraceFindSlot(const UWorld* World)
+{
+	for (int32 Slot = 1; Slot < 256; ++Slot)
+	{
+		if (SLTraceSlotWorlds[Slot] == World)
+		{
+			return (uint8)Slot;
+		}
+	}
+	return 0;
+}
+
+// Append the record to the ring of the calling thread
+void FSLTrace::Record(uint16 Category, ESLTraceEvent Type, float Time,
+	const UObject* Entity1, const UObject* Entity2,
+	float Value0, float Value1, float Value2)
+{
+	const uint32 Generation = SLTraceRingsGeneration.Load(EMemoryOrder::Relaxed);
+	if (!SLTraceThreadRing.IsValid() || SLTraceThreadRingGeneration != Generation)
+	{
+		SLTraceThreadRing = MakeShared<FSLTraceRing, ESPMode::ThreadSafe>(FPlatformTLS::GetCurrentThreadId());
+		SLTraceThreadRingGeneration = Generation;
+		FScopeLock Lock(&SLTraceRingsLock);
+		SLTraceRings.Add(SLTraceThreadRing);
+	}
+	FSLTraceRing* Ring = SLTraceThreadRing.Get();
+
+	// Only the owner thread writes, publish the record after it is complete
+	const uint64 Idx = Ring->Head.Load(EMemoryOrder::Relaxed);
+	FSLTraceRecord& Rec = Ring->Records[Idx & (RingCapacity - 1)];
+	Rec.Time = Time;
+	Rec.Type = (uint16)Type;
+	Rec.Category = Category | ((uint16)GetWorldSlot(Entity1) << 8);
+	Rec.ThreadId = Ring->ThreadId;
+	Rec.Entity1 = Entity1 ? Entity1->GetUniqueID() : 0;
+	Rec.Entity2 = Entity2 ? Entity2->GetUniqueID() : 0;
+	Rec.Values[0] = Value0;
+	Rec.Values[1] = Value1;
+	Rec.Values[2] = Value2;
+	Ring->Head.Store(Idx + 1);
+}
+
+// Start tracing the world, its previous records are forgotten
+void FSLTrace::Reset(UWorld* World)
+{
+	// Release the previous slot of the world, its records are not matched anymore
+	if (const uint8 PrevSlot = SLTraceFindSlot(World))
+	{
+		SLTraceSlotWorlds[PrevSlot] = nullptr;
+	}
+
+	// Take the next free slot
+	for (int32 Attempt = 0; Attempt < 255; ++Attempt)
+	{
+		const uint8 Slot = SLTraceNextSlot;
+		SLTraceNextSlot = SLTraceNextSlot == 255 ? 1 : SLTraceNextSlot + 1;
+		if (SLTraceSlotWorlds[Slot] == nullptr)
+		{
+			SLTraceSlotWorlds[Slot] = World;
+			return;
+		}
+	}
+	UE_LOG(LogSL, Warning, TEXT("%s::%d No free trace slot, %s will not be traced.."),
+		*FString(__func__), __LINE__, *GetNameSafe(World));
+}
+
+// Get the trace slot of the world of the entity
+uint8 FSLTrace::GetWorldSlot(const UObject* Entity)
+{
+	const UWorld* World = Entity ? Entity->GetWorld() : nullptr;
+	if (World == nullptr)
+	{
+		return 0;
+	}
+
+	// Most records of a thread come from the same world, the cached slot is checked in case it was reset
+	if (World != SLTraceThreadWorld || SLTraceSlotWorlds[SLTraceThreadSlot] != World)
+	{
+		SLTraceThreadWorld = World;
+		SLTraceThreadSlot = SLTraceFindSlot(World);
+	}
+	return SLTraceThreadSlot;
+}
+
+// Merge the records of the world sorted by time and write them to file
+bool FSLTrace::DumpToFile(UWorld* World, const FString& Path)
+{
+	const uint8 WorldSlot = SLTraceFindSlot(World);
+	if (WorldSlot == 0)
+	{
+		return false;
+	}
+
+	// Copy out the available records of every ring
+	TArray<FSLTraceRecord> AllRecords;
+	{
+		FScopeLock Lock(&SLTraceRingsLock);
+		for (const auto& Ring : SLTraceRings)
+		{
+			const uint64 HeadBefore = Ring->Head.Load();
+			const uint64 Start = HeadBefore > RingCapacity ? HeadBefore - RingCapacity : 0;
+			const int32 FirstNew = AllRecords.Num();
+			for (uint64 Idx = Start; Idx < HeadBefore; ++Idx)
+			{
+				AllRecords.Add(Ring->Records[Idx & (RingCapacity - 1)]);
+			}
+
+			// Records overwritten by the owner thread while copying are dropped
+			const uint64 HeadAfter = Ring->Head.Load();
+			if (HeadAfter > RingCapacity + Start)
+			{
+				const int32 NumOverwritten = (int32)FMath::Min<uint64>(HeadAfter - RingCapacity - Start, HeadBefore - Start);
+				AllRecords.RemoveAt(FirstNew, NumOverwritten, false);
+			}
+		}
+	}
+
+	// Keep the records of the world, the file only stores the category
+	AllRecords.RemoveAll([WorldSlot](const FSLTraceRecord& Rec) { return (Rec.Category >> 8) != WorldSlot; });
+	for (auto& Rec : AllRecords)
+	{
+		Rec.Category &= 0xFF;
+	}
+	SLTraceSlotWorlds[WorldSlot] = nullptr;
+
+	// The rings are not needed until the next traced episode
+	bool bIsAnyWorldTraced = false;
+	for (int32 Slot = 1; Slot < 256 && !bIsAnyWorldTraced; ++Slot)
+	{
+		bIsAnyWorldTraced = SLTraceSlotWorlds[Slot] != nullptr;
+	}
+	if (!bIsAnyWorldTraced)
+	{
+		ReleaseRings();
+	}
+
+	if (AllRecords.Num() == 0)
+	{
+		return false;
+	}
+
+	// Stable, keeps the order of the records of the same time from a thread
+	AllRecords.StableSort([](const FSLTraceRecord& A, const FSLTraceRecord& B) { return A.Time < B.Time; });
+
+	// Names of the traced entities, the records only store the unique ids
+	TSet<uint32> EntityIds;
+	for (const auto& Rec : AllRecords)
+	{
+		if (Rec.Entity1 != 0) { EntityIds.Add(Rec.Entity1); }
+		if (Rec.Entity2 != 0) { EntityIds.Add(Rec.Entity2); }
+	}
+	TMap<uint32, FString> EntityNames;
+	for (const auto& Pair : FSLEntitiesManager::GetInstance(World)->GetObjectsSemanticData())
+	{
+		const uint32 UniqueId = Pair.Key->GetUniqueID();
+		if (EntityIds.Contains(UniqueId))
+		{
+			EntityNames.Add(UniqueId, Pair.Value->Class + TEXT(":") + Pair.Value->Id);
+		}
+	}
+
+	// Header, records, entity names
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	uint32 RecordSize = sizeof(FSLTraceRecord);
+	uint32 NumRecords = AllRecords.Num();
+	Writer << Magic << Version << RecordSize << NumRecords;
+	Writer.Serialize(AllRecords.GetData(), AllRecords.Num() * sizeof(FSLTraceRecord));
+	Writer << EntityNames;
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Path))
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Could not write the trace to %s.."), *FString(__func__), __LINE__, *Path);
+		return false;
+	}
+	UE_LOG(LogSL, Log, TEXT("%s::%d Wrote %d trace records to %s.."), *FString(__func__), __LINE__, AllRecords.Num(), *Path);
+	return true;
+}
+
+// Free the rings of all the threads
+void FSLTrace::ReleaseRings()
+{
+	FScopeLock Lock(&SLTraceRingsLock);
+	SLTraceRings.Empty();
+	SLTraceRingsGeneration.IncrementExchange();
+}
+
+// Read a dump file and convert the records to text lines
+bool FSLTrace::Decode(const FString& Path, TArray<FString>& OutLines)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Path))
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Could not read %s.."), *FString(__func__), __LINE__, *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	uint32 RecordSize = 0;
+	uint32 NumRecords = 0;
+	Reader << Magic << Version << RecordSize << NumRecords;
+	if (Magic != FileMagic || Version != FileVersion || RecordSize != sizeof(FSLTraceRecord)
+		|| (int64)NumRecords * RecordSize > Reader.TotalSize() - Reader.Tell())
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d %s is not a valid trace file (version %u).."),
+			*FString(__func__), __LINE__, *Path, Version);
+		return false;
+	}
+
+	TArray<FSLTraceRecord> Records;
+	Records.SetNumUninitialized(NumRecords);
+	Reader.Serialize(Records.GetData(), NumRecords * sizeof(FSLTraceRecord));
+	TMap<uint32, FString> EntityNames;
+	Reader << EntityNames;
+
+	auto GetEntityName = [&EntityNames](uint32 Id) -> FString
+	{
+		if (Id == 0)
+		{
+			return TEXT("-");
+		}
+		const FString* Name = EntityNames.Find(Id);
+		return Name ? *Name : FString::Printf(TEXT("#%u"), Id);
+	};
+
+	OutLines.Reserve(OutLines.Num() + Records.Num() + 1);
+	OutLines.Emplace(TEXT("Time,Category,Event,Thread,Entity1,Entity2,Value0,Value1,Value2"));
+	for (const auto& Rec : Records)
+	{
+		OutLines.Emplace(FString::Printf(TEXT("%f,%s,%s,%u,%s,%s,%f,%f,%f"),
+			Rec.Time, GetCategoryName(Rec.Category), GetEventName(Rec.Type), Rec.ThreadId,
+			*GetEntityName(Rec.Entity1), *GetEntityName(Rec.Entity2),
+			Rec.Values[0], Rec.Values[1], Rec.Values[2]));
+	}
+	return true;
+}
+
+// Name of the event type
+const TCHAR* FSLTrace::GetEventName(uint16 Type)
+{
+	static const TCHAR* Names[] = {
+		TEXT("None"),
+		TEXT("GraspBegin"),
+		TEXT("GraspEnd"),
+		TEXT("GraspConcatenated"),
+		TEXT("ManipulatorContactBegin"),
+		TEXT("ManipulatorContactEnd"),
+		TEXT("ManipulatorContactConcatenated"),
+		TEXT("ContactBegin"),
+		TEXT("ContactEnd"),
+		TEXT("ContactConcatenated"),
+		TEXT("PaPUnexpectedState"),
+		TEXT("PaPSupportedByBegin"),
+		TEXT("PaPSupportedByEnd"),
+		TEXT("PaPLiftOff"),
+		TEXT("PaPSkipPickUp"),
+		TEXT("PaPSlide"),
+		TEXT("PaPPickUp"),
+		TEXT("PaPTransport"),
+		TEXT("PaPPutDown"),
+		TEXT("PaPPutDownLimitsNotCrossed"),
+		TEXT("ReachCandidateAdded"),
+		TEXT("ReachCandidateRemoved"),
+		TEXT("ReachContactReset"),
+		TEXT("ReachPreGraspAndReach"),
+	};
+	constexpr uint16 NumNames = sizeof(Names) / sizeof(Names[0]);
+	static_assert(NumNames == (uint16)ESLTraceEvent::Num, "Missing trace event names");
+	return Type < NumNames ? Names[Type] : TEXT("Unknown");
+}
+
+// Name of the category
+const TCHAR* FSLTrace::GetCategoryName(uint16 Category)
+{
+	switch (Category)
+	{
+	case SL_TRACE_CAT_GRASP: return TEXT("Grasp");
+	case SL_TRACE_CAT_CONTACT: return TEXT("Contact");
+	case SL_TRACE_CAT_PAP: return TEXT("PickAndPlace");
+	case SL_TRACE_CAT_REACH: return TEXT("Reach");
+	default: return TEXT("Unknown");
+	}
+}
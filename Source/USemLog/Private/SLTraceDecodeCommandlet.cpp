@@ -0,0 +1,54 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLTraceDecodeCommandlet.h"
+#include "SLTrace.h"
+#include "Misc/Parse.h"
+#include "Misc/FileHelper.h"
+
+// Ctor
+USLTraceDecodeCommandlet::USLTraceDecodeCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Decode the trace
+int32 USLTraceDecodeCommandlet::Main(const FString& Params)
+{
+	FString InPath;
+	if (!FParse::Value(*Params, TEXT("in="), InPath))
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Missing -in=<Episode_TR.bin>.."), *FString(__func__), __LINE__);
+		return 1;
+	}
+
+	TArray<FString> Lines;
+	if (!FSLTrace::Decode(InPath, Lines))
+	{
+		return 1;
+	}
+
+	// Write to file, or print the records if no output is given
+	FString OutPath;
+	if (FParse::Value(*Params, TEXT("out="), OutPath))
+	{
+		if (!FFileHelper::SaveStringArrayToFile(Lines, *OutPath))
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Could not write %s.."), *FString(__func__), __LINE__, *OutPath);
+			return 1;
+		}
+		UE_LOG(LogSL, Display, TEXT("%s::%d Wrote %d records to %s.."),
+			*FString(__func__), __LINE__, Lines.Num() - 1, *OutPath);
+	}
+	else
+	{
+		for (const FString& Line : Lines)
+		{
+			UE_LOG(LogSL, Display, TEXT("%s"), *Line);
+		}
+	}
+	return 0;
+}
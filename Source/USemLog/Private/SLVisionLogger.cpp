@@ -33,7 +33,7 @@ void USLVisionLogger::Init(float InMinRecHz, float InMaxRecHz)
 		if (ASLVisRecordGameMode* SLGameMode = Cast<ASLVisRecordGameMode>(GetWorld()->GetAuthGameMode()))
 		{ 
 			// Set movement replications to objects
-			FSLEntitiesManager::GetInstance()->SetReplicates(true, 10, InMinRecHz, InMaxRecHz);
+			FSLEntitiesManager::GetInstance(GetWorld())->SetReplicates(true, 10, InMinRecHz, InMaxRecHz);
 
 			// Set update rates
 			IConsoleManager::Get().FindConsoleVariable(TEXT("demo.MinRecordHZ"))->Set(InMinRecHz);
@@ -0,0 +1,240 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLWorldStateBenchmarkCommandlet.h"
+#include "SLMongoService.h"
+#include "WorldState/SLWorldStateWriterMongoC.h"
+#include "WorldState/SLWorldStateWriterMongoCBuckets.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+// Ctor
+USLWorldStateBenchmarkCommandlet::USLWorldStateBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Run the benchmark
+int32 USLWorldStateBenchmarkCommandlet::Main(const FString& Params)
+{
+#if SL_WITH_LIBMONGO_C
+	FString DBName = TEXT("SLBenchmark");
+	FString ServerIp = TEXT("127.0.0.1");
+	int32 ServerPort = 27017;
+	int32 NumEntities = 200;
+	int32 NumSamples = 3000;
+	float Rate = 60.f;
+	int32 NumQueries = 200;
+	float Window = 5.f;
+	FParse::Value(*Params, TEXT("db="), DBName);
+	FParse::Value(*Params, TEXT("ip="), ServerIp);
+	FParse::Value(*Params, TEXT("port="), ServerPort);
+	FParse::Value(*Params, TEXT("entities="), NumEntities);
+	FParse::Value(*Params, TEXT("samples="), NumSamples);
+	FParse::Value(*Params, TEXT("rate="), Rate);
+	FParse::Value(*Params, TEXT("queries="), NumQueries);
+	FParse::Value(*Params, TEXT("window="), Window);
+	NumEntities = FMath::Max(NumEntities, 1);
+	NumSamples = FMath::Max(NumSamples, 1);
+	Rate = FMath::Max(Rate, 1.f);
+	NumQueries = FMath::Max(NumQueries, 1);
+
+	TArray<FString> Schemas = { TEXT("ws"), TEXT("buckets") };
+	if (FParse::Param(*Params, TEXT("timeseries")))
+	{
+		Schemas.Add(TEXT("timeseries"));
+	}
+
+	// Transient world with the moving entities
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SLWorldStateBenchmark"));
+	TArray<AActor*> Actors;
+	TArray<FString> Ids;
+	for (int32 Idx = 0; Idx < NumEntities; ++Idx)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+		USceneComponent* Root = NewObject<USceneComponent>(Actor, TEXT("Root"));
+		Root->SetMobility(EComponentMobility::Movable);
+		Actor->SetRootComponent(Root);
+		Root->RegisterComponent();
+		Actors.Add(Actor);
+		Ids.Add(FString::Printf(TEXT("BenchEntity%d"), Idx));
+	}
+
+	// Every schema gets the same deterministic trajectories
+	auto SetPoses = [&Actors](float Time)
+	{
+		for (int32 Idx = 0; Idx < Actors.Num(); ++Idx)
+		{
+			const float Speed = 0.5f + (Idx % 7) * 0.25f;
+			const FVector Loc(Idx * 100.f + 50.f * FMath::Cos(Time * Speed), 50.f * FMath::Sin(Time * Speed), 10.f * Time);
+			Actors[Idx]->SetActorLocationAndRotation(Loc, FQuat(FVector::UpVector, Time * Speed));
+		}
+	};
+
+	const float Duration = NumSamples / Rate;
+	FSLMongoService* Service = FSLMongoService::GetInstance();
+	int32 ExitCode = 0;
+	for (const FString& Schema : Schemas)
+	{
+		// Fresh previous poses for every writer, all the entities are written with every sample
+		TArray<TSLEntityPreviousPose<AActor>> ActorEntities;
+		TArray<TSLEntityPreviousPose<USceneComponent>> ComponentEntities;
+		TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>> SkeletalEntities;
+		for (int32 Idx = 0; Idx < Actors.Num(); ++Idx)
+		{
+			ActorEntities.Emplace(TSLEntityPreviousPose<AActor>(Actors[Idx], FSLEntity(Actors[Idx], Ids[Idx], TEXT("BenchItem"))));
+		}
+
+		const FString CollName = TEXT("bench_") + Schema;
+		const FSLWorldStateWriterParams WriterParams(0.1f, 0.01f, DBName, CollName, ServerIp, ServerPort, true,
+			200, 10.f, Schema.Equals(TEXT("timeseries")));
+		TSharedPtr<ISLWorldStateWriter> Writer;
+		if (Schema.Equals(TEXT("ws")))
+		{
+			Writer = MakeShareable(new FSLWorldStateWriterMongoC(WriterParams));
+		}
+		else
+		{
+			Writer = MakeShareable(new FSLWorldStateWriterMongoCBuckets(WriterParams));
+		}
+		if (!Writer->IsInit())
+		{
+			UE_LOG(LogSL, Error, TEXT("%s::%d Could not init the %s writer.."), *FString(__func__), __LINE__, *Schema);
+			ExitCode = 1;
+			break;
+		}
+
+		// Write the episode and wait until it is in the database
+		FSLGazeData GazeData;
+		const double WriteStart = FPlatformTime::Seconds();
+		for (int32 SampleIdx = 0; SampleIdx < NumSamples; ++SampleIdx)
+		{
+			const float Time = SampleIdx / Rate;
+			SetPoses(Time);
+			Writer->Write(Time, ActorEntities, ComponentEntities, SkeletalEntities, GazeData);
+		}
+		Writer->Finish();
+		Service->Drain();
+		const double WriteTime = FPlatformTime::Seconds() - WriteStart;
+
+		// Same random queries for every schema
+		FRandomStream Stream(42);
+		TArray<double> Latencies;
+		int64 NumQuerySamples = 0;
+		for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+		{
+			const FString& Id = Ids[Stream.RandHelper(Ids.Num())];
+			const float T0 = Stream.FRandRange(0.f, FMath::Max(Duration - Window, 0.f));
+			const double QueryStart = FPlatformTime::Seconds();
+			const int32 Num = QueryTrajectory(DBName, CollName, Schema, Id, T0, T0 + Window);
+			Latencies.Add((FPlatformTime::Seconds() - QueryStart) * 1000.0);
+			if (Num < 0)
+			{
+				ExitCode = 1;
+				break;
+			}
+			NumQuerySamples += Num;
+		}
+		Latencies.Sort();
+		auto Percentile = [&Latencies](double P)
+		{
+			return Latencies[FMath::Clamp(FMath::FloorToInt(P * (Latencies.Num() - 1)), 0, Latencies.Num() - 1)];
+		};
+
+		// The number of returned samples has to match between the schemas
+		UE_LOG(LogSL, Display, TEXT("%s::%d [%s] %d entities x %d samples written in %.2fs (%.0f samples/s); %d trajectory queries (%.1fs) returned %lld samples, latency ms: avg %.3f, p50 %.3f, p99 %.3f, max %.3f.."),
+			*FString(__func__), __LINE__, *Schema, NumEntities, NumSamples, WriteTime, NumEntities * NumSamples / FMath::Max(WriteTime, SMALL_NUMBER),
+			Latencies.Num(), Window, NumQuerySamples,
+			[&Latencies]() { double Sum = 0.0; for (double L : Latencies) { Sum += L; } return Sum / Latencies.Num(); }(),
+			Percentile(0.5), Percentile(0.99), Latencies.Last());
+	}
+
+	World->DestroyWorld(false);
+	FSLMongoService::DeleteInstance();
+	return ExitCode;
+#else
+	UE_LOG(LogSL, Error, TEXT("%s::%d Needs SL_WITH_LIBMONGO_C.."), *FString(__func__), __LINE__);
+	return 1;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Number of samples of the entity in [T0, T1] read with the trajectory query of the schema
+int32 USLWorldStateBenchmarkCommandlet::QueryTrajectory(const FString& DBName, const FString& CollName, const FString& Schema,
+	const FString& Id, float T0, float T1) const
+{
+#if SL_WITH_LIBMONGO_C
+	bson_t* filter = nullptr;
+	bson_t* opts = nullptr;
+	if (Schema.Equals(TEXT("ws")))
+	{
+		// One document per tick, the entity is found through the multikey index
+		filter = BCON_NEW("entities.id", BCON_UTF8(TCHAR_TO_UTF8(*Id)),
+			"timestamp", "{", "$gte", BCON_DOUBLE(T0), "$lte", BCON_DOUBLE(T1), "}");
+		opts = BCON_NEW("projection", "{", "timestamp", BCON_INT32(1), "entities.$", BCON_INT32(1), "}");
+	}
+	else if (Schema.Equals(TEXT("buckets")))
+	{
+		// The buckets overlapping the window, the samples are filtered client side
+		filter = BCON_NEW("id", BCON_UTF8(TCHAR_TO_UTF8(*Id)),
+			"t_start", "{", "$lte", BCON_DOUBLE(T1), "}",
+			"t_end", "{", "$gte", BCON_DOUBLE(T0), "}");
+	}
+	else
+	{
+		filter = BCON_NEW("meta.id", BCON_UTF8(TCHAR_TO_UTF8(*Id)),
+			"timestamp", "{", "$gte", BCON_DOUBLE(T0), "$lte", BCON_DOUBLE(T1), "}");
+	}
+
+	mongoc_client_t* client = FSLMongoService::GetInstance()->PopClient();
+	mongoc_collection_t* collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollName));
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+
+	int32 NumSamples = 0;
+	const bson_t* doc;
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		if (!Schema.Equals(TEXT("buckets")))
+		{
+			NumSamples++;
+			continue;
+		}
+
+		bson_iter_t iter;
+		bson_iter_t ts_iter;
+		if (bson_iter_init_find(&iter, doc, "ts") && BSON_ITER_HOLDS_ARRAY(&iter) && bson_iter_recurse(&iter, &ts_iter))
+		{
+			while (bson_iter_next(&ts_iter))
+			{
+				const double Ts = bson_iter_as_double(&ts_iter);
+				NumSamples += (Ts >= T0 && Ts <= T1) ? 1 : 0;
+			}
+		}
+	}
+
+	bson_error_t error;
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogSL, Error, TEXT("%s::%d Query on %s.%s failed, err.:%s;"),
+			*FString(__func__), __LINE__, *DBName, *CollName, *FString(error.message));
+		NumSamples = -1;
+	}
+
+	mongoc_cursor_destroy(cursor);
+	mongoc_collection_destroy(collection);
+	FSLMongoService::GetInstance()->PushClient(client);
+	bson_destroy(filter);
+	if (opts)
+	{
+		bson_destroy(opts);
+	}
+	return NumSamples;
+#else
+	return -1;
+#endif //SL_WITH_LIBMONGO_C
+}
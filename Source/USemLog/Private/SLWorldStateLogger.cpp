@@ -11,6 +11,8 @@ USLWorldStateLogger::USLWorldStateLogger()
 	bIsInit = false;
 	bIsStarted = false;
 	bIsFinished = false;
+	bIsTickable = false;
+	bIsFixedRate = false;
 }
 
 // Destructor
@@ -43,7 +45,7 @@ void USLWorldStateLogger::Init(ESLWorldStateWriterType WriterType, const FSLWorl
 }
 
 // Start logger
-void USLWorldStateLogger::Start(const float UpdateRate)
+void USLWorldStateLogger::Start(const float UpdateRate, bool bFixedRateSampling)
 {
 	if (!bIsStarted && bIsInit)
 	{
@@ -55,7 +57,15 @@ void USLWorldStateLogger::Start(const float UpdateRate)
 		InitialUpdate();
 
 		// Start updating
-		if (UpdateRate > 0.0f)
+		if (UpdateRate > 0.0f && bFixedRateSampling)
+		{
+			// Feed the worker every frame, it writes the samples due at the multiples of the
+			// update rate by interpolating between the previous and the current frame
+			AsyncWorker->GetTask().StartFixedRateSampling(UpdateRate, GetWorld()->GetTimeSeconds());
+			bIsFixedRate = true;
+			bIsTickable = true;
+		}
+		else if (UpdateRate > 0.0f)
 		{
 			// Update logger on custom timer tick (does not guarantees the UpdateRate value,
 			// since it will be eventually triggered from the game thread tick
@@ -110,6 +120,18 @@ void USLWorldStateLogger::Finish(bool bForced)
 	}
 }
 
+// Add entities registered at runtime to the logged ones
+void USLWorldStateLogger::AddEntities(const TArray<FSLEntity>& Entities)
+{
+	if (bIsInit && AsyncWorker)
+	{
+		for (const FSLEntity& Entity : Entities)
+		{
+			AsyncWorker->GetTask().AddEntity(Entity);
+		}
+	}
+}
+
 /** Begin FTickableGameObject interface */
 // Called after ticking all actors, DeltaTime is the time passed since the last call.
 void USLWorldStateLogger::Tick(float DeltaTime)
@@ -150,8 +172,17 @@ void USLWorldStateLogger::Update()
 	// Start task if worker is done with its previous work
 	if (AsyncWorker->IsDone())
 	{
+		if (bIsFixedRate)
+		{
+			AsyncWorker->GetTask().SetFrameTime(GetWorld()->GetTimeSeconds());
+		}
 		AsyncWorker->StartBackgroundTask();
 	}
+	else if (bIsFixedRate)
+	{
+		// The samples of the skipped frame are interpolated with the next one
+		UE_LOG(LogSL, Verbose, TEXT("%s::%d Previous task not finished, frame merged into the next one.."), *FString(__func__), __LINE__);
+	}
 	else
 	{
 		UE_LOG(LogSL, Error, TEXT("%s::%d Previous task not finished, SKIPPING new task.."), *FString(__func__), __LINE__);
@@ -2,6 +2,13 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "USemLog.h"
+#include "SLMongoService.h"
+#include "SLIdGenerator.h"
+#include "SLLivePublisher.h"
+#include "SLTrace.h"
+#if SL_WITH_SLVIS
+#include "SLVisImageWriterMongoC.h"
+#endif //SL_WITH_SLVIS
 
 // Define logging types
 DEFINE_LOG_CATEGORY(LogSL);
@@ -11,12 +18,27 @@ DEFINE_LOG_CATEGORY(LogSL);
 void FUSemLog::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	// Initialize libmongoc once for all the loggers (the vision writers are created by the vision logger of this module)
+	FSLMongoService::InitDriver();
 }
 
 void FUSemLog::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	// Stop the plugin wide threads before the module is unloaded
+	FSLLivePublisher::DeleteInstance();
+	FSLIdGenerator::DeleteInstance();
+	FSLMongoService::DeleteInstance();
+	FSLTrace::ReleaseRings();
+#if SL_WITH_SLVIS && SLVIS_WITH_LIBMONGO_C
+	// Let the background index builds of the vision writers finish before cleaning up libmongoc
+	while (USLVisImageWriterMongoC::GetNumIndexBuildsInProgress() > 0)
+	{
+		FPlatformProcess::Sleep(0.01f);
+	}
+#endif //SL_WITH_SLVIS && SLVIS_WITH_LIBMONGO_C
+	FSLMongoService::CleanupDriver();
 }
 
 #undef LOCTEXT_NAMESPACE
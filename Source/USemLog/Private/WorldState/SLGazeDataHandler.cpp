@@ -3,7 +3,9 @@
 
 #include "WorldState/SLGazeDataHandler.h"
 #include "Kismet/GameplayStatics.h"
+#if !UE_BUILD_SHIPPING
 #include "DrawDebugHelpers.h"
+#endif // !UE_BUILD_SHIPPING
 #include "SLEntitiesManager.h"
 
 #if SL_WITH_EYE_TRACKING
@@ -11,6 +13,24 @@
 #include "SRanipal_API.h"
 #include "SRanipal_Eye.h"
 #include "SRanipal_FunctionLibrary_Eye.h"
+#include "Templates/Atomic.h"
+
+// Handler receiving the eye tracker data (the data callback has no user pointer)
+static TAtomic<FSLGazeDataHandler*> SLGazeCallbackHandler(nullptr);
+
+// Called by the eye tracker with every new sample, on its own thread
+static void SLOnEyeData(ViveSR::anipal::Eye::EyeData const& EyeData)
+{
+	FSLGazeDataHandler* Handler = SLGazeCallbackHandler.Load();
+	const ViveSR::anipal::Eye::SingleEyeData& Combined = EyeData.verbose_data.combined.eye_data;
+	const uint64 GazeValidBit = 1ull << (int32)ViveSR::anipal::Eye::SingleEyeDataValidity::SINGLE_EYE_DATA_GAZE_DIRECTION_VALIDITY;
+	if(Handler && (Combined.eye_data_validata_bit_mask & GazeValidBit))
+	{
+		// From the right handed eye tracker frame to the camera frame (as the direction returned by GetGazeRay)
+		const FVector& Dir = Combined.gaze_direction_normalized;
+		Handler->AddRay(FVector(Dir.Z, -Dir.X, Dir.Y));
+	}
+}
 #endif // SL_WITH_EYE_TRACKING
 
 // Default ctor
@@ -21,7 +41,18 @@ FSLGazeDataHandler::FSLGazeDataHandler()
 	bIsFinished = false;
 	
 	World = nullptr;
+	EntitiesManager = nullptr;
 	PlayerCameraRef = nullptr;
+
+	bUseDataCallback = false;
+	RayHead = 0;
+	NumRays = 0;
+	PrevCameraLoc = FVector::ZeroVector;
+	PrevCameraQuat = FQuat::Identity;
+	PrevTickTime = 0.f;
+	SampleHead = 0;
+	NumSamples = 0;
+	bLatestIsHit = false;
 }
 
 // Setup the eye tracking software
@@ -49,11 +80,27 @@ void FSLGazeDataHandler::Start(UWorld* InWorld)
 		World = InWorld;
 		if(World)
 		{
+			EntitiesManager = FSLEntitiesManager::GetInstance(World);
 			if(UGameplayStatics::GetPlayerController(World, 0))
 			{
 				PlayerCameraRef = UGameplayStatics::GetPlayerController(World, 0)->PlayerCameraManager;
 				if(PlayerCameraRef)
 				{
+					Samples.SetNum(SampleCapacity);
+					Rays.SetNum(SampleCapacity);
+					PrevCameraLoc = PlayerCameraRef->GetCameraLocation();
+					PrevCameraQuat = PlayerCameraRef->GetCameraRotation().Quaternion();
+					PrevTickTime = World->GetTimeSeconds();
+
+					// Receive the rays at the eye tracker rate, otherwise poll the gaze ray every tick
+					SLGazeCallbackHandler = this;
+					bUseDataCallback = ViveSR::anipal::Eye::RegisterEyeDataCallback(SLOnEyeData) == ViveSR::Error::WORK;
+					if(!bUseDataCallback)
+					{
+						SLGazeCallbackHandler = nullptr;
+						UE_LOG(LogTemp, Warning, TEXT("%s::%d Eye data callback could not be registered, the gaze is sampled once per frame.."),
+							*FString(__func__), __LINE__);
+					}
 					bIsStarted = true;
 				}
 			}
@@ -71,6 +118,13 @@ void FSLGazeDataHandler::Finish()
 	if (!bIsFinished && (bIsStarted || bIsInit))
 	{
 #if SL_WITH_EYE_TRACKING
+		if(bUseDataCallback)
+		{
+			ViveSR::anipal::Eye::UnregisterEyeDataCallback(SLOnEyeData);
+			SLGazeCallbackHandler = nullptr;
+			bUseDataCallback = false;
+		}
+
 		if(ViveSR::anipal::Release(ViveSR::anipal::Eye::ANIPAL_TYPE_EYE) != ViveSR::Error::WORK)
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Release eye tracking framework FAILED!"), *FString(__func__), __LINE__);
@@ -87,7 +141,7 @@ void FSLGazeDataHandler::Finish()
 	}
 }
 
-// Get the current gaze data, true if a raytrace hit occurs
+// Get the latest gaze data, true if the latest trace hit an entity (thread safe)
 bool FSLGazeDataHandler::GetData(FSLGazeData& OutData)
 {
 	if(!bIsStarted)
@@ -95,64 +149,183 @@ bool FSLGazeDataHandler::GetData(FSLGazeData& OutData)
 		return false;
 	}
 
+	FScopeLock Lock(&SamplesLock);
+	if(!bLatestIsHit || NumSamples == 0)
+	{
+		return false;
+	}
+	OutData = Samples[(SampleHead + SampleCapacity - 1) % SampleCapacity].Data;
+	return true;
+}
+
+// Get the buffered samples newer than the given time, oldest first, returns their number (thread safe)
+int32 FSLGazeDataHandler::GetSamples(float SinceTime, TArray<FSLGazeSample>& OutSamples)
+{
+	OutSamples.Reset();
+	if(!bIsStarted)
+	{
+		return 0;
+	}
+
+	FScopeLock Lock(&SamplesLock);
+	for(int32 Idx = NumSamples; Idx > 0; --Idx)
+	{
+		const FSLGazeSample& Sample = Samples[(SampleHead + SampleCapacity - Idx) % SampleCapacity];
+		if(Sample.Timestamp > SinceTime)
+		{
+			OutSamples.Add(Sample);
+		}
+	}
+	return OutSamples.Num();
+}
+
+// Buffer the gaze ray to be traced on the next tick (thread safe, called from the eye tracker data callback)
+void FSLGazeDataHandler::AddRay(const FVector& Direction)
+{
+	FScopeLock Lock(&RaysLock);
+	FSLGazeRay& Ray = Rays[RayHead];
+	Ray.PlatformTime = FPlatformTime::Seconds();
+	Ray.Direction = Direction;
+	RayHead = (RayHead + 1) % SampleCapacity;
+	NumRays = FMath::Min(NumRays + 1, SampleCapacity);
+}
+
+/** Begin FTickableGameObject interface */
+// Called after ticking all actors, DeltaTime is the time passed since the last call.
+void FSLGazeDataHandler::Tick(float DeltaTime)
+{
+	// The results of the async traces are available in the frame after they were issued
+	ConsumeTraces();
+	IssueTraces();
+}
+
+// Return if object is ready to be ticked
+bool FSLGazeDataHandler::IsTickable() const
+{
+	return bIsStarted;
+}
+
+// Return the stat id to use for this tickable
+TStatId FSLGazeDataHandler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSLGazeDataHandler, STATGROUP_Tickables);
+}
+
+// Return the world of the traces
+UWorld* FSLGazeDataHandler::GetTickableGameObjectWorld() const
+{
+	return World;
+}
+/** End FTickableGameObject interface */
+
+// Read the results of the traces issued in the previous frame
+void FSLGazeDataHandler::ConsumeTraces()
+{
+	for(const TPair<FTraceHandle, float>& Trace : PendingTraces)
+	{
+		FTraceDatum TraceDatum;
+		if(!World->QueryTraceData(Trace.Key, TraceDatum))
+		{
+			continue;
+		}
+
+		FSLEntity Entity;
+		const FHitResult* HitResult = TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr;
+		if(HitResult && HitResult->bBlockingHit && EntitiesManager->GetEntity(HitResult->Actor.Get(), Entity))
+		{
+			const FSLGazeData Data(TraceDatum.Start, HitResult->ImpactPoint, Entity);
+			SetLatestSample(Trace.Value, &Data);
+#if !UE_BUILD_SHIPPING
+			DrawDebugLine(World, TraceDatum.Start, TraceDatum.End, FColor::Green);
+			DrawDebugSphere(World, HitResult->ImpactPoint, RayRadius > 0.f ? RayRadius : 2.f, 32, FColor::Red);
+#endif // !UE_BUILD_SHIPPING
+		}
+		else
+		{
+			SetLatestSample(Trace.Value, nullptr);
+#if !UE_BUILD_SHIPPING
+			DrawDebugLine(World, TraceDatum.Start, TraceDatum.End, FColor::Emerald);
+#endif // !UE_BUILD_SHIPPING
+		}
+	}
+	PendingTraces.Reset();
+}
+
+// Issue the async traces of the gaze rays buffered since the previous tick
+void FSLGazeDataHandler::IssueTraces()
+{
 #if SL_WITH_EYE_TRACKING
-	FVector CameraGazeOriginNotUsed, CameraGazeDirection;
-	if(USRanipal_FunctionLibrary_Eye::GetGazeRay(GazeIndex::COMBINE, CameraGazeOriginNotUsed, CameraGazeDirection))
+	if(!bUseDataCallback)
 	{
-		const FVector RaycastOrigin = PlayerCameraRef->GetCameraLocation();
-		const FVector RaycastTarget =  PlayerCameraRef->GetCameraRotation().RotateVector(RaycastOrigin + CameraGazeDirection * RayLength);
-		
-		FCollisionQueryParams TraceParam = FCollisionQueryParams(FName("EyeTraceParam"), true, PlayerCameraRef);
-		FHitResult HitResult;
+		FVector CameraGazeOriginNotUsed, CameraGazeDirection;
+		if(USRanipal_FunctionLibrary_Eye::GetGazeRay(GazeIndex::COMBINE, CameraGazeOriginNotUsed, CameraGazeDirection))
+		{
+			AddRay(CameraGazeDirection);
+		}
+	}
+#endif // SL_WITH_EYE_TRACKING
+
+	// Take the buffered rays, oldest first
+	RaysToTrace.Reset();
+	{
+		FScopeLock Lock(&RaysLock);
+		for(int32 Idx = NumRays; Idx > 0; --Idx)
+		{
+			RaysToTrace.Add(Rays[(RayHead + SampleCapacity - Idx) % SampleCapacity]);
+		}
+		NumRays = 0;
+	}
 
-		// Line trace
+	const float TickTime = World->GetTimeSeconds();
+	const float TickDuration = TickTime - PrevTickTime;
+	const double PlatformTime = FPlatformTime::Seconds();
+	const FVector CameraLoc = PlayerCameraRef->GetCameraLocation();
+	const FQuat CameraQuat = PlayerCameraRef->GetCameraRotation().Quaternion();
+
+	const FCollisionQueryParams TraceParam = FCollisionQueryParams(FName("EyeTraceParam"), true, PlayerCameraRef);
+	FCollisionShape Sphere;
+	Sphere.SetSphere(RayRadius);
+	for(const FSLGazeRay& Ray : RaysToTrace)
+	{
+		// The world time of the ray is given by its age, the ray is traced from the camera pose at that time
+		const float RayTime = FMath::Clamp(TickTime - (float)(PlatformTime - Ray.PlatformTime), PrevTickTime, TickTime);
+		const float Alpha = TickDuration > 0.f ? (RayTime - PrevTickTime) / TickDuration : 1.f;
+		const FVector RaycastOrigin = FMath::Lerp(PrevCameraLoc, CameraLoc, Alpha);
+		const FVector RaycastTarget = RaycastOrigin + FQuat::Slerp(PrevCameraQuat, CameraQuat, Alpha).RotateVector(Ray.Direction * RayLength);
+
+		FTraceHandle TraceHandle;
 		if(RayRadius == 0.f)
 		{
-			if(World->LineTraceSingleByChannel(HitResult, RaycastOrigin, RaycastTarget, ECC_Pawn, TraceParam))
-			{
-				FSLEntity Entity;
-				if(FSLEntitiesManager::GetInstance()->GetEntity(HitResult.Actor.Get(),Entity))
-				{
-					OutData.SetData(RaycastOrigin, HitResult.ImpactPoint, Entity);
-					DrawDebugLine(World, RaycastOrigin, RaycastTarget, FColor::Green);
-					DrawDebugSphere(World, HitResult.ImpactPoint, 2.f, 32, FColor::Red);
-					return true;
-				}
-				else
-				{
-					DrawDebugLine(World, RaycastOrigin, RaycastTarget, FColor::Emerald);
-					return false;
-				}
-			}
+			TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+				RaycastOrigin, RaycastTarget, ECC_Pawn, TraceParam);
 		}
 		else
 		{
-			FCollisionShape Sphere;
-			Sphere.SetSphere(RayRadius);
-			if(World->SweepSingleByChannel(HitResult,RaycastOrigin, RaycastTarget, FQuat::Identity, 
-				ECC_Pawn, Sphere, TraceParam))
-			{
-				FSLEntity Entity;
-				if(FSLEntitiesManager::GetInstance()->GetEntity(HitResult.Actor.Get(),Entity))
-				{
-					OutData.SetData(RaycastOrigin, HitResult.ImpactPoint, Entity);
-					DrawDebugLine(World, RaycastOrigin, RaycastTarget, FColor::Green);
-					DrawDebugSphere(World, HitResult.ImpactPoint, RayRadius, 32, FColor::Red);
-					return true;
-				}
-				else
-				{
-					DrawDebugLine(World, RaycastOrigin, RaycastTarget, FColor::Emerald);
-					return false;
-				}
-			}
+			TraceHandle = World->AsyncSweepByChannel(EAsyncTraceType::Single,
+				RaycastOrigin, RaycastTarget, FQuat::Identity, ECC_Pawn, Sphere, TraceParam);
 		}
+		PendingTraces.Emplace(TraceHandle, RayTime);
 	}
-#endif // SL_WITH_EYE_TRACKING
-	
-	return false;
+
+	PrevCameraLoc = CameraLoc;
+	PrevCameraQuat = CameraQuat;
+	PrevTickTime = TickTime;
 }
 
+// Add the hit to the ring, or mark the latest trace as a miss (game thread)
+void FSLGazeDataHandler::SetLatestSample(float Timestamp, const FSLGazeData* Data)
+{
+	FScopeLock Lock(&SamplesLock);
+	bLatestIsHit = Data != nullptr;
+	if(Data)
+	{
+		FSLGazeSample& Sample = Samples[SampleHead];
+		Sample.Timestamp = Timestamp;
+		Sample.Data = *Data;
+		SampleHead = (SampleHead + 1) % SampleCapacity;
+		NumSamples = FMath::Min(NumSamples + 1, SampleCapacity);
+	}
+}
 
 //
 //void FSLGazeDataHandler::TestGazeData()
@@ -6,7 +6,10 @@
 #include "WorldState/SLWorldStateWriterJson.h"
 #include "WorldState/SLWorldStateWriterBson.h"
 #include "WorldState/SLWorldStateWriterMongoC.h"
+#include "WorldState/SLWorldStateWriterMongoCBuckets.h"
 #include "WorldState/SLWorldStateWriterMongoCxx.h"
+#include "SLLivePublisher.h"
+#include "SLPoseBatch.h"
 #include "Tags.h"
 #include "Animation/SkeletalMeshActor.h"
 
@@ -17,6 +20,16 @@ FSLWorldStateAsyncWorker::FSLWorldStateAsyncWorker()
 	bIsInit = false;
 	bIsStarted = false;
 	bIsFinished = false;
+	bPublishLive = false;
+	PublishedKeyframeGeneration = INDEX_NONE;
+	bKeyframePending = false;
+	bStaticEntitiesWritten = false;
+
+	// Fixed rate sampling
+	SampleRate = 0.f;
+	NextSampleIdx = 0;
+	FrameTime = 0.f;
+	PrevFrameTime = 0.f;
 }
 
 // Destructor
@@ -42,6 +55,12 @@ void FSLWorldStateAsyncWorker::Init(UWorld* InWorld,
 		// Cache the writer type
 		WriterType = InWriterType;
 
+		// Thresholds of the live published poses (same as the written ones)
+		LinearDistanceSquared = InParams.LinearDistanceSquared;
+		AngularDistance = InParams.AngularDistance;
+		bPublishLive = FSLLivePublisher::GetInstance()->IsRunning();
+		EpisodeId = InParams.EpisodeId;
+
 		// Create the writer object
 		switch(WriterType)
 		{
@@ -54,6 +73,9 @@ void FSLWorldStateAsyncWorker::Init(UWorld* InWorld,
 		case ESLWorldStateWriterType::MongoC:
 			Writer = MakeShareable(new FSLWorldStateWriterMongoC(InParams));
 			break;
+		case ESLWorldStateWriterType::MongoCBuckets:
+			Writer = MakeShareable(new FSLWorldStateWriterMongoCBuckets(InParams));
+			break;
 		case ESLWorldStateWriterType::MongoCxx:
 			Writer = MakeShareable(new FSLWorldStateWriterMongoCxx(InParams));
 			break;
@@ -69,11 +91,11 @@ void FSLWorldStateAsyncWorker::Init(UWorld* InWorld,
 		}
 
 		// Make sure the semantic items are initialized
-		FSLEntitiesManager::GetInstance()->Init(World);
+		FSLEntitiesManager::GetInstance(World)->Init(World);
 
 		// Iterate all annotated entities, ignore skeletal ones
 		TArray<FSLEntity> SemanticEntities;
-		FSLEntitiesManager::GetInstance()->GetSemanticDataArray(SemanticEntities);
+		FSLEntitiesManager::GetInstance(World)->GetSemanticDataArray(SemanticEntities);
 		for (const auto& SemEntity : SemanticEntities)
 		{
 			// Take into account only objects with transform data (AActor, USceneComponents)
@@ -97,13 +119,18 @@ void FSLWorldStateAsyncWorker::Init(UWorld* InWorld,
 
 		// Get the skeletal data info
 		TArray<USLSkeletalDataComponent*> SemanticSkeletalData;
-		FSLEntitiesManager::GetInstance()->GetSemanticSkeletalDataArray(SemanticSkeletalData);
+		FSLEntitiesManager::GetInstance(World)->GetSemanticSkeletalDataArray(SemanticSkeletalData);
 		for (const auto& SemSkelData : SemanticSkeletalData)
 		{
 			SkeletalEntities.Emplace(TSLEntityPreviousPose<USLSkeletalDataComponent>(
 				SemSkelData, SemSkelData->OwnerSemanticData));
 		}
 
+		// The subscribers get the initial poses with the first keyframe
+		SeedPublishedPoses(ActorEntitites);
+		SeedPublishedPoses(ComponentEntities);
+		SeedPublishedPoses(SkeletalEntities);
+
 		// Init the gaze handler
 		GazeDataHandler.Init();
 
@@ -148,6 +175,13 @@ void FSLWorldStateAsyncWorker::Finish(bool bForced)
 					// Finish writer (create database indexes for example)
 					AsMongoCWriter->Finish();
 				}
+				else if (WriterType == ESLWorldStateWriterType::MongoCBuckets)
+				{
+					// We cannot cast dynamically if it is not an UObject
+					TSharedPtr<FSLWorldStateWriterMongoCBuckets> AsMongoCBucketsWriter = StaticCastSharedPtr<FSLWorldStateWriterMongoCBuckets>(Writer);
+					// Finish writer (flush the open buckets and create database indexes)
+					AsMongoCBucketsWriter->Finish();
+				}
 			}
 
 			GazeDataHandler.Finish();
@@ -185,12 +219,283 @@ void FSLWorldStateAsyncWorker::RemoveStaticItems()
 	// Skeletal components are probably always movable, so we just skip that step
 }
 
+// Queue an entity registered at runtime
+bool FSLWorldStateAsyncWorker::AddEntity(const FSLEntity& Entity)
+{
+	// Same as the initial entities, the static ones are only written once (skeletal ones are always movable)
+	const bool bIsStatic = FTags::HasKeyValuePair(Entity.Obj, "SemLog", "Mobility", "Static");
+
+	// Skeletal entities are logged through their skeletal data component
+	AActor* SkeletalOwner = nullptr;
+	if (AActor* ObjAsActor = Cast<AActor>(Entity.Obj))
+	{
+		if (!Cast<ASkeletalMeshActor>(ObjAsActor))
+		{
+			return PendingActorEntities.Enqueue(TSLEntityPreviousPose<AActor>(ObjAsActor, Entity))
+				&& (!bIsStatic || PendingStaticEntities.Enqueue(ObjAsActor));
+		}
+		SkeletalOwner = ObjAsActor;
+	}
+	else if (USceneComponent* ObjAsSceneComp = Cast<USceneComponent>(Entity.Obj))
+	{
+		if (!Cast<USkeletalMeshComponent>(ObjAsSceneComp))
+		{
+			return PendingComponentEntities.Enqueue(TSLEntityPreviousPose<USceneComponent>(ObjAsSceneComp, Entity))
+				&& (!bIsStatic || PendingStaticEntities.Enqueue(ObjAsSceneComp));
+		}
+		SkeletalOwner = ObjAsSceneComp->GetOwner();
+	}
+
+	if (SkeletalOwner)
+	{
+		// The bone data is loaded here (game thread), the worker only reads it
+		USLSkeletalDataComponent* SkelComp = Cast<USLSkeletalDataComponent>(
+			SkeletalOwner->GetComponentByClass(USLSkeletalDataComponent::StaticClass()));
+		if (SkelComp && SkelComp->Init())
+		{
+			return PendingSkeletalEntities.Enqueue(TSLEntityPreviousPose<USLSkeletalDataComponent>(SkelComp, SkelComp->OwnerSemanticData));
+		}
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s has no valid USLSkeletalDataComponent, the spawned skeletal entity will not be logged.."),
+			*FString(__func__), __LINE__, *SkeletalOwner->GetName());
+	}
+	return false;
+}
+
+// Write the world state at exact multiples of the sample rate
+void FSLWorldStateAsyncWorker::StartFixedRateSampling(float InSampleRate, float StartTime)
+{
+	if (InSampleRate <= 0.f)
+	{
+		return;
+	}
+
+	SampleRate = InSampleRate;
+	PrevFrameTime = StartTime;
+	FrameTime = StartTime;
+
+	// The first sample is the next multiple of the rate after the start (the initial state is already written)
+	NextSampleIdx = (int64)FMath::FloorToDouble((double)StartTime / SampleRate) + 1;
+
+	// The start poses are the first interpolation keys
+	AdvanceFramePoses();
+}
+
 // Async work done here
 void FSLWorldStateAsyncWorker::DoWork()
 {
+	// Static entities registered at runtime are not updated after their initial pose was written
+	if (bStaticEntitiesWritten && StaticEntitiesToRemove.Num() > 0)
+	{
+		RemoveEntities(ActorEntitites, StaticEntitiesToRemove);
+		RemoveEntities(ComponentEntities, StaticEntitiesToRemove);
+		StaticEntitiesToRemove.Reset();
+	}
+
+	// Add the entities registered since the last write (the initial pose is written since the previous one is unset,
+	// and published with the pending keyframe)
+	TSLEntityPreviousPose<AActor> NewActorEntity;
+	while (PendingActorEntities.Dequeue(NewActorEntity))
+	{
+		ActorEntitites.Emplace(MoveTemp(NewActorEntity));
+		bKeyframePending = true;
+	}
+	TSLEntityPreviousPose<USceneComponent> NewComponentEntity;
+	while (PendingComponentEntities.Dequeue(NewComponentEntity))
+	{
+		ComponentEntities.Emplace(MoveTemp(NewComponentEntity));
+		bKeyframePending = true;
+	}
+	TSLEntityPreviousPose<USLSkeletalDataComponent> NewSkeletalEntity;
+	while (PendingSkeletalEntities.Dequeue(NewSkeletalEntity))
+	{
+		// The skeletal actor and its mesh component share the same data component
+		if (!SkeletalEntities.ContainsByPredicate([&NewSkeletalEntity](const TSLEntityPreviousPose<USLSkeletalDataComponent>& Other)
+			{ return Other.Obj == NewSkeletalEntity.Obj; }))
+		{
+			SkeletalEntities.Emplace(MoveTemp(NewSkeletalEntity));
+			bKeyframePending = true;
+		}
+	}
+	TWeakObjectPtr<UObject> NewStaticEntity;
+	while (PendingStaticEntities.Dequeue(NewStaticEntity))
+	{
+		StaticEntitiesToRemove.Add(NewStaticEntity);
+		bStaticEntitiesWritten = false;
+	}
+
+	if (SampleRate > 0.f)
+	{
+		WriteFixedRateSamples();
+		return;
+	}
+
+	const float Timestamp = World->GetTimeSeconds();
 	FSLGazeData GazeData;
 	GazeDataHandler.GetData(GazeData);
-	Writer->Write(World->GetTimeSeconds(), ActorEntitites, ComponentEntities, SkeletalEntities, GazeData);
+	Writer->Write(Timestamp, ActorEntitites, ComponentEntities, SkeletalEntities, GazeData);
+	bStaticEntitiesWritten = true;
+	if (bPublishLive)
+	{
+		PublishPoses(Timestamp);
+	}
+}
+
+// Read the current pose of every entity as its frame pose (invalid entities are skipped, the writer removes them)
+void FSLWorldStateAsyncWorker::AdvanceFramePoses()
+{
+	for (auto& ActorEntity : ActorEntitites)
+	{
+		if (ActorEntity.Obj.IsValid())
+		{
+			ActorEntity.AdvanceFrame();
+		}
+	}
+	for (auto& ComponentEntity : ComponentEntities)
+	{
+		if (ComponentEntity.Obj.IsValid())
+		{
+			ComponentEntity.AdvanceFrame();
+		}
+	}
+	for (auto& SkeletalEntity : SkeletalEntities)
+	{
+		if (SkeletalEntity.Obj.IsValid())
+		{
+			SkeletalEntity.AdvanceFrame();
+		}
+	}
+}
+
+// Write the interpolated samples due between the previous and the current frame
+void FSLWorldStateAsyncWorker::WriteFixedRateSamples()
+{
+	const double SampleTime = (double)NextSampleIdx * SampleRate;
+	const float FrameDuration = FrameTime - PrevFrameTime;
+
+	// Read the current frame poses once, the previous ones are the interpolation start
+	AdvanceFramePoses();
+
+	// Gaze samples buffered since the previous frame, the nearest one in time is written with every sample (the latest one if none)
+	FSLGazeData LatestGazeData;
+	GazeDataHandler.GetData(LatestGazeData);
+	GazeDataHandler.GetSamples(PrevFrameTime, GazeSamples);
+
+	// Write every sample due in this frame (several ones if the rate is higher than the frame rate),
+	// the bones of the skeletal entities are written with their current frame pose
+	for (double Timestamp = SampleTime; Timestamp <= FrameTime; Timestamp = (double)NextSampleIdx * SampleRate)
+	{
+		FSLGazeData GazeData = LatestGazeData;
+		double MinGazeDelta = TNumericLimits<double>::Max();
+		for (const FSLGazeSample& GazeSample : GazeSamples)
+		{
+			const double GazeDelta = FMath::Abs((double)GazeSample.Timestamp - Timestamp);
+			if (GazeDelta >= MinGazeDelta)
+			{
+				// The samples are sorted by time, the following ones are further away
+				break;
+			}
+			MinGazeDelta = GazeDelta;
+			GazeData = GazeSample.Data;
+		}
+
+		const float Alpha = FrameDuration > SMALL_NUMBER
+			? FMath::Clamp((float)((Timestamp - PrevFrameTime) / FrameDuration), 0.f, 1.f) : 1.f;
+
+		for (auto& ActorEntity : ActorEntitites)
+		{
+			ActorEntity.SetSample(Alpha);
+		}
+		for (auto& ComponentEntity : ComponentEntities)
+		{
+			ComponentEntity.SetSample(Alpha);
+		}
+		for (auto& SkeletalEntity : SkeletalEntities)
+		{
+			SkeletalEntity.SetSample(Alpha);
+		}
+
+		Writer->Write((float)Timestamp, ActorEntitites, ComponentEntities, SkeletalEntities, GazeData);
+		bStaticEntitiesWritten = true;
+		if (bPublishLive)
+		{
+			PublishPoses((float)Timestamp);
+		}
+		NextSampleIdx++;
+	}
+
+	PrevFrameTime = FrameTime;
+}
+
+// Publish the poses of the entities which moved since their previous publish to the live subscribers,
+// or the poses of all the entities if the subscribers need a keyframe
+void FSLWorldStateAsyncWorker::PublishPoses(float Timestamp)
+{
+	// New subscribers (or filters) and added entities have no previous poses to apply the deltas to
+	const int32 KeyframeGeneration = FSLLivePublisher::GetInstance()->GetKeyframeGeneration();
+	const bool bKeyframe = bKeyframePending || KeyframeGeneration != PublishedKeyframeGeneration;
+	PublishedKeyframeGeneration = KeyframeGeneration;
+	bKeyframePending = false;
+
+	TSharedPtr<FSLLivePoseFrame, ESPMode::ThreadSafe> Poses = MakeShared<FSLLivePoseFrame, ESPMode::ThreadSafe>();
+	Poses->Timestamp = Timestamp;
+	AddMovedPoses(ActorEntitites, *Poses, bKeyframe);
+	AddMovedPoses(ComponentEntities, *Poses, bKeyframe);
+	AddMovedPoses(SkeletalEntities, *Poses, bKeyframe);
+	if (Poses->Num() > 0)
+	{
+		// Same frame as the written poses
+		FSLPoseBatch::ConvertToROS(Poses->Locations.GetData(), Poses->Locations.Num());
+		FSLPoseBatch::ConvertToROS(Poses->Quats.GetData(), Poses->Quats.Num());
+		FSLLivePublisher::GetInstance()->PublishPoses(EpisodeId, Poses, bKeyframe);
+	}
+}
+
+// Add the poses of the entities which moved since their previous publish, or all of them (their published pose is updated)
+template<typename T>
+void FSLWorldStateAsyncWorker::AddMovedPoses(TArray<TSLEntityPreviousPose<T>>& Entities, FSLLivePoseFrame& OutPoses, bool bAll)
+{
+	for (auto& Entity : Entities)
+	{
+		if (Entity.Obj.IsValid())
+		{
+			const FVector CurrLoc = Entity.GetLocation();
+			const FQuat CurrQuat = Entity.GetQuat();
+			if (bAll ||
+				FVector::DistSquared(CurrLoc, Entity.PublishedLoc) > LinearDistanceSquared ||
+				CurrQuat.AngularDistance(Entity.PublishedQuat) > AngularDistance)
+			{
+				Entity.PublishedLoc = CurrLoc;
+				Entity.PublishedQuat = CurrQuat;
+				OutPoses.Ids.Add(Entity.Entity.Id);
+				OutPoses.Locations.Add(CurrLoc);
+				OutPoses.Quats.Add(CurrQuat);
+			}
+		}
+	}
+}
+
+// Remove the entities of the given objects from the update pool
+template<typename T>
+void FSLWorldStateAsyncWorker::RemoveEntities(TArray<TSLEntityPreviousPose<T>>& Entities, const TArray<TWeakObjectPtr<UObject>>& Objects)
+{
+	Entities.RemoveAll([&Objects](const TSLEntityPreviousPose<T>& Entity)
+	{
+		return Objects.Contains(TWeakObjectPtr<UObject>(Entity.Obj.Get()));
+	});
+}
+
+// Set the current poses as the published ones
+template<typename T>
+void FSLWorldStateAsyncWorker::SeedPublishedPoses(TArray<TSLEntityPreviousPose<T>>& Entities)
+{
+	for (auto& Entity : Entities)
+	{
+		if (Entity.Obj.IsValid())
+		{
+			Entity.PublishedLoc = Entity.GetLocation();
+			Entity.PublishedQuat = Entity.GetQuat();
+		}
+	}
 }
 
 // Needed by the engine API
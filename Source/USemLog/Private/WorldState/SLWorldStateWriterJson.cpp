@@ -4,7 +4,6 @@
 #include "WorldState/SLWorldStateWriterJson.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "HAL/PlatformFilemanager.h"
-#include "Conversions.h"
 
 // Constructor
 FSLWorldStateWriterJson::FSLWorldStateWriterJson()
@@ -101,152 +100,106 @@ bool FSLWorldStateWriterJson::SetFileHandle(const FString& LogDirectory, const F
 void FSLWorldStateWriterJson::AddActorEntities(TArray<TSLEntityPreviousPose<AActor>>& ActorEntities,
 	TArray<TSharedPtr<FJsonValue>>& OutJsonEntitiesArr)
 {
-	// Iterate items
-	for (auto Itr(ActorEntities.CreateIterator()); Itr; ++Itr)
-	{
-		// Check if pointer is valid
-		if (Itr->Obj.IsValid(/*false, true*/))
-		{
-			// Check if the entity moved more than the threshold since the last logging
-			const FVector CurrLoc = Itr->Obj->GetActorLocation();
-			const FQuat CurrQuat = Itr->Obj->GetActorQuat();
-
-			if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
-				CurrQuat.AngularDistance(Itr->PrevQuat))
-			{
-				// Update prev state
-				Itr->PrevLoc = CurrLoc;
-				Itr->PrevQuat = CurrQuat;
-
-				// Get current entry as json object
-				TSharedPtr<FJsonObject> JsonEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
-					TMap<FString, FString>{ {"id", Itr->Entity.Id}, { "class", Itr->Entity.Class } },
-					CurrLoc, CurrQuat);
-
-				// Add entity to json array
-				OutJsonEntitiesArr.Add(MakeShareable(new FJsonValueObject(JsonEntry)));
-			}
-		}
-		else
-		{
-			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Obj.Get());
-		}
-	}
+	// Gather the entities which moved and convert their poses in one pass
+	PoseBatch.SetMovedEntities(ActorEntities, LinDistSqMin);
+	PoseBatch.ConvertToROS();
+	AddEntitiesPoses(ActorEntities, OutJsonEntitiesArr);
 }
 
 // Get non skeletal components as json array
 void FSLWorldStateWriterJson::AddComponentEntities(TArray<TSLEntityPreviousPose<USceneComponent>>& ComponentEntities,
 	TArray<TSharedPtr<FJsonValue>>& OutJsonEntitiesArr)
 {
-	// Iterate items
-	for (auto Itr(ComponentEntities.CreateIterator()); Itr; ++Itr)
-	{
-		// Check if pointer is valid
-		if (Itr->Obj.IsValid(/*false, true*/))
-		{
-			// Check if the entity moved more than the threshold since the last logging
-			const FVector CurrLoc = Itr->Obj->GetComponentLocation();
-			const FQuat CurrQuat = Itr->Obj->GetComponentQuat();
-
-			if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
-				CurrQuat.AngularDistance(Itr->PrevQuat))
-			{
-				// Update prev state
-				Itr->PrevLoc = CurrLoc;
-				Itr->PrevQuat = CurrQuat;
-
-				// Get current entry as json object
-				TSharedPtr<FJsonObject> JsonEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
-					TMap<FString, FString>{ {"id", Itr->Entity.Id}, { "class", Itr->Entity.Class } },
-					CurrLoc, CurrQuat);
-
-				// Add entity to json array
-				OutJsonEntitiesArr.Add(MakeShareable(new FJsonValueObject(JsonEntry)));
-			}
-		}
-		else
-		{
-			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Obj.Get());
-		}
-	}
+	// Gather the entities which moved and convert their poses in one pass
+	PoseBatch.SetMovedEntities(ComponentEntities, LinDistSqMin);
+	PoseBatch.ConvertToROS();
+	AddEntitiesPoses(ComponentEntities, OutJsonEntitiesArr);
 }
 
 // Get skeletal actors as json array
 void FSLWorldStateWriterJson::AddSkeletalEntities(TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
 	TArray<TSharedPtr<FJsonValue>>& OutJsonEntitiesArr)
 {
-	// Iterate items
-	for (auto Itr(SkeletalEntities.CreateIterator()); Itr; ++Itr)
+	// Gather the entities which moved and convert their poses in one pass
+	PoseBatch.SetMovedEntities(SkeletalEntities, LinDistSqMin);
+	PoseBatch.ConvertToROS();
+
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
 	{
-		// Check if pointer is valid
-		if (Itr->Obj.IsValid(/*false, true*/))
-		{
-			// Check if the entity moved more than the threshold since the last logging
-			const FVector CurrLoc = Itr->Obj->GetComponentLocation();
-			const FQuat CurrQuat = Itr->Obj->GetComponentQuat();
+		const TSLEntityPreviousPose<USLSkeletalDataComponent>& SkelEntity = SkeletalEntities[PoseBatch.EntityIndexes[BatchIdx]];
 
-			if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
-				CurrQuat.AngularDistance(Itr->PrevQuat))
-			{
-				// Update prev state
-				Itr->PrevLoc = CurrLoc;
-				Itr->PrevQuat = CurrQuat;
+		// Get current entry as json object
+		TSharedPtr<FJsonObject> JsonEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
+			TMap<FString, FString>{ {"id", SkelEntity.Entity.Id}, { "class", SkelEntity.Entity.Class } },
+			PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx]);
 
-				// Get current entry as json object
-				TSharedPtr<FJsonObject> JsonEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
-					TMap<FString, FString>{ {"id", Itr->Entity.Id}, { "class", Itr->Entity.Class } },
-					CurrLoc, CurrQuat);
+		// Json array of bones
+		TArray<TSharedPtr<FJsonValue>> JsonBonesArr;
 
-				// Json array of bones
-				TArray<TSharedPtr<FJsonValue>> JsonBonesArr;
+		if (USkeletalMeshComponent* SkelComp = SkelEntity.Obj->SkeletalMeshParent)
+		{
+			// Gather and convert the bone poses in one pass
+			BonePoseBatch.Reset(SkelEntity.Obj->AllBonesData.Num());
+			for (const auto& Pair : SkelEntity.Obj->AllBonesData)
+			{
+				BonePoseBatch.Add(SkelComp->GetBoneLocation(Pair.Key), SkelComp->GetBoneQuaternion(Pair.Key));
+			}
+			BonePoseBatch.ConvertToROS();
 
-				if (USkeletalMeshComponent* SkelComp = Itr->Obj->SkeletalMeshParent)
+			// Iterate through the bones of the skeletal mesh (same order as above)
+			int32 BoneIdx = 0;
+			for (const auto& Pair : SkelEntity.Obj->AllBonesData)
+			{
+				// Get current entry as json object
+				TMap<FString, FString> SemanticData;
+				SemanticData.Add("bone", Pair.Key.ToString());
+				if (!Pair.Value.Class.IsEmpty())
 				{
-					// Iterate through the bones of the skeletal mesh
-					for (const auto& Pair : Itr->Obj->AllBonesData)
-					{
-						const FVector CurrBoneLoc = SkelComp->GetBoneLocation(Pair.Key);
-						const FQuat CurrBoneQuat = SkelComp->GetBoneQuaternion(Pair.Key);
-
-						// Get current entry as json object
-						TMap<FString, FString> SemanticData;
-						SemanticData.Add("bone", Pair.Key.ToString());
-						if (!Pair.Value.Class.IsEmpty())
-						{
-							SemanticData.Add("class", Pair.Value.Class);
-						}
-						if (!Pair.Value.VisualMask.IsEmpty())
-						{
-							SemanticData.Add("mask_hex", Pair.Value.VisualMask);
-						}
-
-						TSharedPtr<FJsonObject> JsonBoneEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
-							SemanticData, CurrBoneLoc, CurrBoneQuat);
-
-						// Add bone to Json array
-						JsonBonesArr.Add(MakeShareable(new FJsonValueObject(JsonBoneEntry)));
-					}
+					SemanticData.Add("class", Pair.Value.Class);
 				}
-				// Add bones to json entry
-				JsonEntry->SetArrayField("bones", JsonBonesArr);
+				if (!Pair.Value.VisualMask.IsEmpty())
+				{
+					SemanticData.Add("mask_hex", Pair.Value.VisualMask);
+				}
+
+				TSharedPtr<FJsonObject> JsonBoneEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
+					SemanticData, BonePoseBatch.Locations[BoneIdx], BonePoseBatch.Quats[BoneIdx]);
+				BoneIdx++;
 
-				// Add entity to json array
-				OutJsonEntitiesArr.Add(MakeShareable(new FJsonValueObject(JsonEntry)));
+				// Add bone to Json array
+				JsonBonesArr.Add(MakeShareable(new FJsonValueObject(JsonBoneEntry)));
 			}
 		}
-		else
-		{
-			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Obj.Get());
-		}
+		// Add bones to json entry
+		JsonEntry->SetArrayField("bones", JsonBonesArr);
+
+		// Add entity to json array
+		OutJsonEntitiesArr.Add(MakeShareable(new FJsonValueObject(JsonEntry)));
+	}
+}
+
+// Add the entities of the (converted) pose batch to the json array
+template<typename T>
+void FSLWorldStateWriterJson::AddEntitiesPoses(const TArray<TSLEntityPreviousPose<T>>& Entities,
+	TArray<TSharedPtr<FJsonValue>>& OutJsonEntitiesArr)
+{
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
+	{
+		const FSLEntity& Entity = Entities[PoseBatch.EntityIndexes[BatchIdx]].Entity;
+
+		// Get current entry as json object
+		TSharedPtr<FJsonObject> JsonEntry = FSLWorldStateWriterJson::GetAsJsonEntry(
+			TMap<FString, FString>{ {"id", Entity.Id}, { "class", Entity.Class } },
+			PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx]);
+
+		// Add entity to json array
+		OutJsonEntitiesArr.Add(MakeShareable(new FJsonValueObject(JsonEntry)));
 	}
 }
 
-// Get key value pairs as json entry
+// Get key value pairs and the pose (already in the ROS frame) as json entry
 TSharedPtr<FJsonObject> FSLWorldStateWriterJson::GetAsJsonEntry(const TMap<FString, FString>& InKeyValMap,
-	const FVector& InLoc, const FQuat& InQuat)
+	const FVector& ROSLoc, const FQuat& ROSQuat)
 {
 	// New json entity object
 	TSharedPtr<FJsonObject> JsonObj = MakeShareable(new FJsonObject);
@@ -257,10 +210,6 @@ TSharedPtr<FJsonObject> FSLWorldStateWriterJson::GetAsJsonEntry(const TMap<FStri
 		JsonObj->SetStringField(Pair.Key, Pair.Value);
 	}
 
-	// Switch to right handed ROS transformation
-	const FVector ROSLoc = FConversions::UToROS(InLoc);
-	const FQuat ROSQuat = FConversions::UToROS(InQuat);
-
 	// Create and add "loc" field
 	TSharedPtr<FJsonObject> LocObj = MakeShareable(new FJsonObject);
 	LocObj->SetNumberField("x", ROSLoc.X);
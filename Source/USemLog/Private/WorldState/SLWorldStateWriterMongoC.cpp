@@ -5,6 +5,7 @@
 #include "Animation/SkeletalMeshActor.h"
 #include "Conversions.h"
 #include "SLEntitiesManager.h"
+#include "SLMongoService.h"
 
 // Constr
 FSLWorldStateWriterMongoC::FSLWorldStateWriterMongoC()
@@ -40,6 +41,9 @@ void FSLWorldStateWriterMongoC::Init(const FSLWorldStateWriterParams& InParams)
 		LinDistSqMin = InParams.LinearDistanceSquared;
 		AngDistMin = InParams.AngularDistance;
 		bIsInit =  true;
+
+		// Declare the indexes before the first insert, they are then maintained with every insert
+		CreateIndexes();
 	}
 }
 
@@ -48,7 +52,6 @@ void FSLWorldStateWriterMongoC::Finish()
 {
 	if (bIsInit)
 	{
-		CreateIndexes();
 		bIsInit = false;
 	}
 }
@@ -71,7 +74,6 @@ void FSLWorldStateWriterMongoC::Write(float Timestamp,
 	bson_t* ws_doc;
 	bson_t entities_arr;
 	bson_t sk_entities_arr;
-	bson_error_t error;
 
 	uint32_t arr_idx = 0;
 
@@ -111,15 +113,8 @@ void FSLWorldStateWriterMongoC::Write(float Timestamp,
 
 
 
-	if (!mongoc_collection_insert_one(collection, ws_doc, NULL, NULL, &error))
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
-			*FString(__func__), __LINE__, *FString(error.message));
-		bson_destroy(ws_doc);
-	}
-
-	// Clean up
-	bson_destroy(ws_doc);
+	// Queue the document, the service writes it asynchronously and takes care of the clean up
+	FSLMongoService::GetInstance()->Submit(DatabaseName, CollName, ws_doc);
 
 #endif //SL_WITH_LIBMONGO_C
 }
@@ -128,31 +123,23 @@ void FSLWorldStateWriterMongoC::Write(float Timestamp,
 bool FSLWorldStateWriterMongoC::Connect(const FString& DBName, const FString& CollectionName, const FString& ServerIp, uint16 ServerPort, bool bOverwrite)
 {
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
-	// Stores any error that might appear during the connection
-	bson_error_t error;
-
-	// Safely create a MongoDB URI object from the given string
-	FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
-	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Uri), &error);
-	if (!uri)
+	// Make sure the shared client pool and writer threads are running
+	if (!FSLMongoService::GetInstance()->Connect(ServerIp, ServerPort))
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s; [Uri=%s]"),
-			*FString(__func__), __LINE__, *FString(error.message), *Uri);
 		return false;
 	}
 
-	// Create a new client instance
-	client = mongoc_client_new_from_uri(uri);
+	// Stores any error that might appear during the connection
+	bson_error_t error;
+
+	// Client used for the synchronous operations (collection setup, indexes), the writes go through the service
+	client = FSLMongoService::GetInstance()->PopClient();
 	if (!client)
 	{
 		return false;
 	}
-
-	// Register the application name so we can track it in the profile logs on the server
-	mongoc_client_set_appname(client, TCHAR_TO_UTF8(*("SL_" + CollectionName)));
+	DatabaseName = DBName;
+	CollName = CollectionName;
 
 	// Get a handle on the database "db_name" and collection "coll_name"
 	database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
@@ -186,18 +173,6 @@ bool FSLWorldStateWriterMongoC::Connect(const FString& DBName, const FString& Co
 	
 	collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollectionName));
 
-	// Check server. Ping the "admin" database
-	bson_t* server_ping_cmd;
-	server_ping_cmd = BCON_NEW("ping", BCON_INT32(1));
-	if (!mongoc_client_command_simple(client, "admin", server_ping_cmd, NULL, NULL, &error))
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Check server err.: %s"),
-			*FString(__func__), __LINE__, *FString(error.message));
-		bson_destroy(server_ping_cmd);
-		return false;
-	}
-
-	bson_destroy(server_ping_cmd);
 	return true;
 #else
 	return false;
@@ -208,265 +183,115 @@ bool FSLWorldStateWriterMongoC::Connect(const FString& DBName, const FString& Co
 void FSLWorldStateWriterMongoC::Disconnect()
 {
 #if SL_WITH_LIBMONGO_C
-	// Release handles and clean up mongoc
-	if(uri)
-	{
-		mongoc_uri_destroy(uri);
-	}
-	if(client)
+	// Release handles and return the client to the pool
+	if(collection)
 	{
-		mongoc_client_destroy(client);
+		mongoc_collection_destroy(collection);
+		collection = nullptr;
 	}
 	if(database)
 	{
 		mongoc_database_destroy(database);
+		database = nullptr;
 	}
-	if(collection)
+	if(client)
 	{
-		mongoc_collection_destroy(collection);
+		FSLMongoService::GetInstance()->PushClient(client);
+		client = nullptr;
 	}
-	mongoc_cleanup();
-#endif //SL_WITH_LIBMONGO_C
+#endif //SL_WITH_LIBMONGO_C
 }
 
-// Create indexes from the logged data, usually called after logging
+// Create the indexes on the (still empty) collection
 bool FSLWorldStateWriterMongoC::CreateIndexes() const
 {
 	if (!bIsInit)
 	{
 		return false;
 	}
-#if SL_WITH_LIBMONGO_C
-
-	bson_t* index_command;
-	bson_error_t error;
-	
-	bson_t index;
-	bson_init(&index);
-	BSON_APPEND_INT32(&index, "timestamp", 1);
-	char* index_name = mongoc_collection_keys_to_index_string(&index);
-
-	bson_t index2;
-	bson_init(&index2);
-	BSON_APPEND_INT32(&index2, "entities.id", 1);
-	char* index_name2 = mongoc_collection_keys_to_index_string(&index2);
-
-	bson_t index3;
-	bson_init(&index3);
-	BSON_APPEND_INT32(&index3, "skel_entities.id", 1);
-	char* index_name3 = mongoc_collection_keys_to_index_string(&index3);
-
-	bson_t index4;
-	bson_init(&index4);
-	BSON_APPEND_INT32(&index4, "skel_entities.bones.name", 1);
-	char* index_name4 = mongoc_collection_keys_to_index_string(&index4);
-
-	bson_t index5;
-	bson_init(&index5);
-	BSON_APPEND_INT32(&index5, "gaze.entity_id", 1);
-	char* index_name5 = mongoc_collection_keys_to_index_string(&index5);
-
-
-	index_command = BCON_NEW("createIndexes",
-			BCON_UTF8(mongoc_collection_get_name(collection)),
-			"indexes",
-			"[",
-				"{",
-					"key",
-					BCON_DOCUMENT(&index),
-					"name",
-					BCON_UTF8(index_name),
-					//"unique",
-					//BCON_BOOL(false),
-				"}",
-				"{",
-					"key",
-					BCON_DOCUMENT(&index2),
-					"name",
-					BCON_UTF8(index_name2),
-					//"unique",
-					//BCON_BOOL(false),
-				"}",
-				"{",
-					"key",
-					BCON_DOCUMENT(&index3),
-					"name",
-					BCON_UTF8(index_name3),
-					//"unique",
-					//BCON_BOOL(false),
-				"}",
-				"{",
-					"key",
-					BCON_DOCUMENT(&index4),
-					"name",
-					BCON_UTF8(index_name4),
-					//"unique",
-					//BCON_BOOL(false),
-				"}",
-				"{",
-					"key",
-					BCON_DOCUMENT(&index5),
-					"name",
-					BCON_UTF8(index_name5),
-					//"unique",
-					//BCON_BOOL(false),
-				"}",
-			"]");
-
-	if (!mongoc_collection_write_command_with_opts(collection, index_command, NULL/*opts*/, NULL/*reply*/, &error))
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Create indexes err.: %s"),
-			*FString(__func__), __LINE__, *FString(error.message));
-		bson_destroy(index_command);
-		bson_free(index_name);
-		return false;
-	}
+	return FSLMongoService::GetInstance()->CreateIndexes(DatabaseName, CollName, GetIndexKeys());
+}
 
-	// Clean up
-	bson_destroy(index_command);
-	bson_free(index_name);
-	return true;
-#else
-	return false;
-#endif //SL_WITH_LIBMONGO_C
+// Indexes of the world state collection
+TArray<FString> FSLWorldStateWriterMongoC::GetIndexKeys()
+{
+	return { TEXT("timestamp"), TEXT("entities.id"), TEXT("skel_entities.id"),
+		TEXT("skel_entities.bones.name"), TEXT("gaze.entity_id") };
 }
 
 #if SL_WITH_LIBMONGO_C
 // Add non skeletal actors to array
 void FSLWorldStateWriterMongoC::AddActorEntities(TArray<TSLEntityPreviousPose<AActor>>& ActorEntities,
-	bson_t* out_doc, uint32_t& idx) const
+	bson_t* out_doc, uint32_t& idx)
 {
-	bson_t arr_obj;
-	char idx_str[16];
-	const char *idx_key;
-
-	// Iterate items
-	for (auto Itr(ActorEntities.CreateIterator()); Itr; ++Itr)
-	{
-		// Check if pointer is valid
-		if (Itr->Obj.IsValid(/*false, true*/))
-		{
-			// Check if the entity moved more than the threshold since the last logging
-			const FVector CurrLoc = Itr->Obj->GetActorLocation();
-			const FQuat CurrQuat = Itr->Obj->GetActorQuat();
-
-			if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
-				CurrQuat.AngularDistance(Itr->PrevQuat))
-			{
-				// Update prev state
-				Itr->PrevLoc = CurrLoc;
-				Itr->PrevQuat = CurrQuat;
-
-				bson_uint32_to_string(idx, &idx_key, idx_str, sizeof idx_str);
-				BSON_APPEND_DOCUMENT_BEGIN(out_doc, idx_key, &arr_obj);
-
-				BSON_APPEND_UTF8(&arr_obj, "id", TCHAR_TO_UTF8(*Itr->Entity.Id));
-				AddPoseChild(CurrLoc, CurrQuat, &arr_obj);
-
-				bson_append_document_end(out_doc, &arr_obj);
-				idx++;
-			}
-		}
-		else
-		{
-			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Obj.Get());
-		}
-	}
+	// Gather the entities which moved and convert their poses in one pass
+	PoseBatch.SetMovedEntities(ActorEntities, LinDistSqMin);
+	PoseBatch.ConvertToROS();
+	AddEntitiesPoses(ActorEntities, out_doc, idx);
 }
 
 // Add non skeletal components to array
 void FSLWorldStateWriterMongoC::AddComponentEntities(TArray<TSLEntityPreviousPose<USceneComponent>>& ComponentEntities,
-	bson_t* out_doc, uint32_t& idx) const
+	bson_t* out_doc, uint32_t& idx)
+{
+	// Gather the entities which moved and convert their poses in one pass
+	PoseBatch.SetMovedEntities(ComponentEntities, LinDistSqMin);
+	PoseBatch.ConvertToROS();
+	AddEntitiesPoses(ComponentEntities, out_doc, idx);
+}
+
+// Add skeletal actors to array
+void FSLWorldStateWriterMongoC::AddSkeletalEntities(TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
+	bson_t* out_doc, uint32_t& idx)
 {
 	bson_t arr_obj;
 	char idx_str[16];
 	const char *idx_key;
 
-	// Iterate items
-	for (auto Itr(ComponentEntities.CreateIterator()); Itr; ++Itr)
-	{
-		// Check if pointer is valid
-		if (Itr->Obj.IsValid(/*false, true*/))
-		{
-			// Check if the entity moved more than the threshold since the last logging
-			const FVector CurrLoc = Itr->Obj->GetComponentLocation();
-			const FQuat CurrQuat = Itr->Obj->GetComponentQuat();
-
-			if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
-				CurrQuat.AngularDistance(Itr->PrevQuat))
-			{
-				// Update prev state
-				Itr->PrevLoc = CurrLoc;
-				Itr->PrevQuat = CurrQuat;
-
-				bson_uint32_to_string(idx, &idx_key, idx_str, sizeof idx_str);
-				BSON_APPEND_DOCUMENT_BEGIN(out_doc, idx_key, &arr_obj);
+	// Gather the entities which moved and convert their poses in one pass
+	PoseBatch.SetMovedEntities(SkeletalEntities, LinDistSqMin);
+	PoseBatch.ConvertToROS();
 
-				BSON_APPEND_UTF8(&arr_obj, "id", TCHAR_TO_UTF8(*Itr->Entity.Id));
-				AddPoseChild(CurrLoc, CurrQuat, &arr_obj);
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
+	{
+		const TSLEntityPreviousPose<USLSkeletalDataComponent>& SkelEntity = SkeletalEntities[PoseBatch.EntityIndexes[BatchIdx]];
 
-				uint32_t arr_jdx = 10;
+		bson_uint32_to_string(idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(out_doc, idx_key, &arr_obj);
 
+		BSON_APPEND_UTF8(&arr_obj, "id", TCHAR_TO_UTF8(*SkelEntity.Entity.Id));
+		AddPoseChild(PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx], &arr_obj);
 
-				bson_append_document_end(out_doc, &arr_obj);
-				idx++;
-			}
-		}
-		else
+		// Add bones
+		if (SkelEntity.Obj->SkeletalMeshParent)
 		{
-			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Obj.Get());
+			AddSkeletalBones(SkelEntity.Obj->SkeletalMeshParent, &arr_obj);
 		}
+
+		bson_append_document_end(out_doc, &arr_obj);
+		idx++;
 	}
 }
 
-// Add skeletal actors to array
-void FSLWorldStateWriterMongoC::AddSkeletalEntities(TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
+// Add the entities of the (converted) pose batch to array
+template<typename T>
+void FSLWorldStateWriterMongoC::AddEntitiesPoses(const TArray<TSLEntityPreviousPose<T>>& Entities,
 	bson_t* out_doc, uint32_t& idx) const
 {
 	bson_t arr_obj;
 	char idx_str[16];
 	const char *idx_key;
 
-	// Iterate items
-	for (auto Itr(SkeletalEntities.CreateIterator()); Itr; ++Itr)
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
 	{
-		// Check if the entity moved more than the threshold since the last logging
-		const FVector CurrLoc = Itr->Obj->GetComponentLocation();
-		const FQuat CurrQuat = Itr->Obj->GetComponentQuat();
-
-		// Check if pointer is valid
-		if (Itr->Obj.IsValid(/*false, true*/))
-		{
-			if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
-				CurrQuat.AngularDistance(Itr->PrevQuat))
-			{
-				// Update prev state
-				Itr->PrevLoc = CurrLoc;
-				Itr->PrevQuat = CurrQuat;
-
-				bson_uint32_to_string(idx, &idx_key, idx_str, sizeof idx_str);
-				BSON_APPEND_DOCUMENT_BEGIN(out_doc, idx_key, &arr_obj);
-
-				BSON_APPEND_UTF8(&arr_obj, "id", TCHAR_TO_UTF8(*Itr->Entity.Id));
-				AddPoseChild(CurrLoc, CurrQuat, &arr_obj);
+		bson_uint32_to_string(idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(out_doc, idx_key, &arr_obj);
 
-				// Add bones
-				if (Itr->Obj->SkeletalMeshParent)
-				{
-					AddSkeletalBones(Itr->Obj->SkeletalMeshParent, &arr_obj);
-				}
+		BSON_APPEND_UTF8(&arr_obj, "id", TCHAR_TO_UTF8(*Entities[PoseBatch.EntityIndexes[BatchIdx]].Entity.Id));
+		AddPoseChild(PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx], &arr_obj);
 
-				bson_append_document_end(out_doc, &arr_obj);
-				idx++;
-			}
-		}
-		else
-		{
-			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Obj.Get());
-		}
+		bson_append_document_end(out_doc, &arr_obj);
+		idx++;
 	}
 }
 
@@ -499,44 +324,41 @@ void FSLWorldStateWriterMongoC::AddGazeData(const FSLGazeData& GazeData, bson_t*
 }
 
 // Add skeletal bones to array
-void FSLWorldStateWriterMongoC::AddSkeletalBones(USkeletalMeshComponent* SkelComp, bson_t* out_doc) const
+void FSLWorldStateWriterMongoC::AddSkeletalBones(USkeletalMeshComponent* SkelComp, bson_t* out_doc)
 {
 	bson_t bones_arr;
 	bson_t arr_obj;
 	char idx_str[16];
 	const char *idx_key;
-	uint32_t arr_idx = 0;
-
-	// Add entities to array
-	BSON_APPEND_ARRAY_BEGIN(out_doc, "bones", &bones_arr);
 
+	// Gather and convert the bone poses in one pass
 	TArray<FName> BoneNames;
 	SkelComp->GetBoneNames(BoneNames);
+	BonePoseBatch.Reset(BoneNames.Num());
 	for (const auto& BoneName : BoneNames)
 	{
-		const FVector CurrLoc = SkelComp->GetBoneLocation(BoneName);
-		const FQuat CurrQuat = SkelComp->GetBoneQuaternion(BoneName);
+		BonePoseBatch.Add(SkelComp->GetBoneLocation(BoneName), SkelComp->GetBoneQuaternion(BoneName));
+	}
+	BonePoseBatch.ConvertToROS();
 
-		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+	// Add entities to array
+	BSON_APPEND_ARRAY_BEGIN(out_doc, "bones", &bones_arr);
+	for (int32 BoneIdx = 0; BoneIdx < BoneNames.Num(); ++BoneIdx)
+	{
+		bson_uint32_to_string(BoneIdx, &idx_key, idx_str, sizeof idx_str);
 		BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
 
-		BSON_APPEND_UTF8(&arr_obj, "name", TCHAR_TO_UTF8(*BoneName.ToString()));
-		AddPoseChild(CurrLoc, CurrQuat, &arr_obj);
+		BSON_APPEND_UTF8(&arr_obj, "name", TCHAR_TO_UTF8(*BoneNames[BoneIdx].ToString()));
+		AddPoseChild(BonePoseBatch.Locations[BoneIdx], BonePoseBatch.Quats[BoneIdx], &arr_obj);
 
 		bson_append_document_end(&bones_arr, &arr_obj);
-		arr_idx++;
 	}
-
 	bson_append_array_end(out_doc, &bones_arr);
 }
 
-// Add pose to document
-void FSLWorldStateWriterMongoC::AddPoseChild(const FVector& InLoc, const FQuat& InQuat, bson_t* out_doc) const
+// Add pose (already in the ROS frame) to document
+void FSLWorldStateWriterMongoC::AddPoseChild(const FVector& ROSLoc, const FQuat& ROSQuat, bson_t* out_doc) const
 {
-	// Switch to right handed ROS transformation
-	const FVector ROSLoc = FConversions::UToROS(InLoc);
-	const FQuat ROSQuat = FConversions::UToROS(InQuat);
-
 	bson_t child_obj_loc;
 	bson_t child_obj_rot;
 	
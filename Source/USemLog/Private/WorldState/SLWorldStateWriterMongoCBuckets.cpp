@@ -0,0 +1,610 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "WorldState/SLWorldStateWriterMongoCBuckets.h"
+#include "Animation/SkeletalMeshActor.h"
+#include "Conversions.h"
+#include "SLEntitiesManager.h"
+#include "SLMongoService.h"
+
+// Constr
+FSLWorldStateWriterMongoCBuckets::FSLWorldStateWriterMongoCBuckets()
+{
+	bIsInit = false;
+}
+
+// Init constr
+FSLWorldStateWriterMongoCBuckets::FSLWorldStateWriterMongoCBuckets(const FSLWorldStateWriterParams& InParams)
+{
+	bIsInit = false;
+	Init(InParams);
+}
+
+// Destr
+FSLWorldStateWriterMongoCBuckets::~FSLWorldStateWriterMongoCBuckets()
+{
+	Finish();
+
+	// Disconnect and clean db connection
+	Disconnect();
+}
+
+// Init
+void FSLWorldStateWriterMongoCBuckets::Init(const FSLWorldStateWriterParams& InParams)
+{
+	if (!bIsInit)
+	{
+		BucketMaxSamples = FMath::Max<int32>(InParams.BucketMaxSamples, 1);
+		BucketMaxDuration = InParams.BucketMaxDuration > 0.f ? InParams.BucketMaxDuration : BIG_NUMBER;
+		bUseTimeSeries = InParams.bUseTimeSeriesCollection;
+		if (!Connect(InParams.TaskId, InParams.EpisodeId, InParams.ServerIp, InParams.ServerPort, InParams.bOverwrite))
+		{
+			return;
+		}
+		LinDistSqMin = InParams.LinearDistanceSquared;
+		AngDistMin = InParams.AngularDistance;
+		bIsInit = true;
+
+		// Declare the indexes before the first insert, they are then maintained with every insert
+		CreateIndexes();
+	}
+}
+
+// Finish
+void FSLWorldStateWriterMongoCBuckets::Finish()
+{
+	if (bIsInit)
+	{
+#if SL_WITH_LIBMONGO_C
+		// Write out the partially filled buckets
+		for (auto& Pair : Buckets)
+		{
+			if (Pair.Value.Num() > 0)
+			{
+				FlushBucket(Pair.Value);
+			}
+		}
+		if (GazeBucket.Num() > 0)
+		{
+			FlushGazeBucket();
+		}
+		InsertPendingDocs();
+#endif //SL_WITH_LIBMONGO_C
+		Buckets.Empty();
+		bIsInit = false;
+	}
+}
+
+// Write data to the entity buckets, full buckets are inserted as documents
+void FSLWorldStateWriterMongoCBuckets::Write(float Timestamp,
+	TArray<TSLEntityPreviousPose<AActor>>& ActorEntities,
+	TArray<TSLEntityPreviousPose<USceneComponent>>& ComponentEntities,
+	TArray<TSLEntityPreviousPose<USLSkeletalDataComponent>>& SkeletalEntities,
+	FSLGazeData& GazeData,
+	bool bCheckAndRemoveInvalidEntities)
+{
+#if SL_WITH_LIBMONGO_C
+	// Non skeletal actors, the poses of the moved ones are converted in one pass
+	RemoveInvalidEntities(ActorEntities);
+	PoseBatch.SetMovedEntities(ActorEntities, LinDistSqMin, AngDistMin);
+	PoseBatch.ConvertToROS();
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
+	{
+		const FSLEntity& Entity = ActorEntities[PoseBatch.EntityIndexes[BatchIdx]].Entity;
+		AddSample(Entity.Obj, Entity.Id, Timestamp, PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx]);
+	}
+
+	// Non skeletal components
+	RemoveInvalidEntities(ComponentEntities);
+	PoseBatch.SetMovedEntities(ComponentEntities, LinDistSqMin, AngDistMin);
+	PoseBatch.ConvertToROS();
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
+	{
+		const FSLEntity& Entity = ComponentEntities[PoseBatch.EntityIndexes[BatchIdx]].Entity;
+		AddSample(Entity.Obj, Entity.Id, Timestamp, PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx]);
+	}
+
+	// Skeletal entities, the bones are bucketed together with their owner
+	RemoveInvalidEntities(SkeletalEntities);
+	PoseBatch.SetMovedEntities(SkeletalEntities, LinDistSqMin, AngDistMin);
+	PoseBatch.ConvertToROS();
+	for (int32 BatchIdx = 0; BatchIdx < PoseBatch.Num(); ++BatchIdx)
+	{
+		const TSLEntityPreviousPose<USLSkeletalDataComponent>& SkelEntity = SkeletalEntities[PoseBatch.EntityIndexes[BatchIdx]];
+		AddSample(SkelEntity.Entity.Obj, SkelEntity.Entity.Id, Timestamp,
+			PoseBatch.Locations[BatchIdx], PoseBatch.Quats[BatchIdx], SkelEntity.Obj->SkeletalMeshParent);
+	}
+
+	// Gaze samples are bucketed separately (the server buckets them as well with the time series collection)
+	if (GazeData.HasDataFast() && !PreviousGazeData.Equals(GazeData, 3.f))
+	{
+		if (bUseTimeSeries)
+		{
+			AddGazeMeasurementDoc(Timestamp, FConversions::UToROS(GazeData.Target),
+				FConversions::UToROS(GazeData.Origin), GazeData.Entity.Id);
+		}
+		else
+		{
+			if (GazeBucket.Num() == 0)
+			{
+				GazeBucket.StartTime = Timestamp;
+			}
+			GazeBucket.EndTime = Timestamp;
+			GazeBucket.Timestamps.Add(Timestamp);
+			AppendLoc(GazeBucket.Locs, FConversions::UToROS(GazeData.Target));
+			AppendLoc(GazeOrigins, FConversions::UToROS(GazeData.Origin));
+			GazeEntityIds.Add(GazeData.Entity.Id);
+			if (IsBucketFull(GazeBucket))
+			{
+				FlushGazeBucket();
+			}
+		}
+		PreviousGazeData = GazeData;
+	}
+
+	// Write all the full buckets (or measurements) in one batch
+	InsertPendingDocs();
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Connect to the database
+bool FSLWorldStateWriterMongoCBuckets::Connect(const FString& DBName, const FString& CollectionName, const FString& ServerIp, uint16 ServerPort, bool bOverwrite)
+{
+#if SL_WITH_LIBMONGO_C
+	// Make sure the shared client pool and writer threads are running
+	if (!FSLMongoService::GetInstance()->Connect(ServerIp, ServerPort))
+	{
+		return false;
+	}
+
+	// Stores any error that might appear during the connection
+	bson_error_t error;
+
+	// Client used for the synchronous operations (collection setup, indexes), the writes go through the service
+	client = FSLMongoService::GetInstance()->PopClient();
+	if (!client)
+	{
+		return false;
+	}
+	DatabaseName = DBName;
+	CollName = CollectionName;
+
+	// Get a handle on the database "db_name" and collection "coll_name"
+	database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
+
+	// Abort if we connect to an existing collection
+	if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*CollectionName), &error))
+	{
+		if (bOverwrite)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d World state collection %s already exists, will be removed and overwritten.."),
+				*FString(__func__), __LINE__, *CollectionName);
+			mongoc_collection_t* old_collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*CollectionName));
+			if (!mongoc_collection_drop(old_collection, &error))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not drop collection, err.:%s;"),
+					*FString(__func__), __LINE__, *FString(error.message));
+				mongoc_collection_destroy(old_collection);
+				return false;
+			}
+			mongoc_collection_destroy(old_collection);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d World state collection %s already exists and should not be overwritten, skipping world state logging.."),
+				*FString(__func__), __LINE__, *CollectionName);
+			return false;
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Collection %s does not exist, creating a new one.."),
+			*FString(__func__), __LINE__, *CollectionName);
+	}
+
+	if (bUseTimeSeries)
+	{
+		// Let the server group the measurements by the entity id (meta field)
+		bson_t* ts_opts = BCON_NEW("timeseries", "{",
+				"timeField", BCON_UTF8("ts"),
+				"metaField", BCON_UTF8("meta"),
+				"granularity", BCON_UTF8("seconds"),
+			"}");
+		collection = mongoc_database_create_collection(database, TCHAR_TO_UTF8(*CollectionName), ts_opts, &error);
+		bson_destroy(ts_opts);
+		if (!collection)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create time series collection (requires MongoDB 5.0+), err.:%s;"),
+				*FString(__func__), __LINE__, *FString(error.message));
+			return false;
+		}
+	}
+	else
+	{
+		collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollectionName));
+	}
+
+	return true;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Disconnect and clean db connection
+void FSLWorldStateWriterMongoCBuckets::Disconnect()
+{
+#if SL_WITH_LIBMONGO_C
+	// Release handles and return the client to the pool
+	if(collection)
+	{
+		mongoc_collection_destroy(collection);
+		collection = nullptr;
+	}
+	if(database)
+	{
+		mongoc_database_destroy(database);
+		database = nullptr;
+	}
+	if(client)
+	{
+		FSLMongoService::GetInstance()->PushClient(client);
+		client = nullptr;
+	}
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Create the indexes on the (still empty) collection
+bool FSLWorldStateWriterMongoCBuckets::CreateIndexes() const
+{
+	if (!bIsInit)
+	{
+		return false;
+	}
+	return FSLMongoService::GetInstance()->CreateIndexes(DatabaseName, CollName, GetIndexKeys(bUseTimeSeries));
+}
+
+// Indexes for per-entity trajectory queries
+TArray<FString> FSLWorldStateWriterMongoCBuckets::GetIndexKeys(bool bTimeSeries)
+{
+	if (bTimeSeries)
+	{
+		// Secondary index on the meta field, the time field is clustered by the server
+		return { TEXT("meta.id+ts"), TEXT("timestamp") };
+	}
+	// Trajectory queries: { id: X, t_start: { $lte: t1 }, t_end: { $gte: t0 } }
+	return { TEXT("id+t_start"), TEXT("t_start") };
+}
+
+// Remove the invalid entities and flush their buckets
+template<typename T>
+void FSLWorldStateWriterMongoCBuckets::RemoveInvalidEntities(TArray<TSLEntityPreviousPose<T>>& Entities)
+{
+	for (auto Itr(Entities.CreateIterator()); Itr; ++Itr)
+	{
+		if (!Itr->Obj.IsValid(/*false, true*/))
+		{
+#if SL_WITH_LIBMONGO_C
+			if (FSLWSEntityBucket* Bucket = Buckets.Find(Itr->Entity.Obj))
+			{
+				if (Bucket->Num() > 0)
+				{
+					FlushBucket(*Bucket);
+				}
+				Buckets.Remove(Itr->Entity.Obj);
+			}
+#endif //SL_WITH_LIBMONGO_C
+			Itr.RemoveCurrent();
+		}
+	}
+}
+
+// Add the current pose (already in the ROS frame) to the entity bucket, true if the bucket is full
+bool FSLWorldStateWriterMongoCBuckets::AddSample(UObject* Obj, const FString& Id, float Timestamp,
+	const FVector& ROSLoc, const FQuat& ROSQuat, USkeletalMeshComponent* SkelComp)
+{
+#if SL_WITH_LIBMONGO_C
+	// Gather and convert the bone poses in one pass
+	if (SkelComp)
+	{
+		SkelComp->GetBoneNames(BoneNames);
+		BonePoseBatch.Reset(BoneNames.Num());
+		for (const auto& BoneName : BoneNames)
+		{
+			BonePoseBatch.Add(SkelComp->GetBoneLocation(BoneName), SkelComp->GetBoneQuaternion(BoneName));
+		}
+		BonePoseBatch.ConvertToROS();
+	}
+
+	// The server does the bucketing, write the sample as it is
+	if (bUseTimeSeries)
+	{
+		AddMeasurementDoc(Id, Timestamp, ROSLoc, ROSQuat, SkelComp);
+		return false;
+	}
+
+	FSLWSEntityBucket* Bucket = Buckets.Find(Obj);
+	if (!Bucket)
+	{
+		Bucket = &Buckets.Add(Obj);
+		Bucket->Id = Id;
+		Bucket->Timestamps.Reserve(BucketMaxSamples);
+		Bucket->Locs.Reserve(BucketMaxSamples * 3);
+		Bucket->Rots.Reserve(BucketMaxSamples * 4);
+		if (SkelComp)
+		{
+			InitBoneBuckets(*Bucket);
+		}
+	}
+	else if (SkelComp && Bucket->Bones.Num() != BonePoseBatch.Num())
+	{
+		// The bone series have to stay in step with the timestamps, the changed skeleton starts a new bucket
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s has %d bones, its bucket was created with %d, flushing the bucket and resetting its bones.."),
+			*FString(__func__), __LINE__, *Id, BonePoseBatch.Num(), Bucket->Bones.Num());
+		if (Bucket->Num() > 0)
+		{
+			FlushBucket(*Bucket);
+		}
+		InitBoneBuckets(*Bucket);
+	}
+
+	if (Bucket->Num() == 0)
+	{
+		Bucket->StartTime = Timestamp;
+	}
+	Bucket->EndTime = Timestamp;
+	Bucket->Timestamps.Add(Timestamp);
+	AppendLoc(Bucket->Locs, ROSLoc);
+	AppendRot(Bucket->Rots, ROSQuat);
+
+	// The bone buckets were created in the bone names order
+	if (SkelComp)
+	{
+		for (int32 BoneIdx = 0; BoneIdx < Bucket->Bones.Num(); ++BoneIdx)
+		{
+			AppendLoc(Bucket->Bones[BoneIdx].Locs, BonePoseBatch.Locations[BoneIdx]);
+			AppendRot(Bucket->Bones[BoneIdx].Rots, BonePoseBatch.Quats[BoneIdx]);
+		}
+	}
+
+	if (IsBucketFull(*Bucket))
+	{
+		FlushBucket(*Bucket);
+		return true;
+	}
+#endif //SL_WITH_LIBMONGO_C
+	return false;
+}
+
+// Create the bone buckets of the entity bucket in the current bone names order
+void FSLWorldStateWriterMongoCBuckets::InitBoneBuckets(FSLWSEntityBucket& Bucket)
+{
+	Bucket.Bones.Reset(BoneNames.Num());
+	for (const auto& BoneName : BoneNames)
+	{
+		FSLWSBoneBucket& BoneBucket = Bucket.Bones.AddDefaulted_GetRef();
+		BoneBucket.Name = BoneName;
+		BoneBucket.Locs.Reserve(BucketMaxSamples * 3);
+		BoneBucket.Rots.Reserve(BucketMaxSamples * 4);
+	}
+}
+
+// Add packed location (already in the ROS frame)
+FORCEINLINE void FSLWorldStateWriterMongoCBuckets::AppendLoc(TArray<double>& OutArr, const FVector& ROSLoc)
+{
+	OutArr.Add(ROSLoc.X);
+	OutArr.Add(ROSLoc.Y);
+	OutArr.Add(ROSLoc.Z);
+}
+
+// Add packed rotation (already in the ROS frame)
+FORCEINLINE void FSLWorldStateWriterMongoCBuckets::AppendRot(TArray<double>& OutArr, const FQuat& ROSQuat)
+{
+	OutArr.Add(ROSQuat.X);
+	OutArr.Add(ROSQuat.Y);
+	OutArr.Add(ROSQuat.Z);
+	OutArr.Add(ROSQuat.W);
+}
+
+#if SL_WITH_LIBMONGO_C
+// Write the bucket as a document and reset it
+void FSLWorldStateWriterMongoCBuckets::FlushBucket(FSLWSEntityBucket& Bucket)
+{
+	bson_t* bucket_doc = bson_new();
+	bson_t ts_arr;
+	char idx_str[16];
+	const char *idx_key;
+
+	BSON_APPEND_UTF8(bucket_doc, "id", TCHAR_TO_UTF8(*Bucket.Id));
+	BSON_APPEND_DOUBLE(bucket_doc, "t_start", Bucket.StartTime);
+	BSON_APPEND_DOUBLE(bucket_doc, "t_end", Bucket.EndTime);
+	BSON_APPEND_INT32(bucket_doc, "n", Bucket.Num());
+
+	BSON_APPEND_ARRAY_BEGIN(bucket_doc, "ts", &ts_arr);
+	for (int32 Idx = 0; Idx < Bucket.Timestamps.Num(); ++Idx)
+	{
+		bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOUBLE(&ts_arr, idx_key, Bucket.Timestamps[Idx]);
+	}
+	bson_append_array_end(bucket_doc, &ts_arr);
+
+	AddDoubleArray("loc", Bucket.Locs, bucket_doc);
+	AddDoubleArray("rot", Bucket.Rots, bucket_doc);
+
+	if (Bucket.Bones.Num() > 0)
+	{
+		bson_t bones_arr;
+		bson_t bone_obj;
+		BSON_APPEND_ARRAY_BEGIN(bucket_doc, "bones", &bones_arr);
+		for (int32 Idx = 0; Idx < Bucket.Bones.Num(); ++Idx)
+		{
+			bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &bone_obj);
+			BSON_APPEND_UTF8(&bone_obj, "name", TCHAR_TO_UTF8(*Bucket.Bones[Idx].Name.ToString()));
+			AddDoubleArray("loc", Bucket.Bones[Idx].Locs, &bone_obj);
+			AddDoubleArray("rot", Bucket.Bones[Idx].Rots, &bone_obj);
+			bson_append_document_end(&bones_arr, &bone_obj);
+		}
+		bson_append_array_end(bucket_doc, &bones_arr);
+	}
+
+	PendingDocs.Add(bucket_doc);
+	Bucket.Reset();
+}
+
+// Write out the gaze bucket as a document and reset it
+void FSLWorldStateWriterMongoCBuckets::FlushGazeBucket()
+{
+	bson_t* bucket_doc = bson_new();
+	bson_t arr;
+	char idx_str[16];
+	const char *idx_key;
+
+	BSON_APPEND_UTF8(bucket_doc, "id", "gaze");
+	BSON_APPEND_DOUBLE(bucket_doc, "t_start", GazeBucket.StartTime);
+	BSON_APPEND_DOUBLE(bucket_doc, "t_end", GazeBucket.EndTime);
+	BSON_APPEND_INT32(bucket_doc, "n", GazeBucket.Num());
+
+	BSON_APPEND_ARRAY_BEGIN(bucket_doc, "ts", &arr);
+	for (int32 Idx = 0; Idx < GazeBucket.Timestamps.Num(); ++Idx)
+	{
+		bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOUBLE(&arr, idx_key, GazeBucket.Timestamps[Idx]);
+	}
+	bson_append_array_end(bucket_doc, &arr);
+
+	BSON_APPEND_ARRAY_BEGIN(bucket_doc, "entity_id", &arr);
+	for (int32 Idx = 0; Idx < GazeEntityIds.Num(); ++Idx)
+	{
+		bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_UTF8(&arr, idx_key, TCHAR_TO_UTF8(*GazeEntityIds[Idx]));
+	}
+	bson_append_array_end(bucket_doc, &arr);
+
+	AddDoubleArray("target", GazeBucket.Locs, bucket_doc);
+	AddDoubleArray("origin", GazeOrigins, bucket_doc);
+
+	PendingDocs.Add(bucket_doc);
+	GazeBucket.Reset();
+	GazeOrigins.Reset();
+	GazeEntityIds.Reset();
+}
+
+// Add the entity sample (already in the ROS frame) as a time series measurement document
+void FSLWorldStateWriterMongoCBuckets::AddMeasurementDoc(const FString& Id, float Timestamp,
+	const FVector& ROSLoc, const FQuat& ROSQuat, USkeletalMeshComponent* SkelComp)
+{
+	bson_t* sample_doc = bson_new();
+	bson_t meta_obj;
+
+	// The time field needs to be a date, the episode time is kept in timestamp
+	BSON_APPEND_DATE_TIME(sample_doc, "ts", static_cast<int64_t>(Timestamp * 1000.0));
+	BSON_APPEND_DOUBLE(sample_doc, "timestamp", Timestamp);
+
+	BSON_APPEND_DOCUMENT_BEGIN(sample_doc, "meta", &meta_obj);
+	BSON_APPEND_UTF8(&meta_obj, "id", TCHAR_TO_UTF8(*Id));
+	bson_append_document_end(sample_doc, &meta_obj);
+
+	AddPoseChild(ROSLoc, ROSQuat, sample_doc);
+
+	if (SkelComp)
+	{
+		bson_t bones_arr;
+		bson_t arr_obj;
+		char idx_str[16];
+		const char *idx_key;
+
+		// The bone poses were converted by the caller, in the bone names order
+		BSON_APPEND_ARRAY_BEGIN(sample_doc, "bones", &bones_arr);
+		for (int32 BoneIdx = 0; BoneIdx < BoneNames.Num() && BoneIdx < BonePoseBatch.Num(); ++BoneIdx)
+		{
+			bson_uint32_to_string(BoneIdx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
+			BSON_APPEND_UTF8(&arr_obj, "name", TCHAR_TO_UTF8(*BoneNames[BoneIdx].ToString()));
+			AddPoseChild(BonePoseBatch.Locations[BoneIdx], BonePoseBatch.Quats[BoneIdx], &arr_obj);
+			bson_append_document_end(&bones_arr, &arr_obj);
+		}
+		bson_append_array_end(sample_doc, &bones_arr);
+	}
+
+	PendingDocs.Add(sample_doc);
+}
+
+// Add the gaze sample (already in the ROS frame) as a time series measurement document
+void FSLWorldStateWriterMongoCBuckets::AddGazeMeasurementDoc(float Timestamp, const FVector& ROSTarget,
+	const FVector& ROSOrigin, const FString& EntityId)
+{
+	bson_t* sample_doc = bson_new();
+	bson_t child_obj;
+
+	// Same time and meta fields as the entity measurements
+	BSON_APPEND_DATE_TIME(sample_doc, "ts", static_cast<int64_t>(Timestamp * 1000.0));
+	BSON_APPEND_DOUBLE(sample_doc, "timestamp", Timestamp);
+
+	BSON_APPEND_DOCUMENT_BEGIN(sample_doc, "meta", &child_obj);
+	BSON_APPEND_UTF8(&child_obj, "id", "gaze");
+	bson_append_document_end(sample_doc, &child_obj);
+
+	BSON_APPEND_UTF8(sample_doc, "entity_id", TCHAR_TO_UTF8(*EntityId));
+
+	BSON_APPEND_DOCUMENT_BEGIN(sample_doc, "target", &child_obj);
+	BSON_APPEND_DOUBLE(&child_obj, "x", ROSTarget.X);
+	BSON_APPEND_DOUBLE(&child_obj, "y", ROSTarget.Y);
+	BSON_APPEND_DOUBLE(&child_obj, "z", ROSTarget.Z);
+	bson_append_document_end(sample_doc, &child_obj);
+
+	BSON_APPEND_DOCUMENT_BEGIN(sample_doc, "origin", &child_obj);
+	BSON_APPEND_DOUBLE(&child_obj, "x", ROSOrigin.X);
+	BSON_APPEND_DOUBLE(&child_obj, "y", ROSOrigin.Y);
+	BSON_APPEND_DOUBLE(&child_obj, "z", ROSOrigin.Z);
+	bson_append_document_end(sample_doc, &child_obj);
+
+	PendingDocs.Add(sample_doc);
+}
+
+// Hand the pending documents over to the mongo service
+void FSLWorldStateWriterMongoCBuckets::InsertPendingDocs()
+{
+	// The service batches the documents of a collection and takes care of the clean up
+	for (bson_t* doc : PendingDocs)
+	{
+		FSLMongoService::GetInstance()->Submit(DatabaseName, CollName, doc);
+	}
+	PendingDocs.Reset();
+}
+
+// Add packed array of doubles
+void FSLWorldStateWriterMongoCBuckets::AddDoubleArray(const char* Key, const TArray<double>& InArr, bson_t* out_doc) const
+{
+	bson_t arr;
+	char idx_str[16];
+	const char *idx_key;
+
+	BSON_APPEND_ARRAY_BEGIN(out_doc, Key, &arr);
+	for (int32 Idx = 0; Idx < InArr.Num(); ++Idx)
+	{
+		bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOUBLE(&arr, idx_key, InArr[Idx]);
+	}
+	bson_append_array_end(out_doc, &arr);
+}
+
+// Add pose (already in the ROS frame) to document
+void FSLWorldStateWriterMongoCBuckets::AddPoseChild(const FVector& ROSLoc, const FQuat& ROSQuat, bson_t* out_doc) const
+{
+	bson_t child_obj_loc;
+	bson_t child_obj_rot;
+
+	BSON_APPEND_DOCUMENT_BEGIN(out_doc, "loc", &child_obj_loc);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "x", ROSLoc.X);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "y", ROSLoc.Y);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "z", ROSLoc.Z);
+	bson_append_document_end(out_doc, &child_obj_loc);
+
+	BSON_APPEND_DOCUMENT_BEGIN(out_doc, "rot", &child_obj_rot);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "x", ROSQuat.X);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "y", ROSQuat.Y);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "z", ROSQuat.Z);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "w", ROSQuat.W);
+	bson_append_document_end(out_doc, &child_obj_rot);
+}
+#endif //SL_WITH_LIBMONGO_C
@@ -228,7 +228,6 @@ void FSLWorldStateWriterMongoCxx::AddNonSkeletalActors(TArray<TSLEntityPreviousP
 		else
 		{
 			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Entity.Get());
 		}
 	}
 }
@@ -302,7 +301,6 @@ void FSLWorldStateWriterMongoCxx::AddSkeletalActors(TArray<TSLEntityPreviousPose
 		else
 		{
 			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Entity.Get());
 		}
 	}
 }
@@ -345,7 +343,6 @@ void FSLWorldStateWriterMongoCxx::AddNonSkeletalComponents(TArray<TSLEntityPrevi
 		else
 		{
 			Itr.RemoveCurrent();
-			FSLEntitiesManager::GetInstance()->RemoveEntity(Itr->Entity.Get());
 		}
 	}
 }
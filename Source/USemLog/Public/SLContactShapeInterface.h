@@ -6,7 +6,8 @@
 #include "Components/MeshComponent.h"
 #include "Components/ShapeComponent.h"
 #include "SLStructs.h"
-#include "TimerManager.h"
+#include "SLSupportedByEvaluator.h"
+#include "SLTimerWheel.h"
 #include "SLContactShapeInterface.generated.h"
 
 /**
@@ -19,22 +20,25 @@ struct FSLOverlapEndEvent
 	FSLOverlapEndEvent() = default;
 
 	// Init ctor
-	FSLOverlapEndEvent(UPrimitiveComponent* InOtherComp, const FSLEntity& InOtherItem, float InTime) :
+	FSLOverlapEndEvent(UPrimitiveComponent* InOtherComp, const FSLEntityHandle& InOtherItem, float InTime) :
 		OtherComp(InOtherComp), OtherItem(InOtherItem), Time(InTime) {};
 
 	// Overlap component
 	UPrimitiveComponent* OtherComp;
 	
 	// Other item of the overlap end
-	FSLEntity OtherItem;
+	FSLEntityHandle OtherItem;
 
 	// Time
 	float Time;
+
+	// Delayed publish timer
+	FSLTimerWheelHandle TimerHandle;
 };
 
 
 /** Notiy the begin/end of a supported by event */
-DECLARE_MULTICAST_DELEGATE_FourParams(FSLBeginSupportedBySignature, const FSLEntity& /*Supported*/, const FSLEntity& /*Supporting*/, float /*Time*/, const uint64 /*PairId*/);
+DECLARE_MULTICAST_DELEGATE_FourParams(FSLBeginSupportedBySignature, const FSLEntityHandle& /*Supported*/, const FSLEntityHandle& /*Supporting*/, float /*Time*/, const uint64 /*PairId*/);
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FSLEndSupportedBySignature, const uint64 /*PairId1*/, const uint64 /*PairId2*/, float /*Time*/);
 
 /**
@@ -50,6 +54,9 @@ class ISLContactShapeInterface
 {
 	GENERATED_BODY()
 
+	// Sends back the started supported by events
+	friend class FSLSupportedByEvaluator;
+
 public:
 	// Initialize trigger area for runtime, check if outer is valid and semantically annotated
 	virtual void Init(bool bLogSupportedByEvents = true) = 0;
@@ -102,11 +109,11 @@ protected:
 	// Publish currently overlapping components
 	void TriggerInitialOverlaps();
 
-	// Start checking for supported by events
-	void StartSupportedByUpdateCheck();
+	// Add a supported by candidate to the evaluator
+	void AddSupportedByCandidate(const FSLContactResult& InContact);
 
-	// Check for supported by events
-	void SupportedByUpdateCheckBegin();
+	// Called by the evaluator with the started supported by events of this shape
+	void OnSupportedByBegin(const TArray<FSLSBBeginResult>& InResults);
 
 	// Check if Other is a supported by candidate
 	bool CheckAndRemoveIfJustCandidate(UObject* InOther);
@@ -127,14 +134,14 @@ protected:
 		UPrimitiveComponent* OtherComp,
 		int32 OtherBodyIndex);
 
-	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedOverlapEndEventCallback();
+	// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+	void DelayedOverlapEndEventCallback(UObject* InOther);
 
-	// Broadcast delayed overlaps, if curr time < 0, it guarantees a publish
-	bool PublishDelayedOverlapEndEvent(const FSLOverlapEndEvent& Ev, float CurrTime = -1.f);
+	// Broadcast delayed overlap end
+	void PublishDelayedOverlapEndEvent(const FSLOverlapEndEvent& Ev);
 
 	// Skip publishing overlap event if it can be concatenated with the current event start
-	bool SkipOverlapEndEventBroadcast(const FSLEntity& InItem, float StartTime);
+	bool SkipOverlapEndEventBroadcast(const FSLEntityHandle& InItem, float StartTime);
 	
 public:
 	// Event called when a semantic overlap begins / ends
@@ -171,32 +178,15 @@ protected:
 	UMeshComponent* OwnerMeshComp;
 
 	// Semantic data of the owner
-	FSLEntity SemanticOwner;
+	FSLEntityHandle SemanticOwner;
 
 	// Include supported by events
 	bool bLogSupportedByEvents;
 
-	// SupportedBy contact candidates
-	TArray<FSLContactResult> SBCandidates;
-	
-	// Supported by event update timer handle
-	FTimerHandle SBTimerHandle;
-
-	// Allow binding against non-UObject functions
-	FTimerDelegate SBTimerDelegate;
-
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle DelayTimerHandle;
-
-	// Can only bind the timer handle to UObjects or FTimerDelegates
-	FTimerDelegate DelayTimerDelegate;
-
-	// Array of recently ended overlaps
-	TArray<FSLOverlapEndEvent> RecentlyEndedOverlapEvents;
+	// Recently ended overlaps waiting on the timer wheel for a possible concatenation, indexed by the other object
+	TMap<UObject*, FSLOverlapEndEvent> RecentlyEndedOverlapEvents;
 
 	/* Constants */
 	constexpr static const char* TagTypeName = "SemLogColl";
-	constexpr static float SBUpdateRate = 0.11f;
-	constexpr static float SBMaxVertSpeed = 0.5f;
 	constexpr static float MaxOverlapEventTimeGap = 0.12f;
 };
\ No newline at end of file
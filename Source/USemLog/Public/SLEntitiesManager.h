@@ -4,6 +4,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "SLWorldInstances.h"
 #include "SLStructs.h"
 #include "SLSkeletalDataComponent.h"
 
@@ -23,11 +24,11 @@ public:
 	// Destructor
 	~FSLEntitiesManager() = default;
 
-	// Get singleton
-	static FSLEntitiesManager* GetInstance();
+	// Get the instance of the world (created on first use)
+	static FSLEntitiesManager* GetInstance(UWorld* World);
 
-	// Delete instance
-	static void DeleteInstance();
+	// Delete the instance of the world
+	static void DeleteInstance(UWorld* World);
 
 	// Init data / load Map
 	void Init(UWorld* World);
@@ -47,6 +48,15 @@ public:
 	// Try to add the given object as a semantic object (return false if the object is not properly annotated)
 	bool AddObject(UObject* Object);
 
+	// Register the annotated actor and components of an actor spawned at runtime (returns the number of added entities)
+	int32 AddActorEntities(AActor* Actor, TArray<FSLEntity>& OutNewEntities);
+
+	// Register an annotated component added at runtime
+	bool AddComponentEntity(UActorComponent* Component, FSLEntity& OutNewEntity);
+
+	// Unregister the destroyed actor and its components (returns the number of removed entities)
+	int32 RemoveActorEntities(AActor* Actor);
+
 	// Get semantic object structure, from object
 	FSLEntity GetEntity(UObject* Object) const;
 
@@ -56,6 +66,12 @@ public:
 	// Get semantic object structure, from object
 	bool GetEntity(UObject* Object, FSLEntity& OutEntity) const;
 
+	// Get the handle to the entity record of the object (invalid if the object is not annotated)
+	FSLEntityHandle GetEntityHandle(UObject* Object) const;
+
+	// Get the handle to the entity record of the object or, if not annotated, of its outer (cached, meant for the overlap callbacks)
+	FSLEntityHandle ResolveEntity(UObject* Object);
+
 	// Get semantic id from object
 	FString GetId(UObject* Object) const;
 
@@ -69,13 +85,13 @@ public:
 	bool GetValidAncestor(UObject* Object, UObject* OutAncestor = nullptr) const;
 
 	// Get the map of objects to the semantic items
-	TMap<UObject*, FSLEntity>& GetObjectsSemanticData() { return ObjectsSemanticData; }
+	TMap<UObject*, TSharedRef<FSLEntity>>& GetObjectsSemanticData() { return ObjectsSemanticData; }
 
 	// Get the array of semantically annotated objects (returns the number of keys)
 	int32 GetSemanticObjects(TArray<UObject*>& OutArray) const { return ObjectsSemanticData.GetKeys(OutArray); }
 
 	// Get the map of objects to the semantic items
-	void GetSemanticDataArray(TArray<FSLEntity>& OutArray) const { ObjectsSemanticData.GenerateValueArray(OutArray); }
+	void GetSemanticDataArray(TArray<FSLEntity>& OutArray) const;
 
 
 	// Get the map of objects to the semantic items
@@ -118,14 +134,24 @@ public:
 	};
 
 private:
-	// Instance of the singleton
-	static TSharedPtr<FSLEntitiesManager> StaticInstance;
+	// Parse the tags and add the object, only the resolve cache entry of the object is reset (true if added)
+	bool AddObjectIncremental(UObject* Object, FSLEntity& OutNewEntity);
+
+	// Remove the resolve cache entries of the destroyed objects and the ones resolving to the removed records
+	void PruneResolveCache(const TSet<const FSLEntity*>& RemovedEntities);
+
+private:
+	// Instance of every world
+	static TSLWorldInstances<FSLEntitiesManager> WorldInstances;
 
 	// Flag showing the data has been init
 	bool bIsInit;
 
-	// Map of UObject pointer to object structure
-	TMap<UObject*, FSLEntity> ObjectsSemanticData;
+	// Map of UObject pointer to object structure (shared records, the handles stay valid when the map grows)
+	TMap<UObject*, TSharedRef<FSLEntity>> ObjectsSemanticData;
+
+	// Resolved entities of the overlapping objects, including the outer fallback (misses are not cached)
+	TMap<TWeakObjectPtr<UObject>, FSLEntityHandle> ResolveCache;
 
 	// Map of UObject (Owner -- actor or component) to skeletal data component
 	TMap<UObject*, USLSkeletalDataComponent*> ObjectsSemanticSkeletalData;
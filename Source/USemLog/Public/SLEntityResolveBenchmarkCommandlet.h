@@ -0,0 +1,28 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLEntityResolveBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures the entity resolve of the overlapping objects (object map lookup with the outer fallback)
+ * without and with the resolve cache of the entities manager, and checks that both return the same
+ * entities before and after removing actors, usage:
+ * UE4Editor-Cmd <Project> -run=SLEntityResolveBenchmark [-actors=1000] [-comps=8] [-lookups=1000000] [-runs=3]
+ */
+UCLASS()
+class USEMLOG_API USLEntityResolveBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLEntityResolveBenchmarkCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+};
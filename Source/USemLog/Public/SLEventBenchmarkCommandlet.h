@@ -0,0 +1,27 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLEventBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures the event publishing throughput (creation, id generation and storage) of the
+ * heap allocated events against the pooled ones with pre-generated ids, usage:
+ * UE4Editor-Cmd <Project> -run=SLEventBenchmark [-num=200000] [-runs=3]
+ */
+UCLASS()
+class USEMLOG_API USLEventBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLEventBenchmarkCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+};
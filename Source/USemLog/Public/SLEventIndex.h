@@ -0,0 +1,162 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declaration
+class ISLEvent;
+
+/**
+* Indexed data of a finished event
+*/
+struct FSLEventIndexEntry
+{
+	// Unique id of the event
+	FString Id;
+
+	// Event type (owl class, e.g. GraspingSomething)
+	FName Type;
+
+	// Start and end time of the event
+	float Start = 0.f;
+	float End = 0.f;
+
+	// Ids of the involved entities
+	TArray<FString> EntityIds;
+
+	// Serialize the entry (the type as a string, plain file archives do not serialize names)
+	friend FArchive& operator<<(FArchive& Ar, FSLEventIndexEntry& Entry)
+	{
+		FString TypeStr = Entry.Type.ToString();
+		Ar << Entry.Id << TypeStr << Entry.Start << Entry.End << Entry.EntityIds;
+		if (Ar.IsLoading())
+		{
+			Entry.Type = FName(*TypeStr);
+		}
+		return Ar;
+	}
+};
+
+/**
+* Interval tree (AVL balanced, augmented with the max end time of the subtrees), supports incremental inserts
+*/
+class FSLEventIntervalTree
+{
+public:
+	// Insert the interval of the entry
+	void Insert(float Start, float End, int32 Entry);
+
+	// Entries of the intervals overlapping [T0, T1]
+	void Query(float T0, float T1, TArray<int32>& OutEntries) const;
+
+	// Number of intervals
+	int32 Num() const { return Nodes.Num(); };
+
+private:
+	// Tree node, children are indexes in the nodes array
+	struct FNode
+	{
+		float Start;
+		float End;
+		float MaxEnd;
+		int32 Entry;
+		int32 Left;
+		int32 Right;
+		int32 Height;
+	};
+
+	// Insert the node in the subtree, returns the new subtree root
+	int32 Insert(int32 Root, int32 NewIdx);
+
+	// Query the subtree
+	void Query(int32 Root, float T0, float T1, TArray<int32>& OutEntries) const;
+
+	// Height of the subtree
+	FORCEINLINE int32 GetHeight(int32 Idx) const { return Idx == INDEX_NONE ? 0 : Nodes[Idx].Height; }
+
+	// Recompute the height and max end of the node from its children
+	void Update(int32 Idx);
+
+	// Rotations, return the new subtree root
+	int32 RotateLeft(int32 Idx);
+	int32 RotateRight(int32 Idx);
+
+	// Restore the AVL balance of the node, returns the new subtree root
+	int32 Rebalance(int32 Idx);
+
+private:
+	// Nodes pool
+	TArray<FNode> Nodes;
+
+	// Root node index
+	int32 Root = INDEX_NONE;
+};
+
+/**
+ * Incrementally maintained temporal index of the finished events, one interval tree per event type
+ * and a postings list per entity; the queries are thread safe and can run while the events are being added,
+ * the index is written with the episode and can be loaded offline
+ */
+class USEMLOG_API FSLEventIndex
+{
+public:
+	// Add the finished event to the index
+	void Add(const ISLEvent& Event);
+
+	// Add the entry to the index
+	void Add(const FSLEventIndexEntry& Entry);
+
+	// Indexed data of the event (from its type name and entity ids, or from its owl representation if these are not implemented)
+	static FSLEventIndexEntry GetEntry(const ISLEvent& Event);
+
+	// Events overlapping [T0, T1], optionally filtered by type (NAME_None for all) and by an involved entity (empty for all)
+	void Query(float T0, float T1, FName Type, const FString& EntityId, TArray<FSLEventIndexEntry>& OutEvents) const;
+
+	// All the events involving the entity
+	void QueryEntity(const FString& EntityId, TArray<FSLEventIndexEntry>& OutEvents) const;
+
+	// Indexed event types
+	void GetTypes(TArray<FName>& OutTypes) const;
+
+	// Number of indexed events
+	int32 Num() const;
+
+	// Remove all the events
+	void Reset();
+
+	// Write the index entries to file
+	bool SaveToFile(const FString& Path) const;
+
+	// Load an index written with an episode
+	static TSharedPtr<FSLEventIndex, ESPMode::ThreadSafe> LoadFromFile(const FString& Path);
+
+	/* Constants */
+	// Index file header values
+	constexpr static uint32 FileMagic = 0x58454C53; // "SLEX"
+	constexpr static uint32 FileVersion = 2;
+
+private:
+	// Add the entry (write lock held)
+	void AddUnlocked(const FSLEventIndexEntry& Entry);
+
+	// True if the entry matches the query
+	FORCEINLINE bool Matches(const FSLEventIndexEntry& Entry, float T0, float T1, FName Type) const
+	{
+		return Entry.Start <= T1 && Entry.End >= T0 && (Type.IsNone() || Entry.Type == Type);
+	}
+
+private:
+	// Protects the data below
+	mutable FRWLock Lock;
+
+	// Indexed events
+	TArray<FSLEventIndexEntry> Entries;
+
+	// Interval tree of every event type
+	TMap<FName, FSLEventIntervalTree> TypeTrees;
+
+	// Entries of every entity (in the order they were added)
+	TMap<FString, TArray<int32>> EntityPostings;
+};
@@ -0,0 +1,29 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLEventIndexCheckCommandlet.generated.h"
+
+/**
+ * Fills the event index with random events (incrementally, in chunks) and compares the results of random
+ * interval queries (with and without type and entity filters) against a linear scan, reporting mismatches
+ * and the query times of both; the index is then saved and loaded back and checked against the original, usage:
+ * UE4Editor-Cmd <Project> -run=SLEventIndexCheck [-events=100000] [-chunks=10] [-queries=1000]
+ *	[-types=8] [-entities=200] [-duration=3600] [-seed=0]
+ */
+UCLASS()
+class USEMLOG_API USLEventIndexCheckCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLEventIndexCheckCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+};
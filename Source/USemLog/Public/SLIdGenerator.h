@@ -0,0 +1,83 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/AsyncWork.h"
+
+/**
+* Background task generating a batch of unique ids
+*/
+class FSLIdBatchWorker : public FNonAbandonableTask
+{
+	friend class FAsyncTask<FSLIdBatchWorker>;
+
+public:
+	// Generated ids
+	TArray<FString> Ids;
+
+	// Number of ids to generate
+	int32 BatchSize = 0;
+
+private:
+	// FAsyncTask - async work done here
+	void DoWork();
+
+	// Needed by unreal internally
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FSLIdBatchWorker, STATGROUP_ThreadPoolAsyncTasks);
+	}
+};
+
+/**
+ * Process wide source of unique ids (base64url encoded guids) for the events,
+ * the ids are generated in batches on a background thread, the next batch is prepared when half of the current one is used
+ */
+class USEMLOG_API FSLIdGenerator
+{
+private:
+	// Constructor
+	FSLIdGenerator();
+
+public:
+	// Destructor
+	~FSLIdGenerator();
+
+	// Get singleton
+	static FSLIdGenerator* GetInstance();
+
+	// Delete instance
+	static void DeleteInstance();
+
+	// Get a new unique id (thread safe)
+	FString NewId();
+
+private:
+	// Start generating the next batch
+	void RequestNextBatch();
+
+private:
+	// Instance of the singleton
+	static TUniquePtr<FSLIdGenerator> StaticInstance;
+
+	// Ids ready to be handed out
+	TArray<FString> ReadyIds;
+
+	// Index of the next id to hand out
+	int32 ReadyIdx;
+
+	// Generates the next batch
+	FAsyncTask<FSLIdBatchWorker>* BatchWorker;
+
+	// True if the worker was started and its batch not yet consumed
+	bool bIsBatchPending;
+
+	// Guards the ids
+	FCriticalSection Lock;
+
+	/* Constants */
+	// Number of ids generated at once
+	constexpr static int32 BatchSize = 4096;
+};
@@ -0,0 +1,27 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLImageStatsCommandlet.generated.h"
+
+/**
+ * Checks the vectorized image statistics kernels against their scalar versions on generated mask images
+ * and measures their speed, returns non zero if the results differ, usage:
+ * UE4Editor-Cmd <Project> -run=SLImageStats [-width=1920] [-height=1080] [-colors=8] [-runs=3]
+ */
+UCLASS()
+class USEMLOG_API USLImageStatsCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLImageStatsCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+};
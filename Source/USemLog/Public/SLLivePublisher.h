@@ -0,0 +1,410 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Containers/Queue.h"
+#include "SLEventIndex.h"
+
+class FSocket;
+class FRunnableThread;
+class FSLLivePublisher;
+
+/**
+* Message types of the live channel
+*/
+enum class ESLLiveMsgType : uint8
+{
+	// Publisher -> subscriber, poses of the entities which moved (ROS frame)
+	Poses = 1,
+
+	// Publisher -> subscriber, a finished event
+	Event = 2,
+
+	// Subscriber -> publisher, sets the topic filter of the subscriber
+	Subscribe = 3,
+
+	// Publisher -> subscriber, poses of all the entities of the episode (sent when subscribers connect), never dropped
+	Keyframe = 4
+};
+
+/**
+* Framing of the live channel (little endian, payload fields serialized as unreal archives,
+* strings are an int32 length including the terminator followed by the ANSI chars, negative lengths mean UTF-16):
+*	uint32 Size (bytes after this field)
+*	uint8  Type (ESLLiveMsgType)
+*	uint32 Seq (per subscriber, gaps are the frames dropped by the backpressure)
+*	double SendTime (FPlatformTime::Seconds() at publish, comparable between the processes of the host)
+*	FString Episode (episode id of the publishing world, several worlds can publish on the same channel; empty from subscribers)
+*	Payload:
+*		Poses:     float Timestamp, int32 Num, Num x (FString Id, float X Y Z, float QX QY QZ QW)
+*		Keyframe:  same as Poses
+*		Event:     FString Id, FString Type, float Start, float End, TArray<FString> EntityIds
+*		Subscribe: uint8 bPoses, uint8 bEvents, TArray<FString> EventTypes, TArray<FString> EntityIds,
+*		           TArray<FString> Episodes (empty = all)
+*/
+struct FSLLiveFrameHeader
+{
+	// Size of the fixed header fields after the size field (the episode id follows them)
+	constexpr static uint32 HeaderSize = sizeof(uint8) + sizeof(uint32) + sizeof(double);
+
+	// Max size of a frame sent by a subscriber
+	constexpr static uint32 MaxSubscribeSize = 1024 * 1024;
+};
+
+/**
+* Entity poses of a world state write
+*/
+struct FSLLivePoseFrame
+{
+	// World time of the poses
+	float Timestamp = 0.f;
+
+	// Entity ids
+	TArray<FString> Ids;
+
+	// Poses (ROS frame)
+	TArray<FVector> Locations;
+	TArray<FQuat> Quats;
+
+	// Number of poses
+	int32 Num() const { return Ids.Num(); };
+};
+
+/**
+* Topic filter of a subscriber
+*/
+struct FSLLiveTopicFilter
+{
+	// Receive the entity poses
+	bool bPoses = true;
+
+	// Receive the events
+	bool bEvents = true;
+
+	// Event types to receive (empty for all)
+	TSet<FString> EventTypes;
+
+	// Entities to receive the poses and events of (empty for all)
+	TSet<FString> EntityIds;
+
+	// Episodes to receive the poses and events of (empty for all)
+	TSet<FString> Episodes;
+
+	// Serialize the filter (payload of the subscribe message)
+	friend FArchive& operator<<(FArchive& Ar, FSLLiveTopicFilter& Filter)
+	{
+		uint8 bPosesByte = Filter.bPoses ? 1 : 0;
+		uint8 bEventsByte = Filter.bEvents ? 1 : 0;
+		Ar << bPosesByte << bEventsByte;
+		SerializeStringSet(Ar, Filter.EventTypes);
+		SerializeStringSet(Ar, Filter.EntityIds);
+		SerializeStringSet(Ar, Filter.Episodes);
+		if (Ar.IsLoading())
+		{
+			Filter.bPoses = bPosesByte != 0;
+			Filter.bEvents = bEventsByte != 0;
+		}
+		return Ar;
+	}
+
+	// Serialize the set as an array of strings, the loaded count is checked against the remaining bytes before allocating
+	static void SerializeStringSet(FArchive& Ar, TSet<FString>& Set)
+	{
+		if (!Ar.IsLoading())
+		{
+			TArray<FString> Values = Set.Array();
+			Ar << Values;
+			return;
+		}
+
+		// Every string takes at least its length field
+		int32 Num = 0;
+		Ar << Num;
+		if (Ar.IsError() || Num < 0 || (int64)Num * (int64)sizeof(int32) > Ar.TotalSize() - Ar.Tell())
+		{
+			Ar.SetError();
+			return;
+		}
+		Set.Empty(Num);
+		for (int32 Idx = 0; Idx < Num && !Ar.IsError(); ++Idx)
+		{
+			FString Value;
+			Ar << Value;
+			Set.Add(MoveTemp(Value));
+		}
+	}
+};
+
+/**
+* Publish statistics (of the whole channel or of a subscriber)
+*/
+struct FSLLivePublisherStats
+{
+	// Number of connected subscribers
+	int32 NumSubscribers = 0;
+
+	// Number of published messages
+	uint64 NumPublished = 0;
+
+	// Number of sent frames
+	uint64 NumSent = 0;
+
+	// Number of pose frames dropped by the backpressure
+	uint64 NumDropped = 0;
+
+	// Number of subscribers disconnected for not keeping up with the events
+	uint64 NumSlowDisconnects = 0;
+
+	// Sent bytes
+	uint64 SentBytes = 0;
+
+	// Get result as string
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("Subscribers:%d Published:%llu Sent:%llu Dropped:%llu SlowDisconnects:%llu SentData:%.2fMB"),
+			NumSubscribers, NumPublished, NumSent, NumDropped, NumSlowDisconnects, SentBytes / (1024.0 * 1024.0));
+	}
+};
+
+/**
+* Sender thread of the live publisher, accepts the subscribers and sends them the published messages
+*/
+class FSLLivePublisherRunnable : public FRunnable
+{
+public:
+	// Ctor
+	FSLLivePublisherRunnable(FSLLivePublisher* InPublisher) : Publisher(InPublisher), bStop(false) {};
+
+	/** Begin FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override { bStop = true; };
+	/** End FRunnable interface */
+
+private:
+	// Owner publisher
+	FSLLivePublisher* Publisher;
+
+	// Set when the thread should exit
+	FThreadSafeBool bStop;
+};
+
+/**
+ * Plugin wide live publisher, streams the world state poses and the finished events to the subscribers
+ * connected to a local tcp socket; every subscriber has its own topic filter and outgoing queue,
+ * slow subscribers lose their oldest pose frames (a keyframe is requested to restore them) and are disconnected
+ * if they cannot keep up with the events; the frames are tagged with the episode of the publishing world,
+ * the channel is shared by the managers of all the worlds (started by the first one, stopped by the last one)
+ */
+class USEMLOG_API FSLLivePublisher
+{
+	// Give the sender thread access to the queues and the subscribers
+	friend class FSLLivePublisherRunnable;
+
+private:
+	// Constructor
+	FSLLivePublisher();
+
+public:
+	// Destructor
+	~FSLLivePublisher();
+
+	// Get singleton
+	static FSLLivePublisher* GetInstance();
+
+	// Delete instance (stops the channel)
+	static void DeleteInstance();
+
+	// Listen on the local port and start the sender thread (true if it is listening, or it already is on the same port),
+	// every successful start has to be paired with a stop
+	bool Start(uint16 InPort);
+
+	// Release a start, the last one sends the queued messages, closes the subscribers and stops the sender thread
+	void Stop();
+
+	// True if the channel is listening
+	bool IsRunning() const { return bIsRunning; };
+
+	// Publish the poses of the episode, keyframes hold all its entities (any thread)
+	void PublishPoses(const FString& InEpisode, TSharedPtr<FSLLivePoseFrame, ESPMode::ThreadSafe> InPoses, bool bKeyframe = false);
+
+	// Publish the finished event of the episode (any thread)
+	void PublishEvent(const FString& InEpisode, const FSLEventIndexEntry& InEvent);
+
+	// Incremented when a subscriber connects, changes its filter or loses pose frames, the publishers send a keyframe when it changes (any thread)
+	int32 GetKeyframeGeneration() const { return KeyframeGeneration.GetValue(); };
+
+	// Get the channel stats
+	FSLLivePublisherStats GetStats() const;
+
+private:
+	/**
+	* Published message, serialized once per subscriber filter
+	*/
+	struct FMessage
+	{
+		// Type of the message
+		ESLLiveMsgType Type;
+
+		// Time of the publish
+		double SendTime;
+
+		// Episode of the publishing world
+		FString Episode;
+
+		// Poses (pose messages)
+		TSharedPtr<FSLLivePoseFrame, ESPMode::ThreadSafe> Poses;
+
+		// Event (event messages)
+		TSharedPtr<FSLEventIndexEntry, ESPMode::ThreadSafe> Event;
+	};
+
+	/**
+	* Frame waiting to be sent to a subscriber
+	*/
+	struct FOutFrame
+	{
+		// Header and payload
+		TArray<uint8> Data;
+
+		// Already sent bytes
+		int32 NumSent = 0;
+
+		// Pose frames can be dropped by the backpressure
+		bool bDroppable = false;
+	};
+
+	/**
+	* Connected subscriber
+	*/
+	struct FSubscriber
+	{
+		// Connection
+		FSocket* Socket = nullptr;
+
+		// Topic filter, every topic until the subscriber sends its own
+		FSLLiveTopicFilter Filter;
+
+		// Frames waiting to be sent, in publish order
+		TArray<FOutFrame> OutFrames;
+
+		// Bytes waiting to be sent
+		int32 PendingBytes = 0;
+
+		// Received bytes of the incomplete subscriber frames
+		TArray<uint8> InBuffer;
+
+		// Sequence number of the next frame
+		uint32 NextSeq = 0;
+
+		// Set if the subscriber should be disconnected
+		bool bClose = false;
+
+		// Set if pose frames were dropped and no keyframe was queued since
+		bool bKeyframeRequested = false;
+
+		// Send stats
+		FSLLivePublisherStats Stats;
+	};
+
+	// Called by the sender thread, returns true if there was any work done
+	bool Tick();
+
+	// Accept the pending connections
+	bool AcceptSubscribers();
+
+	// Read the subscribe messages, false if the subscriber disconnected
+	bool ReceiveFromSubscriber(FSubscriber& Subscriber);
+
+	// Add the message to the queues of the subscribers it passes the filter of
+	void Dispatch(const FMessage& Message);
+
+	// True if the message (or a part of it) passes the filter
+	static bool PassesFilter(const FMessage& Message, const FSLLiveTopicFilter& Filter);
+
+	// Serialize the message payload, the poses are restricted to the given entities (all if empty)
+	static void EncodePayload(const FMessage& Message, const TSet<FString>& EntityIds, TArray<uint8>& OutPayload);
+
+	// Add the frame with the payload to the queue of the subscriber
+	void AddFrame(FSubscriber& Subscriber, const FMessage& Message, const TArray<uint8>& Payload);
+
+	// Update the stats snapshot from the ones of the subscribers
+	void UpdateStats();
+
+	// Drop the oldest pose frames of a slow subscriber (and request a keyframe), false if it is too far behind with the events
+	bool ApplyBackpressure(FSubscriber& Subscriber);
+
+	// Send the queued frames, false if the subscriber disconnected
+	bool SendToSubscriber(FSubscriber& Subscriber);
+
+	// Close the subscriber connection
+	void CloseSubscriber(FSubscriber& Subscriber);
+
+	// Send the queued messages, close the subscribers and stop the sender thread (regardless of the starts)
+	void Shutdown();
+
+private:
+	// Instance of the singleton
+	static TSharedPtr<FSLLivePublisher> StaticInstance;
+
+	// Set while listening
+	FThreadSafeBool bIsRunning;
+
+	// Listened port
+	uint16 Port;
+
+	// Number of starts not yet stopped (game thread)
+	int32 NumStarts;
+
+	// Requests a keyframe from the publishers
+	FThreadSafeCounter KeyframeGeneration;
+
+	// Listening socket
+	FSocket* Listener;
+
+	// Published messages (poses from the world state worker, events from the game thread)
+	TQueue<FMessage, EQueueMode::Mpsc> Messages;
+
+	// Connected subscribers (sender thread only)
+	TArray<FSubscriber> Subscribers;
+
+	// Stats of the closed subscribers (sender thread only)
+	FSLLivePublisherStats ClosedStats;
+
+	// Protects the stats snapshot
+	mutable FCriticalSection StatsLock;
+
+	// Stats of the channel, including the ones of the closed subscribers
+	FSLLivePublisherStats Stats;
+
+	// Number of published messages
+	FThreadSafeCounter64 NumPublished;
+
+	// Signaled on new messages
+	FEvent* WorkEvent;
+
+	// Sender thread
+	FSLLivePublisherRunnable* Sender;
+	FRunnableThread* SenderThread;
+
+	/* Constants */
+	// Pending bytes of a subscriber from which its oldest pose frames are dropped
+	constexpr static int32 MaxPendingBytes = 4 * 1024 * 1024;
+
+	// Pending bytes of a subscriber (events only) from which it is disconnected
+	constexpr static int32 MaxPendingEventBytes = 16 * 1024 * 1024;
+
+	// Max number of subscribers
+	constexpr static int32 MaxSubscribers = 16;
+
+	// Max wait (ms) of the sender thread between the checks for new connections and subscriber messages
+	constexpr static uint32 MaxWaitMs = 5;
+
+	// Max time (s) for sending the queued frames when stopping
+	constexpr static double FlushTimeout = 1.0;
+};
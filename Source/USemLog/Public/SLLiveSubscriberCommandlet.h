@@ -0,0 +1,28 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLLiveSubscriberCommandlet.generated.h"
+
+/**
+ * Test subscriber of the live publisher, receives the published frames and reports the
+ * end-to-end latency (publish to receive) and the frames dropped by the backpressure, usage:
+ * UE4Editor-Cmd <Project> -run=SLLiveSubscriber [-port=9595] [-num=10000] [-timeout=60]
+ *	[-types=GraspingSomething,TouchingSituation] [-entities=Id1,Id2] [-episodes=Ep1,Ep2] [-noposes] [-noevents]
+ */
+UCLASS()
+class USEMLOG_API USLLiveSubscriberCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLLiveSubscriberCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+};
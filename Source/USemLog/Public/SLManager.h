@@ -68,6 +68,12 @@ public:
 	// Get episode id
 	FString GetEpisodeId() const { return EpisodeId; };
 
+	// Register an actor whose semantic tags were set after it was spawned (spawned actors are registered automatically)
+	bool RegisterActor(AActor* Actor);
+
+	// Register an annotated component added at runtime to an existing actor
+	bool RegisterComponent(UActorComponent* Component);
+
 private:
 	// Setup user input bindings
 	void SetupInputBindings();
@@ -78,6 +84,19 @@ private:
 	// Call finish from user input
 	void FinishFromInput();
 
+	// Hook the actor spawn and destroy callbacks, the entities are registered incrementally during the episode
+	void StartEntityRegistration();
+
+	// Remove the actor spawn and destroy callbacks
+	void FinishEntityRegistration();
+
+	// Called when an actor is spawned in the world
+	void OnActorSpawned(AActor* Actor);
+
+	// Called when a registered actor is destroyed
+	UFUNCTION()
+	void OnEntityActorDestroyed(AActor* DestroyedActor);
+
 private:
 	// Set when manager is initialized
 	bool bIsInit;
@@ -88,6 +107,12 @@ private:
 	// Set when manager is finished
 	bool bIsFinished;
 
+	// Set if the live publisher was started by the manager (it is shared by the managers of all the worlds)
+	bool bLivePublisherStarted;
+
+	// Handle of the actor spawned callback
+	FDelegateHandle ActorSpawnedHandle;
+
 	/* Semantic logger */
 	// Log directory (or the database name if saving to mongodb)
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bUseCustomTaskId"))
@@ -170,6 +195,18 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Metadata Logger", meta = (editcondition = "bScanItems"))
 	bool bIncludeScansLocally;
 
+	// Number of scans rendered in one frame with scene captures (0 - one screenshot at a time)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Metadata Logger", meta = (editcondition = "bScanItems"), meta = (ClampMin = 0))
+	int32 ScanBatchSize;
+
+	// Reuse the scans of unchanged items (content hash of mesh, materials and scan settings), resumes interrupted scans
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Metadata Logger", meta = (editcondition = "bScanItems"))
+	bool bUseScanCache;
+
+	// Max size of the scan images waiting to be uploaded to gridfs before the scanning is paused (MB)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Metadata Logger", meta = (editcondition = "bScanItems"), meta = (ClampMin = 1))
+	int32 ScanUploadBudgetMB;
+
 	// Overwrite existing entries
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Metadata Logger", meta = (editcondition = "bLogMetadata"))
 	bool bOverwriteMetadata;
@@ -193,6 +230,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"), meta = (ClampMin = 0))
 	float UpdateRate;
 
+	// Write the world state at exact multiples of the update rate by interpolating the poses between frames
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"))
+	bool bFixedRateSampling;
+
 	// Distance (cm) threshold difference for logging a given item
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"), meta = (ClampMin = 0))
 	float LinearDistance;
@@ -205,6 +246,18 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"))
 	ESLWorldStateWriterType WriterType;
 
+	// Max number of samples per entity bucket document (MongoCBuckets writer)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"), meta = (ClampMin = 1))
+	int32 BucketMaxSamples;
+
+	// Max time span (s) of an entity bucket document (MongoCBuckets writer)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"), meta = (ClampMin = 0))
+	float BucketMaxDuration;
+
+	// Let the server do the bucketing using a time series collection (MongoCBuckets writer, requires MongoDB 5.0+)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|World State Logger", meta = (editcondition = "bLogWorldState"))
+	bool bUseTimeSeriesCollection;
+
 	// World state logger, use UPROPERTY to avoid GC
 	UPROPERTY()
 	USLWorldStateLogger* WorldStateLogger;
@@ -240,6 +293,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Event Data Logger", meta = (editcondition = "bLogEventData"))
 	bool bWriteTimelines;
 
+	// Write the binary trace of the event listeners (decode with -run=SLTraceDecode)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Event Data Logger", meta = (editcondition = "bLogEventData"))
+	bool bWriteEventTrace;
+
 	// Includes the related events in the episode (TODO)
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Event Data Logger", meta = (editcondition = "bLogEventData"))
 	bool bWriteEpisodeMetadata;
@@ -271,4 +328,15 @@ private:
 	UPROPERTY()
 	USLVisionLogger* VisionDataLogger;
 	/* End vision data logger properties */
+
+
+	/* Begin live publisher properties */
+	// Publish the world state poses and the finished events to the local subscribers while logging
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bPublishLive;
+
+	// Local tcp port of the live publisher (test subscriber: -run=SLLiveSubscriber)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Live Publisher", meta = (editcondition = "bPublishLive"), meta = (ClampMin = 0, ClampMax = 65535))
+	uint16 LivePublishPort;
+	/* End live publisher properties */
 };
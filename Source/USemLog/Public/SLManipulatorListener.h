@@ -8,6 +8,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "SLStructs.h" // FSLEntity
 #include "TimerManager.h"
+#include "SLTimerWheel.h"
 #include "SLManipulatorListener.generated.h"
 
 /**
@@ -37,6 +38,9 @@ struct FSLGraspEndEvent
 
 	// End time of the event 
 	float Time;
+
+	// Delayed publish timer
+	FSLTimerWheelHandle TimerHandle;
 };
 
 /**
@@ -56,6 +60,9 @@ struct FSLContactEndEvent
 
 	// End time of the event 
 	float Time;
+
+	// Delayed publish timer
+	FSLTimerWheelHandle TimerHandle;
 };
 
 /** Notify when an object is grasped and released*/
@@ -145,8 +152,8 @@ private:
 	// A grasp has ended
 	void EndGrasp(AActor* Other);
 
-	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedGraspEndEventCallback();
+	// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+	void DelayedGraspEndEventCallback(AActor* OtherActor);
 
 	// Check if this begin event happened right after the previous one ended
 	// if so remove it from the array, and cancel publishing the begin event
@@ -162,8 +169,8 @@ private:
 	UFUNCTION()
 	void OnEndOverlapContact(AActor* OtherActor);
 
-	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedContactEndEventCallback();
+	// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+	void DelayedContactEndEventCallback(UObject* OtherObj);
 
 	// Check if this begin event happened right after the previous one ended
 	// if so remove it from the array, and cancel publishing the begin event
@@ -240,11 +247,8 @@ private:
 	// Active grasp type
 	FString ActiveGraspType;
 	
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle GraspDelayTimerHandle;
-
-	// Array of recently ended events
-	TArray<FSLGraspEndEvent> RecentlyEndedGraspEvents;
+	// Recently ended events waiting on the timer wheel for a possible concatenation, indexed by the other actor
+	TMap<AActor*, FSLGraspEndEvent> RecentlyEndedGraspEvents;
 
 
 	/* Contact related */
@@ -257,11 +261,8 @@ private:
 	// Objects currently in contact and the number of shapes in contact with. Used of semantic contact detection
 	TMap<AActor*, int32> ObjectsInContact;
 
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle ContactDelayTimerHandle;
-
-	// Array of recently ended events
-	TArray<FSLContactEndEvent> RecentlyEndedContactEvents;
+	// Recently ended events waiting on the timer wheel for a possible concatenation, indexed by the other object
+	TMap<UObject*, FSLContactEndEvent> RecentlyEndedContactEvents;
 	
 
 	/* Constants */
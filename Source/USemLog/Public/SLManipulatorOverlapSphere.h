@@ -7,6 +7,7 @@
 #include "Components/SphereComponent.h"
 #include "Engine/StaticMeshActor.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "SLTimerWheel.h"
 #include "SLManipulatorOverlapSphere.generated.h"
 
 /**
@@ -36,6 +37,9 @@ struct FSLManipulatorOverlapEndEvent
 
 	// End time of the event 
 	float Time;
+
+	// Delayed publish timer
+	FSLTimerWheelHandle TimerHandle;
 };
 
 /** Delegate to notify that a contact begins between the grasp overlap and an item**/
@@ -118,8 +122,8 @@ private:
 		UPrimitiveComponent* OtherComp,
 		int32 OtherBodyIndex);
 
-	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedGraspOverlapEndEventCallback();
+	// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+	void DelayedGraspOverlapEndEventCallback(AActor* OtherActor);
 
 	// Check if this begin event happened right after the previous one ended
 	// if so remove it from the array, and cancel publishing the begin event
@@ -145,8 +149,8 @@ private:
 		UPrimitiveComponent* OtherComp,
 		int32 OtherBodyIndex);
 
-	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedContactOverlapEndEventCallback();
+	// Delayed call of sending the finished event, called by the timer wheel if no concatenation happened
+	void DelayedContactOverlapEndEventCallback(AActor* OtherActor);
 
 	// Check if this begin event happened right after the previous one ended
 	// if so remove it from the array, and cancel publishing the begin event
@@ -210,18 +214,12 @@ private:
 	TArray<AStaticMeshActor*> IgnoreList;
 
 
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle GraspDelayTimerHandle;
-
-	// Array of recently ended events
-	TArray<FSLManipulatorOverlapEndEvent> RecentlyEndedGraspOverlapEvents;
+	// Recently ended events waiting on the timer wheel for a possible concatenation, indexed by the other actor
+	TMap<AActor*, FSLManipulatorOverlapEndEvent> RecentlyEndedGraspOverlapEvents;
 	
 	
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle ContactDelayTimerHandle;
-
-	// Array of recently ended events
-	TArray<FSLManipulatorOverlapEndEvent> RecentlyEndedContactOverlapEvents;
+	// Recently ended events waiting on the timer wheel for a possible concatenation, indexed by the other actor
+	TMap<AActor*, FSLManipulatorOverlapEndEvent> RecentlyEndedContactOverlapEvents;
 	
 
 	/* Constants */
@@ -6,6 +6,7 @@
 #include "USemLog.h"
 #include "UObject/NoExportTypes.h"
 #include "SLItemScanner.h"
+#include "SLScanUploader.h"
 #if SL_WITH_LIBMONGO_C
 THIRD_PARTY_INCLUDES_START
 #if PLATFORM_WINDOWS
@@ -39,7 +40,8 @@ public:
 	
 	// Init logger
 	void Init(const FString& InTaskId, const FString InServerIp, uint16 InServerPort,
-		bool bScanItems, FIntPoint Resolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally,  bool bOverwrite = false);
+		bool bScanItems, FIntPoint Resolution, const TSet<ESLItemScannerViewMode>& InViewModes, bool bIncludeScansLocally,  bool bOverwrite = false, int32 ScanBatchSize = 0, bool bUseScanCache = false,
+		int32 ScanUploadBudgetMB = 64);
 
 	// Start logger
 	void Start(const FString& InTaskDescription);
@@ -63,13 +65,13 @@ private:
 	// Disconnect and clean db connection
 	void Disconnect();
 
-	// Create the scan entry bson document
-	void StartScanEntry(/*Class..*/);
+	// Create the scan entry bson document of the item (index and class) seen from the scan pose
+	void StartScanEntry(int32 ItemIdx, const FString& Class, int32 PoseIdx);
 	
-	// Add image to gridfs and the oid to the array doc
+	// Queue the image for the gridfs upload, its file id is added to the scan entry once uploaded
 	void AddImageEntry(const FString& ViewType, const TArray<uint8>& CompressedBitmap);
 
-	// Write the document to the database
+	// Close the scan entry, written once all its images are uploaded
 	void WriteScanEntry();
 	
 	//// Add a scan entry to the database
@@ -78,9 +80,6 @@ private:
 	//	const FVector& SphereIndex,
 	//	FIntPoint Resolution);
 	
-	// Add image to gridfs
-	void AddToGridFs(const FString& ViewModeName, const TArray<uint8>& CompressedBitmap);
-
 #if SL_WITH_LIBMONGO_C
 	// Write the task description
 	void AddTaskDescription(const FString& InTaskDescription, bson_t* in_doc);
@@ -109,29 +108,26 @@ private:
 	UPROPERTY() // Avoid GC
 	USLItemScanner* ItemsScanner;
 
-#if SL_WITH_LIBMONGO_C
-	// Server uri
-	mongoc_uri_t* uri;
-
-	// MongoC connection client
-	mongoc_client_t* client;
+	// Database name (task id)
+	FString DatabaseName;
 
-	// Database to access
-	mongoc_database_t* database;
+	// Metadata collection name
+	FString MetaCollName;
 
-	// Database collection
-	mongoc_collection_t* collection;
+	// Uploads the scan images in the background and writes the scan entries
+	TUniquePtr<FSLScanUploader> ScanUploader;
 
-	// Insert scans binaries
-	mongoc_gridfs_t* gridfs;
+#if SL_WITH_LIBMONGO_C
+	// Pooled client, kept for the gridfs handle
+	mongoc_client_t* client = nullptr;
 
-	// Scan entry doc
-	bson_t* scan_doc;
+	// Database to access
+	mongoc_database_t* database = nullptr;
 
-	// Image scans array doc
-	bson_t* scan_img_arr_doc;
+	// Database collection
+	mongoc_collection_t* collection = nullptr;
 
-	// Image scan array doc index
-	uint32_t img_arr_idx;
+	// Insert scans binaries (used by the scan uploader thread)
+	mongoc_gridfs_t* gridfs = nullptr;
 #endif //SL_WITH_LIBMONGO_C
 };
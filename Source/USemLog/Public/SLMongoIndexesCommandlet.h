@@ -0,0 +1,31 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLMongoIndexesCommandlet.generated.h"
+
+/**
+ * Builds the indexes of already logged episodes in parallel, usage:
+ * UE4Editor-Cmd <Project> -run=SLMongoIndexes -db=<TaskId> [-colls=<Ep1,Ep2,..> | -all]
+ *	[-type=ws|buckets|timeseries] [-keys=<f0,f1+f2,..>] [-parallel=4] [-ip=127.0.0.1] [-port=27017]
+ */
+UCLASS()
+class USEMLOG_API USLMongoIndexesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLMongoIndexesCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+
+private:
+	// Get the names of all the episode collections of the database
+	bool GetEpisodeCollections(const FString& DBName, TArray<FString>& OutCollNames) const;
+};
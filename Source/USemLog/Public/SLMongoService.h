@@ -0,0 +1,383 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Async/AsyncWork.h"
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+	#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+	#else
+	#include <mongoc/mongoc.h>
+	#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+class FRunnableThread;
+class FSLMongoService;
+
+/**
+* Write statistics of the mongo service (or of one of its collection queues)
+*/
+struct FSLMongoServiceStats
+{
+	// Documents currently waiting to be written
+	int32 QueueDepth = 0;
+
+	// Highest number of documents that waited to be written
+	int32 MaxQueueDepth = 0;
+
+	// Number of submitted documents
+	uint64 NumSubmitted = 0;
+
+	// Number of written documents
+	uint64 NumWritten = 0;
+
+	// Number of documents that could not be written after all the retries
+	uint64 NumFailed = 0;
+
+	// Number of retried batches
+	uint64 NumRetries = 0;
+
+	// Sum of the latencies (s) from submission to written
+	double TotalLatency = 0.0;
+
+	// Max latency (s) from submission to written
+	double MaxLatency = 0.0;
+
+	// Average latency (s) from submission to written
+	double GetAvgLatency() const { return NumWritten > 0 ? TotalLatency / NumWritten : 0.0; }
+
+	// Add the values of the other stats
+	void Append(const FSLMongoServiceStats& Other)
+	{
+		QueueDepth += Other.QueueDepth;
+		MaxQueueDepth = FMath::Max(MaxQueueDepth, Other.MaxQueueDepth);
+		NumSubmitted += Other.NumSubmitted;
+		NumWritten += Other.NumWritten;
+		NumFailed += Other.NumFailed;
+		NumRetries += Other.NumRetries;
+		TotalLatency += Other.TotalLatency;
+		MaxLatency = FMath::Max(MaxLatency, Other.MaxLatency);
+	}
+
+	// Get result as string
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("QueueDepth:%d MaxQueueDepth:%d Submitted:%llu Written:%llu Failed:%llu Retries:%llu AvgLatency:%.2fms MaxLatency:%.2fms"),
+			QueueDepth, MaxQueueDepth, NumSubmitted, NumWritten, NumFailed, NumRetries,
+			GetAvgLatency() * 1000.0, MaxLatency * 1000.0);
+	}
+};
+
+/**
+* State of a background index build
+*/
+enum class ESLMongoIndexJobState : uint8
+{
+	None,
+	Pending,
+	Building,
+	Done,
+	Failed
+};
+
+/**
+* Status of the index build of a collection
+*/
+struct FSLMongoIndexJobStatus
+{
+	// Database name
+	FString DBName;
+
+	// Collection name
+	FString CollName;
+
+	// Indexes to build, the fields of compound indexes are joined with '+' (e.g. "id+t_start")
+	TArray<FString> Keys;
+
+	// Current state
+	ESLMongoIndexJobState State = ESLMongoIndexJobState::None;
+
+	// Time when the job was queued
+	double SubmitTime = 0.0;
+
+	// Time when the build started
+	double StartTime = 0.0;
+
+	// Time when the build finished
+	double EndTime = 0.0;
+
+	// Error message of failed builds
+	FString Error;
+
+	// True if the build is done or failed
+	bool IsFinished() const { return State == ESLMongoIndexJobState::Done || State == ESLMongoIndexJobState::Failed; }
+
+	// Get result as string
+	FString ToString() const
+	{
+		static const TCHAR* StateNames[] = { TEXT("None"), TEXT("Pending"), TEXT("Building"), TEXT("Done"), TEXT("Failed") };
+		const double Duration = IsFinished() ? EndTime - StartTime : 0.0;
+		return FString::Printf(TEXT("%s.%s State:%s Indexes:[%s] Duration:%.2fs%s%s"),
+			*DBName, *CollName, StateNames[(uint8)State], *FString::Join(Keys, TEXT(",")), Duration,
+			Error.IsEmpty() ? TEXT("") : TEXT(" Err.:"), *Error);
+	}
+};
+
+/**
+* Writer thread of the mongo service, drains the collection queues
+*/
+class FSLMongoWriterRunnable : public FRunnable
+{
+public:
+	// Ctor
+	FSLMongoWriterRunnable(FSLMongoService* InService) : Service(InService), bStop(false) {};
+
+	/** Begin FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override { bStop = true; };
+	/** End FRunnable interface */
+
+private:
+	// Owner service
+	FSLMongoService* Service;
+
+	// Set when the thread should exit
+	FThreadSafeBool bStop;
+};
+
+/**
+* Background index build of a collection, runs on the thread pool
+*/
+class FSLMongoIndexBuildTask : public FNonAbandonableTask
+{
+	friend class FAutoDeleteAsyncTask<FSLMongoIndexBuildTask>;
+
+public:
+	// Ctor
+	FSLMongoIndexBuildTask(FSLMongoService* InService, const FString& InNamespace) : Service(InService), Namespace(InNamespace) {};
+
+	// Build the indexes
+	void DoWork();
+
+	// Needed by the engine to track the tasks
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FSLMongoIndexBuildTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+private:
+	// Owner service
+	FSLMongoService* Service;
+
+	// Key of the job (db.coll)
+	FString Namespace;
+};
+
+/**
+ * Plugin wide mongo service, owns the client pool and the writer threads,
+ * the loggers submit their documents to per-collection queues which are written asynchronously
+ */
+class USEMLOG_API FSLMongoService
+{
+	// Give the writer threads access to the queues
+	friend class FSLMongoWriterRunnable;
+
+	// Give the index builds access to the jobs
+	friend class FSLMongoIndexBuildTask;
+
+private:
+	// Constructor
+	FSLMongoService();
+
+public:
+	// Destructor
+	~FSLMongoService();
+
+	// Get singleton
+	static FSLMongoService* GetInstance();
+
+	// Delete instance (waits for the queues to drain)
+	static void DeleteInstance();
+
+	// Initialize libmongoc once for the plugin (the vision writers included), call before any mongo use
+	static void InitDriver();
+
+	// Clean up libmongoc, call once nothing uses it anymore
+	static void CleanupDriver();
+
+	// Create the client pool and the writer threads (true if the server is reachable, or it is already connected to it)
+	bool Connect(const FString& ServerIp, uint16 ServerPort);
+
+	// Drain the queues, stop the writer threads and destroy the client pool
+	void Disconnect();
+
+	// True if the client pool is created
+	bool IsConnected() const;
+
+	// Block until all the submitted documents are written
+	void Drain();
+
+	// Get the stats of all the collections
+	FSLMongoServiceStats GetStats() const;
+
+	// Get the stats of the given collection
+	FSLMongoServiceStats GetStats(const FString& DBName, const FString& CollName) const;
+
+	// Create the indexes and wait for the result, cheap on empty collections (declare them before the first insert)
+	bool CreateIndexes(const FString& DBName, const FString& CollName, const TArray<FString>& Keys, FString* OutError = nullptr);
+
+	// Queue an index build which runs in the background, nobody waits on it
+	void BuildIndexesAsync(const FString& DBName, const FString& CollName, const TArray<FString>& Keys);
+
+	// Max number of index builds running in parallel
+	void SetMaxParallelIndexBuilds(int32 InNum);
+
+	// Get the status of the index build of the collection
+	FSLMongoIndexJobStatus GetIndexJobStatus(const FString& DBName, const FString& CollName) const;
+
+	// Get the status of all the index builds
+	TArray<FSLMongoIndexJobStatus> GetIndexJobs() const;
+
+	// Get the number of finished, failed and total index builds
+	void GetIndexJobsProgress(int32& OutNumFinished, int32& OutNumFailed, int32& OutNumTotal) const;
+
+#if SL_WITH_LIBMONGO_C
+	// Get a client from the pool for synchronous operations (needs to be pushed back)
+	mongoc_client_t* PopClient();
+
+	// Return the client to the pool
+	void PushClient(mongoc_client_t* InClient);
+
+	// Queue the document for writing, the service takes ownership of the document
+	void Submit(const FString& DBName, const FString& CollName, bson_t* doc);
+#endif //SL_WITH_LIBMONGO_C
+
+private:
+#if SL_WITH_LIBMONGO_C
+	/**
+	* Document waiting to be written
+	*/
+	struct FWriteRequest
+	{
+		// The document (owned)
+		bson_t* doc;
+
+		// Time of the submission
+		double SubmitTime;
+	};
+
+	/**
+	* Documents waiting to be written to a collection
+	*/
+	struct FCollectionQueue
+	{
+		// Database name
+		FString DBName;
+
+		// Collection name
+		FString CollName;
+
+		// Documents in submission order
+		TArray<FWriteRequest> Pending;
+
+		// Set while a writer is processing a batch of the queue (keeps the insertion order)
+		bool bInProgress = false;
+
+		// Write stats
+		FSLMongoServiceStats Stats;
+	};
+
+	// Called by the writer threads, writes the next available batch, false if there was nothing to write
+	bool ProcessNextBatch();
+
+	// Insert the batch, retry on failures, return the number of retries
+	int32 WriteBatch(mongoc_client_t* InClient, const FString& DBName, const FString& CollName,
+		const TArray<FWriteRequest>& Batch, bool& bOutSuccess);
+
+	// Run the createIndexes command with the given client
+	bool WriteIndexes(mongoc_client_t* InClient, const FString& DBName, const FString& CollName,
+		const TArray<FString>& Keys, FString& OutError);
+#endif //SL_WITH_LIBMONGO_C
+
+	// Called by the index build tasks
+	void RunIndexJob(const FString& Namespace);
+
+	// Start pending jobs while there are free build slots (call with the jobs lock held)
+	void StartPendingIndexJobs();
+
+	// Cancel the pending jobs and wait for the running ones
+	void WaitForIndexJobs();
+
+private:
+	// Instance of the singleton
+	static TSharedPtr<FSLMongoService> StaticInstance;
+
+	// Set if libmongoc is initialized
+	static bool bIsDriverInit;
+
+	// Set when the pool is created
+	bool bIsConnected;
+
+	// Guards the connection state, the pool is created and destroyed with the lock held
+	mutable FCriticalSection ConnectionLock;
+
+	// Connected uri
+	FString ConnectedUri;
+
+	// Protects the queues
+	mutable FCriticalSection QueuesLock;
+
+#if SL_WITH_LIBMONGO_C
+	// Queues indexed by the db.coll namespace
+	TMap<FString, TSharedPtr<FCollectionQueue>> Queues;
+
+	// Server uri
+	mongoc_uri_t* uri;
+
+	// Thread safe client pool
+	mongoc_client_pool_t* pool;
+#endif //SL_WITH_LIBMONGO_C
+
+	// Protects the index jobs
+	mutable FCriticalSection IndexJobsLock;
+
+	// Index builds indexed by the db.coll namespace
+	TMap<FString, FSLMongoIndexJobStatus> IndexJobs;
+
+	// Number of index builds currently running
+	int32 NumRunningIndexJobs;
+
+	// Max number of index builds running in parallel
+	int32 MaxParallelIndexBuilds;
+
+	// Queue to start the search for work from (round robin over the collections)
+	int32 NextQueueIdx;
+
+	// Signaled on new submissions
+	FEvent* WorkEvent;
+
+	// Writer threads
+	TArray<FSLMongoWriterRunnable*> Writers;
+	TArray<FRunnableThread*> WriterThreads;
+
+	/* Constants */
+	// Number of writer threads
+	constexpr static int32 NumWriters = 2;
+
+	// Max documents inserted with one insert_many
+	constexpr static int32 MaxBatchSize = 256;
+
+	// Max tries for writing a batch
+	constexpr static int32 MaxRetries = 3;
+
+	// Max number of clients in the pool
+	constexpr static int32 MaxPoolSize = 16;
+};
@@ -40,6 +40,138 @@ public:
 	float StartTime;
 };
 
+/**
+ * Fixed capacity ring buffer of the recent locations of a moved object,
+ * with a monotonic queue of the highest samples for sliding window height queries
+ * (the memory is allocated once, nothing is allocated while adding samples)
+ */
+struct FSLPaPMovementBuffer
+{
+public:
+	// Allocate the buffers
+	void Init(int32 InCapacity)
+	{
+		Capacity = InCapacity;
+		Times.SetNumUninitialized(Capacity);
+		Locations.SetNumUninitialized(Capacity);
+		MaxQueue.SetNumUninitialized(Capacity);
+		Reset();
+	}
+
+	// Clear the samples, keep the memory
+	void Reset()
+	{
+		FirstSeq = 0;
+		EndSeq = 0;
+		MaxFirst = 0;
+		MaxEnd = 0;
+	}
+
+	// Number of samples
+	int32 Num() const { return (int32)(EndSeq - FirstSeq); };
+
+	// Sequence number of the oldest sample
+	uint32 GetFirstSeq() const { return FirstSeq; };
+
+	// Time of the sample
+	float GetTime(uint32 Seq) const { return Times[Seq % Capacity]; };
+
+	// Location of the sample
+	const FVector& GetLocation(uint32 Seq) const { return Locations[Seq % Capacity]; };
+
+	// Add the sample, drop the ones older than the given duration (or the oldest if the buffer is full)
+	void Add(float Time, const FVector& Location, float MaxDuration)
+	{
+		if (Num() == Capacity)
+		{
+			FirstSeq++;
+			DropRemovedFromMaxQueue();
+		}
+
+		Times[EndSeq % Capacity] = Time;
+		Locations[EndSeq % Capacity] = Location;
+
+		// Lower samples can never be the highest of a window again
+		while (MaxEnd != MaxFirst && GetLocation(MaxQueue[(MaxEnd - 1) % Capacity]).Z <= Location.Z)
+		{
+			MaxEnd--;
+		}
+		MaxQueue[MaxEnd % Capacity] = EndSeq;
+		MaxEnd++;
+		EndSeq++;
+
+		while (Num() > 1 && Time - GetTime(FirstSeq) > MaxDuration)
+		{
+			FirstSeq++;
+		}
+		DropRemovedFromMaxQueue();
+	}
+
+	// Find the newest sample in the last window duration which is higher than the given height
+	bool FindNewestAbove(float CurrTime, float WindowDuration, float MinZ, uint32& OutSeq)
+	{
+		// Samples leaving the window are not needed anymore, the time only advances
+		while (MaxEnd != MaxFirst && CurrTime - GetTime(MaxQueue[MaxFirst % Capacity]) >= WindowDuration)
+		{
+			MaxFirst++;
+		}
+
+		// The queue front is the highest sample of the window
+		if (MaxEnd == MaxFirst || GetLocation(MaxQueue[MaxFirst % Capacity]).Z <= MinZ)
+		{
+			return false;
+		}
+
+		// The heights are strictly decreasing in the queue, binary search the last one above the limit
+		uint32 Lo = MaxFirst;
+		uint32 Hi = MaxEnd - 1;
+		while (Lo < Hi)
+		{
+			const uint32 Mid = Lo + (Hi - Lo + 1) / 2;
+			if (GetLocation(MaxQueue[Mid % Capacity]).Z > MinZ)
+			{
+				Lo = Mid;
+			}
+			else
+			{
+				Hi = Mid - 1;
+			}
+		}
+		OutSeq = MaxQueue[Lo % Capacity];
+		return true;
+	}
+
+private:
+	// Drop the queued samples which are not in the buffer anymore
+	void DropRemovedFromMaxQueue()
+	{
+		while (MaxEnd != MaxFirst && MaxQueue[MaxFirst % Capacity] < FirstSeq)
+		{
+			MaxFirst++;
+		}
+	}
+
+	// Max number of samples
+	int32 Capacity = 0;
+
+	// Sample times
+	TArray<float> Times;
+
+	// Sample locations
+	TArray<FVector> Locations;
+
+	// Sequence numbers of the samples with decreasing heights (monotonic queue)
+	TArray<uint32> MaxQueue;
+
+	// Sequence number of the oldest and after the newest sample
+	uint32 FirstSeq = 0;
+	uint32 EndSeq = 0;
+
+	// Positions of the first and after the last element of the monotonic queue
+	uint32 MaxFirst = 0;
+	uint32 MaxEnd = 0;
+};
+
 /** Notify the beginning and the end of the pick and place related events */
 DECLARE_MULTICAST_DELEGATE_FourParams(FSLPaPSubEventSignature, const FSLEntity& /*Self*/, AActor* /*Other*/, float /*StartTime*/, float /*EndTime*/);
 
@@ -95,8 +227,8 @@ private:
 	// Object released, terminate active even
 	void FinishActiveEvent();
 
-	// Backtrace and check if a put-down event happened
-	bool HasPutDownEventHappened(const float CurrTime,const FVector& CurrObjLocation,  uint32& OutPutDownEndIdx);
+	// Check if a put-down event happened, returns the newest sample where the object was still above the put-down height
+	bool HasPutDownEventHappened(const float CurrTime,const FVector& CurrObjLocation,  uint32& OutPutDownEndSeq);
 
 	// State update functions
 	void Update_NONE();
@@ -158,7 +290,7 @@ private:
 
 	/* PutDown related */
 	// Past locations and time during transport in order to backtrace and detect put-down events
-	TArray<TPair<float, FVector>> RecentMovementBuffer;
+	FSLPaPMovementBuffer RecentMovementBuffer;
 
 	/* Constants */
 	constexpr static float UpdateRate = 0.05f;
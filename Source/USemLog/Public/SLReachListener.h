@@ -7,6 +7,7 @@
 #include "Components/SphereComponent.h"
 #include "SLStructs.h"
 #include "Engine/StaticMeshActor.h"
+#include "SLTimerWheel.h"
 #include "SLReachListener.generated.h"
 
 /**
@@ -26,6 +27,9 @@ struct FSLPreGraspEndEvent
 
 	// End time of the event 
 	float Time;
+
+	// Delayed reset timer
+	FSLTimerWheelHandle TimerHandle;
 };
 
 // Convenience enum
@@ -131,12 +135,15 @@ private:
 	// Manipulator is not in contact with object anymore, check for possible concatenation, or reset the potential reach time
 	void OnSLManipulatorContactEnd(const FSLEntity& Self, const FSLEntity& Other, float Time);
 	
-	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedManipulatorContactEndEventCallback();
+	// Delayed call of resetting the reach time, called by the timer wheel if no concatenation happened
+	void DelayedManipulatorContactEndEventCallback(AStaticMeshActor* Other);
 
 	// Check if this begin event happened right after the previous one ended, if so remove it from the array, and cancel publishing the begin event
 	bool SkipRecentManipulatorContactEndEventTime(AStaticMeshActor* Other, float StartTime);
 
+	// Cancel all the delayed reach time resets
+	void CancelRecentManipulatorContactEndEvents();
+
 public:
 	// Event called when the reaching motion is finished
 	FSLPreGraspAndReachEventSignature OnPreGraspAndReachEvent;
@@ -169,11 +176,8 @@ private:
 	// Pause everything if the hand is currently grasping something
 	AActor* CurrGraspedObj;
 
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle ManipulatorContactDelayTimerHandle;
-
-	// Array of recently ended events
-	TArray<FSLPreGraspEndEvent> RecentlyEndedManipulatorContactEvents;
+	// Recently ended events waiting on the timer wheel for a possible concatenation, indexed by the other actor
+	TMap<AStaticMeshActor*, FSLPreGraspEndEvent> RecentlyEndedManipulatorContactEvents;
 	
 	/* Constants */
 	constexpr static float MinDist = 2.5f;
@@ -0,0 +1,149 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Containers/Queue.h"
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+	#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+	#else
+	#include <mongoc/mongoc.h>
+	#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+class FRunnableThread;
+
+/**
+ * Background upload queue of the scan images, the images are written in chunks to gridfs on a dedicated thread,
+ * the scan documents (with the file ids of their images) are submitted to the mongo service once their uploads finished,
+ * the game thread only blocks if the bytes waiting to be uploaded exceed the in-flight budget
+ */
+class FSLScanUploader : public FRunnable
+{
+public:
+	// Ctor
+	FSLScanUploader();
+
+	// Dtor, waits for the pending uploads
+	~FSLScanUploader();
+
+#if SL_WITH_LIBMONGO_C
+	// Start the upload thread, the gridfs handle is used exclusively by the thread until finished
+	bool Start(mongoc_gridfs_t* InGridFS, const FString& InDBName, const FString& InCollName, int64 InMaxInFlightBytes);
+#endif //SL_WITH_LIBMONGO_C
+
+	// Upload the remaining images, write the remaining documents and stop the thread
+	void Finish();
+
+	// Start a new scan document of the item (index and class) seen from the scan pose
+	void BeginEntry(int32 ItemIdx, const FString& Class, int32 PoseIdx);
+
+	// Queue the image for upload, its file id is added to the current scan document
+	void AddImage(const FString& ViewType, const TArray<uint8>& CompressedBitmap);
+
+	// Close the current scan document, it is written once its images are uploaded
+	void EndEntry();
+
+	// Bytes waiting to be uploaded
+	int64 GetInFlightBytes() const { return InFlightBytes.GetValue(); };
+
+	/** Begin FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override { bStop = true; };
+	/** End FRunnable interface */
+
+private:
+	/**
+	* Work item of the upload thread, processed in order
+	*/
+	struct FUploadJob
+	{
+		enum class EType : uint8
+		{
+			BeginEntry,
+			Image,
+			EndEntry
+		};
+
+		// Job type
+		EType Type = EType::Image;
+
+		// View type of the image
+		FString ViewType;
+
+		// Class of the scanned item (begin entry)
+		FString Class;
+
+		// Scanned item and pose (begin entry)
+		int32 ItemIdx = INDEX_NONE;
+		int32 PoseIdx = INDEX_NONE;
+
+		// Compressed image
+		TArray<uint8> Data;
+	};
+
+	// Process the job on the upload thread
+	void ProcessJob(FUploadJob& Job);
+
+#if SL_WITH_LIBMONGO_C
+	// Write the data to gridfs in chunks, return the file id
+	bool UploadImage(const TArray<uint8>& Data, bson_oid_t* out_oid);
+#endif //SL_WITH_LIBMONGO_C
+
+private:
+	// Jobs pushed by the game thread
+	TQueue<FUploadJob, EQueueMode::Spsc> Jobs;
+
+	// Bytes queued and not yet uploaded
+	FThreadSafeCounter64 InFlightBytes;
+
+	// Max bytes waiting to be uploaded before the game thread blocks
+	int64 MaxInFlightBytes;
+
+	// Signaled on new jobs
+	FEvent* WorkEvent;
+
+	// Signaled when an upload finished
+	FEvent* UploadedEvent;
+
+	// Upload thread
+	FRunnableThread* Thread;
+
+	// Set when the thread should exit (after the queue is empty)
+	FThreadSafeBool bStop;
+
+	// Database and collection of the scan documents
+	FString DBName;
+	FString CollName;
+
+	// Number of uploaded and failed images (upload thread)
+	int32 NumUploaded;
+	int32 NumFailed;
+
+#if SL_WITH_LIBMONGO_C
+	// Gridfs handle (upload thread)
+	mongoc_gridfs_t* gridfs;
+
+	// Current scan document (upload thread)
+	bson_t* scan_doc;
+
+	// Images array of the current scan document
+	bson_t img_arr;
+
+	// Index of the next image in the array
+	uint32_t img_arr_idx;
+#endif //SL_WITH_LIBMONGO_C
+
+	/* Constants */
+	// Size of the writes to gridfs, also used as gridfs chunk size
+	constexpr static uint32 UploadChunkSize = 255 * 1024;
+};
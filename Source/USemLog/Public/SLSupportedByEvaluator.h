@@ -0,0 +1,140 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SLWorldInstances.h"
+#include "Tickable.h"
+#include "SLStructs.h"
+
+class ISLContactShapeInterface;
+
+/**
+* Supported by candidate, contact between the owner of a shape and another mesh
+*/
+struct FSLSBCandidate
+{
+	// Shape which will be notified
+	ISLContactShapeInterface* Shape;
+
+	// Used to check that the shape is still alive
+	TWeakObjectPtr<UObject> ShapeObj;
+
+	// The contact data
+	FSLContactResult Contact;
+
+	// Index of the self mesh in the cached mesh data (set every update)
+	int32 SelfIdx;
+
+	// Index of the other mesh in the cached mesh data (set every update)
+	int32 OtherIdx;
+};
+
+/**
+* Candidate which turned into a supported by event
+*/
+struct FSLSBBeginResult
+{
+	// Supported entity
+	FSLEntityHandle Supported;
+
+	// Supporting entity
+	FSLEntityHandle Supporting;
+
+	// Pair id of the event
+	uint64 PairId;
+
+	// True if the shape owner is the supported entity
+	bool bSelfIsSupported;
+};
+
+/**
+ * Evaluates the supported by candidates of all the contact shapes in a single pass,
+ * instead of a timer per shape, the started events are sent back to the shapes in batches
+ */
+class USEMLOG_API FSLSupportedByEvaluator : public FTickableGameObject
+{
+private:
+	// Constructor
+	FSLSupportedByEvaluator(UWorld* InWorld);
+
+public:
+	// Destructor
+	~FSLSupportedByEvaluator() = default;
+
+	// Get the instance of the world (created on first use)
+	static FSLSupportedByEvaluator* GetInstance(UWorld* World);
+
+	// Delete the instance of the world
+	static void DeleteInstance(UWorld* World);
+
+	// Add a candidate of the shape
+	void AddCandidate(ISLContactShapeInterface* Shape, UObject* ShapeObj, const FSLContactResult& Contact);
+
+	// Remove the candidate of the shape with the other object, false if there was none
+	bool RemoveCandidate(ISLContactShapeInterface* Shape, UObject* Other);
+
+	// Remove all the candidates of the shape
+	void RemoveShape(ISLContactShapeInterface* Shape);
+
+	// Evaluate large candidate sets on multiple threads
+	void SetParallelEvaluation(bool bInParallel) { bParallel = bInParallel; };
+
+	// Number of pending candidates
+	int32 GetNumCandidates() const { return Candidates.Num(); };
+
+	/** Begin FTickableGameObject interface */
+	// Called after ticking all actors, DeltaTime is the time passed since the last call.
+	virtual void Tick(float DeltaTime) override;
+
+	// Return if object is ready to be ticked
+	virtual bool IsTickable() const override;
+
+	// Return the stat id to use for this tickable
+	virtual TStatId GetStatId() const override;
+
+	// Return the world the tickable belongs to (ticked with the world, skipped while it is paused)
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	/** End FTickableGameObject interface */
+
+private:
+	// Check all the candidates and notify the shapes
+	void Evaluate();
+
+	// Read the velocity and height of the mesh once per update, returns its cache index
+	int32 CacheMeshData(UMeshComponent* Mesh);
+
+private:
+	// Instance of every world
+	static TSLWorldInstances<FSLSupportedByEvaluator> WorldInstances;
+
+	// Owning world
+	TWeakObjectPtr<UWorld> World;
+
+	// Candidates of all the shapes
+	TArray<FSLSBCandidate> Candidates;
+
+	// Cache index of the meshes of the current update
+	TMap<UMeshComponent*, int32> MeshIndexes;
+
+	// Cached vertical velocities of the meshes
+	TArray<float> MeshVelZ;
+
+	// Cached heights of the meshes
+	TArray<float> MeshLocZ;
+
+	// Evaluation results of the current update
+	TArray<uint8> Results;
+
+	// Time passed since the last evaluation
+	float TimeSinceUpdate;
+
+	// Evaluate on multiple threads
+	bool bParallel;
+
+	/* Constants */
+	constexpr static float UpdateRate = 0.11f;
+	constexpr static float MaxVertSpeed = 0.5f;
+	constexpr static int32 MinParallelNum = 512;
+};
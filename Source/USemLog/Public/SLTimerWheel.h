@@ -0,0 +1,157 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SLWorldInstances.h"
+#include "Tickable.h"
+
+/**
+* Handle of a scheduled timer, invalid once the timer fired or was cancelled
+*/
+struct FSLTimerWheelHandle
+{
+	// Index of the timer node
+	int32 Index = INDEX_NONE;
+
+	// Generation of the node when the timer was scheduled
+	uint32 Generation = 0;
+
+	// True if it was set by a schedule call
+	bool IsSet() const { return Index != INDEX_NONE; };
+
+	// Forget the timer
+	void Invalidate() { Index = INDEX_NONE; Generation = 0; };
+};
+
+/**
+ * Hierarchical timer wheel for deadline based "publish unless cancelled" callbacks (delayed event concatenation),
+ * constant time schedule and cancel, all the expired timers are collected and fired once per tick
+ */
+class USEMLOG_API FSLTimerWheel : public FTickableGameObject
+{
+private:
+	// Constructor
+	FSLTimerWheel(UWorld* InWorld);
+
+public:
+	// Destructor
+	~FSLTimerWheel() = default;
+
+	// Get the instance of the world (created on first use)
+	static FSLTimerWheel* GetInstance(UWorld* World);
+
+	// Delete the instance of the world (pending timers are dropped without firing)
+	static void DeleteInstance(UWorld* World);
+
+	// Fire the callback after the delay, unless cancelled; if an owner is given, the callback is skipped if the owner is gone
+	FSLTimerWheelHandle Schedule(float Delay, TFunction<void()>&& Callback, const UObject* Owner = nullptr);
+
+	// Remove the timer without firing it, false if it already fired or was cancelled (the handle is invalidated)
+	bool Cancel(FSLTimerWheelHandle& Handle);
+
+	// True if the timer is still waiting to fire
+	bool IsPending(const FSLTimerWheelHandle& Handle) const;
+
+	// Number of waiting timers
+	int32 GetNumPending() const { return NumPending; };
+
+	/** Begin FTickableGameObject interface */
+	// Called after ticking all actors, DeltaTime is the time passed since the last call.
+	virtual void Tick(float DeltaTime) override;
+
+	// Return if object is ready to be ticked
+	virtual bool IsTickable() const override;
+
+	// Return the stat id to use for this tickable
+	virtual TStatId GetStatId() const override;
+
+	// Return the world the tickable belongs to (ticked with the world, skipped while it is paused)
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	/** End FTickableGameObject interface */
+
+private:
+	/**
+	* Scheduled timer, linked in the list of its slot
+	*/
+	struct FTimerNode
+	{
+		// Callback to fire
+		TFunction<void()> Callback;
+
+		// Skip the callback if the owner is gone
+		TWeakObjectPtr<const UObject> Owner;
+
+		// True if an owner was given
+		bool bHasOwner;
+
+		// Tick when the timer expires
+		uint64 ExpireTick;
+
+		// Slot list links (or the next free node)
+		int32 Prev;
+		int32 Next;
+
+		// Slot the node is linked into (INDEX_NONE if free)
+		int32 Slot;
+
+		// Incremented every time the node is released, invalidates old handles
+		uint32 Generation;
+	};
+
+	// Link the node in the slot matching its expire tick
+	void Insert(int32 NodeIdx);
+
+	// Unlink the node from its slot
+	void Unlink(int32 NodeIdx);
+
+	// Give the node back to the free list
+	void Release(int32 NodeIdx);
+
+	// Move the timers of the slot of the given level down the hierarchy
+	void Cascade(int32 Level);
+
+	// Advance the wheel one tick and collect the expired timers
+	void Step();
+
+private:
+	// Instance of every world
+	static TSLWorldInstances<FSLTimerWheel> WorldInstances;
+
+	// Owning world
+	TWeakObjectPtr<UWorld> World;
+
+	// Timer nodes (pooled)
+	TArray<FTimerNode> Nodes;
+
+	// Head of the free nodes list
+	int32 FreeHead;
+
+	// Head node of every slot list, level after level
+	TArray<int32> SlotHeads;
+
+	// Current tick of the wheel
+	uint64 CurrTick;
+
+	// Time not yet consumed by a full tick
+	float TimeAccumulator;
+
+	// Number of waiting timers
+	int32 NumPending;
+
+	// Timers expired in the current tick, fired after the wheel advanced
+	TArray<int32> Expired;
+
+	/* Constants */
+	// Time span of a tick
+	constexpr static float TickResolution = 0.01f;
+
+	// Slots per level (power of two)
+	constexpr static int32 SlotBits = 6;
+	constexpr static int32 NumSlots = 1 << SlotBits;
+	constexpr static uint64 SlotMask = NumSlots - 1;
+
+	// Number of levels, each level spans NumSlots times the previous one (~46h in total)
+	constexpr static int32 NumLevels = 4;
+};
@@ -0,0 +1,135 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/* Trace categories (bit flags) */
+#define SL_TRACE_CAT_GRASP		0x01
+#define SL_TRACE_CAT_CONTACT	0x02
+#define SL_TRACE_CAT_PAP		0x04
+#define SL_TRACE_CAT_REACH		0x08
+#define SL_TRACE_CAT_ALL		0xFF
+
+// Categories compiled in, can be set from the build rules (SL_TRACE_CATEGORIES=0 compiles out all the traces)
+#ifndef SL_TRACE_CATEGORIES
+#define SL_TRACE_CATEGORIES SL_TRACE_CAT_ALL
+#endif // SL_TRACE_CATEGORIES
+
+// Record a trace, the arguments are not evaluated if the category is compiled out
+// e.g. SL_TRACE(SL_TRACE_CAT_PAP, ESLTraceEvent::PaPLiftOff, Time, Obj, nullptr, Height);
+#define SL_TRACE(Category, Type, Time, ...) \
+	do { if ((SL_TRACE_CATEGORIES & (Category)) != 0) { FSLTrace::Record((Category), (Type), (Time), ##__VA_ARGS__); } } while (0)
+
+/**
+* Traced event types (stored in the records, only append new values)
+*/
+enum class ESLTraceEvent : uint16
+{
+	None = 0,
+
+	/* Grasp */
+	GraspBegin,
+	GraspEnd,
+	GraspConcatenated,
+	ManipulatorContactBegin,
+	ManipulatorContactEnd,
+	ManipulatorContactConcatenated,
+
+	/* Contact */
+	ContactBegin,
+	ContactEnd,
+	ContactConcatenated,
+
+	/* Pick and place */
+	PaPUnexpectedState,
+	PaPSupportedByBegin,
+	PaPSupportedByEnd,
+	PaPLiftOff,
+	PaPSkipPickUp,
+	PaPSlide,
+	PaPPickUp,
+	PaPTransport,
+	PaPPutDown,
+	PaPPutDownLimitsNotCrossed,
+
+	/* Reach */
+	ReachCandidateAdded,
+	ReachCandidateRemoved,
+	ReachContactReset,
+	ReachPreGraspAndReach,
+
+	Num
+};
+
+/**
+* Fixed size trace record (32 bytes), written to the dump files as is
+*/
+struct FSLTraceRecord
+{
+	// World time of the event
+	float Time;
+
+	// Event type (ESLTraceEvent)
+	uint16 Type;
+
+	// Trace category (SL_TRACE_CAT_*), in memory the high byte holds the slot of the traced world
+	uint16 Category;
+
+	// Id of the thread which wrote the record
+	uint32 ThreadId;
+
+	// Unique ids of the involved objects (0 if unset)
+	uint32 Entity1;
+	uint32 Entity2;
+
+	// Event specific values (distances, heights, start times, ..)
+	float Values[3];
+};
+static_assert(sizeof(FSLTraceRecord) == 32, "FSLTraceRecord is expected to be 32 bytes");
+
+/**
+ * Structured binary trace of the event listeners, a cheaper alternative to logging in the hot paths,
+ * every thread writes to its own lock free ring buffer, the rings are merged and dumped to a file at the end of the episode,
+ * the records are tagged with the world of the first entity so that concurrent episodes are dumped separately
+ */
+class USEMLOG_API FSLTrace
+{
+public:
+	// Append the record to the ring of the calling thread (use the SL_TRACE macro)
+	static void Record(uint16 Category, ESLTraceEvent Type, float Time,
+		const UObject* Entity1 = nullptr, const UObject* Entity2 = nullptr,
+		float Value0 = 0.f, float Value1 = 0.f, float Value2 = 0.f);
+
+	// Start tracing the world, its previous records are forgotten (call before starting a new episode)
+	static void Reset(UWorld* World);
+
+	// Merge the records of the world sorted by time and write them to file together with the names of the traced entities
+	// (the rings are released if no other world is traced)
+	static bool DumpToFile(UWorld* World, const FString& Path);
+
+	// Free the rings of all the threads, the threads register new ones with their next record (e.g. at module shutdown)
+	static void ReleaseRings();
+
+	// Read a dump file and convert the records to text lines (offline decoder)
+	static bool Decode(const FString& Path, TArray<FString>& OutLines);
+
+	// Name of the event type
+	static const TCHAR* GetEventName(uint16 Type);
+
+	// Name of the category
+	static const TCHAR* GetCategoryName(uint16 Category);
+
+	/* Constants */
+	// Max number of records kept per thread (power of two), older records are overwritten
+	constexpr static uint32 RingCapacity = 1 << 15;
+
+	// Dump file header values
+	constexpr static uint32 FileMagic = 0x52544C53; // "SLTR"
+	constexpr static uint32 FileVersion = 1;
+
+private:
+	// Get the trace slot of the world of the entity (0 if the world is not traced)
+	static uint8 GetWorldSlot(const UObject* Entity);
+};
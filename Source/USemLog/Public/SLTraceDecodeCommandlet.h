@@ -0,0 +1,26 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLTraceDecodeCommandlet.generated.h"
+
+/**
+ * Converts a binary event trace dump to csv, usage:
+ * UE4Editor-Cmd <Project> -run=SLTraceDecode -in=<Episode_TR.bin> [-out=<Episode_TR.csv>]
+ */
+UCLASS()
+class USEMLOG_API USLTraceDecodeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLTraceDecodeCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+};
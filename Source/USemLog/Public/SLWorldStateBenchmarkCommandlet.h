@@ -0,0 +1,34 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "USemLog.h"
+#include "Commandlets/Commandlet.h"
+#include "SLWorldStateBenchmarkCommandlet.generated.h"
+
+/**
+ * Writes the same synthetic episode (moving entities in a transient world) with the per-tick mongo schema,
+ * the entity buckets and optionally the time series collection, then compares the write times and the
+ * latency of random per-entity trajectory queries, usage:
+ * UE4Editor-Cmd <Project> -run=SLWorldStateBenchmark [-db=SLBenchmark] [-entities=200] [-samples=3000]
+ *	[-rate=60] [-queries=200] [-window=5] [-timeseries] [-ip=127.0.0.1] [-port=27017]
+ */
+UCLASS()
+class USEMLOG_API USLWorldStateBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLWorldStateBenchmarkCommandlet();
+
+	/** Begin UCommandlet interface */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet interface */
+
+private:
+	// Number of samples of the entity in [T0, T1] read with the trajectory query of the schema, -1 on errors
+	int32 QueryTrajectory(const FString& DBName, const FString& CollName, const FString& Schema,
+		const FString& Id, float T0, float T1) const;
+};
@@ -41,10 +41,14 @@ public class USemLog : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"RenderCore", // Scan render target readback
+				"RHI",
 				"Slate",
 				"SlateCore",
 				"Json",
 				"JsonUtilities",
+				"Sockets", // Live publisher
+				"Networking", // Live publisher
 				"UTags",
 				"UIds",
 				"UConversions",
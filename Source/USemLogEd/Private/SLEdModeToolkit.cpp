@@ -16,6 +16,7 @@
 #include "SLSemanticMapWriter.h"
 #include "SLContactBox.h"
 #include "SLSkeletalDataComponent.h"
+#include "SLVisMaskLattice.h"
 #include "Ids.h"
 #include "Tags.h"
 #include "ScopedTransaction.h"
@@ -26,7 +27,7 @@
 // Ctor
 FSLEdModeToolkit::FSLEdModeToolkit()
 {
-	bOverwriteSemanticMap = true;
+	bOverwriteSemanticMap = false;
 	bOverwriteExistingClassNames = true;
 	bOverwriteVisualMaskValues = true;
 	bGenerateRandomVisualMasks = true;
@@ -57,8 +58,8 @@ void FSLEdModeToolkit::Init(const TSharedPtr<IToolkitHost>& InitToolkitHost)
 						+ SHorizontalBox::Slot()
 							[
 								SNew(SCheckBox)
-								.ToolTipText(LOCTEXT("GenSemMap_Overwrite", "Overwrite"))
-								.IsChecked(ECheckBoxState::Checked)
+								.ToolTipText(LOCTEXT("GenSemMap_Overwrite", "Full regeneration(checked) / Update changed individuals(unchecked)"))
+								.IsChecked(ECheckBoxState::Unchecked)
 								.OnCheckStateChanged(this, &FSLEdModeToolkit::OnCheckedOverwriteSemanticMap)
 							]
 					]
@@ -237,11 +238,9 @@ FReply FSLEdModeToolkit::GenerateSemanticMap()
 	// Create writer
 	FSLSemanticMapWriter SemMapWriter;
 
-	// TODO use bOverwriteSemanticMap
-
-	// Generate map and write to file
+	// Generate map and write to file (overwrite regenerates every individual, otherwise only the changed ones are rebuilt)
 	SemMapWriter.WriteToFile(GEditor->GetEditorWorldContext().World(),
-		ESLOwlSemanticMapTemplate::IAIKitchen, TEXT("SemLog"), TEXT("SemanticMap"));
+		ESLOwlSemanticMapTemplate::IAIKitchen, TEXT("SemLog"), TEXT("SemanticMap"), !bOverwriteSemanticMap);
 
 	return FReply::Handled();
 }
@@ -393,49 +392,56 @@ FReply FSLEdModeToolkit::GenerateVisualMasks()
 	}
 }
 
-// Set unique mask colors in hex for the entities (use random colors)
+// Set unique mask colors in hex for the entities (use the mask color lattice, consecutive colors are far apart)
 FReply FSLEdModeToolkit::GenerateVisualMasksRand()
 {
-	// Lambda for generating unique colors as hex string
-	auto GenerateUniqueColorLambda = [](const uint8 Tolerance, const int32 NrOfTrials, TArray<FColor>& ConsumedColors)->FString
+	FSLVisMaskLattice Lattice(SLVIS_SEM_TOL);
+	int32 NumAssigned = 0;
+	int32 NumUnassigned = 0;
+
+	// Lambda for allocating unique colors as hex string
+	auto AllocateColorLambda = [&Lattice, &NumAssigned, &NumUnassigned]()->FString
 	{
-		// Iterate generating a random color until it is unique (and differs from black)
-		for (int32 Idx = 0; Idx < NrOfTrials; ++Idx)
+		FColor MaskColor;
+		if (Lattice.Allocate(MaskColor))
 		{
-			FColor RandColor = FColor::MakeRandomColor();
-			// Find by predicate lambda
-			auto AlmostEqualPredicate = [RandColor, Tolerance](const FColor& Item)
-			{
-				return FMath::Abs(RandColor.R - Item.R) <= Tolerance
-					&& FMath::Abs(RandColor.G - Item.G) <= Tolerance
-					&& FMath::Abs(RandColor.B - Item.B) <= Tolerance;
-			};
+			NumAssigned++;
+			return MaskColor.ToHex();
+		}
+		NumUnassigned++;
+		return FColor::Black.ToHex();
+	};
 
-			// Continue if the random color is not similar to black
-			if (!AlmostEqualPredicate(FColor::Black))
+	// Keep the existing values, their colors are reserved before allocating new ones
+	if (!bOverwriteVisualMaskValues)
+	{
+		for (TActorIterator<AStaticMeshActor> ActItr(GEditor->GetEditorWorldContext().World()); ActItr; ++ActItr)
+		{
+			if (UStaticMeshComponent* SMC = ActItr->GetStaticMeshComponent())
 			{
-				// Cache image if there is no other similar stored
-				if (FColor* SemColor = ConsumedColors.FindByPredicate(AlmostEqualPredicate))
+				const FString ActHex = FTags::GetValue(*ActItr, "SemLog", "VisMask");
+				const FString CompHex = FTags::GetValue(SMC, "SemLog", "VisMask");
+				if (!ActHex.IsEmpty())
 				{
-					// Conflict
-					//UE_LOG(LogTemp, Warning, TEXT("\t\t\t%s::%d Conflict between RandColor=%s; and SemColor=%s; Trial=%d"),
-					//	*FString(__func__), __LINE__, *RandColor.ToString(), *SemColor->ToString(), Idx);
+					Lattice.Add(FColor::FromHex(ActHex));
 				}
-				else
+				if (!CompHex.IsEmpty())
 				{
-					// Different color found
-					ConsumedColors.Emplace(RandColor);
-					return RandColor.ToHex();
+					Lattice.Add(FColor::FromHex(CompHex));
 				}
 			}
 		}
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not generate a unique color, saving as black.."), *FString(__func__), __LINE__);
-		return FColor::Black.ToHex();
-	};
-
-	const uint8 Tolerance = 27;
-	const int32 NrOfTrials = 1000;
-	TArray<FColor> ConsumedColors;
+		for (TObjectIterator<USLSkeletalDataComponent> ObjItr; ObjItr; ++ObjItr)
+		{
+			for (const auto& Pair : ObjItr->SemanticBonesData)
+			{
+				if (Pair.Value.IsSet() && !Pair.Value.VisualMask.IsEmpty())
+				{
+					Lattice.Add(FColor::FromHex(Pair.Value.VisualMask));
+				}
+			}
+		}
+	}
 
 	// Iterate only static mesh actors
 	for (TActorIterator<AStaticMeshActor> ActItr(GEditor->GetEditorWorldContext().World()); ActItr; ++ActItr)
@@ -443,23 +449,20 @@ FReply FSLEdModeToolkit::GenerateVisualMasksRand()
 		// Continue only if a valid mesh component is available
 		if (UStaticMeshComponent* SMC = ActItr->GetStaticMeshComponent())
 		{
-			if (bOverwriteVisualMaskValues)
+			// Check if the actor or the component is semantically annotated
+			if (FTags::HasKey(*ActItr, "SemLog", "Class"))
 			{
-				// Check if the actor or the component is semantically annotated
-				if (FTags::HasKey(*ActItr, "SemLog", "Class"))
+				if (bOverwriteVisualMaskValues || !FTags::HasKey(*ActItr, "SemLog", "VisMask"))
 				{
-					FTags::AddKeyValuePair(*ActItr, "SemLog", "VisMask", GenerateUniqueColorLambda(Tolerance, NrOfTrials, ConsumedColors), true);
-				}
-				else if (FTags::HasKey(SMC, "SemLog", "Class"))
-				{
-					FTags::AddKeyValuePair(SMC, "SemLog", "VisMask", GenerateUniqueColorLambda(Tolerance, NrOfTrials, ConsumedColors), true);
+					FTags::AddKeyValuePair(*ActItr, "SemLog", "VisMask", AllocateColorLambda(), true);
 				}
 			}
-			else
+			else if (FTags::HasKey(SMC, "SemLog", "Class"))
 			{
-				// TODO not implemented
-				// Load all existing values into the array first
-				// then start adding new values with AddUnique
+				if (bOverwriteVisualMaskValues || !FTags::HasKey(SMC, "SemLog", "VisMask"))
+				{
+					FTags::AddKeyValuePair(SMC, "SemLog", "VisMask", AllocateColorLambda(), true);
+				}
 			}
 		}
 	}
@@ -470,35 +473,36 @@ FReply FSLEdModeToolkit::GenerateVisualMasksRand()
 		// Valid if its parent is a skeletal mesh component
 		if (Cast<USkeletalMeshComponent>(ObjItr->GetAttachParent()))
 		{
-			if (bOverwriteVisualMaskValues)
+			for (auto& Pair : ObjItr->SemanticBonesData)
 			{
-				for (auto& Pair : ObjItr->SemanticBonesData)
+				// Check if data is set (it has a semantic class)
+				if (Pair.Value.IsSet() && (bOverwriteVisualMaskValues || Pair.Value.VisualMask.IsEmpty()))
 				{
-					// Check if data is set (it has a semantic class)
-					if (Pair.Value.IsSet())
-					{
-						Pair.Value.VisualMask = GenerateUniqueColorLambda(Tolerance, NrOfTrials, ConsumedColors);
+					Pair.Value.VisualMask = AllocateColorLambda();
 
-						// Add the mask to the map used at runtime as well
-						if (ObjItr->AllBonesData.Contains(Pair.Key))
-						{
-							ObjItr->AllBonesData[Pair.Key].VisualMask = Pair.Value.VisualMask;
-						}
-						else
-						{
-							// This should not happen, the two maps should be synced
-							UE_LOG(LogTemp, Error, TEXT("%s::%d Cannot fine bone %s, maps are not synced.."), 
-								*FString(__func__), __LINE__, *Pair.Key.ToString());
-						}
+					// Add the mask to the map used at runtime as well
+					if (ObjItr->AllBonesData.Contains(Pair.Key))
+					{
+						ObjItr->AllBonesData[Pair.Key].VisualMask = Pair.Value.VisualMask;
+					}
+					else
+					{
+						// This should not happen, the two maps should be synced
+						UE_LOG(LogTemp, Error, TEXT("%s::%d Cannot fine bone %s, maps are not synced.."), 
+							*FString(__func__), __LINE__, *Pair.Key.ToString());
 					}
 				}
 			}
-			else 
-			{
-				// Not implemented
-			}
 		}
 	}
+
+	if (NumUnassigned > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Out of mask colors, %d entities were saved as black (capacity=%d with tolerance=%d).."),
+			*FString(__func__), __LINE__, NumUnassigned, Lattice.GetCapacity(), Lattice.GetTolerance());
+	}
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Assigned %d mask colors, %d/%d remaining.."),
+		*FString(__func__), __LINE__, NumAssigned, Lattice.GetNumFree(), Lattice.GetCapacity());
 	
 	return FReply::Handled();
 }
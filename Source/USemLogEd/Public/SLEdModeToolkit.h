@@ -53,7 +53,7 @@ private:
 	// Set unique mask colors in hex for the entities (random or incremental)
 	FReply GenerateVisualMasks();
 
-	// Set unique mask colors in hex for the entities (random generator)
+	// Set unique mask colors in hex for the entities (lattice colors, consecutive colors far apart)
 	FReply GenerateVisualMasksRand();
 
 	// Set unique mask colors in hex for the entities (incremental generator)
@@ -87,7 +87,7 @@ private:
 	// Widget pointer
 	TSharedPtr<SWidget> ToolkitWidget;
 
-	// If true, overwrite existing semantic map
+	// If true, regenerate the whole semantic map, otherwise only the changed individuals are rebuilt
 	bool bOverwriteSemanticMap;
 
 	// If true, overwrite existing class names
@@ -0,0 +1,378 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLImageStats.h"
+#include "Async/ParallelFor.h"
+
+static_assert(sizeof(FColor) == sizeof(uint32), "FColor is expected to be a packed 32 bit value");
+
+// Keep the first occurrence of every color with its index, a pixel is only counted for its first matching color (as in the scalar versions),
+// the kernels match every color independently so they get the distinct colors only
+static void SLUniqueColors(const TArray<FColor>& Colors, TArray<uint32>& OutColorValues, TArray<int32>& OutColorIndexes)
+{
+	TSet<uint32> Seen;
+	Seen.Reserve(Colors.Num());
+	for (int32 CIdx = 0; CIdx < Colors.Num(); ++CIdx)
+	{
+		const uint32 Value = Colors[CIdx].DWColor();
+		bool bIsAlreadyInSet = false;
+		Seen.Add(Value, &bIsAlreadyInSet);
+		if (!bIsAlreadyInSet)
+		{
+			OutColorValues.Add(Value);
+			OutColorIndexes.Add(CIdx);
+		}
+	}
+}
+
+// Count the pixels of the distinct colors in the range, the counts are added to the output
+static void SLCountColorsRange(const uint32* Pixels, int32 Num, const uint32* Colors, int32 NumColors, int32* OutCounts)
+{
+	int32 Idx = 0;
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	TArray<VectorRegisterInt, TInlineAllocator<8>> ColorRegs;
+	TArray<VectorRegisterInt, TInlineAllocator<8>> Counts;
+	for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+	{
+		ColorRegs.Add(VectorIntSet1(Colors[CIdx]));
+		Counts.Add(GlobalVectorConstants::IntZero);
+	}
+
+	// A match sets the lane to -1, subtracting it increments the lane count
+	const int32 NumPacked = Num - (Num % 4);
+	for (; Idx < NumPacked; Idx += 4)
+	{
+		const VectorRegisterInt Pixel4 = VectorIntLoad(Pixels + Idx);
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			Counts[CIdx] = VectorIntSubtract(Counts[CIdx], VectorIntCompareEQ(Pixel4, ColorRegs[CIdx]));
+		}
+	}
+
+	for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+	{
+		int32 Lanes[4];
+		VectorIntStore(Counts[CIdx], Lanes);
+		OutCounts[CIdx] += Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+	}
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS
+
+	// Remaining pixels
+	for (; Idx < Num; ++Idx)
+	{
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			if (Pixels[Idx] == Colors[CIdx])
+			{
+				OutCounts[CIdx]++;
+				break;
+			}
+		}
+	}
+}
+
+// Add the statistics of the row pixels in [FirstX, Width) to the output
+static void SLRowStatsScalar(const uint32* Row, int32 FirstX, int32 Width, int32 Y, const uint32* Colors, int32 NumColors, FSLColorStats* OutStats)
+{
+	for (int32 X = FirstX; X < Width; ++X)
+	{
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			if (Row[X] == Colors[CIdx])
+			{
+				FSLColorStats& Stats = OutStats[CIdx];
+				Stats.NumPixels++;
+				Stats.SumX += X;
+				Stats.SumY += Y;
+				Stats.Min = Stats.Min.ComponentMin(FIntPoint(X, Y));
+				Stats.Max = Stats.Max.ComponentMax(FIntPoint(X, Y));
+				break;
+			}
+		}
+	}
+}
+
+// Add the statistics of the rows to the output
+static void SLColorStatsRows(const uint32* Pixels, int32 Width, int32 FirstRow, int32 NumRows, const uint32* Colors, int32 NumColors, FSLColorStats* OutStats)
+{
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	TArray<VectorRegisterInt, TInlineAllocator<8>> ColorRegs;
+	for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+	{
+		ColorRegs.Add(VectorIntSet1(Colors[CIdx]));
+	}
+
+	// Per lane row accumulators of every color: count, sum of x, first and last x (-1 if unset)
+	TArray<VectorRegisterInt, TInlineAllocator<32>> RowRegs;
+	RowRegs.SetNumUninitialized(NumColors * 4);
+	const VectorRegisterInt MinusOne = VectorIntSet1(-1);
+	const VectorRegisterInt Step = VectorIntSet1(4);
+	const int32 NumPacked = Width - (Width % 4);
+
+	for (int32 Y = FirstRow; Y < FirstRow + NumRows; ++Y)
+	{
+		const uint32* Row = Pixels + int64(Y) * Width;
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			RowRegs[CIdx * 4] = GlobalVectorConstants::IntZero;
+			RowRegs[CIdx * 4 + 1] = GlobalVectorConstants::IntZero;
+			RowRegs[CIdx * 4 + 2] = MinusOne;
+			RowRegs[CIdx * 4 + 3] = MinusOne;
+		}
+
+		VectorRegisterInt X4 = MakeVectorRegisterInt(0, 1, 2, 3);
+		for (int32 X = 0; X < NumPacked; X += 4)
+		{
+			const VectorRegisterInt Pixel4 = VectorIntLoad(Row + X);
+			for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+			{
+				VectorRegisterInt* Regs = &RowRegs[CIdx * 4];
+				const VectorRegisterInt Match = VectorIntCompareEQ(Pixel4, ColorRegs[CIdx]);
+				const VectorRegisterInt MatchX = VectorIntAnd(Match, X4);
+				Regs[0] = VectorIntSubtract(Regs[0], Match);
+				Regs[1] = VectorIntAdd(Regs[1], MatchX);
+
+				// The first x is only set once, the last x is overwritten by every match (x grows)
+				const VectorRegisterInt FirstMatch = VectorIntAnd(Match, VectorIntCompareEQ(Regs[2], MinusOne));
+				Regs[2] = VectorIntOr(VectorIntAnd(FirstMatch, X4), VectorIntAndNot(FirstMatch, Regs[2]));
+				Regs[3] = VectorIntOr(MatchX, VectorIntAndNot(Match, Regs[3]));
+			}
+			X4 = VectorIntAdd(X4, Step);
+		}
+
+		// Reduce the lanes
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			int32 Counts[4], SumsX[4], FirstsX[4], LastsX[4];
+			VectorIntStore(RowRegs[CIdx * 4], Counts);
+			const int32 RowNum = Counts[0] + Counts[1] + Counts[2] + Counts[3];
+			if (RowNum == 0)
+			{
+				continue;
+			}
+			VectorIntStore(RowRegs[CIdx * 4 + 1], SumsX);
+			VectorIntStore(RowRegs[CIdx * 4 + 2], FirstsX);
+			VectorIntStore(RowRegs[CIdx * 4 + 3], LastsX);
+
+			int32 MinX = MAX_int32;
+			int32 MaxX = INDEX_NONE;
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				if (FirstsX[Lane] != INDEX_NONE)
+				{
+					MinX = FMath::Min(MinX, FirstsX[Lane]);
+					MaxX = FMath::Max(MaxX, LastsX[Lane]);
+				}
+			}
+
+			FSLColorStats& Stats = OutStats[CIdx];
+			Stats.NumPixels += RowNum;
+			Stats.SumX += int64(SumsX[0]) + SumsX[1] + SumsX[2] + SumsX[3];
+			Stats.SumY += int64(Y) * RowNum;
+			Stats.Min = Stats.Min.ComponentMin(FIntPoint(MinX, Y));
+			Stats.Max = Stats.Max.ComponentMax(FIntPoint(MaxX, Y));
+		}
+
+		// Remaining pixels of the row
+		SLRowStatsScalar(Row, NumPacked, Width, Y, Colors, NumColors, OutStats);
+	}
+#else
+	for (int32 Y = FirstRow; Y < FirstRow + NumRows; ++Y)
+	{
+		SLRowStatsScalar(Pixels + int64(Y) * Width, 0, Width, Y, Colors, NumColors, OutStats);
+	}
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS
+}
+
+// Number of pixels of every color, all colors are counted in one pass
+void FSLImageStats::CountColors(const TArray<FColor>& Image, const TArray<FColor>& Colors, TArray<int32>& OutCounts)
+{
+	OutCounts.Init(0, Colors.Num());
+	if (Image.Num() == 0 || Colors.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<uint32> ColorValues;
+	TArray<int32> ColorIndexes;
+	SLUniqueColors(Colors, ColorValues, ColorIndexes);
+
+	const uint32* Pixels = reinterpret_cast<const uint32*>(Image.GetData());
+	const int32 NumColors = ColorValues.Num();
+	const int32 NumChunks = FMath::DivideAndRoundUp(Image.Num(), ChunkSize);
+
+	// Every chunk counts in its own slots, summed at the end
+	TArray<int32> ChunkCounts;
+	ChunkCounts.SetNumZeroed(NumChunks * NumColors);
+	ParallelFor(NumChunks, [&](int32 ChunkIdx)
+	{
+		const int32 First = ChunkIdx * ChunkSize;
+		SLCountColorsRange(Pixels + First, FMath::Min(ChunkSize, Image.Num() - First),
+			ColorValues.GetData(), NumColors, &ChunkCounts[ChunkIdx * NumColors]);
+	}, NumChunks == 1);
+
+	for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+	{
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			OutCounts[ColorIndexes[CIdx]] += ChunkCounts[ChunkIdx * NumColors + CIdx];
+		}
+	}
+}
+
+// Number of pixels of the color
+int32 FSLImageStats::CountColor(const TArray<FColor>& Image, const FColor& Color)
+{
+	TArray<int32> Counts;
+	CountColors(Image, TArray<FColor>{ Color }, Counts);
+	return Counts[0];
+}
+
+// Number of pixels, bounding box and centroid of every color, all colors are processed in one pass
+void FSLImageStats::ComputeColorStats(const TArray<FColor>& Image, int32 Width, const TArray<FColor>& Colors, TArray<FSLColorStats>& OutStats)
+{
+	OutStats.Init(FSLColorStats(), Colors.Num());
+	if (Width <= 0 || Image.Num() == 0 || Colors.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<uint32> ColorValues;
+	TArray<int32> ColorIndexes;
+	SLUniqueColors(Colors, ColorValues, ColorIndexes);
+
+	const uint32* Pixels = reinterpret_cast<const uint32*>(Image.GetData());
+	const int32 NumColors = ColorValues.Num();
+	const int32 Height = Image.Num() / Width;
+	const int32 RowsPerChunk = FMath::Max(ChunkSize / Width, 1);
+	const int32 NumChunks = FMath::DivideAndRoundUp(Height, RowsPerChunk);
+
+	TArray<FSLColorStats> ChunkStats;
+	ChunkStats.Init(FSLColorStats(), NumChunks * NumColors);
+	ParallelFor(NumChunks, [&](int32 ChunkIdx)
+	{
+		const int32 FirstRow = ChunkIdx * RowsPerChunk;
+		SLColorStatsRows(Pixels, Width, FirstRow, FMath::Min(RowsPerChunk, Height - FirstRow),
+			ColorValues.GetData(), NumColors, &ChunkStats[ChunkIdx * NumColors]);
+	}, NumChunks == 1);
+
+	for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+	{
+		for (int32 CIdx = 0; CIdx < NumColors; ++CIdx)
+		{
+			OutStats[ColorIndexes[CIdx]].Merge(ChunkStats[ChunkIdx * NumColors + CIdx]);
+		}
+	}
+}
+
+// Number of pixels of every distinct color of the image
+void FSLImageStats::ComputeHistogram(const TArray<FColor>& Image, TMap<FColor, int32>& OutHistogram)
+{
+	OutHistogram.Reset();
+	if (Image.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(Image.Num(), ChunkSize);
+	TArray<TMap<FColor, int32>> ChunkHistograms;
+	ChunkHistograms.SetNum(NumChunks);
+	ParallelFor(NumChunks, [&](int32 ChunkIdx)
+	{
+		// Mask images are mostly runs of the same color, the map is only updated at the end of a run
+		TMap<FColor, int32>& Histogram = ChunkHistograms[ChunkIdx];
+		const int32 First = ChunkIdx * ChunkSize;
+		const int32 Last = FMath::Min(First + ChunkSize, Image.Num());
+		FColor RunColor = Image[First];
+		int32 RunNum = 0;
+		for (int32 Idx = First; Idx < Last; ++Idx)
+		{
+			if (Image[Idx] == RunColor)
+			{
+				RunNum++;
+			}
+			else
+			{
+				Histogram.FindOrAdd(RunColor) += RunNum;
+				RunColor = Image[Idx];
+				RunNum = 1;
+			}
+		}
+		Histogram.FindOrAdd(RunColor) += RunNum;
+	}, NumChunks == 1);
+
+	for (const auto& Histogram : ChunkHistograms)
+	{
+		for (const auto& Pair : Histogram)
+		{
+			OutHistogram.FindOrAdd(Pair.Key) += Pair.Value;
+		}
+	}
+}
+
+// Replace the pixels of the mapped colors
+void FSLImageStats::RemapColors(TArray<FColor>& InOutImage, const TMap<FColor, FColor>& ColorMap)
+{
+	if (InOutImage.Num() == 0 || ColorMap.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(InOutImage.Num(), ChunkSize);
+	ParallelFor(NumChunks, [&](int32 ChunkIdx)
+	{
+		// Cache the lookup of the previous pixel color
+		const int32 First = ChunkIdx * ChunkSize;
+		const int32 Last = FMath::Min(First + ChunkSize, InOutImage.Num());
+		FColor PrevColor = InOutImage[First];
+		const FColor* PrevMapped = ColorMap.Find(PrevColor);
+		for (int32 Idx = First; Idx < Last; ++Idx)
+		{
+			FColor& Pixel = InOutImage[Idx];
+			if (Pixel != PrevColor)
+			{
+				PrevColor = Pixel;
+				PrevMapped = ColorMap.Find(PrevColor);
+			}
+			if (PrevMapped)
+			{
+				Pixel = *PrevMapped;
+			}
+		}
+	}, NumChunks == 1);
+}
+
+// Number of pixels of every color
+void FSLImageStats::CountColorsScalar(const TArray<FColor>& Image, const TArray<FColor>& Colors, TArray<int32>& OutCounts)
+{
+	OutCounts.Init(0, Colors.Num());
+	for (const auto& Pixel : Image)
+	{
+		for (int32 CIdx = 0; CIdx < Colors.Num(); ++CIdx)
+		{
+			if (Pixel == Colors[CIdx])
+			{
+				OutCounts[CIdx]++;
+				break;
+			}
+		}
+	}
+}
+
+// Number of pixels, bounding box and centroid of every color
+void FSLImageStats::ComputeColorStatsScalar(const TArray<FColor>& Image, int32 Width, const TArray<FColor>& Colors, TArray<FSLColorStats>& OutStats)
+{
+	OutStats.Init(FSLColorStats(), Colors.Num());
+	if (Width <= 0)
+	{
+		return;
+	}
+
+	const uint32* Pixels = reinterpret_cast<const uint32*>(Image.GetData());
+	const uint32* ColorValues = reinterpret_cast<const uint32*>(Colors.GetData());
+	const int32 Height = Image.Num() / Width;
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		SLRowStatsScalar(Pixels + int64(Y) * Width, 0, Width, Y, ColorValues, Colors.Num(), OutStats.GetData());
+	}
+}
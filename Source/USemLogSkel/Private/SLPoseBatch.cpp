@@ -0,0 +1,48 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLPoseBatch.h"
+
+// Convert the locations to the ROS frame in place (y is mirrored, cm to m)
+void FSLPoseBatch::ConvertToROS(FVector* InOutLocations, int32 Num)
+{
+	static_assert(sizeof(FVector) == 3 * sizeof(float), "FVector is expected to be three packed floats");
+
+	// The locations are packed floats (x,y,z,x,y,z..), four locations fill three registers,
+	// the scale pattern repeats every three registers
+	const VectorRegister Scale0 = MakeVectorRegister(0.01f, -0.01f, 0.01f, 0.01f);
+	const VectorRegister Scale1 = MakeVectorRegister(-0.01f, 0.01f, 0.01f, -0.01f);
+	const VectorRegister Scale2 = MakeVectorRegister(0.01f, 0.01f, -0.01f, 0.01f);
+
+	float* Data = reinterpret_cast<float*>(InOutLocations);
+	const int32 NumPacked = Num - (Num % 4);
+	for (int32 Idx = 0; Idx < NumPacked; Idx += 4)
+	{
+		float* Ptr = Data + Idx * 3;
+		VectorStore(VectorMultiply(VectorLoad(Ptr), Scale0), Ptr);
+		VectorStore(VectorMultiply(VectorLoad(Ptr + 4), Scale1), Ptr + 4);
+		VectorStore(VectorMultiply(VectorLoad(Ptr + 8), Scale2), Ptr + 8);
+	}
+
+	// Remaining locations
+	for (int32 Idx = NumPacked; Idx < Num; ++Idx)
+	{
+		FVector& Loc = InOutLocations[Idx];
+		Loc = FVector(Loc.X, -Loc.Y, Loc.Z) / 100.f;
+	}
+}
+
+// Convert the rotations to the ROS frame in place (x and z are mirrored)
+void FSLPoseBatch::ConvertToROS(FQuat* InOutQuats, int32 Num)
+{
+	static_assert(sizeof(FQuat) == 4 * sizeof(float), "FQuat is expected to be four packed floats");
+
+	// One rotation per register
+	const VectorRegister Sign = MakeVectorRegister(-1.f, 1.f, -1.f, 1.f);
+	float* Data = reinterpret_cast<float*>(InOutQuats);
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+	{
+		float* Ptr = Data + Idx * 4;
+		VectorStore(VectorMultiply(VectorLoad(Ptr), Sign), Ptr);
+	}
+}
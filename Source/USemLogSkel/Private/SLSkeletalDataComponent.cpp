@@ -3,7 +3,7 @@
 
 #include "SLSkeletalDataComponent.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "Tags.h"
+#include "SLTagCache.h"
 
 // Sets default values for this component's properties
 USLSkeletalDataComponent::USLSkeletalDataComponent()
@@ -209,8 +209,8 @@ bool USLSkeletalDataComponent::SetSemanticOwnerData()
 		OwnerSemanticData.Clear();
 
 		// Check if the attachment is the semantic owner
-		FString Id = FTags::GetValue(GetAttachParent(), "SemLog", "Id");
-		FString Class = FTags::GetValue(GetAttachParent(), "SemLog", "Class");
+		FString Id = FSLTagCache::GetInstance(GetWorld())->GetValue(GetAttachParent(), "Id");
+		FString Class = FSLTagCache::GetInstance(GetWorld())->GetValue(GetAttachParent(), "Class");
 		
 		if (!Id.IsEmpty() && !Class.IsEmpty())
 		{
@@ -221,8 +221,8 @@ bool USLSkeletalDataComponent::SetSemanticOwnerData()
 		else
 		{
 			// Check if the owner is the semantic parent
-			Id = FTags::GetValue(GetOwner(), "SemLog", "Id");
-			Class = FTags::GetValue(GetOwner(), "SemLog", "Class");
+			Id = FSLTagCache::GetInstance(GetWorld())->GetValue(GetOwner(), "Id");
+			Class = FSLTagCache::GetInstance(GetWorld())->GetValue(GetOwner(), "Class");
 			if (!Id.IsEmpty() && !Class.IsEmpty())
 			{
 				SemanticOwner = GetOwner();
@@ -0,0 +1,195 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLTagCache.h"
+#include "USemLogSkel.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+TSLWorldInstances<FSLTagCache> FSLTagCache::WorldInstances;
+
+// Constructor
+FSLTagCache::FSLTagCache() : bIsInit(false)
+{
+}
+
+// Get the instance of the world
+FSLTagCache* FSLTagCache::GetInstance(UWorld* World)
+{
+	return WorldInstances.FindOrAdd(World, []() { return new FSLTagCache(); });
+}
+
+// Delete the instance of the world
+void FSLTagCache::DeleteInstance(UWorld* World)
+{
+	WorldInstances.Remove(World);
+}
+
+// Parse the tags of the world if not already done
+void FSLTagCache::Init(UWorld* World)
+{
+	if (!IsInitFor(World))
+	{
+		Build(World);
+	}
+}
+
+// Parse the tags of all the actors and components of the world
+void FSLTagCache::Build(UWorld* World)
+{
+	Clear();
+	if (World == nullptr)
+	{
+		return;
+	}
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Gather the objects on the game thread
+	TArray<UObject*> Objects;
+	for (TActorIterator<AActor> ActorItr(World); ActorItr; ++ActorItr)
+	{
+		Objects.Add(*ActorItr);
+		for (UActorComponent* Comp : ActorItr->GetComponents())
+		{
+			Objects.Add(Comp);
+		}
+	}
+	const double GatherTime = FPlatformTime::Seconds();
+
+	// Parse the tags in parallel, every object writes only its own slot
+	TArray<TMap<FString, FString>> ParsedPairs;
+	ParsedPairs.SetNum(Objects.Num());
+	ParallelFor(Objects.Num(), [&Objects, &ParsedPairs](int32 Idx)
+	{
+		if (const TArray<FName>* Tags = GetTags(Objects[Idx]))
+		{
+			ParseKeyValuePairs(*Tags, ParsedPairs[Idx]);
+		}
+	});
+	const double ParseTime = FPlatformTime::Seconds();
+
+	for (int32 Idx = 0; Idx < Objects.Num(); ++Idx)
+	{
+		if (ParsedPairs[Idx].Num() > 0)
+		{
+			ObjectsKeyValuePairs.Emplace(Objects[Idx], MoveTemp(ParsedPairs[Idx]));
+		}
+	}
+
+	CachedWorld = World;
+	bIsInit = true;
+
+	UE_LOG(LogSLSkel, Log, TEXT("%s::%d Cached the tags of %d/%d objects in %.3fs (gather=%.3fs, parse=%.3fs, store=%.3fs).."),
+		*FString(__func__), __LINE__, ObjectsKeyValuePairs.Num(), Objects.Num(), FPlatformTime::Seconds() - StartTime,
+		GatherTime - StartTime, ParseTime - GatherTime, FPlatformTime::Seconds() - ParseTime);
+}
+
+// Clear data
+void FSLTagCache::Clear()
+{
+	ObjectsKeyValuePairs.Empty();
+	CachedWorld.Reset();
+	bIsInit = false;
+}
+
+// Parse the tags of a single object
+int32 FSLTagCache::AddObject(UObject* Object)
+{
+	TMap<FString, FString> KeyValuePairs;
+	if (const TArray<FName>* Tags = GetTags(Object))
+	{
+		ParseKeyValuePairs(*Tags, KeyValuePairs);
+	}
+	const int32 Num = KeyValuePairs.Num();
+	if (Num > 0)
+	{
+		ObjectsKeyValuePairs.Emplace(Object, MoveTemp(KeyValuePairs));
+	}
+	else
+	{
+		ObjectsKeyValuePairs.Remove(Object);
+	}
+	return Num;
+}
+
+// Get the value of the key, falls back to parsing the object tags if the object is not cached
+FString FSLTagCache::GetValue(UObject* Object, const FString& Key) const
+{
+	if (const TMap<FString, FString>* KeyValuePairs = ObjectsKeyValuePairs.Find(Object))
+	{
+		if (const FString* Value = KeyValuePairs->Find(Key))
+		{
+			return *Value;
+		}
+		return FString();
+	}
+
+	// Objects of other worlds, spawned after the cache was built, or without SemLog tags (cheap, no pairs to parse)
+	TMap<FString, FString> KeyValuePairs;
+	if (const TArray<FName>* Tags = GetTags(Object))
+	{
+		ParseKeyValuePairs(*Tags, KeyValuePairs);
+	}
+	if (const FString* Value = KeyValuePairs.Find(Key))
+	{
+		return *Value;
+	}
+	return FString();
+}
+
+// Check if the object has the key
+bool FSLTagCache::HasKey(UObject* Object, const FString& Key) const
+{
+	if (const TMap<FString, FString>* KeyValuePairs = ObjectsKeyValuePairs.Find(Object))
+	{
+		return KeyValuePairs->Contains(Key);
+	}
+	TMap<FString, FString> KeyValuePairs;
+	if (const TArray<FName>* Tags = GetTags(Object))
+	{
+		ParseKeyValuePairs(*Tags, KeyValuePairs);
+	}
+	return KeyValuePairs.Contains(Key);
+}
+
+// Parse the SemLog key-value pairs from the tags (format: "SemLog;Key1,Value1;Key2,Value2;")
+bool FSLTagCache::ParseKeyValuePairs(const TArray<FName>& Tags, TMap<FString, FString>& OutKeyValuePairs)
+{
+	static const FString TagType = TEXT("SemLog;");
+	for (const FName& Tag : Tags)
+	{
+		const FString TagStr = Tag.ToString();
+		if (!TagStr.StartsWith(TagType, ESearchCase::CaseSensitive))
+		{
+			continue;
+		}
+
+		TArray<FString> Pairs;
+		TagStr.RightChop(TagType.Len()).ParseIntoArray(Pairs, TEXT(";"));
+		for (const FString& Pair : Pairs)
+		{
+			FString Key;
+			FString Value;
+			if (Pair.Split(TEXT(","), &Key, &Value))
+			{
+				OutKeyValuePairs.Emplace(MoveTemp(Key), MoveTemp(Value));
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+// Get the tags of the actor or component
+const TArray<FName>* FSLTagCache::GetTags(UObject* Object)
+{
+	if (AActor* AsActor = Cast<AActor>(Object))
+	{
+		return &AsActor->Tags;
+	}
+	else if (UActorComponent* AsComp = Cast<UActorComponent>(Object))
+	{
+		return &AsComp->ComponentTags;
+	}
+	return nullptr;
+}
@@ -0,0 +1,173 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLVisMaskLattice.h"
+
+// Ctor
+FSLVisMaskLattice::FSLVisMaskLattice(uint8 InTolerance)
+{
+	// Nodes closer than 2*Tolerance+1 could not be told apart after deviations
+	Tolerance = FMath::Min<uint8>(InTolerance, 127);
+	Step = 2 * Tolerance + 1;
+	NumLevels = FMath::DivideAndRoundUp(256, Step);
+	Offset = (255 - (NumLevels - 1) * Step) / 2;
+	NumNodes = NumLevels * NumLevels * NumLevels;
+
+	// Channel value to closest node level
+	for (int32 Val = 0; Val < 256; ++Val)
+	{
+		NodeLevel[Val] = FMath::Clamp(FMath::RoundToInt(float(Val - Offset) / Step), 0, NumLevels - 1);
+	}
+
+	// Allocation stride close to the golden ratio of the nodes, consecutive masks will be far apart in the color space
+	Stride = FMath::Max(FMath::RoundToInt(NumNodes * 0.618f), 1);
+	auto GCD = [](int32 A, int32 B) { while (B != 0) { const int32 T = B; B = A % B; A = T; } return A; };
+	while (GCD(NumNodes, Stride) != 1)
+	{
+		Stride++;
+	}
+
+	Reset();
+}
+
+// Allocate the next free mask color, false if there are no free nodes left
+bool FSLVisMaskLattice::Allocate(FColor& OutColor)
+{
+	// Every node is visited once in the stride order, the used ones are skipped
+	while (NumFree > 0 && Cursor < NumNodes)
+	{
+		const int32 NodeIdx = int32((int64(Cursor) * Stride) % NumNodes);
+		Cursor++;
+		if (!UsedNodes[NodeIdx])
+		{
+			OutColor = GetNodeColor(NodeIdx);
+			UsedNodes[NodeIdx] = true;
+			NodeColors.FindOrAdd(NodeIdx).Add(OutColor);
+			NumFree--;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Add an existing mask color (its node will not be allocated), false if the node was already used
+bool FSLVisMaskLattice::Add(const FColor& Color)
+{
+	const int32 NodeIdx = GetNodeIndex(Color);
+	const FColor NodeColor = GetNodeColor(NodeIdx);
+	NodeColors.FindOrAdd(NodeIdx).Add(FColor(Color.R, Color.G, Color.B, 255));
+	const bool bWasUsed = UsedNodes[NodeIdx];
+	if (NodeColor.R != Color.R || NodeColor.G != Color.G || NodeColor.B != Color.B)
+	{
+		// The deviated pixels of an off-lattice color and of the nodes closer than 2*Tolerance to it would overlap
+		bHasOffLatticeColors = true;
+		TArray<int32, TInlineAllocator<3>> RLevels, GLevels, BLevels;
+		GetLevelsInRange(Color.R, 2 * Tolerance, RLevels);
+		GetLevelsInRange(Color.G, 2 * Tolerance, GLevels);
+		GetLevelsInRange(Color.B, 2 * Tolerance, BLevels);
+		for (int32 R : RLevels)
+		{
+			for (int32 G : GLevels)
+			{
+				for (int32 B : BLevels)
+				{
+					UseNode((R * NumLevels + G) * NumLevels + B);
+				}
+			}
+		}
+	}
+	UseNode(NodeIdx);
+	return !bWasUsed;
+}
+
+// Find the added mask color closest to the color, within the tolerance
+bool FSLVisMaskLattice::FindMaskColor(const FColor& Color, FColor& OutMaskColor) const
+{
+	// Off-lattice colors can be in the neighbour nodes as well, the closest match wins
+	int32 MinDist = MAX_int32;
+	auto CheckNode = [&](int32 NodeIdx)
+	{
+		if (const auto* Colors = NodeColors.Find(NodeIdx))
+		{
+			for (const FColor& MaskColor : *Colors)
+			{
+				if (IsWithinTolerance(Color, MaskColor))
+				{
+					const int32 Dist = FMath::Abs(Color.R - MaskColor.R)
+						+ FMath::Abs(Color.G - MaskColor.G)
+						+ FMath::Abs(Color.B - MaskColor.B);
+					if (Dist < MinDist)
+					{
+						MinDist = Dist;
+						OutMaskColor = MaskColor;
+					}
+				}
+			}
+		}
+	};
+
+	if (!bHasOffLatticeColors)
+	{
+		CheckNode(GetNodeIndex(Color));
+		return MinDist != MAX_int32;
+	}
+
+	const int32 R = NodeLevel[Color.R];
+	const int32 G = NodeLevel[Color.G];
+	const int32 B = NodeLevel[Color.B];
+	for (int32 RIdx = FMath::Max(R - 1, 0); RIdx <= FMath::Min(R + 1, NumLevels - 1); ++RIdx)
+	{
+		for (int32 GIdx = FMath::Max(G - 1, 0); GIdx <= FMath::Min(G + 1, NumLevels - 1); ++GIdx)
+		{
+			for (int32 BIdx = FMath::Max(B - 1, 0); BIdx <= FMath::Min(B + 1, NumLevels - 1); ++BIdx)
+			{
+				CheckNode((RIdx * NumLevels + GIdx) * NumLevels + BIdx);
+			}
+		}
+	}
+	return MinDist != MAX_int32;
+}
+
+// Remove all the added and allocated colors
+void FSLVisMaskLattice::Reset()
+{
+	UsedNodes.Init(false, NumNodes);
+	NodeColors.Empty();
+	bHasOffLatticeColors = false;
+	Cursor = 0;
+
+	// The first node is within the tolerance of black (background)
+	UsedNodes[0] = true;
+	NumFree = NumNodes - 1;
+}
+
+// Color of the node
+FColor FSLVisMaskLattice::GetNodeColor(int32 NodeIdx) const
+{
+	const int32 B = NodeIdx % NumLevels;
+	const int32 G = (NodeIdx / NumLevels) % NumLevels;
+	const int32 R = NodeIdx / (NumLevels * NumLevels);
+	return FColor(Offset + R * Step, Offset + G * Step, Offset + B * Step, 255);
+}
+
+// Mark the node as used
+void FSLVisMaskLattice::UseNode(int32 NodeIdx)
+{
+	if (!UsedNodes[NodeIdx])
+	{
+		UsedNodes[NodeIdx] = true;
+		NumFree--;
+	}
+}
+
+// Node levels of a channel within the distance of the value
+void FSLVisMaskLattice::GetLevelsInRange(int32 Value, int32 Distance, TArray<int32, TInlineAllocator<3>>& OutLevels) const
+{
+	for (int32 Level = NodeLevel[Value] - 2; Level <= NodeLevel[Value] + 2; ++Level)
+	{
+		if (Level >= 0 && Level < NumLevels && FMath::Abs(Offset + Level * Step - Value) <= Distance)
+		{
+			OutLevels.Add(Level);
+		}
+	}
+}
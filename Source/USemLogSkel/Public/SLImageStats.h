@@ -0,0 +1,80 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Pixel statistics of a color in an image
+*/
+struct FSLColorStats
+{
+	// Number of pixels with the color
+	int32 NumPixels = 0;
+
+	// Bounding box of the pixels (inclusive, invalid if there are no pixels)
+	FIntPoint Min = FIntPoint(MAX_int32, MAX_int32);
+	FIntPoint Max = FIntPoint(INDEX_NONE, INDEX_NONE);
+
+	// Sum of the pixel coordinates
+	int64 SumX = 0;
+	int64 SumY = 0;
+
+	// Average pixel coordinate
+	FVector2D GetCentroid() const
+	{
+		return NumPixels > 0 ? FVector2D(double(SumX) / NumPixels, double(SumY) / NumPixels) : FVector2D::ZeroVector;
+	};
+
+	// Add the statistics of another image region
+	void Merge(const FSLColorStats& Other)
+	{
+		NumPixels += Other.NumPixels;
+		Min = Min.ComponentMin(Other.Min);
+		Max = Max.ComponentMax(Other.Max);
+		SumX += Other.SumX;
+		SumY += Other.SumY;
+	};
+
+	// Same statistics
+	bool operator==(const FSLColorStats& Other) const
+	{
+		return NumPixels == Other.NumPixels && Min == Other.Min && Max == Other.Max && SumX == Other.SumX && SumY == Other.SumY;
+	};
+};
+
+/**
+ * Image statistics kernels shared by the item scanner and the vision mask handler,
+ * the (distinct) colors are compared exactly as packed 32 bit values (four pixels per vector instruction),
+ * large images are split in chunks which are processed in parallel
+ */
+class USEMLOGSKEL_API FSLImageStats
+{
+public:
+	// Number of pixels of every color, all colors are counted in one pass
+	static void CountColors(const TArray<FColor>& Image, const TArray<FColor>& Colors, TArray<int32>& OutCounts);
+
+	// Number of pixels of the color
+	static int32 CountColor(const TArray<FColor>& Image, const FColor& Color);
+
+	// Number of pixels, bounding box and centroid of every color, all colors are processed in one pass
+	static void ComputeColorStats(const TArray<FColor>& Image, int32 Width, const TArray<FColor>& Colors, TArray<FSLColorStats>& OutStats);
+
+	// Number of pixels of every distinct color of the image
+	static void ComputeHistogram(const TArray<FColor>& Image, TMap<FColor, int32>& OutHistogram);
+
+	// Replace the pixels of the mapped colors
+	static void RemapColors(TArray<FColor>& InOutImage, const TMap<FColor, FColor>& ColorMap);
+
+	/* Scalar reference versions, used to verify the vectorized kernels */
+	// Number of pixels of every color
+	static void CountColorsScalar(const TArray<FColor>& Image, const TArray<FColor>& Colors, TArray<int32>& OutCounts);
+
+	// Number of pixels, bounding box and centroid of every color
+	static void ComputeColorStatsScalar(const TArray<FColor>& Image, int32 Width, const TArray<FColor>& Colors, TArray<FSLColorStats>& OutStats);
+
+	/* Constants */
+	// Number of pixels processed by one parallel task
+	constexpr static int32 ChunkSize = 64 * 1024;
+};
@@ -0,0 +1,80 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SLStructs.h"
+
+/**
+ * Contiguous buffer of poses converted in one pass from the Unreal frame (left handed, cm)
+ * to the ROS frame (right handed, m), same results as FConversions::UToROS applied on every pose
+ */
+struct USEMLOGSKEL_API FSLPoseBatch
+{
+	// Locations of the poses
+	TArray<FVector> Locations;
+
+	// Rotations of the poses
+	TArray<FQuat> Quats;
+
+	// Index in the entities array of every pose (set when adding moved entities)
+	TArray<int32> EntityIndexes;
+
+	// Add pose, returns its index
+	int32 Add(const FVector& InLoc, const FQuat& InQuat)
+	{
+		Locations.Add(InLoc);
+		return Quats.Add(InQuat);
+	};
+
+	// Number of poses
+	int32 Num() const { return Quats.Num(); };
+
+	// Remove the poses, keep the memory
+	void Reset(int32 NewSize = 0) { Locations.Reset(NewSize); Quats.Reset(NewSize); EntityIndexes.Reset(NewSize); };
+
+	// Reset and add the poses of the entities which moved more than the thresholds since their previous write
+	// (their previous pose is updated), invalid entities are removed from the array
+	template<typename T>
+	void SetMovedEntities(TArray<TSLEntityPreviousPose<T>>& Entities, float LinDistSqMin, float AngDistMin = 0.f)
+	{
+		Reset(Entities.Num());
+		for (auto Itr(Entities.CreateIterator()); Itr; ++Itr)
+		{
+			if (Itr->Obj.IsValid(/*false, true*/))
+			{
+				const FVector CurrLoc = Itr->GetLocation();
+				const FQuat CurrQuat = Itr->GetQuat();
+				if (FVector::DistSquared(CurrLoc, Itr->PrevLoc) > LinDistSqMin ||
+					CurrQuat.AngularDistance(Itr->PrevQuat) > AngDistMin)
+				{
+					// Update prev state
+					Itr->PrevLoc = CurrLoc;
+					Itr->PrevQuat = CurrQuat;
+
+					// The previously added indexes stay valid, only later entities are shifted by the removals
+					Add(CurrLoc, CurrQuat);
+					EntityIndexes.Add(Itr.GetIndex());
+				}
+			}
+			else
+			{
+				Itr.RemoveCurrent();
+			}
+		}
+	};
+
+	// Convert all the poses to the ROS frame
+	void ConvertToROS()
+	{
+		ConvertToROS(Locations.GetData(), Locations.Num());
+		ConvertToROS(Quats.GetData(), Quats.Num());
+	};
+
+	// Convert the locations to the ROS frame in place (y is mirrored, cm to m)
+	static void ConvertToROS(FVector* InOutLocations, int32 Num);
+
+	// Convert the rotations to the ROS frame in place (x and z are mirrored)
+	static void ConvertToROS(FQuat* InOutQuats, int32 Num);
+};
@@ -4,6 +4,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
 #include "SLStructs.generated.h"
 
 /************************************************************************/
@@ -92,6 +94,12 @@ struct FSLEntity
 	}
 };
 
+/**
+* Handle to an entity record of the entities manager, copying it does not copy the strings
+* and it keeps the record alive while events are still referencing it
+*/
+typedef TSharedPtr<const FSLEntity> FSLEntityHandle;
+
 /**
 * Structure holding the semantic data of two entities
 */
@@ -139,8 +147,29 @@ struct TSLEntityPreviousPose
 	// Its previous rotation
 	FQuat PrevQuat;
 
+	// Its pose at the previous and at the current frame (fixed rate sampling)
+	FVector PrevFrameLoc;
+	FQuat PrevFrameQuat;
+	FVector FrameLoc;
+	FQuat FrameQuat;
+
+	// True if the frame pose was read at least once
+	bool bHasFramePose;
+
+	// Interpolated pose to write instead of the current one (fixed rate sampling)
+	FVector SampleLoc;
+	FQuat SampleQuat;
+
+	// True if the sample pose should be written
+	bool bUseSamplePose;
+
+	// Its previous live published pose
+	FVector PublishedLoc;
+	FQuat PublishedQuat;
+
 	// Default constructor
-	TSLEntityPreviousPose() {};
+	TSLEntityPreviousPose() : bHasFramePose(false), bUseSamplePose(false),
+		PublishedLoc(FVector(BIG_NUMBER)), PublishedQuat(FQuat::Identity) {};
 
 	// Init constructor
 	TSLEntityPreviousPose(TWeakObjectPtr<T> InObj,
@@ -150,11 +179,48 @@ struct TSLEntityPreviousPose
 		Obj(InObj),
 		Entity(InEntity),
 		PrevLoc(InPrevLoc),
-		PrevQuat(InPrevQuat)
+		PrevQuat(InPrevQuat),
+		bHasFramePose(false),
+		bUseSamplePose(false),
+		PublishedLoc(FVector(BIG_NUMBER)),
+		PublishedQuat(FQuat::Identity)
 	{};
 
 	// Check if the entity is valid and has a transform
 	bool IsSet() const { return Entity.IsSet() && (Cast<USceneComponent>(Entity.Obj) || Cast<AActor>(Entity.Obj)); }
+
+	// Location to write (the interpolated sample if set, otherwise the current one of the object)
+	FVector GetLocation() const { return bUseSamplePose ? SampleLoc : GetObjLocation(Obj.Get()); }
+
+	// Rotation to write (the interpolated sample if set, otherwise the current one of the object)
+	FQuat GetQuat() const { return bUseSamplePose ? SampleQuat : GetObjQuat(Obj.Get()); }
+
+	// Read the current pose of the object as the frame pose, the previous one is kept for the interpolation
+	void AdvanceFrame()
+	{
+		const FVector CurrLoc = GetObjLocation(Obj.Get());
+		const FQuat CurrQuat = GetObjQuat(Obj.Get());
+		PrevFrameLoc = bHasFramePose ? FrameLoc : CurrLoc;
+		PrevFrameQuat = bHasFramePose ? FrameQuat : CurrQuat;
+		FrameLoc = CurrLoc;
+		FrameQuat = CurrQuat;
+		bHasFramePose = true;
+	}
+
+	// Set the pose to write to the interpolation between the previous and the current frame pose (Alpha in [0,1])
+	void SetSample(float Alpha)
+	{
+		SampleLoc = FMath::Lerp(PrevFrameLoc, FrameLoc, Alpha);
+		SampleQuat = FQuat::Slerp(PrevFrameQuat, FrameQuat, Alpha);
+		bUseSamplePose = true;
+	}
+
+private:
+	// Pose getters of the supported object types
+	static FVector GetObjLocation(const AActor* InObj) { return InObj->GetActorLocation(); }
+	static FVector GetObjLocation(const USceneComponent* InObj) { return InObj->GetComponentLocation(); }
+	static FQuat GetObjQuat(const AActor* InObj) { return InObj->GetActorQuat(); }
+	static FQuat GetObjQuat(const USceneComponent* InObj) { return InObj->GetComponentQuat(); }
 };
 
 /**
@@ -166,10 +232,10 @@ struct FSLContactResult
 	GENERATED_BODY()
 
 	// Self
-	FSLEntity Self;
+	FSLEntityHandle Self;
 
 	// Other 
-	FSLEntity Other;
+	FSLEntityHandle Other;
 
 	// The mesh (static or skeletal) of the other overlapping component
 	TWeakObjectPtr<UMeshComponent> SelfMeshComponent;
@@ -187,7 +253,7 @@ struct FSLContactResult
 	FSLContactResult() {};
 
 	// Init constructor
-	FSLContactResult(const FSLEntity& InSelf, const FSLEntity& InOther, float InTime,
+	FSLContactResult(const FSLEntityHandle& InSelf, const FSLEntityHandle& InOther, float InTime,
 		bool bIsSemanticOverlapArea) :
 		Self(InSelf),
 		Other(InOther),
@@ -196,7 +262,7 @@ struct FSLContactResult
 	{};
 
 	// Init constructor with mesh component (static/skeletal)
-	FSLContactResult(const FSLEntity& InSelf, const FSLEntity& InOther, float InTime,
+	FSLContactResult(const FSLEntityHandle& InSelf, const FSLEntityHandle& InOther, float InTime,
 		bool bIsSemanticOverlapArea, UMeshComponent* InSelfMeshComponent, UMeshComponent* InOtherMeshComponent) :
 		Self(InSelf),
 		Other(InOther),
@@ -210,7 +276,7 @@ struct FSLContactResult
 	FString ToString() const
 	{
 		return FString::Printf(TEXT("Self:[%s] Other:[%s] Time:%f bIsOtherASemanticOverlapArea:%s StaticMeshActor:%s StaticMeshComponent:%s"),
-			*Self.ToString(), *Other.ToString(), Time,
+			Self.IsValid() ? *Self->ToString() : TEXT("None"), Other.IsValid() ? *Other->ToString() : TEXT("None"), Time,
 			bIsOtherASemanticOverlapArea == true ? TEXT("True") : TEXT("False"),
 			OtherMeshComponent.IsValid() ? *OtherMeshComponent->GetName() : TEXT("None"));
 	}
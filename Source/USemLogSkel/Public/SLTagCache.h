@@ -0,0 +1,78 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SLWorldInstances.h"
+
+/**
+ * Singleton with the parsed SemLog tag key-value pairs of the actors and components of a world,
+ * the tags are parsed once (in parallel) and shared by all the consumers (entities manager, vision masks, semantic map, scanner)
+ */
+class USEMLOGSKEL_API FSLTagCache
+{
+private:
+	// Constructor
+	FSLTagCache();
+
+public:
+	// Destructor
+	~FSLTagCache() = default;
+
+	// Get the instance of the world (created on first use)
+	static FSLTagCache* GetInstance(UWorld* World);
+
+	// Delete the instance of the world
+	static void DeleteInstance(UWorld* World);
+
+	// Parse the tags of the world if not already done
+	void Init(UWorld* World);
+
+	// Parse the tags of all the actors and components of the world (replaces any previous data)
+	void Build(UWorld* World);
+
+	// Check if the tags of the given world are cached
+	bool IsInitFor(UWorld* World) const { return bIsInit && CachedWorld.Get() == World; };
+
+	// Clear data
+	void Clear();
+
+	// Parse the tags of a single object (e.g. spawned at runtime), returns the number of SemLog pairs
+	int32 AddObject(UObject* Object);
+
+	// Forget the tags of the object
+	void RemoveObject(UObject* Object) { ObjectsKeyValuePairs.Remove(Object); };
+
+	// Get the SemLog key-value pairs of the object (nullptr if the object has no SemLog tags or is not cached)
+	const TMap<FString, FString>* Find(UObject* Object) const { return ObjectsKeyValuePairs.Find(Object); };
+
+	// Get the value of the key, falls back to parsing the object tags if the object is not cached
+	FString GetValue(UObject* Object, const FString& Key) const;
+
+	// Check if the object has the key
+	bool HasKey(UObject* Object, const FString& Key) const;
+
+	// Get all the objects with SemLog tags and their key-value pairs (destroyed objects have invalid keys until the next build)
+	const TMap<TWeakObjectPtr<UObject>, TMap<FString, FString>>& GetObjectKeyValuePairsMap() const { return ObjectsKeyValuePairs; };
+
+	// Parse the SemLog key-value pairs from the tags, false if there is no SemLog tag
+	static bool ParseKeyValuePairs(const TArray<FName>& Tags, TMap<FString, FString>& OutKeyValuePairs);
+
+private:
+	// Get the tags of the actor or component
+	static const TArray<FName>* GetTags(UObject* Object);
+
+private:
+	// Instance of every world
+	static TSLWorldInstances<FSLTagCache> WorldInstances;
+
+	// Flag showing the data has been init
+	bool bIsInit;
+
+	// World the tags were parsed from
+	TWeakObjectPtr<UWorld> CachedWorld;
+
+	// Objects with SemLog tags and their key-value pairs (weak keys, a deleted object never matches a new one at the same address)
+	TMap<TWeakObjectPtr<UObject>, TMap<FString, FString>> ObjectsKeyValuePairs;
+};
@@ -0,0 +1,111 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Max deviation of a rendered mask color from its semantic value (per channel)
+#ifndef SLVIS_SEM_TOL
+#define SLVIS_SEM_TOL 21
+#endif // SLVIS_SEM_TOL
+
+// Max deviation of a rendered background pixel from black (per channel)
+#ifndef SLVIS_BLACK_TOL
+#define SLVIS_BLACK_TOL 5
+#endif // SLVIS_BLACK_TOL
+
+/**
+ * Partitions the RGB space into a lattice of mask colors, the nodes are 2*Tolerance+1 apart on every channel,
+ * so a color deviated with at most Tolerance from a node rounds back to that node (O(1) snapping),
+ * masks are allocated deterministically from the free nodes in an order which keeps consecutive colors far apart
+ */
+class USEMLOGSKEL_API FSLVisMaskLattice
+{
+public:
+	// Ctor
+	FSLVisMaskLattice(uint8 InTolerance = SLVIS_SEM_TOL);
+
+	// Allocate the next free mask color, false if there are no free nodes left
+	bool Allocate(FColor& OutColor);
+
+	// Add an existing mask color (its node will not be allocated, nor the ones it could be confused with if it is off-lattice),
+	// false if the node was already used
+	bool Add(const FColor& Color);
+
+	// Find the added mask color closest to the color, within the tolerance
+	bool FindMaskColor(const FColor& Color, FColor& OutMaskColor) const;
+
+	// Remove all the added and allocated colors
+	void Reset();
+
+	// Total number of mask colors of the lattice
+	int32 GetCapacity() const { return NumNodes - 1; };
+
+	// Number of mask colors which can still be allocated
+	int32 GetNumFree() const { return NumFree; };
+
+	// Tolerance used to space the nodes
+	uint8 GetTolerance() const { return Tolerance; };
+
+private:
+	// Index of the node closest to the color
+	FORCEINLINE int32 GetNodeIndex(const FColor& Color) const
+	{
+		return (NodeLevel[Color.R] * NumLevels + NodeLevel[Color.G]) * NumLevels + NodeLevel[Color.B];
+	}
+
+	// Color of the node
+	FColor GetNodeColor(int32 NodeIdx) const;
+
+	// Mark the node as used
+	void UseNode(int32 NodeIdx);
+
+	// Node levels of a channel within the distance of the value
+	void GetLevelsInRange(int32 Value, int32 Distance, TArray<int32, TInlineAllocator<3>>& OutLevels) const;
+
+	// Compare the two colors with the tolerance
+	FORCEINLINE bool IsWithinTolerance(const FColor& ColorA, const FColor& ColorB) const
+	{
+		return FMath::Abs(ColorA.R - ColorB.R) <= Tolerance
+			&& FMath::Abs(ColorA.G - ColorB.G) <= Tolerance
+			&& FMath::Abs(ColorA.B - ColorB.B) <= Tolerance;
+	}
+
+private:
+	// Max deviation of a color from the mask value
+	uint8 Tolerance;
+
+	// Distance between two nodes on a channel
+	int32 Step;
+
+	// Value of the first node on a channel
+	int32 Offset;
+
+	// Number of nodes on a channel
+	int32 NumLevels;
+
+	// Number of nodes in the lattice (including the black one)
+	int32 NumNodes;
+
+	// Number of nodes which can still be allocated
+	int32 NumFree;
+
+	// Stride of the allocation order (co-prime with the number of nodes)
+	int32 Stride;
+
+	// Position in the allocation order
+	int32 Cursor;
+
+	// Closest node level of every channel value
+	uint8 NodeLevel[256];
+
+	// Nodes used by an allocated or added color
+	TBitArray<> UsedNodes;
+
+	// Mask colors added to the nodes, usually the node color itself (legacy, off-lattice colors are kept as they are)
+	TMap<int32, TArray<FColor, TInlineAllocator<1>>> NodeColors;
+
+	// True if off-lattice colors were added, the neighbour nodes need to be searched as well
+	bool bHasOffLatticeColors;
+};
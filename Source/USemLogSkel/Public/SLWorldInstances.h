@@ -0,0 +1,61 @@
+// Copyright 2017-2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UWorld;
+
+/**
+ * One instance of T per world, used instead of process wide singletons so that
+ * several worlds (PIE instances, game instances) can log concurrently without sharing state (game thread only)
+ */
+template<typename T>
+class TSLWorldInstances
+{
+public:
+	// Get the instance of the world, create it with the given function if missing
+	template<typename FCreateFunc>
+	T* FindOrAdd(UWorld* World, FCreateFunc&& CreateFunc)
+	{
+		if (TSharedPtr<T>* Instance = Instances.Find(World))
+		{
+			return Instance->Get();
+		}
+
+		// Forget the instances of the worlds which are gone
+		for (auto Itr(Instances.CreateIterator()); Itr; ++Itr)
+		{
+			if (Itr->Key.IsStale())
+			{
+				Itr.RemoveCurrent();
+			}
+		}
+
+		TSharedPtr<T> NewInstance = MakeShareable(CreateFunc());
+		Instances.Emplace(World, NewInstance);
+		return NewInstance.Get();
+	}
+
+	// Get the instance of the world (nullptr if none)
+	T* Find(UWorld* World) const
+	{
+		const TSharedPtr<T>* Instance = Instances.Find(World);
+		return Instance ? Instance->Get() : nullptr;
+	}
+
+	// Delete the instance of the world
+	void Remove(UWorld* World) { Instances.Remove(World); };
+
+	// Delete all the instances
+	void Empty() { Instances.Empty(); };
+
+	// Number of worlds with an instance
+	int32 Num() const { return Instances.Num(); };
+
+private:
+	// World to its instance
+	TMap<TWeakObjectPtr<UWorld>, TSharedPtr<T>> Instances;
+};
@@ -97,6 +97,14 @@ public:
 	// Check if the writer should skip this timestamp (varios reasons, img already inserted, ther are other images in the given range etc.)
 	bool ShouldSkipThisFrame(float Timestamp);
 
+	// Number of background index builds which did not finish yet (waited for by USemLog before cleaning up libmongoc)
+	static USEMLOGVISION_API int32 GetNumIndexBuildsInProgress();
+
+#if SLVIS_WITH_LIBMONGO_C
+	// Re-create the indexes (there could be new entries), blocks until the build is done
+	static bool CreateIndexes(mongoc_collection_t* collection);
+#endif //SLVIS_WITH_LIBMONGO_C
+
 private:
 	// Connect to the database
 	bool Connect(const FString& DBName, const FString& EpisodeId, const FString& ServerIp, uint16 ServerPort);
@@ -104,9 +112,6 @@ private:
 	// Get parameters about the closest entry to the given timestamp
 	void GetWorldStateParamsAt(float InTimestamp, bool bSearchBeforeTimestamp, FSLVisWorldStateEntryParams& OutParams);
 
-	// Re-create the indexes (there could be new entries)
-	bool CreateIndexes() const;
-
 #if SLVIS_WITH_LIBMONGO_C
 	// Save images to gridfs and return the bson entry
 	void AddViewsDataToDoc(const TArray<FSLVisViewData>& ViewsData, bson_t* out_views_doc);
@@ -122,6 +127,11 @@ private:
 	// Min time offset for a new db entry
 	float TimeRange;
 
+	// Connection parameters, used by the background index build
+	FString ServerUri;
+	FString DatabaseName;
+	FString CollName;
+
 #if SLVIS_WITH_LIBMONGO_C
 	// Server uri
 	mongoc_uri_t* uri;
@@ -8,6 +8,7 @@
 #include "UObject/NoExportTypes.h"
 #include "Components/MeshComponent.h"
 #include "Materials/MaterialInterface.h"
+#include "SLVisMaskLattice.h"
 #include "SLVisMaskHandler.generated.h"
 
 /**
@@ -138,8 +139,8 @@ private:
 	// true if the mask materials are currently are on the meshes
 	bool bMaskMaterialsOn;
 
-	// Store the semantic colors in an array (FindByPredicate convenience)
-	TArray<FColor> MaskColors;
+	// Semantic colors indexed by their lattice node (snapping deviated colors)
+	FSLVisMaskLattice MaskLattice;
 
 	// Semantic color data stored in a map (bit redundant with the color array)
 	TMap<FColor, FSLVisEntitiyData> EntitiesMasks;
@@ -3,6 +3,62 @@
 
 #include "SLVisImageWriterMongoC.h"
 #include "Conversions.h"
+#include "SLPoseBatch.h"
+#include "Async/AsyncWork.h"
+#include "HAL/ThreadSafeCounter.h"
+
+// Background index builds which did not finish yet
+static FThreadSafeCounter NumIndexBuildsInProgress;
+
+/**
+* Re-creates the image data indexes with its own client, the writer does not wait on it
+*/
+class FSLVisIndexBuildTask : public FNonAbandonableTask
+{
+	friend class FAutoDeleteAsyncTask<FSLVisIndexBuildTask>;
+
+public:
+	// Ctor
+	FSLVisIndexBuildTask(const FString& InUri, const FString& InDBName, const FString& InCollName)
+		: Uri(InUri), DBName(InDBName), CollName(InCollName) {};
+
+	// Build the indexes
+	void DoWork()
+	{
+#if SLVIS_WITH_LIBMONGO_C
+		const double StartTime = FPlatformTime::Seconds();
+		mongoc_client_t* client = mongoc_client_new(TCHAR_TO_UTF8(*Uri));
+		if (client)
+		{
+			mongoc_collection_t* collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollName));
+			if (USLVisImageWriterMongoC::CreateIndexes(collection))
+			{
+				UE_LOG(LogTemp, Log, TEXT("%s::%d Indexes of %s.%s built in %.2fs.."),
+					*FString(__func__), __LINE__, *DBName, *CollName, FPlatformTime::Seconds() - StartTime);
+			}
+			mongoc_collection_destroy(collection);
+			mongoc_client_destroy(client);
+		}
+#endif //SLVIS_WITH_LIBMONGO_C
+		NumIndexBuildsInProgress.Decrement();
+	}
+
+	// Needed by the engine to track the tasks
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FSLVisIndexBuildTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+private:
+	// Server uri
+	FString Uri;
+
+	// Database name
+	FString DBName;
+
+	// Collection name
+	FString CollName;
+};
 
 // Ctor
 USLVisImageWriterMongoC::USLVisImageWriterMongoC()
@@ -14,13 +70,12 @@ USLVisImageWriterMongoC::USLVisImageWriterMongoC()
 USLVisImageWriterMongoC::~USLVisImageWriterMongoC()
 {
 #if SLVIS_WITH_LIBMONGO_C
-	//Release our handles and clean up libmongoc
+	//Release our handles
 	mongoc_gridfs_destroy(gridfs);
 	mongoc_collection_destroy(collection);
 	mongoc_database_destroy(database);
 	mongoc_uri_destroy(uri);
 	mongoc_client_destroy(client);
-	mongoc_cleanup();
 #endif //SLVIS_WITH_LIBMONGO_C
 }
 
@@ -42,8 +97,9 @@ void USLVisImageWriterMongoC::Finish()
 {
 	if (bIsInit)
 	{
-		// Re-create the indexes
-		USLVisImageWriterMongoC::CreateIndexes();
+		// Re-create the indexes in the background, the episode stays queryable while they are built
+		NumIndexBuildsInProgress.Increment();
+		(new FAutoDeleteAsyncTask<FSLVisIndexBuildTask>(ServerUri, DatabaseName, CollName))->StartBackgroundTask();
 		bIsInit = false;
 	}
 }
@@ -245,14 +301,14 @@ bool USLVisImageWriterMongoC::ShouldSkipThisFrame(float Timestamp)
 bool USLVisImageWriterMongoC::Connect(const FString& DBName, const FString& EpisodeId, const FString& ServerIp, uint16 ServerPort)
 {
 #if SLVIS_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
 	// Stores any error that might appear during the connection
 	bson_error_t error;	
 	
 	// Safely create a MongoDB URI object from the given string
 	FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
+	ServerUri = Uri;
+	DatabaseName = DBName;
+	CollName = EpisodeId;
 	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Uri), &error);
 	if (!uri) 
 	{
@@ -359,14 +415,16 @@ void USLVisImageWriterMongoC::GetWorldStateParamsAt(float InTimestamp, bool bSea
 #endif //SLVIS_WITH_LIBMONGO_C
 }
 
-// Not needed if the index already exists (it gets updated for every new entry)
-bool USLVisImageWriterMongoC::CreateIndexes() const
+// Number of background index builds which did not finish yet
+int32 USLVisImageWriterMongoC::GetNumIndexBuildsInProgress()
 {
-	if (!bIsInit)
-	{
-		return false;
-	}
+	return NumIndexBuildsInProgress.GetValue();
+}
+
 #if SLVIS_WITH_LIBMONGO_C
+// Not needed if the index already exists (it gets updated for every new entry)
+bool USLVisImageWriterMongoC::CreateIndexes(mongoc_collection_t* collection)
+{
 
 	bson_t idx_id;
 	bson_init(&idx_id);
@@ -522,12 +580,8 @@ bool USLVisImageWriterMongoC::CreateIndexes() const
 	bson_free(idx_id_str);
 	bson_free(idx_eid_str);
 	return true;
-#else
-	return false;
-#endif //SLVIS_WITH_LIBMONGO_C
 }
 
-#if SLVIS_WITH_LIBMONGO_C
 // Save images to gridfs and return the bson entry
 void USLVisImageWriterMongoC::AddViewsDataToDoc(const TArray<FSLVisViewData>& ViewsData, bson_t* out_views_doc)
 {
@@ -569,6 +623,10 @@ void USLVisImageWriterMongoC::AddViewsDataToDoc(const TArray<FSLVisViewData>& Vi
 	const char *l_key;
 	uint32_t l = 0;
 
+	// Poses of the entities and bones of the view, converted to the ROS frame in one pass
+	FSLPoseBatch PoseBatch;
+	FSLPoseBatch BonePoseBatch;
+
 	// Create the views array
 	BSON_APPEND_ARRAY_BEGIN(out_views_doc, "camera_views", &view_arr);
 	for (const auto& View : ViewsData)
@@ -592,6 +650,14 @@ void USLVisImageWriterMongoC::AddViewsDataToDoc(const TArray<FSLVisViewData>& Vi
 			BSON_APPEND_INT32(&view_arr_obj_res, "y", View.Resolution.Y);
 			bson_append_document_end(&view_arr_obj, &view_arr_obj_res);
 
+			// Switch to right handed ROS transformation
+			PoseBatch.Reset(View.SemanticEntities.Num());
+			for (const auto& Entity : View.SemanticEntities)
+			{
+				PoseBatch.Add(Entity.TransformFromView.GetLocation(), Entity.TransformFromView.GetRotation());
+			}
+			PoseBatch.ConvertToROS();
+
 			// Create the entities array
 			j = 0;
 			BSON_APPEND_ARRAY_BEGIN(&view_arr_obj, "entities", &entity_arr);
@@ -609,9 +675,8 @@ void USLVisImageWriterMongoC::AddViewsDataToDoc(const TArray<FSLVisViewData>& Vi
 					BSON_APPEND_DOUBLE(&entity_arr_obj, "linear_distance", FConversions::CmToM(Entity.LinearDistanceToView));
 					BSON_APPEND_DOUBLE(&entity_arr_obj, "angular_distance", FConversions::CmToM(Entity.AngularDistanceToView));
 
-					// Switch to right handed ROS transformation
-					const FVector ROSLoc = FConversions::UToROS(Entity.TransformFromView.GetLocation());
-					const FQuat ROSQuat = FConversions::UToROS(Entity.TransformFromView.GetRotation());
+					const FVector& ROSLoc = PoseBatch.Locations[j];
+					const FQuat& ROSQuat = PoseBatch.Quats[j];
 
 					bson_t child_obj_loc;
 					bson_t child_obj_rot;
@@ -653,6 +718,14 @@ void USLVisImageWriterMongoC::AddViewsDataToDoc(const TArray<FSLVisViewData>& Vi
 				BSON_APPEND_UTF8(&entity_arr_obj, "id", TCHAR_TO_UTF8(*SkelEntity.Id));
 				BSON_APPEND_UTF8(&entity_arr_obj, "class", TCHAR_TO_UTF8(*SkelEntity.Class));
 
+					// Switch to right handed ROS transformation
+					BonePoseBatch.Reset(SkelEntity.BonesData.Num());
+					for (const auto& BoneData : SkelEntity.BonesData)
+					{
+						BonePoseBatch.Add(BoneData.TransformFromView.GetLocation(), BoneData.TransformFromView.GetRotation());
+					}
+					BonePoseBatch.ConvertToROS();
+
 					l = 0;
 					BSON_APPEND_ARRAY_BEGIN(&entity_arr_obj, "bones", &entity_bone_arr);
 					// Add the skeletal bones
@@ -667,9 +740,8 @@ void USLVisImageWriterMongoC::AddViewsDataToDoc(const TArray<FSLVisViewData>& Vi
 						BSON_APPEND_INT32(&entity_bone_arr_obj, "num_pixels", BoneData.NumPixels);
 						BSON_APPEND_DOUBLE(&entity_bone_arr_obj, "distance", FConversions::CmToM(BoneData.DistanceToView));
 
-						// Switch to right handed ROS transformation
-						const FVector ROSLoc = FConversions::UToROS(BoneData.TransformFromView.GetLocation());
-						const FQuat ROSQuat = FConversions::UToROS(BoneData.TransformFromView.GetRotation());
+						const FVector& ROSLoc = BonePoseBatch.Locations[l];
+						const FQuat& ROSQuat = BonePoseBatch.Quats[l];
 
 						bson_t child_obj_loc;
 						bson_t child_obj_rot;
@@ -8,10 +8,9 @@
 #include "EngineUtils.h"
 #include "SLSkeletalDataComponent.h"
 #include "Tags.h"
+#include "SLTagCache.h"
 #include "SLVisImageWriterInterface.h"
-
-#define SLVIS_SEM_TOL 21
-#define SLVIS_BLACK_TOL 5
+#include "SLImageStats.h"
 
 
 // Ctor
@@ -62,6 +61,10 @@ void USLVisMaskHandler::Init(int32 InNumOfPixels)
 // Save the original color materials of the static meshes, and create a for each mesh a mask material
 void USLVisMaskHandler::SetupStaticMeshes()
 {	
+	// The tags are parsed once per world and shared with the loggers
+	FSLTagCache* TagCache = FSLTagCache::GetInstance(GetWorld());
+	TagCache->Init(GetWorld());
+
 	for (TActorIterator<AStaticMeshActor> SMAItr(GetWorld()); SMAItr; ++SMAItr)
 	{
 		if (UStaticMeshComponent* SMC = SMAItr->GetStaticMeshComponent())
@@ -70,7 +73,7 @@ void USLVisMaskHandler::SetupStaticMeshes()
 			OriginalMaterials.Emplace(SMC, SMC->GetMaterials());
 
 			// The static mesh has one mask color, check if the hex value is stored by the actor or component
-			FString ColorHex = FTags::GetValue(*SMAItr, "SemLog", "VisMask");
+			FString ColorHex = TagCache->GetValue(*SMAItr, "VisMask");
 			if (!ColorHex.IsEmpty())
 			{
 				FColor SemColor(FColor::FromHex(ColorHex));
@@ -81,7 +84,7 @@ void USLVisMaskHandler::SetupStaticMeshes()
 			}
 			else
 			{
-				ColorHex = FTags::GetValue(SMC, "SemLog", "VisMask");
+				ColorHex = TagCache->GetValue(SMC, "VisMask");
 				if (!ColorHex.IsEmpty())
 				{
 					FColor SemColor(FColor::FromHex(ColorHex));
@@ -222,78 +225,87 @@ void USLVisMaskHandler::ProcessMaskImage(TArray<FColor>& MaskImage, const FTrans
 	TMap<FColor, FSLVisEntitiyData> EntitiesInImage; // Cache which static meshes are in the image
 	TMap<FColor, FSLVisBoneData> BonesInImage; // Cache which bones are in the image
 
-	//TSet<FColor> ColorsInRange;
-	//TSet<FColor> ColorsOutOfRange;
+	// The mask images only have a few distinct colors, the semantic color lookups (with tolerance)
+	// are done once per color of the image histogram instead of once per pixel
+	TMap<FColor, int32> Histogram;
+	FSLImageStats::ComputeHistogram(MaskImage, Histogram);
 
-	// Image array index value
-	int32 Idx = 0;
+	// Colors which are replaced in the image (deviated semantic colors, or black if not a semantic color)
+	TMap<FColor, FColor> ColorMap;
 
-	// Iterate mask image
-	for (auto& PixelColor : MaskImage)
+	// Iterate the image colors
+	for (const auto& ColorNumPair : Histogram)
 	{
-		// Continue if it is different than black with a tolerance
-		if (!AlmostEqual(PixelColor, FColor::Black, SLVIS_BLACK_TOL))
+		// Skip the background, black with a tolerance
+		if (AlmostEqual(ColorNumPair.Key, FColor::Black, SLVIS_BLACK_TOL))
 		{
-			FColor TempColor = PixelColor;
-			// Check and replace if color got deviated from the semantic one due to conversions (FLinearColor to FColor)
-			if (RestoreIfCloseToAMaskColor(PixelColor))
+			continue;
+		}
+
+		// Check and replace if color got deviated from the semantic one due to conversions (FLinearColor to FColor)
+		FColor PixelColor = ColorNumPair.Key;
+		RestoreIfCloseToAMaskColor(PixelColor);
+
+		// Check if pixel color belongs to a semantic mask color of a static mesh
+		if (EntitiesMasks.Contains(PixelColor))
+		{
+			// Check if color has been cached in the temp map (several deviated colors can map to the same semantic color)
+			if (FSLVisEntitiyData* EntityDataInImage = EntitiesInImage.Find(PixelColor))
 			{
-				//ColorsInRange.Add(TempColor); // for debug 
+				// Update the existing data
+				EntityDataInImage->NumPixels += ColorNumPair.Value;
 			}
-
-			// Check if pixel color belongs to a semantic mask color of a static mesh
-			if (EntitiesMasks.Contains(PixelColor))
+			else
 			{
-				// Check if color has been cached in the temp map
-				if(EntitiesInImage.Contains(PixelColor))
+				FSLVisEntitiyData EntityData = EntitiesMasks[PixelColor];
+				if (EntityData.SelfAsActor)
 				{
-					// Update the existing data
-					EntitiesInImage[PixelColor].NumPixels++;
+					EntityData.TransformFromView = ViewWorldTransform.GetRelativeTransform(EntityData.SelfAsActor->GetTransform());
+					EntityData.LinearDistanceToView = FVector::Distance(ViewWorldTransform.GetLocation(), EntityData.SelfAsActor->GetActorLocation());
+					EntityData.AngularDistanceToView = ViewWorldTransform.GetRotation().AngularDistance(EntityData.SelfAsActor->GetActorQuat());
 				}
-				else
+				else if (EntityData.SelfAsComponent)
 				{
-					FSLVisEntitiyData EntityData = EntitiesMasks[PixelColor];
-					if (EntityData.SelfAsActor)
-					{
-						EntityData.TransformFromView = ViewWorldTransform.GetRelativeTransform(EntityData.SelfAsActor->GetTransform());
-						EntityData.LinearDistanceToView = FVector::Distance(ViewWorldTransform.GetLocation(), EntityData.SelfAsActor->GetActorLocation());
-						EntityData.AngularDistanceToView = ViewWorldTransform.GetRotation().AngularDistance(EntityData.SelfAsActor->GetActorQuat());
-					}
-					else if (EntityData.SelfAsComponent)
-					{
-						EntityData.TransformFromView = ViewWorldTransform.GetRelativeTransform(EntityData.SelfAsComponent->GetComponentTransform());
-						EntityData.LinearDistanceToView = FVector::Distance(ViewWorldTransform.GetLocation(), EntityData.SelfAsComponent->GetComponentLocation());
-						EntityData.AngularDistanceToView = ViewWorldTransform.GetRotation().AngularDistance(EntityData.SelfAsComponent->GetComponentQuat());
-					}
-					// Add init entity data
-					EntitiesInImage.Emplace(PixelColor, EntityData);
+					EntityData.TransformFromView = ViewWorldTransform.GetRelativeTransform(EntityData.SelfAsComponent->GetComponentTransform());
+					EntityData.LinearDistanceToView = FVector::Distance(ViewWorldTransform.GetLocation(), EntityData.SelfAsComponent->GetComponentLocation());
+					EntityData.AngularDistanceToView = ViewWorldTransform.GetRotation().AngularDistance(EntityData.SelfAsComponent->GetComponentQuat());
 				}
+				// Add init entity data
+				EntityData.NumPixels = ColorNumPair.Value;
+				EntitiesInImage.Emplace(PixelColor, EntityData);
 			}
-			else if (BonesMasks.Contains(PixelColor)) // Check if color belongs to a skeletal bone
+		}
+		else if (BonesMasks.Contains(PixelColor)) // Check if color belongs to a skeletal bone
+		{
+			// Check if color has already been cached
+			if (FSLVisBoneData* BoneDataInImage = BonesInImage.Find(PixelColor))
 			{
-				// Check if color has already been cached
-				if (BonesInImage.Contains(PixelColor))
-				{
-					// Update the data
-					BonesInImage[PixelColor].NumPixels++;
-				}
-				else
-				{
-					// Add the bone to the first time
-					BonesInImage.Emplace(PixelColor, BonesMasks[PixelColor]);
-				}
+				// Update the data
+				BoneDataInImage->NumPixels += ColorNumPair.Value;
 			}
 			else
 			{
-				// Pixel color not found int the mask semantic list, will be changed to black
-				//ColorsOutOfRange.Add(Color); // for debug 
-				PixelColor = FColor::Black;
+				// Add the bone to the first time
+				FSLVisBoneData BoneData = BonesMasks[PixelColor];
+				BoneData.NumPixels = ColorNumPair.Value;
+				BonesInImage.Emplace(PixelColor, BoneData);
 			}
 		}
-		// Increment array position index 
-		Idx++;
+		else
+		{
+			// Pixel color not found int the mask semantic list, will be changed to black
+			PixelColor = FColor::Black;
+		}
+
+		if (PixelColor != ColorNumPair.Key)
+		{
+			ColorMap.Emplace(ColorNumPair.Key, PixelColor);
+		}
 	}
 
+	// Fix the pixel color deviations in the image
+	FSLImageStats::RemapColors(MaskImage, ColorMap);
+
 	//UE_LOG(LogTemp, Warning, TEXT("%s::%d Semantic colors:"), *FString(__func__), __LINE__);
 	//for (const auto& C : SemanticColors)
 	//{
@@ -355,8 +367,16 @@ void USLVisMaskHandler::AddSemanticData(const FColor& Color, const FString& Colo
 	FSLVisEntitiyData EntityData;
 	EntityData.Color = Color;
 	EntityData.ColorHex = ColorHex;
-	EntityData.Class = FTags::GetValue(Tags, "SemLog", "Class");
-	EntityData.Id = FTags::GetValue(Tags, "SemLog", "Id");
+	if (const TMap<FString, FString>* KeyValuePairs = FSLTagCache::GetInstance(GetWorld())->Find(Self))
+	{
+		EntityData.Class = KeyValuePairs->FindRef("Class");
+		EntityData.Id = KeyValuePairs->FindRef("Id");
+	}
+	else
+	{
+		EntityData.Class = FTags::GetValue(Tags, "SemLog", "Class");
+		EntityData.Id = FTags::GetValue(Tags, "SemLog", "Id");
+	}
 	if (Self)
 	{
 		if (AStaticMeshActor* AsSMA = Cast<AStaticMeshActor>(Self))
@@ -369,7 +389,7 @@ void USLVisMaskHandler::AddSemanticData(const FColor& Color, const FString& Colo
 		}
 	}
 
-	MaskColors.Emplace(Color);
+	MaskLattice.Add(Color);
 	EntitiesMasks.Emplace(Color, EntityData);
 
 	//UE_LOG(LogTemp, Warning, TEXT("%s::%d EntityData=\n\t%s"), *FString(__func__), __LINE__, *EntityData.ToString());
@@ -396,7 +416,7 @@ void USLVisMaskHandler::AddSkelSemanticData(const FString& OwnerId,
 	BoneData.Class = BoneClass;
 	BoneData.TransformFromWorld = WorldTransform;
 
-	MaskColors.Emplace(Color);
+	MaskLattice.Add(Color);
 	BonesMasks.Emplace(Color, BoneData);
 
 	//UE_LOG(LogTemp, Warning, TEXT("%s::%d EntityData=\n\t%s"), *FString(__func__), __LINE__, *EntityData.ToString());
@@ -405,17 +425,12 @@ void USLVisMaskHandler::AddSkelSemanticData(const FString& OwnerId,
 // Compare against the semantic colors, if found switch (update color info during), returns true if the color has been switched
 bool USLVisMaskHandler::RestoreIfCloseToAMaskColor(FColor& OutColor)
 {
-	// Lambda for the FindByPredicate function, checks if the two colors are similar 
-	auto AlmostEqualPredicate = [this, &OutColor](const FColor& SemColor)
-	{
-		return this->AlmostEqual(OutColor, SemColor, SLVIS_SEM_TOL);
-	};
-
-	// If the two colors are similar, replace it with the semantic value
-	if (FColor* FoundSemanticColor = MaskColors.FindByPredicate(AlmostEqualPredicate))
+	// The lattice node of the color holds the semantic colors within the tolerance (O(1) lookup)
+	FColor FoundSemanticColor;
+	if (MaskLattice.FindMaskColor(OutColor, FoundSemanticColor))
 	{
 		// Do the switch
-		OutColor = *FoundSemanticColor;
+		OutColor = FoundSemanticColor;
 		return true;
 	}
 	return false;
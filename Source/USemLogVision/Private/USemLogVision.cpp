@@ -11,6 +11,7 @@ DEFINE_LOG_CATEGORY(LogSLVis);
 void FUSemLogVision::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	// libmongoc is initialized and cleaned up by the mongo service of USemLog, which creates the vision writers
 }
 
 void FUSemLogVision::ShutdownModule()